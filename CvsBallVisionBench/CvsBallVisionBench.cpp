@@ -0,0 +1,518 @@
+// CvsBallVisionBench.cpp : latency and throughput benchmarks for the core image path
+//
+// Runs against the simulated camera backend, so no hardware is needed. --playback adds scenarios
+// that replay a recording as fast as the core path accepts it.
+// Usage: CvsBallVisionBench [--quick] [--duration <ms>] [--output <results.json>] [--playback <recording>]
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "CvsBallVisionCore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CvsBallVision;
+
+namespace
+{
+    const char* const RESULTS_FORMAT_VERSION = "1";
+    constexpr int DEFAULT_DURATION_MS = 3000;
+    constexpr int QUICK_DURATION_MS = 1000;
+    constexpr int WARMUP_MS = 300;
+    constexpr int DRAIN_MS = 100;      // Lets frames received inside the window reach the callback
+    constexpr double BENCH_GAMMA = 2.2;
+    constexpr size_t PLAYBACK_SAMPLES_PER_SECOND = 20000;
+
+    // Latency distribution of one measurement (microseconds)
+    struct Percentiles
+    {
+        size_t count = 0;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p99 = 0.0;
+        double p999 = 0.0;
+        double max = 0.0;
+    };
+
+    Percentiles ComputePercentiles(std::vector<double> samples)
+    {
+        Percentiles result;
+        if (samples.empty())
+            return result;
+
+        std::sort(samples.begin(), samples.end());
+
+        // Nearest-rank percentile
+        auto rank = [&](double p) {
+            size_t index = static_cast<size_t>(p * samples.size());
+            return samples[std::min(index, samples.size() - 1)];
+        };
+
+        double sum = 0.0;
+        for (double value : samples)
+        {
+            sum += value;
+        }
+
+        result.count = samples.size();
+        result.mean = sum / samples.size();
+        result.p50 = rank(0.50);
+        result.p99 = rank(0.99);
+        result.p999 = rank(0.999);
+        result.max = samples.back();
+        return result;
+    }
+
+    struct AcquisitionScenario
+    {
+        std::string name;
+        int width;
+        int height;
+        double fps;                 // 0: unpaced playback
+        bool bPipeline;
+        std::string playbackPath;   // Replay this recording instead of the simulated camera
+    };
+
+    struct AcquisitionResult
+    {
+        AcquisitionScenario scenario;
+        bool bOk = false;
+        double measuredFps = 0.0;
+        uint64_t frames = 0;
+        uint64_t framesDropped = 0;
+        Percentiles capture;        // OnImageReceived copy out of the driver buffer
+        Percentiles debayer;        // Includes fused colour correction and gamma
+        Percentiles postProcess;    // Post-process stage (software gamma only when not fused)
+        Percentiles queueWait;
+        Percentiles dispatch;       // Publish to callback entry
+        Percentiles endToEnd;       // Driver handoff to callback entry
+    };
+
+    struct ThroughputResult
+    {
+        std::string name;
+        int width = 0;
+        int height = 0;
+        Percentiles perCall;
+        double megapixelsPerSecond = 0.0;
+    };
+
+    // Per-frame samples gathered in the frame callback
+    struct FrameSamples
+    {
+        std::mutex mutex;
+        std::vector<double> capture;
+        std::vector<double> debayer;
+        std::vector<double> postProcess;
+        std::vector<double> queueWait;
+        std::vector<double> dispatch;
+        std::vector<double> endToEnd;
+        int64_t recordAfterNs = 0;     // Measurement window on the receive timestamp
+        int64_t recordUntilNs = 0;
+
+        void Reserve(size_t count)
+        {
+            for (auto* pSamples : { &capture, &debayer, &postProcess, &queueWait, &dispatch, &endToEnd })
+            {
+                pSamples->reserve(count);
+            }
+        }
+    };
+
+    int64_t SteadyNowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool RunAcquisition(const AcquisitionScenario& scenario, int durationMs, AcquisitionResult& result)
+    {
+        result.scenario = scenario;
+        const bool bPlayback = !scenario.playbackPath.empty();
+
+        CameraController camera;
+        bool bBackend;
+        if (bPlayback)
+        {
+            PlaybackConfig config;
+            config.path = scenario.playbackPath;
+            config.pacing = PlaybackPacing::Maximum;
+            config.loop = true;
+            bBackend = camera.SetPlaybackBackend(config);
+        }
+        else
+        {
+            SimulatedCameraConfig config;
+            config.sensorWidth = scenario.width;
+            config.sensorHeight = scenario.height;
+            config.frameRate = scenario.fps;
+            config.randomSeed = 1;
+            bBackend = camera.SetDeviceBackend(DeviceBackendType::Simulated, config);
+        }
+
+        if (!bBackend || !camera.InitializeSystem() || !camera.UpdateDeviceList() || !camera.ConnectCamera(0))
+        {
+            printf("  %s: failed to open the %s camera: %s\n", scenario.name.c_str(),
+                bPlayback ? "playback" : "simulated", camera.GetLastErrorDescription().c_str());
+            return false;
+        }
+
+        if (bPlayback)
+        {
+            camera.GetResolution(result.scenario.width, result.scenario.height);
+        }
+        else
+        {
+            // Short exposure so the frame rate is not capped by it
+            camera.SetExposureTime(std::min(Constants::DEFAULT_EXPOSURE_US, 500000.0 / scenario.fps));
+            camera.SetFrameRate(scenario.fps);
+        }
+        camera.SetGamma(BENCH_GAMMA);
+
+        PipelineConfig pipeline;
+        pipeline.enabled = scenario.bPipeline;
+        camera.SetPipelineConfig(pipeline);
+
+        FrameSamples samples;
+        const double expectedFps = bPlayback ? PLAYBACK_SAMPLES_PER_SECOND : scenario.fps;
+        samples.Reserve(static_cast<size_t>(expectedFps * durationMs / 1000.0 * 1.5) + 64);
+        samples.recordAfterNs = SteadyNowNs() + static_cast<int64_t>(WARMUP_MS) * 1000000;
+        samples.recordUntilNs = samples.recordAfterNs + static_cast<int64_t>(durationMs) * 1000000;
+
+        camera.RegisterFrameCallback([&samples](const FrameRef& frame) {
+            const int64_t nowNs = SteadyNowNs();
+            const FrameTimings& t = frame.GetImageData().timings;
+            if (t.receivedNs < samples.recordAfterNs || t.receivedNs >= samples.recordUntilNs)
+                return;
+
+            const double endToEnd = (nowNs - t.receivedNs) / 1000.0;
+            const double processing = t.captureUs + t.debayerUs + t.postProcessUs + t.queueWaitUs;
+
+            std::lock_guard<std::mutex> lock(samples.mutex);
+            samples.capture.push_back(t.captureUs);
+            samples.debayer.push_back(t.debayerUs);
+            samples.postProcess.push_back(t.postProcessUs);
+            samples.queueWait.push_back(t.queueWaitUs);
+            samples.dispatch.push_back(std::max(0.0, endToEnd - processing));
+            samples.endToEnd.push_back(endToEnd);
+        });
+
+        if (!camera.StartAcquisition())
+        {
+            printf("  %s: failed to start acquisition: %s\n",
+                scenario.name.c_str(), camera.GetLastErrorDescription().c_str());
+            camera.DisconnectCamera();
+            return false;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(WARMUP_MS + durationMs + DRAIN_MS));
+
+        FrameRingStatistics ringStats;
+        PipelineStatistics pipelineStats;
+        camera.GetFrameRingStatistics(ringStats);
+        camera.GetPipelineStatistics(pipelineStats);
+
+        camera.StopAcquisition();
+        camera.RegisterFrameCallback(nullptr);
+        camera.DisconnectCamera();
+        camera.FreeSystem();
+
+        std::lock_guard<std::mutex> lock(samples.mutex);
+        result.frames = samples.endToEnd.size();
+        result.measuredFps = result.frames * 1000.0 / durationMs;
+        result.framesDropped = ringStats.framesDroppedRingFull + ringStats.framesDroppedDevice +
+            ringStats.framesDroppedInvalid + pipelineStats.capture.framesDropped +
+            pipelineStats.debayer.framesDropped + pipelineStats.postProcess.framesDropped +
+            pipelineStats.fanOut.framesDropped;
+        result.capture = ComputePercentiles(samples.capture);
+        result.debayer = ComputePercentiles(samples.debayer);
+        result.postProcess = ComputePercentiles(samples.postProcess);
+        result.queueWait = ComputePercentiles(samples.queueWait);
+        result.dispatch = ComputePercentiles(samples.dispatch);
+        result.endToEnd = ComputePercentiles(samples.endToEnd);
+        result.bOk = result.frames > 0;
+        return result.bOk;
+    }
+
+    // Time `iterations` calls of fn over a width x height image
+    template <typename Fn>
+    ThroughputResult MeasureThroughput(const char* name, int width, int height, int iterations, Fn fn)
+    {
+        ThroughputResult result;
+        result.name = name;
+        result.width = width;
+        result.height = height;
+
+        std::vector<double> perCall;
+        perCall.reserve(iterations);
+
+        fn();   // Warm caches and lazily built tables
+
+        auto totalStart = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            perCall.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+        double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - totalStart).count();
+
+        result.perCall = ComputePercentiles(perCall);
+        result.megapixelsPerSecond = totalSeconds > 0.0 ?
+            static_cast<double>(width) * height * iterations / totalSeconds / 1e6 : 0.0;
+        return result;
+    }
+
+    std::vector<ThroughputResult> RunThroughput(bool bQuick)
+    {
+        const int sizes[][2] = { { 640, 480 }, { 1456, 1088 }, { 1920, 1200 } };
+        const int iterations = bQuick ? 30 : 200;
+
+        std::vector<ThroughputResult> results;
+        std::mt19937 rng(1);
+
+        for (const auto& size : sizes)
+        {
+            const int width = size[0];
+            const int height = size[1];
+
+            std::vector<uint8_t> bayer(static_cast<size_t>(width) * height);
+            for (auto& value : bayer)
+            {
+                value = static_cast<uint8_t>(rng());
+            }
+            std::vector<uint8_t> rgb(bayer.size() * 3);
+
+            results.push_back(MeasureThroughput("ConvertBayerToRGB", width, height, iterations, [&] {
+                ConvertBayerToRGB(bayer.data(), rgb.data(), width, height, "BayerRG");
+            }));
+
+            results.push_back(MeasureThroughput("ApplyGammaCorrection", width, height, iterations, [&] {
+                ApplyGammaCorrection(rgb.data(), width, height, 3, BENCH_GAMMA);
+            }));
+        }
+
+        return results;
+    }
+
+    std::vector<AcquisitionScenario> BuildScenarios(bool bQuick, const std::string& playbackPath)
+    {
+        const int resolutions[][2] = { { 640, 480 }, { 1456, 1088 } };
+        const double rates[] = { 60.0, 200.0 };
+
+        std::vector<AcquisitionScenario> scenarios;
+        for (const auto& resolution : resolutions)
+        {
+            for (double fps : rates)
+            {
+                for (bool bPipeline : { true, false })
+                {
+                    if (bQuick && !bPipeline)
+                        continue;
+
+                    std::ostringstream name;
+                    name << resolution[0] << "x" << resolution[1] << "@" << fps << (bPipeline ? " pipeline" : " inline");
+                    scenarios.push_back({ name.str(), resolution[0], resolution[1], fps, bPipeline, "" });
+                }
+            }
+        }
+
+        if (!playbackPath.empty())
+        {
+            for (bool bPipeline : { true, false })
+            {
+                scenarios.push_back({ bPipeline ? "playback pipeline" : "playback inline", 0, 0, 0.0, bPipeline, playbackPath });
+            }
+        }
+        return scenarios;
+    }
+
+    std::string CurrentTimestampUtc()
+    {
+        std::time_t now = std::time(nullptr);
+        std::tm utc;
+#if defined(_WIN32)
+        gmtime_s(&utc, &now);
+#else
+        gmtime_r(&now, &utc);
+#endif
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+        return buffer;
+    }
+
+    void WritePercentiles(std::ostream& out, const char* name, const Percentiles& p, bool bLast = false)
+    {
+        out << "        \"" << name << "\": { \"count\": " << p.count
+            << ", \"mean\": " << p.mean << ", \"p50\": " << p.p50 << ", \"p99\": " << p.p99
+            << ", \"p999\": " << p.p999 << ", \"max\": " << p.max << " }" << (bLast ? "\n" : ",\n");
+    }
+
+    bool WriteJson(const std::string& path, int durationMs,
+        const std::vector<AcquisitionResult>& acquisition, const std::vector<ThroughputResult>& throughput)
+    {
+        std::ofstream out(path);
+        if (!out)
+            return false;
+
+        out.setf(std::ios::fixed);
+        out.precision(3);
+
+        out << "{\n";
+        out << "  \"format\": \"" << RESULTS_FORMAT_VERSION << "\",\n";
+        out << "  \"sdkVersion\": \"" << GetSDKVersion() << "\",\n";
+        out << "  \"instructionSet\": \"" << GetProcessingInstructionSet() << "\",\n";
+        out << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+        out << "  \"build\": \"Release\",\n";
+#else
+        out << "  \"build\": \"Debug\",\n";
+#endif
+        out << "  \"timestamp\": \"" << CurrentTimestampUtc() << "\",\n";
+        out << "  \"durationMs\": " << durationMs << ",\n";
+        out << "  \"units\": \"microseconds\",\n";
+
+        out << "  \"acquisition\": [\n";
+        for (size_t i = 0; i < acquisition.size(); ++i)
+        {
+            const AcquisitionResult& r = acquisition[i];
+            out << "    {\n";
+            out << "      \"name\": \"" << r.scenario.name << "\",\n";
+            out << "      \"width\": " << r.scenario.width << ", \"height\": " << r.scenario.height << ",\n";
+            out << "      \"targetFps\": " << r.scenario.fps << ", \"measuredFps\": " << r.measuredFps << ",\n";
+            out << "      \"pipeline\": " << (r.scenario.bPipeline ? "true" : "false") << ",\n";
+            out << "      \"ok\": " << (r.bOk ? "true" : "false") << ",\n";
+            out << "      \"frames\": " << r.frames << ", \"framesDropped\": " << r.framesDropped << ",\n";
+            out << "      \"latency\": {\n";
+            WritePercentiles(out, "capture", r.capture);
+            WritePercentiles(out, "debayer", r.debayer);
+            WritePercentiles(out, "postProcess", r.postProcess);
+            WritePercentiles(out, "queueWait", r.queueWait);
+            WritePercentiles(out, "dispatch", r.dispatch);
+            WritePercentiles(out, "endToEnd", r.endToEnd, true);
+            out << "      }\n";
+            out << "    }" << (i + 1 < acquisition.size() ? ",\n" : "\n");
+        }
+        out << "  ],\n";
+
+        out << "  \"throughput\": [\n";
+        for (size_t i = 0; i < throughput.size(); ++i)
+        {
+            const ThroughputResult& r = throughput[i];
+            out << "    { \"name\": \"" << r.name << "\", \"width\": " << r.width << ", \"height\": " << r.height
+                << ", \"megapixelsPerSecond\": " << r.megapixelsPerSecond
+                << ", \"perCall\": { \"count\": " << r.perCall.count << ", \"mean\": " << r.perCall.mean
+                << ", \"p50\": " << r.perCall.p50 << ", \"p99\": " << r.perCall.p99
+                << ", \"p999\": " << r.perCall.p999 << ", \"max\": " << r.perCall.max << " } }"
+                << (i + 1 < throughput.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n";
+        out << "}\n";
+
+        return static_cast<bool>(out);
+    }
+
+    void PrintUsage()
+    {
+        printf("Usage: CvsBallVisionBench [--quick] [--duration <ms>] [--output <results.json>] [--playback <recording>]\n");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    bool bQuick = false;
+    int durationMs = -1;
+    std::string outputPath = "CvsBallVisionBench.json";
+    std::string playbackPath;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+        {
+            bQuick = true;
+        }
+        else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc)
+        {
+            durationMs = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+        {
+            outputPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--playback") == 0 && i + 1 < argc)
+        {
+            playbackPath = argv[++i];
+        }
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    if (durationMs <= 0)
+        durationMs = bQuick ? QUICK_DURATION_MS : DEFAULT_DURATION_MS;
+
+    printf("CvsBallVision benchmark (SDK %s, %s, %u hardware threads)\n",
+        GetSDKVersion().c_str(), GetProcessingInstructionSet().c_str(), std::thread::hardware_concurrency());
+
+    bool bAllOk = true;
+
+    printf("\nAcquisition latency, microseconds (p50 / p99 / p99.9)\n");
+    printf("%-28s %8s %6s %22s %22s %22s %22s %22s\n",
+        "scenario", "fps", "drops", "capture", "debayer", "post-process", "dispatch", "end-to-end");
+
+    std::vector<AcquisitionResult> acquisition;
+    for (const auto& scenario : BuildScenarios(bQuick, playbackPath))
+    {
+        AcquisitionResult result;
+        if (!RunAcquisition(scenario, durationMs, result))
+            bAllOk = false;
+
+        auto cell = [](const Percentiles& p) {
+            char text[64];
+            snprintf(text, sizeof(text), "%.0f / %.0f / %.0f", p.p50, p.p99, p.p999);
+            return std::string(text);
+        };
+
+        printf("%-28s %8.1f %6llu %22s %22s %22s %22s %22s\n",
+            scenario.name.c_str(), result.measuredFps, static_cast<unsigned long long>(result.framesDropped),
+            cell(result.capture).c_str(), cell(result.debayer).c_str(), cell(result.postProcess).c_str(),
+            cell(result.dispatch).c_str(), cell(result.endToEnd).c_str());
+
+        acquisition.push_back(result);
+    }
+
+    printf("\nThroughput\n");
+    printf("%-22s %11s %10s %10s %10s\n", "function", "size", "MPix/s", "p50 us", "p99 us");
+
+    std::vector<ThroughputResult> throughput = RunThroughput(bQuick);
+    for (const auto& result : throughput)
+    {
+        char size[32];
+        snprintf(size, sizeof(size), "%dx%d", result.width, result.height);
+        printf("%-22s %11s %10.1f %10.0f %10.0f\n",
+            result.name.c_str(), size, result.megapixelsPerSecond, result.perCall.p50, result.perCall.p99);
+    }
+
+    if (!WriteJson(outputPath, durationMs, acquisition, throughput))
+    {
+        printf("\nFailed to write %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    printf("\nResults written to %s\n", outputPath.c_str());
+    return bAllOk ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "CvsBallVisionCore.h"
+#include <algorithm>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdlib>
+#endif
+
+namespace CvsBallVision
+{
+    // Page-aligned frame memory owned by the host side (capture copies, frame ring slots).
+    //
+    // Pages are touched when allocated so the acquisition path never takes a first-touch
+    // fault, and can optionally be locked into RAM so they are never paged out under
+    // memory pressure. Locking is best effort: IsLocked reports whether it succeeded, and a
+    // failed lock is not retried until the buffer is reallocated, so per-frame Reserve calls
+    // stay cheap when mlock/VirtualLock is over quota. Contents are not preserved when the
+    // buffer grows.
+    class AlignedBuffer
+    {
+    public:
+        AlignedBuffer()
+            : m_pData(nullptr)
+            , m_size(0)
+            , m_capacity(0)
+            , m_bLocked(false)
+            , m_bLockAttempted(false)
+        {
+        }
+
+        ~AlignedBuffer()
+        {
+            Free();
+        }
+
+        AlignedBuffer(const AlignedBuffer&) = delete;
+        AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+        uint8_t* Data() const { return m_pData; }
+        size_t Size() const { return m_size; }
+        bool IsLocked() const { return m_bLocked; }
+
+        // Make at least `bytes` available; only reallocates when growing
+        bool Reserve(size_t bytes, bool bLock)
+        {
+            if (bytes <= m_capacity)
+            {
+                // Lock the existing pages in place, once
+                if (bLock && !m_bLockAttempted && m_pData)
+                {
+                    m_bLockAttempted = true;
+                    m_bLocked = Lock(m_pData, m_capacity);
+                }
+                m_size = std::max(m_size, bytes);
+                return true;
+            }
+
+            Free();
+            if (bytes == 0)
+                return true;
+
+            const size_t capacity = (bytes + Constants::MEMORY_PAGE_SIZE - 1) / Constants::MEMORY_PAGE_SIZE * Constants::MEMORY_PAGE_SIZE;
+
+#if defined(_WIN32)
+            void* p = VirtualAlloc(nullptr, capacity, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+            void* p = nullptr;
+            if (posix_memalign(&p, Constants::MEMORY_PAGE_SIZE, capacity) != 0)
+                p = nullptr;
+#endif
+            if (!p)
+                return false;
+
+            // Prefault every page now rather than on the first frame
+            memset(p, 0, capacity);
+
+            m_pData = static_cast<uint8_t*>(p);
+            m_size = bytes;
+            m_capacity = capacity;
+            m_bLockAttempted = bLock;
+            m_bLocked = bLock && Lock(p, capacity);
+            return true;
+        }
+
+        void Free()
+        {
+            if (!m_pData)
+                return;
+
+#if defined(_WIN32)
+            if (m_bLocked)
+                VirtualUnlock(m_pData, m_capacity);
+            VirtualFree(m_pData, 0, MEM_RELEASE);
+#else
+            if (m_bLocked)
+                munlock(m_pData, m_capacity);
+            free(m_pData);
+#endif
+            m_pData = nullptr;
+            m_size = 0;
+            m_capacity = 0;
+            m_bLocked = false;
+            m_bLockAttempted = false;
+        }
+
+    private:
+        static bool Lock(void* p, size_t bytes)
+        {
+#if defined(_WIN32)
+            if (VirtualLock(p, bytes))
+                return true;
+
+            // The default working set only allows a few hundred KB to be locked; grow it once
+            SIZE_T minimum = 0, maximum = 0;
+            HANDLE hProcess = GetCurrentProcess();
+            if (!GetProcessWorkingSetSize(hProcess, &minimum, &maximum) ||
+                !SetProcessWorkingSetSize(hProcess, minimum + bytes, std::max(maximum, minimum + bytes)))
+                return false;
+
+            return VirtualLock(p, bytes) != FALSE;
+#else
+            return mlock(p, bytes) == 0;
+#endif
+        }
+
+        uint8_t* m_pData;
+        size_t m_size;
+        size_t m_capacity;
+        bool m_bLocked;
+        bool m_bLockAttempted;      // Lock was tried for the current allocation
+    };
+}
@@ -0,0 +1,418 @@
+#pragma once
+
+#include "CvsBallVisionCore.h"
+#include "AlignedBuffer.h"
+#include "CameraBackend.h"
+#include <condition_variable>
+#include <cstring>
+
+namespace CvsBallVision
+{
+    class BurstCapture::Impl
+    {
+    public:
+        AlignedBuffer arena;            // frameCount * bytesPerFrame, frames back to back
+        std::vector<ImageData> frames;
+        std::string pixelFormat;
+        uint64_t framesMissed = 0;
+        size_t eventIndex = 0;
+        std::shared_ptr<AlignedBuffer> ring;    // Look-back: the frozen ring the frames point into
+    };
+
+    // Raw copy of a driver frame into recorder memory, with the sensor origin of its window.
+    // False if it does not fit (resolution changed).
+    inline bool CopyRawFrame(const CVS_BUFFER& buffer, int64_t receivedNs, int offsetX, int offsetY,
+        const ImageProcessing::RawFormat& format, uint8_t* pDst, size_t capacity, ImageData& image)
+    {
+        const int channels = buffer.image.channels > 0 ? buffer.image.channels : 1;
+        const int rowBytes = GetBufferRowBytes(buffer, format);
+        const int srcStep = buffer.image.step >= rowBytes ? buffer.image.step : rowBytes;
+        const int height = buffer.image.height;
+        if (static_cast<size_t>(rowBytes) * height > capacity)
+            return false;
+
+        const uint8_t* pSrc = static_cast<const uint8_t*>(buffer.image.pImage);
+        if (srcStep == rowBytes)
+        {
+            memcpy(pDst, pSrc, static_cast<size_t>(rowBytes) * height);
+        }
+        else
+        {
+            for (int y = 0; y < height; ++y)
+            {
+                memcpy(pDst + static_cast<size_t>(y) * rowBytes, pSrc + static_cast<size_t>(y) * srcStep, rowBytes);
+            }
+        }
+
+        image.pData = pDst;
+        image.width = buffer.image.width;
+        image.height = height;
+        image.channels = channels;
+        image.step = rowBytes;
+        image.blockID = buffer.blockID;
+        image.timestamp = buffer.timestamp;
+        image.timings.receivedNs = receivedNs;
+        image.layout = channels > 1 || format.bitDepth == 8 ? PixelLayout::Mono8 :
+            (format.bPacked ? PixelLayout::RawPacked : PixelLayout::Mono16);
+        image.bottomUp = false;
+        image.bitDepth = channels > 1 ? 8 : format.bitDepth;
+        image.offsetX = offsetX;
+        image.offsetY = offsetY;
+        return true;
+    }
+
+    // Records the next N raw frames into a burst arena allocated (and prefaulted) when armed.
+    //
+    // The frame path only pays for an atomic load while nothing is armed. Armed, each frame
+    // costs one copy into the arena under an uncontended mutex, so the burst keeps up with
+    // the sensor regardless of what the pipeline is doing.
+    class BurstRecorder
+    {
+    public:
+        BurstRecorder()
+            : m_bArmed(false)
+            , m_rawFormat({ 8, false })
+            , m_bytesPerFrame(0)
+            , m_next(0)
+            , m_lastBlockID(0)
+        {
+        }
+
+        // Control path: allocates the whole burst up front
+        bool Arm(size_t frameCount, size_t bytesPerFrame, const std::string& pixelFormat, bool bLockMemory)
+        {
+            Cancel();
+
+            std::shared_ptr<BurstCapture> burst(new BurstCapture());
+            BurstCapture::Impl& impl = *burst->m_pImpl;
+            if (!impl.arena.Reserve(frameCount * bytesPerFrame, bLockMemory))
+                return false;
+
+            ImageData empty;
+            memset(&empty, 0, sizeof(empty));
+            impl.frames.assign(frameCount, empty);
+            impl.pixelFormat = pixelFormat;
+
+            ImageProcessing::RawFormat rawFormat = { 8, false };
+            ImageProcessing::ParseRawFormat(pixelFormat, rawFormat);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pRecording = burst;
+            m_rawFormat = rawFormat;
+            m_pCompleted.reset();
+            m_bytesPerFrame = bytesPerFrame;
+            m_next = 0;
+            m_lastBlockID = 0;
+            m_bArmed.store(true, std::memory_order_release);
+            return true;
+        }
+
+        void Cancel()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bArmed.store(false, std::memory_order_release);
+            m_pRecording.reset();
+            m_cvDone.notify_all();
+        }
+
+        bool IsArmed() const
+        {
+            return m_bArmed.load(std::memory_order_acquire);
+        }
+
+        // Frame path. Returns true when the frame was taken by the burst; completed is set
+        // once the last frame is in. offsetX / offsetY: hardware window the frame was exposed with.
+        // A frame that no longer fits the arena ends the burst (bAborted, Wait returns nullptr)
+        // and is left to the normal path.
+        bool Record(const CVS_BUFFER& buffer, int64_t receivedNs, int offsetX, int offsetY,
+            std::shared_ptr<BurstCapture>& completed, bool& bAborted)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_pRecording)
+                return false;
+
+            BurstCapture::Impl& impl = *m_pRecording->m_pImpl;
+
+            if (m_lastBlockID != 0 && buffer.blockID > m_lastBlockID + 1)
+            {
+                impl.framesMissed += buffer.blockID - m_lastBlockID - 1;
+            }
+            m_lastBlockID = buffer.blockID;
+
+            ImageData& image = impl.frames[m_next];
+            if (!CopyRawFrame(buffer, receivedNs, offsetX, offsetY, m_rawFormat,
+                impl.arena.Data() + m_next * m_bytesPerFrame, m_bytesPerFrame, image))
+            {
+                // Resolution changed since arming: the rest of the burst cannot be recorded either
+                m_bArmed.store(false, std::memory_order_release);
+                m_pRecording.reset();
+                m_cvDone.notify_all();
+                bAborted = true;
+                return false;
+            }
+            image.sequence = m_next;
+
+            if (++m_next == impl.frames.size())
+            {
+                m_bArmed.store(false, std::memory_order_release);
+                completed = std::move(m_pRecording);
+                m_pCompleted = completed;
+                m_cvDone.notify_all();
+            }
+            return true;
+        }
+
+        // Takes the completed burst; nullptr on timeout or when the burst was cancelled
+        std::shared_ptr<BurstCapture> Wait(uint32_t timeoutMs)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cvDone.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                [this] { return m_pCompleted || !m_pRecording; });
+
+            std::shared_ptr<BurstCapture> burst;
+            burst.swap(m_pCompleted);
+            return burst;
+        }
+
+    private:
+        std::atomic<bool> m_bArmed;
+        std::mutex m_mutex;
+        std::condition_variable m_cvDone;
+        std::shared_ptr<BurstCapture> m_pRecording;
+        std::shared_ptr<BurstCapture> m_pCompleted;
+        ImageProcessing::RawFormat m_rawFormat;
+        size_t m_bytesPerFrame;
+        size_t m_next;
+        uint64_t m_lastBlockID;
+    };
+
+    // Continuous look-back ring: the last N raw frames, overwritten oldest first.
+    //
+    // TriggerEvent marks the frame count at the moment of the event; once postEventFrames more
+    // have arrived the ring is frozen and handed out as a capture (no copy). While that capture
+    // is alive outside the recorder the ring is not written; recording restarts, empty, as soon
+    // as it is released. The recorder only keeps the capture for Wait until the controller has
+    // handed it to a callback (Handed). Acquisition itself is never touched.
+    class LookbackRecorder
+    {
+    public:
+        static constexpr uint64_t NO_EVENT = ~0ull;
+
+        LookbackRecorder()
+            : m_bEnabled(false)
+            , m_rawFormat({ 8, false })
+            , m_bytesPerFrame(0)
+            , m_postEventFrames(0)
+            , m_written(0)
+            , m_eventAt(NO_EVENT)
+            , m_lastBlockID(0)
+            , m_bFrozen(false)
+            , m_waiters(0)
+        {
+        }
+
+        // Control path: (re)allocates the ring when its geometry changes
+        bool Configure(size_t slotCount, size_t bytesPerFrame, size_t postEventFrames,
+            const std::string& pixelFormat, bool bLockMemory)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                // Same geometry: keep the ring (Reserve only locks it in place if that was never tried)
+                if (m_pArena && m_slots.size() == slotCount && m_bytesPerFrame == bytesPerFrame &&
+                    m_pArena->Reserve(slotCount * bytesPerFrame, bLockMemory))
+                {
+                    m_postEventFrames = postEventFrames;
+                    SetPixelFormat(pixelFormat);
+                    m_bEnabled.store(true, std::memory_order_release);
+                    return true;
+                }
+            }
+
+            Clear();
+
+            // Allocated outside the lock: a frozen capture may still own the previous ring
+            std::shared_ptr<AlignedBuffer> arena = std::make_shared<AlignedBuffer>();
+            if (!arena->Reserve(slotCount * bytesPerFrame, bLockMemory))
+                return false;
+
+            ImageData empty;
+            memset(&empty, 0, sizeof(empty));
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pArena = std::move(arena);
+            m_slots.assign(slotCount, empty);
+            m_gaps.assign(slotCount, 0);
+            m_bytesPerFrame = bytesPerFrame;
+            m_postEventFrames = postEventFrames;
+            SetPixelFormat(pixelFormat);
+            Restart();
+            m_bEnabled.store(true, std::memory_order_release);
+            return true;
+        }
+
+        // Releases the ring (a capture already handed out keeps its own reference)
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bEnabled.store(false, std::memory_order_release);
+            m_pArena.reset();
+            m_slots.clear();
+            m_gaps.clear();
+            m_pPending.reset();
+            Restart();
+            m_cvDone.notify_all();
+        }
+
+        bool IsEnabled() const
+        {
+            return m_bEnabled.load(std::memory_order_acquire);
+        }
+
+        size_t GetCapacity() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_slots.size();
+        }
+
+        // Control path. False when disabled, an event is already pending or the previous
+        // capture has not been released. With no post-event frames the capture completes here.
+        bool TriggerEvent(std::shared_ptr<BurstCapture>& completed)
+        {
+            // Shell allocated up front so completion on the frame path does not allocate
+            std::shared_ptr<BurstCapture> capture(new BurstCapture());
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_pArena || m_eventAt != NO_EVENT || m_bFrozen)
+                return false;
+
+            capture->m_pImpl->frames.reserve(m_slots.size());
+            capture->m_pImpl->pixelFormat = m_pixelFormat;
+            m_pPending = std::move(capture);
+            m_eventAt = m_written;
+
+            if (m_postEventFrames == 0)
+            {
+                completed = Freeze();
+            }
+            return true;
+        }
+
+        // The capture went to the look-back callback: unless someone is already blocked in Wait,
+        // drop the recorder's copy so the ring re-arms as soon as the callback lets go of it
+        void Handed(const std::shared_ptr<BurstCapture>& capture)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_waiters == 0 && m_pCompleted == capture)
+                m_pCompleted.reset();
+        }
+
+        // Frame path
+        void Record(const CVS_BUFFER& buffer, int64_t receivedNs, int offsetX, int offsetY,
+            std::shared_ptr<BurstCapture>& completed)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_pArena)
+                return;
+
+            if (m_bFrozen)
+            {
+                // Still owned by the capture that was handed out (or is waiting to be taken by Wait)
+                if (m_pArena.use_count() > 1)
+                    return;
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                Restart();
+            }
+
+            const size_t slot = static_cast<size_t>(m_written % m_slots.size());
+            if (!CopyRawFrame(buffer, receivedNs, offsetX, offsetY, m_rawFormat,
+                m_pArena->Data() + slot * m_bytesPerFrame, m_bytesPerFrame, m_slots[slot]))
+                return;
+
+            m_gaps[slot] = (m_lastBlockID != 0 && buffer.blockID > m_lastBlockID + 1) ?
+                buffer.blockID - m_lastBlockID - 1 : 0;
+            m_lastBlockID = buffer.blockID;
+            m_slots[slot].sequence = m_written;
+            ++m_written;
+
+            if (m_eventAt != NO_EVENT && m_written - m_eventAt >= m_postEventFrames)
+            {
+                completed = Freeze();
+            }
+        }
+
+        // Takes the completed capture; nullptr on timeout or when the ring was cleared
+        std::shared_ptr<BurstCapture> Wait(uint32_t timeoutMs)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            ++m_waiters;
+            m_cvDone.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                [this] { return m_pCompleted || !m_pArena; });
+            --m_waiters;
+
+            std::shared_ptr<BurstCapture> capture;
+            capture.swap(m_pCompleted);
+            return capture;
+        }
+
+    private:
+        // Caller holds m_mutex
+        void SetPixelFormat(const std::string& pixelFormat)
+        {
+            m_pixelFormat = pixelFormat;
+            m_rawFormat = { 8, false };
+            ImageProcessing::ParseRawFormat(pixelFormat, m_rawFormat);
+        }
+
+        void Restart()
+        {
+            m_written = 0;
+            m_eventAt = NO_EVENT;
+            m_lastBlockID = 0;
+            m_bFrozen = false;
+        }
+
+        // Caller holds m_mutex. Orders the ring oldest first into the pending capture.
+        std::shared_ptr<BurstCapture> Freeze()
+        {
+            std::shared_ptr<BurstCapture> capture = std::move(m_pPending);
+            BurstCapture::Impl& impl = *capture->m_pImpl;
+
+            const size_t count = static_cast<size_t>(std::min<uint64_t>(m_written, m_slots.size()));
+            const uint64_t first = m_written - count;
+            for (uint64_t i = first; i < m_written; ++i)
+            {
+                const size_t slot = static_cast<size_t>(i % m_slots.size());
+                impl.frames.push_back(m_slots[slot]);
+                if (i != first)
+                    impl.framesMissed += m_gaps[slot];
+            }
+            impl.eventIndex = static_cast<size_t>(std::max(m_eventAt, first) - first);
+            impl.ring = m_pArena;
+
+            m_eventAt = NO_EVENT;
+            m_bFrozen = true;
+            m_pCompleted = capture;
+            m_cvDone.notify_all();
+            return capture;
+        }
+
+        std::atomic<bool> m_bEnabled;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_cvDone;
+        std::shared_ptr<AlignedBuffer> m_pArena;
+        std::vector<ImageData> m_slots;
+        std::vector<uint64_t> m_gaps;       // blockIDs skipped before each slot's frame
+        std::string m_pixelFormat;
+        ImageProcessing::RawFormat m_rawFormat;
+        size_t m_bytesPerFrame;
+        size_t m_postEventFrames;
+        uint64_t m_written;                 // Frames recorded since the ring (re)started
+        uint64_t m_eventAt;                 // m_written when the event fired, or NO_EVENT
+        uint64_t m_lastBlockID;
+        bool m_bFrozen;
+        int m_waiters;                      // Threads blocked in Wait
+        std::shared_ptr<BurstCapture> m_pPending;
+        std::shared_ptr<BurstCapture> m_pCompleted;     // Kept for Wait until taken or Handed
+    };
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "CvsBallVisionCore.h"
+#include "ImageProcessing.h"
+#include <algorithm>
+#include <cstdint>
+
+#ifndef CVSBALLVISION_NO_CVSCAMCTRL
+#include "cvsCamCtrl.h"
+#else
+// Builds without the CREVIS SDK (e.g. Linux CI) only have the simulated backend.
+// These declarations mirror the subset of cvsCamCtrl.h the core depends on.
+typedef int32_t CVS_ERROR;
+
+enum
+{
+    MCAM_ERR_OK = 0,
+    MCAM_ERR_NO_DEVICE = -1006,
+    MCAM_ERR_TIMEOUT = -1011
+};
+
+enum
+{
+    EVENT_NEW_IMAGE = 0
+};
+
+enum
+{
+    CVP_BayerBG2RGB = 0,
+    CVP_BayerGB2RGB,
+    CVP_BayerRG2RGB,
+    CVP_BayerGR2RGB
+};
+
+struct _cvsImage
+{
+    void* pImage;
+    int32_t width;
+    int32_t height;
+    int32_t channels;
+    int32_t step;
+};
+
+struct _cvsBuffer
+{
+    _cvsImage image;
+    uint64_t blockID;
+    uint64_t timestamp;
+};
+#endif
+
+namespace CvsBallVision
+{
+    // Error codes raised by the software backends (kept outside the SDK's MCAM_ERR_* range)
+    namespace BackendError
+    {
+        constexpr CVS_ERROR GENERIC = static_cast<CVS_ERROR>(-10001);
+        constexpr CVS_ERROR NOT_INITIALIZED = static_cast<CVS_ERROR>(-10002);
+        constexpr CVS_ERROR INVALID_HANDLE = static_cast<CVS_ERROR>(-10003);
+        constexpr CVS_ERROR INVALID_PARAMETER = static_cast<CVS_ERROR>(-10004);
+        constexpr CVS_ERROR NODE_NOT_FOUND = static_cast<CVS_ERROR>(-10005);
+        constexpr CVS_ERROR ACCESS_DENIED = static_cast<CVS_ERROR>(-10006);
+        constexpr CVS_ERROR BUFFER_TOO_SMALL = static_cast<CVS_ERROR>(-10007);
+        constexpr CVS_ERROR TRANSFER_ERROR = static_cast<CVS_ERROR>(-10008);
+        constexpr CVS_ERROR FILE_IO = static_cast<CVS_ERROR>(-10009);
+    }
+
+    // Grab callback signature used by every backend (matches ST_RegisterGrabCallback)
+    typedef void(*GrabCallbackFunc)(int32_t, const CVS_BUFFER*, void*);
+
+    // Device backend interface.
+    // Mirrors the ST_* functions used by CameraController so the acquisition path
+    // can run against real hardware or a synthetic source without code changes.
+    class ICameraBackend
+    {
+    public:
+        virtual ~ICameraBackend() = default;
+
+        virtual const char* GetName() const = 0;
+
+        // System
+        virtual CVS_ERROR InitSystem() = 0;
+        virtual CVS_ERROR FreeSystem() = 0;
+        virtual CVS_ERROR UpdateDevice(uint32_t timeout) = 0;
+        virtual CVS_ERROR GetAvailableCameraNum(uint32_t* pCamNum) = 0;
+        virtual CVS_ERROR GetDeviceInfo(uint32_t enumIndex, CameraInfo& info) = 0;
+
+        // Device
+        virtual CVS_ERROR OpenDevice(uint32_t enumIndex, int32_t* phDevice) = 0;
+        virtual CVS_ERROR CloseDevice(int32_t hDevice) = 0;
+        virtual CVS_ERROR AcqStart(int32_t hDevice) = 0;
+        virtual CVS_ERROR AcqStop(int32_t hDevice) = 0;
+        virtual CVS_ERROR RegisterGrabCallback(int32_t hDevice, GrabCallbackFunc callback, void* pUserDefine) = 0;
+        virtual CVS_ERROR UnregisterGrabCallback(int32_t hDevice) = 0;
+
+        // Buffers and image processing
+        virtual CVS_ERROR InitBuffer(int32_t hDevice, CVS_BUFFER* pBuffer, int32_t channels = 1) = 0;
+        virtual CVS_ERROR FreeBuffer(CVS_BUFFER* pBuffer) = 0;
+        virtual CVS_ERROR GrabImage(int32_t hDevice, CVS_BUFFER* pBuffer) = 0;
+        virtual CVS_ERROR CvtColor(const CVS_BUFFER& src, CVS_BUFFER* pDst, int32_t code) = 0;
+
+        // GenICam register access
+        virtual CVS_ERROR GetIntReg(int32_t hDevice, const char* nodeName, int64_t* pValue) = 0;
+        virtual CVS_ERROR SetIntReg(int32_t hDevice, const char* nodeName, int64_t value) = 0;
+        virtual CVS_ERROR GetIntRegRange(int32_t hDevice, const char* nodeName, int64_t* pMin, int64_t* pMax, int64_t* pInc) = 0;
+        virtual CVS_ERROR GetFloatReg(int32_t hDevice, const char* nodeName, double* pValue) = 0;
+        virtual CVS_ERROR SetFloatReg(int32_t hDevice, const char* nodeName, double value) = 0;
+        virtual CVS_ERROR GetFloatRegRange(int32_t hDevice, const char* nodeName, double* pMin, double* pMax) = 0;
+        virtual CVS_ERROR GetEnumReg(int32_t hDevice, const char* nodeName, char* pValue, uint32_t* pSize) = 0;
+        virtual CVS_ERROR SetEnumReg(int32_t hDevice, const char* nodeName, const char* value) = 0;
+        virtual CVS_ERROR GetEnumEntrySize(int32_t hDevice, const char* nodeName, int32_t* pSize) = 0;
+        virtual CVS_ERROR GetEnumEntryValue(int32_t hDevice, const char* nodeName, int32_t index, char* pValue, uint32_t* pSize) = 0;
+        virtual CVS_ERROR SetBoolReg(int32_t hDevice, const char* nodeName, bool value) = 0;
+        virtual CVS_ERROR SetCmdReg(int32_t hDevice, const char* nodeName) = 0;
+
+        // Parameter persistence and diagnostics
+        virtual CVS_ERROR ExportJson(int32_t hDevice, const char* filePath) = 0;
+        virtual CVS_ERROR ImportJson(int32_t hDevice, const char* filePath) = 0;
+        virtual const char* GetLastErrorDescription(int32_t hDevice) = 0;
+    };
+
+    // Backend factories
+#ifndef CVSBALLVISION_NO_CVSCAMCTRL
+    std::unique_ptr<ICameraBackend> CreateCvsCamCtrlBackend();
+#endif
+    std::unique_ptr<ICameraBackend> CreateSimulatedBackend(const SimulatedCameraConfig& config);
+    std::unique_ptr<ICameraBackend> CreatePlaybackBackend(const PlaybackConfig& config);
+
+    // Portable Bayer demosaic (ImageProcessing engine) used where ST_CvtColor is unavailable
+    CVS_ERROR SoftwareCvtColor(const CVS_BUFFER& src, CVS_BUFFER* pDst, int32_t code);
+
+    // Bytes per row of a driver frame: single-channel rows follow the pixel format's sample layout
+    inline int GetBufferRowBytes(const CVS_BUFFER& buffer, const ImageProcessing::RawFormat& format)
+    {
+        if (buffer.image.channels > 1)
+            return buffer.image.width * buffer.image.channels;
+
+        return ImageProcessing::GetRawRowBytes(buffer.image.width, format);
+    }
+
+    // Narrows a driver frame to a window of itself without copying: the image pointer moves to the
+    // window and the stride stays the whole frame's. The window keeps its size where the frame allows
+    // and is moved inside it; offsets are rounded down to even columns / rows where the layout needs
+    // it (Bayer tiles, packed byte pairs). offsetX / offsetY receive the window's position.
+    inline void CropBuffer(CVS_BUFFER& buffer, const ImageProcessing::RawFormat& format, bool bBayer,
+        const RoiRect& roi, int& offsetX, int& offsetY)
+    {
+        const int rowBytes = GetBufferRowBytes(buffer, format);
+        const int step = buffer.image.step >= rowBytes ? buffer.image.step : rowBytes;
+        const int width = std::min(roi.width, buffer.image.width);
+        const int height = std::min(roi.height, buffer.image.height);
+
+        int x = std::max(0, std::min(roi.x, buffer.image.width - width));
+        int y = std::max(0, std::min(roi.y, buffer.image.height - height));
+        if (bBayer || format.bPacked)
+            x &= ~1;
+        if (bBayer)
+            y &= ~1;
+
+        const int skipBytes = buffer.image.channels > 1 ? x * buffer.image.channels : ImageProcessing::GetRawRowBytes(x, format);
+        buffer.image.pImage = static_cast<uint8_t*>(buffer.image.pImage) + static_cast<size_t>(y) * step + skipBytes;
+        buffer.image.width = width;
+        buffer.image.height = height;
+        buffer.image.step = step;
+        offsetX = x;
+        offsetY = y;
+    }
+}
@@ -0,0 +1,554 @@
+#include "CvsBallVisionCore.h"
+#include "LatencyHistogram.h"
+#include "ProcessingPipeline.h"
+#include <algorithm>
+#include <deque>
+#include <sstream>
+
+#ifdef max
+#undef max
+#endif
+
+#ifdef min
+#undef min
+#endif
+
+namespace CvsBallVision
+{
+    using namespace Constants;
+
+    class CameraGroup::Impl
+    {
+    public:
+        Impl()
+#ifndef CVSBALLVISION_NO_CVSCAMCTRL
+            : m_backendType(DeviceBackendType::CvsCamCtrl)
+#else
+            : m_backendType(DeviceBackendType::Simulated)
+#endif
+            , m_bInitialized(false)
+            , m_bAcquiring(false)
+            , m_nextSequence(0)
+            , m_setsDelivered(0)
+            , m_framesUnmatched(0)
+        {
+        }
+
+        // A frame waiting for its partners from the other cameras
+        struct PendingFrame
+        {
+            FrameRef frame;
+            int64_t key;            // Match key (timestamp, arrival time or relative blockID)
+            int64_t receivedNs;
+        };
+
+        struct Member
+        {
+            std::unique_ptr<CameraController> camera;
+            std::deque<PendingFrame> pending;
+            uint64_t firstBlockID;          // BlockID mode: key = blockID - firstBlockID
+            bool bFirstFrame;
+        };
+
+        DeviceBackendType m_backendType;
+        SimulatedCameraConfig m_simulatedConfig;
+        bool m_bInitialized;
+        std::unique_ptr<CameraController> m_pEnumerator;    // Owns the system; used for enumeration
+        std::vector<Member> m_members;
+        CameraGroupConfig m_config;
+        std::atomic<bool> m_bAcquiring;
+
+        // Matching state (pending queues, keys) and in-order delivery
+        std::mutex m_matchMutex;
+        std::mutex m_deliveryMutex;
+        uint64_t m_nextSequence;
+
+        std::mutex m_callbackMutex;
+        FrameSetCallback m_frameSetCallback;
+        ErrorCallback m_errorCallback;
+        StatusCallback m_statusCallback;
+
+        std::atomic<uint64_t> m_setsDelivered;
+        std::atomic<uint64_t> m_framesUnmatched;
+        LatencyHistogram m_spreadHistogram;
+        LatencyHistogram m_assemblyHistogram;
+        LatencyHistogram m_latencyHistogram;
+
+        std::unique_ptr<CameraController> CreateController();
+        void OnFrame(size_t index, const FrameRef& frame);
+        bool TakeMatchedSet(FrameSet& set, int64_t& firstReceivedNs);
+        void ClearPending();
+        void ReportError(int error, const std::string& context);
+        void ReportStatus(const std::string& status);
+    };
+
+    std::unique_ptr<CameraController> CameraGroup::Impl::CreateController()
+    {
+        auto camera = std::make_unique<CameraController>();
+        camera->SetDeviceBackend(m_backendType, m_simulatedConfig);
+        return camera;
+    }
+
+    void CameraGroup::Impl::OnFrame(size_t index, const FrameRef& frame)
+    {
+        if (!m_bAcquiring.load(std::memory_order_acquire) || !frame)
+            return;
+
+        const ImageData& image = frame.GetImageData();
+
+        FrameSet set;
+        int64_t firstReceivedNs = 0;
+        std::unique_lock<std::mutex> deliveryLock;
+        {
+            std::lock_guard<std::mutex> lock(m_matchMutex);
+            Member& member = m_members[index];
+
+            PendingFrame pending;
+            pending.frame = frame;
+            pending.receivedNs = image.timings.receivedNs;
+            switch (m_config.matchMode)
+            {
+            case FrameMatchMode::Timestamp:
+                pending.key = static_cast<int64_t>(image.timestamp);
+                break;
+            case FrameMatchMode::ArrivalTime:
+                pending.key = image.timings.receivedNs;
+                break;
+            default:
+                if (member.bFirstFrame)
+                {
+                    member.firstBlockID = image.blockID;
+                    member.bFirstFrame = false;
+                }
+                pending.key = static_cast<int64_t>(image.blockID - member.firstBlockID);
+                break;
+            }
+
+            // Bounded wait for partners: the oldest frame gives way
+            if (member.pending.size() >= m_config.maxPendingFrames)
+            {
+                member.pending.pop_front();
+                m_framesUnmatched++;
+            }
+            member.pending.push_back(std::move(pending));
+
+            if (!TakeMatchedSet(set, firstReceivedNs))
+                return;
+
+            // Hand over to delivery before the next set can be matched, so sets stay in order
+            deliveryLock = std::unique_lock<std::mutex>(m_deliveryMutex);
+        }
+
+        m_spreadHistogram.RecordNs(set.spreadNs);
+        m_assemblyHistogram.RecordNs(set.completedNs - firstReceivedNs);
+        m_setsDelivered++;
+
+        {
+            std::lock_guard<std::mutex> lock(m_callbackMutex);
+            if (m_frameSetCallback)
+            {
+                try
+                {
+                    m_frameSetCallback(set);
+                }
+                catch (...)
+                {
+                    // Ignore callback exceptions
+                }
+            }
+        }
+
+        m_latencyHistogram.RecordNs(ToSteadyNs(std::chrono::steady_clock::now()) - firstReceivedNs);
+    }
+
+    // Caller holds m_matchMutex
+    bool CameraGroup::Impl::TakeMatchedSet(FrameSet& set, int64_t& firstReceivedNs)
+    {
+        const int64_t toleranceNs = m_config.matchMode == FrameMatchMode::BlockID ? 0 :
+            static_cast<int64_t>(m_config.matchToleranceUs * 1000.0);
+
+        while (true)
+        {
+            // A set needs a frame from every camera
+            for (const Member& member : m_members)
+            {
+                if (member.pending.empty())
+                    return false;
+            }
+
+            size_t oldest = 0;
+            int64_t minKey = m_members[0].pending.front().key;
+            int64_t maxKey = minKey;
+            for (size_t i = 1; i < m_members.size(); ++i)
+            {
+                int64_t key = m_members[i].pending.front().key;
+                if (key < minKey)
+                {
+                    minKey = key;
+                    oldest = i;
+                }
+                maxKey = std::max(maxKey, key);
+            }
+
+            if (maxKey - minKey <= toleranceNs)
+                break;
+
+            // Every other camera is already past the oldest head: it has no partners
+            m_members[oldest].pending.pop_front();
+            m_framesUnmatched++;
+        }
+
+        set.sequence = m_nextSequence++;
+        set.spreadNs = 0;
+        set.completedNs = 0;
+        set.frames.clear();
+        set.frames.reserve(m_members.size());
+
+        int64_t minKey = INT64_MAX;
+        int64_t maxKey = INT64_MIN;
+        firstReceivedNs = INT64_MAX;
+        for (Member& member : m_members)
+        {
+            PendingFrame& head = member.pending.front();
+            minKey = std::min(minKey, head.key);
+            maxKey = std::max(maxKey, head.key);
+            firstReceivedNs = std::min(firstReceivedNs, head.receivedNs);
+            set.completedNs = std::max(set.completedNs, head.receivedNs);
+            set.frames.push_back(std::move(head.frame));
+            member.pending.pop_front();
+        }
+        set.spreadNs = maxKey - minKey;
+        return true;
+    }
+
+    void CameraGroup::Impl::ClearPending()
+    {
+        std::lock_guard<std::mutex> lock(m_matchMutex);
+        for (Member& member : m_members)
+        {
+            member.pending.clear();
+            member.bFirstFrame = true;
+            member.firstBlockID = 0;
+        }
+        m_nextSequence = 0;
+    }
+
+    void CameraGroup::Impl::ReportError(int error, const std::string& context)
+    {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        if (m_errorCallback)
+        {
+            try
+            {
+                m_errorCallback(error, context);
+            }
+            catch (...)
+            {
+                // Ignore callback exceptions
+            }
+        }
+    }
+
+    void CameraGroup::Impl::ReportStatus(const std::string& status)
+    {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        if (m_statusCallback)
+        {
+            try
+            {
+                m_statusCallback(status);
+            }
+            catch (...)
+            {
+                // Ignore callback exceptions
+            }
+        }
+    }
+
+    CameraGroup::CameraGroup()
+        : m_pImpl(std::make_unique<Impl>())
+    {
+    }
+
+    CameraGroup::~CameraGroup()
+    {
+        Disconnect();
+        if (m_pImpl->m_pEnumerator)
+        {
+            m_pImpl->m_pEnumerator->FreeSystem();
+        }
+    }
+
+    bool CameraGroup::SetDeviceBackend(DeviceBackendType type, const SimulatedCameraConfig& simulatedConfig)
+    {
+        if (m_pImpl->m_bInitialized)
+        {
+            m_pImpl->ReportError(-1, "Cannot change backend after initialization");
+            return false;
+        }
+
+        m_pImpl->m_backendType = type;
+        m_pImpl->m_simulatedConfig = simulatedConfig;
+        return true;
+    }
+
+    bool CameraGroup::Initialize(uint32_t timeout)
+    {
+        if (!m_pImpl->m_pEnumerator)
+        {
+            m_pImpl->m_pEnumerator = m_pImpl->CreateController();
+            m_pImpl->m_pEnumerator->RegisterErrorCallback([this](int error, const std::string& message) {
+                m_pImpl->ReportError(error, message);
+            });
+        }
+
+        if (!m_pImpl->m_pEnumerator->InitializeSystem() || !m_pImpl->m_pEnumerator->UpdateDeviceList(timeout))
+            return false;
+
+        m_pImpl->m_bInitialized = true;
+        return true;
+    }
+
+    std::vector<CameraInfo> CameraGroup::GetAvailableCameras()
+    {
+        if (!m_pImpl->m_pEnumerator)
+            return std::vector<CameraInfo>();
+
+        return m_pImpl->m_pEnumerator->GetAvailableCameras();
+    }
+
+    bool CameraGroup::Connect(const std::vector<uint32_t>& enumIndices)
+    {
+        if (!m_pImpl->m_bInitialized)
+        {
+            m_pImpl->ReportError(-1, "Camera group not initialized");
+            return false;
+        }
+
+        if (enumIndices.empty() || enumIndices.size() > CAMERA_GROUP_MAX_CAMERAS)
+        {
+            m_pImpl->ReportError(-1, "Invalid number of cameras");
+            return false;
+        }
+
+        Disconnect();
+
+        for (size_t index = 0; index < enumIndices.size(); ++index)
+        {
+            Impl::Member member;
+            member.camera = m_pImpl->CreateController();
+            member.firstBlockID = 0;
+            member.bFirstFrame = true;
+
+            std::string prefix;
+            {
+                std::stringstream ss;
+                ss << "Camera " << index << ": ";
+                prefix = ss.str();
+            }
+            member.camera->RegisterErrorCallback([this, prefix](int error, const std::string& message) {
+                m_pImpl->ReportError(error, prefix + message);
+            });
+            member.camera->RegisterStatusCallback([this, prefix](const std::string& status) {
+                m_pImpl->ReportStatus(prefix + status);
+            });
+            member.camera->RegisterFrameCallback([this, index](const FrameRef& frame) {
+                m_pImpl->OnFrame(index, frame);
+            });
+
+            // Each controller holds a reference on the SDK system and enumerates for itself
+            if (!member.camera->InitializeSystem() ||
+                !member.camera->UpdateDeviceList() ||
+                !member.camera->ConnectCamera(enumIndices[index]))
+            {
+                member.camera->FreeSystem();
+                Disconnect();
+                return false;
+            }
+
+            m_pImpl->m_members.push_back(std::move(member));
+        }
+
+        std::stringstream ss;
+        ss << "Camera group connected (" << enumIndices.size() << " cameras)";
+        m_pImpl->ReportStatus(ss.str());
+        return true;
+    }
+
+    void CameraGroup::Disconnect()
+    {
+        StopAcquisition();
+
+        for (auto& member : m_pImpl->m_members)
+        {
+            member.camera->DisconnectCamera();
+            member.camera->FreeSystem();
+        }
+        m_pImpl->m_members.clear();
+    }
+
+    bool CameraGroup::IsConnected() const
+    {
+        return !m_pImpl->m_members.empty();
+    }
+
+    size_t CameraGroup::GetCameraCount() const
+    {
+        return m_pImpl->m_members.size();
+    }
+
+    CameraController* CameraGroup::GetCamera(size_t index)
+    {
+        if (index >= m_pImpl->m_members.size())
+            return nullptr;
+
+        return m_pImpl->m_members[index].camera.get();
+    }
+
+    bool CameraGroup::SetConfig(const CameraGroupConfig& config)
+    {
+        if (config.matchToleranceUs < 0.0 || config.maxPendingFrames < 1 ||
+            config.maxPendingFrames > FRAME_RING_MAX_SIZE - FRAME_RING_SIZE)
+        {
+            m_pImpl->ReportError(-1, "Invalid camera group configuration");
+            return false;
+        }
+
+        if (m_pImpl->m_bAcquiring)
+        {
+            m_pImpl->ReportError(-1, "Cannot change camera group configuration during acquisition");
+            return false;
+        }
+
+        m_pImpl->m_config = config;
+        return true;
+    }
+
+    CameraGroupConfig CameraGroup::GetConfig() const
+    {
+        return m_pImpl->m_config;
+    }
+
+    bool CameraGroup::StartAcquisition()
+    {
+        if (m_pImpl->m_members.empty())
+        {
+            m_pImpl->ReportError(-1, "No cameras connected");
+            return false;
+        }
+
+        if (m_pImpl->m_bAcquiring)
+            return true;
+
+        m_pImpl->ClearPending();
+        m_pImpl->m_bAcquiring.store(true, std::memory_order_release);
+
+        for (size_t index = 0; index < m_pImpl->m_members.size(); ++index)
+        {
+            CameraController& camera = *m_pImpl->m_members[index].camera;
+
+            // Frames waiting for partners stay pinned in each camera's ring
+            size_t ringSize = FRAME_RING_SIZE + m_pImpl->m_config.maxPendingFrames;
+            if (camera.GetFrameRingSize() < ringSize)
+            {
+                camera.SetFrameRingSize(ringSize);
+            }
+
+            if (!camera.StartAcquisition())
+            {
+                for (size_t started = 0; started < index; ++started)
+                {
+                    m_pImpl->m_members[started].camera->StopAcquisition();
+                }
+                m_pImpl->m_bAcquiring.store(false, std::memory_order_release);
+                m_pImpl->ClearPending();
+                return false;
+            }
+        }
+
+        ResetStatistics();
+        m_pImpl->ReportStatus("Camera group acquisition started");
+        return true;
+    }
+
+    bool CameraGroup::StopAcquisition()
+    {
+        if (!m_pImpl->m_bAcquiring)
+            return true;
+
+        m_pImpl->m_bAcquiring.store(false, std::memory_order_release);
+
+        bool bOk = true;
+        for (auto& member : m_pImpl->m_members)
+        {
+            bOk = member.camera->StopAcquisition() && bOk;
+        }
+
+        // Unpin frames that never found partners
+        m_pImpl->ClearPending();
+        m_pImpl->ReportStatus("Camera group acquisition stopped");
+        return bOk;
+    }
+
+    bool CameraGroup::IsAcquiring() const
+    {
+        return m_pImpl->m_bAcquiring;
+    }
+
+    bool CameraGroup::ExecuteSoftwareTrigger()
+    {
+        bool bOk = !m_pImpl->m_members.empty();
+        for (auto& member : m_pImpl->m_members)
+        {
+            bOk = member.camera->ExecuteSoftwareTrigger() && bOk;
+        }
+        return bOk;
+    }
+
+    void CameraGroup::RegisterFrameSetCallback(FrameSetCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(m_pImpl->m_callbackMutex);
+        m_pImpl->m_frameSetCallback = callback;
+    }
+
+    void CameraGroup::RegisterErrorCallback(ErrorCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(m_pImpl->m_callbackMutex);
+        m_pImpl->m_errorCallback = callback;
+    }
+
+    void CameraGroup::RegisterStatusCallback(StatusCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(m_pImpl->m_callbackMutex);
+        m_pImpl->m_statusCallback = callback;
+    }
+
+    void CameraGroup::GetStatistics(CameraGroupStatistics& stats)
+    {
+        stats.setsDelivered = m_pImpl->m_setsDelivered;
+        stats.framesUnmatched = m_pImpl->m_framesUnmatched;
+        m_pImpl->m_spreadHistogram.GetStatistics(stats.setSpread);
+        m_pImpl->m_assemblyHistogram.GetStatistics(stats.setAssembly);
+        m_pImpl->m_latencyHistogram.GetStatistics(stats.setLatency);
+
+        stats.cameras.resize(m_pImpl->m_members.size());
+        for (size_t index = 0; index < m_pImpl->m_members.size(); ++index)
+        {
+            m_pImpl->m_members[index].camera->GetInstrumentation(stats.cameras[index]);
+        }
+    }
+
+    void CameraGroup::ResetStatistics()
+    {
+        m_pImpl->m_setsDelivered = 0;
+        m_pImpl->m_framesUnmatched = 0;
+        m_pImpl->m_spreadHistogram.Reset();
+        m_pImpl->m_assemblyHistogram.Reset();
+        m_pImpl->m_latencyHistogram.Reset();
+
+        for (auto& member : m_pImpl->m_members)
+        {
+            member.camera->ResetInstrumentation();
+        }
+    }
+}
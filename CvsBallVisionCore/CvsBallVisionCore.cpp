@@ -1,13 +1,26 @@
 #include "CvsBallVisionCore.h"
-#include "cvsCamCtrl.h"
+#include "BurstRecorder.h"
+#include "CameraBackend.h"
+#include "DeviceState.h"
+#include "FrameRecorder.h"
+#include "FrameRing.h"
+#include "ImageProcessing.h"
+#include "LatencyHistogram.h"
+#include "ProcessingPipeline.h"
+#include "RcuPointer.h"
 #include <thread>
 #include <chrono>
 #include <algorithm>
 #include <sstream>
 #include <condition_variable>
 #include <cmath>
+#include <cstring>
+#include <unordered_map>
 
-#pragma comment(lib, "cvsCamCtrl.lib")
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #ifdef max
 #undef max
@@ -21,30 +34,33 @@ namespace CvsBallVision
 {
     using namespace Constants;
 
-    // Forward declaration for callback type
-    typedef void(*GrabCallbackFunc)(int32_t, const CVS_BUFFER*, void*);
-
     // RAII helper class for acquisition state management
     class AcquisitionGuard
     {
     private:
+        ICameraBackend* m_pBackend;
         int32_t m_hDevice;
+        std::atomic<bool>* m_pAcquiringFlag;
         bool m_wasAcquiring;
         bool m_shouldRestart;
-        std::atomic<bool>* m_pAcquiringFlag;
+        std::function<void()> m_onRestart;
 
     public:
-        AcquisitionGuard(int32_t hDevice, std::atomic<bool>* pAcquiringFlag)
-            : m_hDevice(hDevice)
+        AcquisitionGuard(ICameraBackend* pBackend, int32_t hDevice, std::atomic<bool>* pAcquiringFlag,
+            std::function<void()> onRestart = nullptr)
+            : m_pBackend(pBackend)
+            , m_hDevice(hDevice)
             , m_pAcquiringFlag(pAcquiringFlag)
             , m_wasAcquiring(pAcquiringFlag->load())
             , m_shouldRestart(m_wasAcquiring)
+            , m_onRestart(std::move(onRestart))
         {
+            // AcqStop returns once the SDK has stopped streaming; callers then wait for
+            // in-flight callbacks (Impl::WaitForCallbacksIdle) instead of sleeping
             if (m_wasAcquiring)
             {
                 *m_pAcquiringFlag = false;
-                ST_AcqStop(m_hDevice);
-                std::this_thread::sleep_for(std::chrono::milliseconds(HARDWARE_PREP_TIME_MS));
+                m_pBackend->AcqStop(m_hDevice);
             }
         }
 
@@ -52,8 +68,11 @@ namespace CvsBallVision
         {
             if (m_shouldRestart && m_wasAcquiring)
             {
-                ST_AcqStart(m_hDevice);
+                m_pBackend->AcqStart(m_hDevice);
                 *m_pAcquiringFlag = true;
+
+                if (m_onRestart)
+                    m_onRestart();
             }
         }
 
@@ -65,16 +84,19 @@ namespace CvsBallVision
     class CallbackGuard
     {
     private:
+        ICameraBackend* m_pBackend;
         int32_t m_hDevice;
+        std::atomic<bool>* m_pCallbackFlag;
         bool m_wasRegistered;
         bool m_shouldReregister;
         GrabCallbackFunc m_callback;
         void* m_pUserData;
-        std::atomic<bool>* m_pCallbackFlag;
 
     public:
-        CallbackGuard(int32_t hDevice, std::atomic<bool>* pCallbackFlag, GrabCallbackFunc callback, void* pUserData)
-            : m_hDevice(hDevice)
+        CallbackGuard(ICameraBackend* pBackend, int32_t hDevice, std::atomic<bool>* pCallbackFlag,
+            GrabCallbackFunc callback, void* pUserData)
+            : m_pBackend(pBackend)
+            , m_hDevice(hDevice)
             , m_pCallbackFlag(pCallbackFlag)
             , m_wasRegistered(pCallbackFlag->load())
             , m_shouldReregister(m_wasRegistered)
@@ -84,8 +106,7 @@ namespace CvsBallVision
             if (m_wasRegistered)
             {
                 *m_pCallbackFlag = false;
-                ST_UnregisterGrabCallback(m_hDevice, EVENT_NEW_IMAGE);
-                std::this_thread::sleep_for(std::chrono::milliseconds(RESOLUTION_CHANGE_DELAY_MS));
+                m_pBackend->UnregisterGrabCallback(m_hDevice);
             }
         }
 
@@ -93,7 +114,7 @@ namespace CvsBallVision
         {
             if (m_shouldReregister && m_wasRegistered && m_callback)
             {
-                ST_RegisterGrabCallback(m_hDevice, EVENT_NEW_IMAGE, m_callback, m_pUserData);
+                m_pBackend->RegisterGrabCallback(m_hDevice, m_callback, m_pUserData);
                 *m_pCallbackFlag = true;
             }
         }
@@ -106,19 +127,28 @@ namespace CvsBallVision
     class ResolutionTransaction
     {
     private:
+        ICameraBackend* m_pBackend;
         int32_t m_hDevice;
         int m_oldWidth;
         int m_oldHeight;
+        int m_oldOffsetX;
+        int m_oldOffsetY;
         bool m_committed;
         bool m_needsRollback;
+        std::function<void()> m_onRollback;
 
     public:
-        ResolutionTransaction(int32_t hDevice, int oldWidth, int oldHeight)
-            : m_hDevice(hDevice)
+        ResolutionTransaction(ICameraBackend* pBackend, int32_t hDevice, int oldWidth, int oldHeight,
+            int oldOffsetX, int oldOffsetY, std::function<void()> onRollback = nullptr)
+            : m_pBackend(pBackend)
+            , m_hDevice(hDevice)
             , m_oldWidth(oldWidth)
             , m_oldHeight(oldHeight)
+            , m_oldOffsetX(oldOffsetX)
+            , m_oldOffsetY(oldOffsetY)
             , m_committed(false)
             , m_needsRollback(false)
+            , m_onRollback(std::move(onRollback))
         {
         }
 
@@ -127,8 +157,18 @@ namespace CvsBallVision
             if (!m_committed && m_needsRollback)
             {
                 // Rollback resolution changes
-                ST_SetIntReg(m_hDevice, "Width", m_oldWidth);
-                ST_SetIntReg(m_hDevice, "Height", m_oldHeight);
+                m_pBackend->SetIntReg(m_hDevice, "Width", m_oldWidth);
+                m_pBackend->SetIntReg(m_hDevice, "Height", m_oldHeight);
+
+                // The old size fits the old window again; undo any slide towards the origin
+                if (m_oldOffsetX != 0 || m_oldOffsetY != 0)
+                {
+                    m_pBackend->SetIntReg(m_hDevice, "OffsetX", m_oldOffsetX);
+                    m_pBackend->SetIntReg(m_hDevice, "OffsetY", m_oldOffsetY);
+                }
+
+                if (m_onRollback)
+                    m_onRollback();
             }
         }
 
@@ -138,32 +178,46 @@ namespace CvsBallVision
         int GetOldHeight() const { return m_oldHeight; }
     };
 
-    // Optimized image buffer pool for zero-copy and real-time performance
+    // Driver buffers for the pull (GrabImage) path.
+    // Free buffers sit on an index stack, so Get/Release are O(1) and the most recently
+    // returned (cache-warm) buffer is reused first. The pool grows on demand up to its
+    // limit and is sized / trimmed to the target depth between acquisitions.
     class ImageBufferPool
     {
     private:
         struct BufferInfo
         {
             CVS_BUFFER buffer;
-            std::atomic<bool> inUse;
-            uint64_t lastUsed;
-
-            BufferInfo() : inUse(false), lastUsed(0)
-            {
-                memset(&buffer, 0, sizeof(CVS_BUFFER));
-            }
+            uint32_t index;
+            bool bInUse;
+            int64_t acquiredNs;
         };
 
         std::vector<std::unique_ptr<BufferInfo>> m_buffers;
+        std::unordered_map<const CVS_BUFFER*, uint32_t> m_bufferIndex;     // Driver buffer -> m_buffers index
+        std::vector<uint32_t> m_freeList;
         std::mutex m_poolMutex;
+        std::condition_variable m_cvReturned;
+        ICameraBackend* m_pBackend;
         int32_t m_hDevice;
+        size_t m_targetDepth;
         size_t m_maxBuffers;
+        size_t m_inUse;
+        size_t m_highWater;
+        uint64_t m_exhausted;
+        LatencyHistogram m_holdHistogram;      // GetBuffer -> ReleaseBuffer
         std::atomic<bool> m_shuttingDown;
 
     public:
-        ImageBufferPool(int32_t hDevice, size_t maxBuffers = BUFFER_POOL_SIZE)
-            : m_hDevice(hDevice)
+        ImageBufferPool(ICameraBackend* pBackend, int32_t hDevice,
+            size_t targetDepth = BUFFER_POOL_SIZE, size_t maxBuffers = BUFFER_POOL_GROWTH_MAX)
+            : m_pBackend(pBackend)
+            , m_hDevice(hDevice)
+            , m_targetDepth(std::min(targetDepth, maxBuffers))
             , m_maxBuffers(maxBuffers)
+            , m_inUse(0)
+            , m_highWater(0)
+            , m_exhausted(0)
             , m_shuttingDown(false)
         {
             // Pre-allocate buffers for better real-time performance
@@ -181,16 +235,14 @@ namespace CvsBallVision
         {
             std::lock_guard<std::mutex> lock(m_poolMutex);
             m_buffers.reserve(m_maxBuffers);
+            m_freeList.reserve(m_maxBuffers);
+            m_bufferIndex.reserve(m_maxBuffers);
 
-            // Pre-create initial buffers
-            for (size_t i = 0; i < 2 && i < m_maxBuffers; ++i)
+            while (m_buffers.size() < m_targetDepth)
             {
-                auto bufInfo = std::make_unique<BufferInfo>();
-                CVS_ERROR status = ST_InitBuffer(m_hDevice, &bufInfo->buffer);
-                if (status == MCAM_ERR_OK)
-                {
-                    m_buffers.push_back(std::move(bufInfo));
-                }
+                if (!AddBuffer())
+                    break;
+                m_freeList.push_back(static_cast<uint32_t>(m_buffers.size() - 1));
             }
         }
 
@@ -199,90 +251,138 @@ namespace CvsBallVision
             if (m_shuttingDown)
                 return nullptr;
 
-            // Try to get buffer without locking first (lock-free fast path)
-            for (auto& bufInfo : m_buffers)
-            {
-                bool expected = false;
-                if (bufInfo->inUse.compare_exchange_strong(expected, true,
-                    std::memory_order_acquire, std::memory_order_relaxed))
-                {
-                    return &bufInfo->buffer;
-                }
-            }
-
-            // Need to create new buffer
             std::lock_guard<std::mutex> lock(m_poolMutex);
 
-            // Double-check after acquiring lock
-            for (auto& bufInfo : m_buffers)
+            uint32_t index;
+            if (!m_freeList.empty())
             {
-                bool expected = false;
-                if (bufInfo->inUse.compare_exchange_strong(expected, true,
-                    std::memory_order_acquire, std::memory_order_relaxed))
-                {
-                    return &bufInfo->buffer;
-                }
+                index = m_freeList.back();
+                m_freeList.pop_back();
             }
-
-            // Create new buffer if under limit
-            if (m_buffers.size() < m_maxBuffers && !m_shuttingDown)
+            else if (m_buffers.size() < m_maxBuffers && AddBuffer())
             {
-                auto bufInfo = std::make_unique<BufferInfo>();
-                CVS_ERROR status = ST_InitBuffer(m_hDevice, &bufInfo->buffer);
-                if (status == MCAM_ERR_OK)
-                {
-                    bufInfo->inUse = true;
-                    CVS_BUFFER* pBuffer = &bufInfo->buffer;
-                    m_buffers.push_back(std::move(bufInfo));
-                    return pBuffer;
-                }
+                // Grow on demand (consumers are slower than the target assumed)
+                index = static_cast<uint32_t>(m_buffers.size() - 1);
+            }
+            else
+            {
+                m_exhausted++;
+                return nullptr;
             }
 
-            return nullptr;
+            BufferInfo& info = *m_buffers[index];
+            info.bInUse = true;
+            info.acquiredNs = ToSteadyNs(std::chrono::steady_clock::now());
+            m_highWater = std::max(m_highWater, ++m_inUse);
+            return &info.buffer;
         }
 
-        void ReleaseBuffer(CVS_BUFFER* pBuffer)
+        // Blocks until a buffer is returned (or the timeout passes) when the pool is exhausted
+        CVS_BUFFER* WaitForBuffer(std::chrono::milliseconds timeout)
         {
-            if (!pBuffer) return;
+            CVS_BUFFER* pBuffer = GetBuffer();
+            if (pBuffer || m_shuttingDown)
+                return pBuffer;
 
-            for (auto& bufInfo : m_buffers)
             {
-                if (&bufInfo->buffer == pBuffer)
-                {
-                    bufInfo->inUse.store(false, std::memory_order_release);
-                    bufInfo->lastUsed = std::chrono::steady_clock::now().time_since_epoch().count();
-                    break;
-                }
+                std::unique_lock<std::mutex> lock(m_poolMutex);
+                m_cvReturned.wait_for(lock, timeout, [this] { return !m_freeList.empty() || m_shuttingDown; });
             }
+            return GetBuffer();
+        }
+
+        void ReleaseBuffer(CVS_BUFFER* pBuffer)
+        {
+            if (!pBuffer) return;
+
+            int64_t nowNs = ToSteadyNs(std::chrono::steady_clock::now());
+
+            std::lock_guard<std::mutex> lock(m_poolMutex);
+
+            // Only buffers this pool handed out are accepted; anything else is never dereferenced
+            auto it = m_bufferIndex.find(pBuffer);
+            if (it == m_bufferIndex.end())
+                return;
+
+            BufferInfo* pInfo = m_buffers[it->second].get();
+            if (!pInfo->bInUse)
+                return;
+
+            pInfo->bInUse = false;
+            m_holdHistogram.RecordNs(nowNs - pInfo->acquiredNs);
+            m_freeList.push_back(pInfo->index);
+            --m_inUse;
+            m_cvReturned.notify_all();
         }
 
+        // Force every buffer back to free (acquisition stopped, nothing holds them)
         void ResetBuffers()
         {
-            for (auto& bufInfo : m_buffers)
+            std::lock_guard<std::mutex> lock(m_poolMutex);
+            m_freeList.clear();
+            for (size_t i = m_buffers.size(); i-- > 0;)
             {
-                bufInfo->inUse.store(false, std::memory_order_release);
-                bufInfo->lastUsed = 0;
+                m_buffers[i]->bInUse = false;
+                m_freeList.push_back(static_cast<uint32_t>(i));
             }
+            m_inUse = 0;
+            m_cvReturned.notify_all();
         }
 
-        void WaitForAllBuffersReturned()
+        // Grow to / trim down to `depth` buffers. Trimming only happens while none is in use.
+        void SetTargetDepth(size_t depth)
         {
-            auto timeout = std::chrono::steady_clock::now() +
-                std::chrono::seconds(BUFFER_RETURN_TIMEOUT_SEC);
-            while (std::chrono::steady_clock::now() < timeout)
             {
-                bool allReturned = true;
-                for (auto& bufInfo : m_buffers)
+                std::lock_guard<std::mutex> lock(m_poolMutex);
+                m_targetDepth = std::min(std::max<size_t>(depth, 1), m_maxBuffers);
+
+                if (m_inUse == 0 && m_buffers.size() > m_targetDepth)
                 {
-                    if (bufInfo->inUse.load(std::memory_order_acquire))
+                    while (m_buffers.size() > m_targetDepth)
+                    {
+                        m_bufferIndex.erase(&m_buffers.back()->buffer);
+                        m_pBackend->FreeBuffer(&m_buffers.back()->buffer);
+                        m_buffers.pop_back();
+                    }
+
+                    m_freeList.clear();
+                    for (size_t i = m_buffers.size(); i-- > 0;)
                     {
-                        allReturned = false;
-                        break;
+                        m_freeList.push_back(static_cast<uint32_t>(i));
                     }
                 }
-                if (allReturned) break;
-                std::this_thread::sleep_for(std::chrono::milliseconds(BUFFER_WAIT_TIMEOUT_MS));
             }
+
+            PreallocateBuffers();
+        }
+
+        void ResetStatistics()
+        {
+            std::lock_guard<std::mutex> lock(m_poolMutex);
+            m_highWater = m_inUse;
+            m_exhausted = 0;
+            m_holdHistogram.Reset();
+        }
+
+        void GetStatistics(BufferPoolStatistics& stats)
+        {
+            std::lock_guard<std::mutex> lock(m_poolMutex);
+            stats.buffers = static_cast<uint32_t>(m_buffers.size());
+            stats.inUse = static_cast<uint32_t>(m_inUse);
+            stats.highWaterMark = static_cast<uint32_t>(m_highWater);
+            stats.exhausted = m_exhausted;
+        }
+
+        void GetHoldStatistics(LatencyStatistics& stats) const
+        {
+            m_holdHistogram.GetStatistics(stats);
+        }
+
+        void WaitForAllBuffersReturned()
+        {
+            std::unique_lock<std::mutex> lock(m_poolMutex);
+            m_cvReturned.wait_for(lock, std::chrono::seconds(BUFFER_RETURN_TIMEOUT_SEC),
+                [this] { return m_inUse == 0; });
         }
 
         void Clear()
@@ -290,19 +390,15 @@ namespace CvsBallVision
             std::lock_guard<std::mutex> lock(m_poolMutex);
             for (auto& bufInfo : m_buffers)
             {
-                // Wait for buffer to be released
-                int retries = BUFFER_RELEASE_MAX_RETRIES;
-                while (bufInfo->inUse.load(std::memory_order_acquire) && retries-- > 0)
-                {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(BUFFER_WAIT_RETRY_MS));
-                }
-
                 if (bufInfo->buffer.image.pImage)
                 {
-                    ST_FreeBuffer(&bufInfo->buffer);
+                    m_pBackend->FreeBuffer(&bufInfo->buffer);
                 }
             }
             m_buffers.clear();
+            m_bufferIndex.clear();
+            m_freeList.clear();
+            m_inUse = 0;
         }
 
         void Reinitialize()
@@ -312,8 +408,77 @@ namespace CvsBallVision
             Clear();
             PreallocateBuffers();
         }
+
+    private:
+        // Caller holds m_poolMutex
+        bool AddBuffer()
+        {
+            auto bufInfo = std::make_unique<BufferInfo>();
+            memset(&bufInfo->buffer, 0, sizeof(CVS_BUFFER));
+            bufInfo->index = static_cast<uint32_t>(m_buffers.size());
+            bufInfo->bInUse = false;
+            bufInfo->acquiredNs = 0;
+
+            if (m_pBackend->InitBuffer(m_hDevice, &bufInfo->buffer) != MCAM_ERR_OK)
+                return false;
+
+            m_bufferIndex[&bufInfo->buffer] = bufInfo->index;
+            m_buffers.push_back(std::move(bufInfo));
+            return true;
+        }
     };
 
+    static int GetLayoutBytesPerPixel(PixelLayout layout)
+    {
+        switch (layout)
+        {
+        case PixelLayout::RGB24:
+        case PixelLayout::BGR24: return 3;
+        case PixelLayout::BGRA32: return 4;
+        case PixelLayout::Mono16: return 2;
+        default: return 1;
+        }
+    }
+
+    static ImageProcessing::PackedFormat ToPackedFormat(PixelLayout layout)
+    {
+        switch (layout)
+        {
+        case PixelLayout::BGR24: return ImageProcessing::PackedFormat::BGR24;
+        case PixelLayout::BGRA32: return ImageProcessing::PackedFormat::BGRA32;
+        default: return ImageProcessing::PackedFormat::RGB24;
+        }
+    }
+
+    static bool IsValidOutputFormat(const OutputFormat& format)
+    {
+        const int alignment = format.rowAlignment;
+        return GetLayoutBytesPerPixel(format.layout) >= 3 &&
+            alignment >= 1 && alignment <= OUTPUT_ROW_ALIGNMENT_MAX && (alignment & (alignment - 1)) == 0;
+    }
+
+    static bool IsValidToneCurve(const ToneCurveConfig& config)
+    {
+        // Written so that NaN fails every range
+        if (!(config.blackLevel >= 0.0 && config.blackLevel < TONE_CURVE_MAX_VALUE) ||
+            !(config.contrast >= TONE_CONTRAST_MIN && config.contrast <= TONE_CONTRAST_MAX) ||
+            !(config.gamma >= GAMMA_MIN && config.gamma <= GAMMA_MAX))
+        {
+            return false;
+        }
+
+        if (config.customCurve.empty())
+            return true;
+
+        return config.customCurve.size() == static_cast<size_t>(TONE_CURVE_ENTRIES) &&
+            *std::max_element(config.customCurve.begin(), config.customCurve.end()) <= TONE_CURVE_MAX_VALUE;
+    }
+
+    static int AlignRowBytes(int rowBytes, int alignment)
+    {
+        return (rowBytes + alignment - 1) & ~(alignment - 1);
+    }
+
     // Implementation class
     class CameraController::Impl
     {
@@ -325,6 +490,8 @@ namespace CvsBallVision
         static void StaticGrabCallback(int32_t eventID, const CVS_BUFFER* pBuffer, void* pUserDefine);
 
         // Member variables
+        std::unique_ptr<ICameraBackend> m_pBackend;
+        DeviceBackendType m_backendType;
         int32_t m_hDevice;
         std::atomic<bool> m_bSystemInitialized;
         std::atomic<bool> m_bConnected;
@@ -332,102 +499,328 @@ namespace CvsBallVision
         std::atomic<bool> m_bCallbackRegistered;
         std::atomic<bool> m_bShuttingDown;
 
-        // Callback synchronization (improved)
+        // Acquisition state machine (m_bAcquiring gates frames; this tracks the transitions)
+        std::atomic<AcquisitionState> m_acquisitionState;
+        LatencyHistogram m_startHistogram;
+        LatencyHistogram m_firstFrameHistogram;
+        LatencyHistogram m_stopHistogram;
+        LatencyHistogram m_resumeHistogram;
+        std::atomic<int64_t> m_startRequestNs;     // Set by StartAcquisition, cleared by the first frame
+        std::atomic<int64_t> m_resumeRequestNs;    // Set by ResumeAcquisition, cleared by the first frame
+        std::atomic<uint64_t> m_drainTimeouts;
+        std::atomic<bool> m_bPaused;                // Frame gate, checked on arrival
+        PauseMode m_pauseMode;
+
+        // Callback synchronization: signalled when the last in-flight callback leaves
+        // while frames are no longer accepted
         std::atomic<int> m_activeCallbacks;
         std::condition_variable m_cvCallbackComplete;
+        uint64_t m_callbacksIdleEpoch;          // Times the count reached 0 with the gate closed (m_shutdownMutex)
         std::mutex m_shutdownMutex;
 
         // Optimized buffer management
         std::unique_ptr<ImageBufferPool> m_bufferPool;
-        CVS_BUFFER* m_pCurrentBuffer;
-        CVS_BUFFER m_rgbBuffer;
-        std::mutex m_imageMutex;
+        BufferPoolConfig m_bufferPoolConfig;
+        size_t m_bufferPoolDepth;               // Target depth chosen at the last start
+        double m_bufferPoolLatencyMs;           // Consumer latency that depth was computed from
         std::mutex m_callbackMutex;
 
+        // Frame ring (owned, pinned slots handed to consumers)
+        FrameRingPtr m_frameRing;
+        size_t m_frameRingSize;
+        FrameRef m_readerFrame;             // Frame pinned on behalf of GetLatestImage
+        std::mutex m_readerMutex;
+        std::atomic<uint64_t> m_lastBlockID;
+        std::atomic<uint64_t> m_framesDroppedDevice;
+        std::atomic<uint64_t> m_framesDroppedInvalid;
+
+        // Processing pipeline (capture -> debayer -> post-process -> fan-out)
+        PipelineConfig m_pipelineConfig;
+        std::atomic<bool> m_bPipelineRunning;
+        std::unique_ptr<RawFramePool> m_rawFramePool;
+        std::unique_ptr<BoundedQueue<PipelineFrame>> m_stageQueues[PIPELINE_STAGE_COUNT];  // Input queue per stage
+        std::vector<std::thread> m_pipelineThreads;
+        PipelineStageCounters m_stageCounters[PIPELINE_STAGE_COUNT];
+        LatencyCounter m_endToEndLatency;
+        std::atomic<DemosaicMethod> m_demosaicMethod;
+        OutputFormat m_outputFormat;        // Only changed while not acquiring
+
+        // Colour correction as configured, plus the Q10 matrix handed to the fused kernel
+        struct ColorCorrectionState
+        {
+            ColorCorrection config;
+            bool bActive;
+            int16_t matrix[9];
+        };
+        RcuPointer<ColorCorrectionState> m_colorCorrection;
+
+        // 10/12-bit handling as configured, plus the tone curve as a table
+        struct HighBitDepthState
+        {
+            HighBitDepthConfig config;
+            bool bLut;
+            ImageProcessing::Lut12To8 lut;
+        };
+        RcuPointer<HighBitDepthState> m_highBitDepth;
+
+        // Region of interest: the software crop is read per frame, hardware offsets move on the control path
+        struct HardwareRoiLimits
+        {
+            bool bValid;                // Ranges follow the window size; re-read after it changes
+            int64_t minX, maxX, incX;
+            int64_t minY, maxY, incY;
+        };
+        RcuPointer<RoiRect> m_softwareRoi;
+        HardwareRoiLimits m_roiLimits;
+        std::mutex m_roiMutex;              // Serialises offset writes and m_roiLimits
+        std::mutex m_roiSizeMutex;          // Held across window size changes so tracking moves never race them
+
+        // Window origin per frame: a move applies from the first blockID the camera can still expose
+        // with it; frames already under way keep the previous origin
+        struct RoiOrigin
+        {
+            uint64_t firstBlockID;
+            int x;
+            int y;
+        };
+        RoiOrigin m_roiHistory[TRACKING_ROI_HISTORY];  // Oldest first, never empty
+        size_t m_roiHistoryCount;
+        std::mutex m_roiHistoryMutex;
+        std::atomic<int> m_roiMoveLatency;  // Frames already exposing when offsets are written
+
+        // Tracking ROI: targets are handed to a thread that writes the offsets
+        struct TrackingRestore
+        {
+            int width;
+            int height;
+            int offsetX;
+            int offsetY;
+            bool bFrameRate;
+            double frameRate;
+        };
+        TrackingRoiConfig m_trackingConfig;
+        TrackingRestore m_trackingRestore;  // Window and frame rate from before tracking
+        std::thread m_trackingThread;
+        std::mutex m_trackingMutex;         // Target and m_bTrackingActive
+        std::condition_variable m_cvTracking;
+        bool m_bTrackingActive;
+        bool m_bTrackingTarget;             // Target not yet written
+        double m_trackingX;
+        double m_trackingY;
+        int64_t m_trackingTargetNs;
+        std::atomic<uint64_t> m_trackingTargets;
+        std::atomic<uint64_t> m_trackingCoalesced;
+        std::atomic<uint64_t> m_trackingMoves;
+        std::atomic<uint64_t> m_trackingUnchanged;
+        std::atomic<uint64_t> m_trackingFailures;
+        LatencyHistogram m_trackingHistogram;
+
         ImageCallback m_imageCallback;
+        FrameCallback m_frameCallback;
         ErrorCallback m_errorCallback;
         StatusCallback m_statusCallback;
+        BurstCallback m_burstCallback;
+        BurstCallback m_lookbackCallback;
 
+        // Burst capture (raw frames copied on arrival, ahead of the pipeline)
+        BurstRecorder m_burstRecorder;
+        std::atomic<bool> m_bBurstDeliverFrames;
+
+        // Look-back ring (every raw frame, frozen on an event)
+        LookbackConfig m_lookbackConfig;
+        LookbackRecorder m_lookbackRecorder;
+
+        // Raw recording to disk (copy on arrival, written by the recorder's own thread)
+        FrameRecorder m_frameRecorder;
+
+        // Pull delivery: the grab thread parks on m_cvGrab while the stream is stopped
+        GrabConfig m_grabConfig;            // Only changed while not acquiring
         std::thread m_grabThread;
         std::atomic<bool> m_bStopGrabThread;
+        std::atomic<bool> m_bStreamStopped;     // Paused with PauseMode::StopStream
+        std::mutex m_grabMutex;
+        std::condition_variable m_cvGrab;
+
+        std::atomic<uint64_t> m_frameCount;     // Frames published to consumers
+        std::atomic<uint64_t> m_errorCount;
 
-        uint64_t m_frameCount;
-        uint64_t m_errorCount;
+        // FPS is derived on read (GetStatistics), never on the frame path
+        std::mutex m_statisticsMutex;
         std::chrono::steady_clock::time_point m_lastFpsTime;
         uint64_t m_lastFrameCount;
         double m_currentFps;
 
-        int m_lastError;
+        // Hot-path instrumentation (lock-free writers, snapshot by GetInstrumentation)
+        LatencyHistogram m_grabWaitHistogram;
+        LatencyHistogram m_debayerHistogram;
+        LatencyHistogram m_gammaHistogram;
+        LatencyHistogram m_callbackHistogram;
+        LatencyHistogram m_endToEndHistogram;
+        std::atomic<uint64_t> m_framesReceived;
+        std::atomic<int64_t> m_lastGrabReturnNs;    // 0 = no frame yet
+        std::chrono::steady_clock::time_point m_instrumentationStart;
+        uint64_t m_instrumentationFrameBase;        // m_frameCount at the last reset
+        DropStatistics m_dropBase;                  // Drop counters at the last reset
 
-        // Current resolution cache
-        int m_currentWidth;
-        int m_currentHeight;
+        int m_lastError;
 
-        // Feature availability flags
-        bool m_bHasGain;
-        bool m_bHasExposure;
-        bool m_bHasFrameRate;
-        bool m_bHasGamma;
-        std::string m_gainNodeName;
-        std::string m_gammaNodeName;
+        // Pixel format, resolution, feature nodes and ranges (no register reads per frame)
+        DeviceStateCache m_deviceState;
 
         // Gamma control
         bool m_bSoftwareGammaEnabled;
         double m_currentGamma;
-        std::vector<uint8_t> m_gammaLUT;
-        std::mutex m_gammaLUTMutex;
 
-        // Zero-copy image data for callback
-        ImageData m_lastImageData;
+        // Tone curve and software gamma composed into one table per frame depth.
+        // Rebuilt whole on the control path (under m_toneMutex), read lock-free per frame.
+        struct ToneTables
+        {
+            ImageProcessing::Lut8 lut8;             // 8-bit frames
+            ImageProcessing::Lut12To8 lut12To8;     // 10/12-bit Convert8, applied while unpacking
+            ImageProcessing::Lut12 lut12;           // Mono16 frames; bIdentity = nothing to apply
+        };
+        RcuPointer<ToneTables> m_toneTables;
+        ToneCurveConfig m_toneCurve;
+        bool m_bHardwareLut;                        // Camera has LUTIndex / LUTValue
+        bool m_bHardwareLutActive;                  // m_toneCurve lives in the camera's LUT
+        std::vector<int64_t> m_hardwareLut;         // Entries last written to the camera (-1 = unknown)
+        mutable std::mutex m_toneMutex;
 
         // Methods
         void GrabThreadFunc();
+        bool ShouldGrab() const;
+        void WakeGrabThread();
+        void StopGrabThread();
+        void LeaveFrameCallback();
+        void DeliverBurst(const std::shared_ptr<BurstCapture>& burst, bool bLookback);
         void OnImageReceived(const CVS_BUFFER* pBuffer);
+        bool CaptureFrame(const CVS_BUFFER* pBuffer, PipelineFrame& frame);
+        bool ConvertFrame(PipelineFrame& frame);
+        bool PostProcessFrame(PipelineFrame& frame);
+        void DeliverFrame(PipelineFrame& frame);
+        void DiscardFrame(PipelineFrame& frame);
+        void EnqueueFrame(size_t stage, PipelineFrame& frame);
+        void PipelineWorker(size_t stage);
+        void RecordStageTime(size_t stage, std::chrono::steady_clock::duration elapsed);
+        void RecordGrabWait(int64_t arrivalNs);
+        void GetDropCounters(DropStatistics& drops);
+        void ResetInstrumentation();
+        bool StartAcquisition();
+        bool StopAcquisition();
+        bool PauseAcquisition(PauseMode mode);
+        bool ResumeAcquisition();
+        bool WaitForCallbacksIdle();
+        bool StartPipeline();
+        void StopPipeline();
+        size_t GetPipelineSlotCount() const;
+        void UpdateBufferPoolDepth();
+        bool PrepareLookback();
         void ReportError(int error, const std::string& context);
         void ReportStatus(const std::string& status);
-        bool IsColorCamera();
+        bool GetBayerPattern(ImageProcessing::BayerPattern& pattern) const;
         void DetectAvailableFeatures();
+        bool LoadDeviceState();
         bool CheckFeatureAvailable(const char* nodeName);
+        std::string FindFeatureNodeName(const char* const* nodeNames, size_t count);
         std::string FindGainNodeName();
-        std::string FindGammaNodeName();
         bool ReinitializeBuffers();
         bool SetResolutionOptimized(int width, int height);
-        bool ValidateBufferSize(const CVS_BUFFER* pSrc, const CVS_BUFFER* pDst);
+        void LoadHardwareROI();
+        void FitHardwareROI(int width, int height);
+        bool MoveHardwareROI(int offsetX, int offsetY);
+        void ResetRoiHistory(int offsetX, int offsetY);
+        void RecordRoiMove(int offsetX, int offsetY);
+        void GetRoiOrigin(uint64_t blockID, int& offsetX, int& offsetY);
+        bool SetTrackingROI(const TrackingRoiConfig& config);
+        bool RestoreTrackingWindow();
+        void StartTracking();
+        void StopTracking();
+        void TrackingThreadFunc();
+        bool PrepareFrameRing();
+        void ReleaseReaderFrame();
         void SafeShutdown();
         void UpdateGammaLUT(double gamma);
-        void ApplyGammaToImage(uint8_t* pData, int width, int height, int channels);
-        bool CheckGammaSupport();
+        void UpdateToneTables();
+        bool WriteHardwareLut(const ToneCurveConfig& config);
+        void DisableHardwareLut();
+        void ApplyToneToImage(ImageData& imageData);
+        std::string FindGammaNodeName();
+        bool GetFeatureRange(DeviceFeature feature, double& min, double& max);
+        bool GetFeatureValue(DeviceFeature feature, double& value);
+        CVS_ERROR SetFeatureValue(DeviceFeature feature, double value);
+        bool GetParameters(CameraParameters& params);
+        bool ApplyParameters(const CameraParameters& params);
     };
 
     CameraController::Impl::Impl()
-        : m_hDevice(-1)
+#ifndef CVSBALLVISION_NO_CVSCAMCTRL
+        : m_pBackend(CreateCvsCamCtrlBackend())
+        , m_backendType(DeviceBackendType::CvsCamCtrl)
+#else
+        : m_pBackend(CreateSimulatedBackend(SimulatedCameraConfig()))
+        , m_backendType(DeviceBackendType::Simulated)
+#endif
+        , m_hDevice(-1)
         , m_bSystemInitialized(false)
         , m_bConnected(false)
         , m_bAcquiring(false)
         , m_bCallbackRegistered(false)
         , m_bShuttingDown(false)
-        , m_bStopGrabThread(false)
+        , m_acquisitionState(AcquisitionState::Idle)
+        , m_startRequestNs(0)
+        , m_resumeRequestNs(0)
+        , m_drainTimeouts(0)
+        , m_bPaused(false)
+        , m_pauseMode(PauseMode::GateFrames)
         , m_activeCallbacks(0)
+        , m_callbacksIdleEpoch(0)
+        , m_bufferPoolDepth(BUFFER_POOL_SIZE)
+        , m_bufferPoolLatencyMs(0.0)
+        , m_frameRingSize(FRAME_RING_SIZE)
+        , m_lastBlockID(0)
+        , m_framesDroppedDevice(0)
+        , m_framesDroppedInvalid(0)
+        , m_bPipelineRunning(false)
+        , m_demosaicMethod(DemosaicMethod::Bilinear)
+        , m_colorCorrection(std::unique_ptr<ColorCorrectionState>(new ColorCorrectionState()))
+        , m_highBitDepth(std::unique_ptr<HighBitDepthState>(new HighBitDepthState()))
+        , m_softwareRoi(std::unique_ptr<RoiRect>(new RoiRect()))
+        , m_roiHistoryCount(1)
+        , m_roiMoveLatency(1)
+        , m_bTrackingActive(false)
+        , m_bTrackingTarget(false)
+        , m_trackingX(0.0)
+        , m_trackingY(0.0)
+        , m_trackingTargetNs(0)
+        , m_trackingTargets(0)
+        , m_trackingCoalesced(0)
+        , m_trackingMoves(0)
+        , m_trackingUnchanged(0)
+        , m_trackingFailures(0)
+        , m_bBurstDeliverFrames(false)
+        , m_bStopGrabThread(false)
+        , m_bStreamStopped(false)
         , m_frameCount(0)
         , m_errorCount(0)
         , m_lastFrameCount(0)
         , m_currentFps(0.0)
+        , m_framesReceived(0)
+        , m_lastGrabReturnNs(0)
+        , m_instrumentationFrameBase(0)
         , m_lastError(MCAM_ERR_OK)
-        , m_currentWidth(0)
-        , m_currentHeight(0)
-        , m_bHasGain(false)
-        , m_bHasExposure(false)
-        , m_bHasFrameRate(false)
-        , m_bHasGamma(false)
         , m_bSoftwareGammaEnabled(false)
         , m_currentGamma(DEFAULT_GAMMA)
-        , m_pCurrentBuffer(nullptr)
+        , m_bHardwareLut(false)
+        , m_bHardwareLutActive(false)
     {
-        memset(&m_rgbBuffer, 0, sizeof(m_rgbBuffer));
-        memset(&m_lastImageData, 0, sizeof(m_lastImageData));
         m_lastFpsTime = std::chrono::steady_clock::now();
+        m_instrumentationStart = m_lastFpsTime;
+        memset(&m_dropBase, 0, sizeof(m_dropBase));
+        memset(&m_roiLimits, 0, sizeof(m_roiLimits));
+        memset(&m_roiHistory, 0, sizeof(m_roiHistory));
+        memset(&m_trackingRestore, 0, sizeof(m_trackingRestore));
 
-        // Initialize gamma LUT
+        // Initialize tone tables
         UpdateGammaLUT(DEFAULT_GAMMA);
     }
 
@@ -438,167 +831,193 @@ namespace CvsBallVision
 
     void CameraController::Impl::SafeShutdown()
     {
-        // 1. Unregister callbacks first to prevent new callbacks
-        if (m_bCallbackRegistered)
+        // 0. No more offset writes
+        StopTracking();
+
+        // 1. Stop acquisition (waits for the SDK, in-flight callbacks and the pipeline)
+        if (m_acquisitionState != AcquisitionState::Idle)
         {
-            ST_UnregisterGrabCallback(m_hDevice, EVENT_NEW_IMAGE);
-            m_bCallbackRegistered = false;
-            std::this_thread::sleep_for(std::chrono::milliseconds(CALLBACK_UNREGISTER_DELAY_MS));
+            StopAcquisition();
         }
 
-        // 2. Stop acquisition
-        if (m_bAcquiring)
+        // 2. Unregister callbacks to prevent new callbacks
+        if (m_bCallbackRegistered)
         {
-            m_bAcquiring = false;
-            ST_AcqStop(m_hDevice);
-            std::this_thread::sleep_for(std::chrono::milliseconds(ACQUISITION_STOP_TIMEOUT_MS));
+            m_pBackend->UnregisterGrabCallback(m_hDevice);
+            m_bCallbackRegistered = false;
         }
 
         // 3. Set shutdown flag
         m_bShuttingDown = true;
 
         // 4. Wait for all active callbacks to complete
+        if (!WaitForCallbacksIdle())
         {
-            std::unique_lock<std::mutex> lock(m_shutdownMutex);
-            bool allComplete = m_cvCallbackComplete.wait_for(
-                lock,
-                std::chrono::seconds(CALLBACK_COMPLETE_TIMEOUT_SEC),
-                [this] { return m_activeCallbacks == 0; }
-            );
-
-            if (!allComplete)
-            {
-                // Force clear if timeout
-                m_activeCallbacks = 0;
-            }
+            // Force clear if timeout
+            m_activeCallbacks = 0;
         }
 
         // 5. Clear callbacks
         {
             std::lock_guard<std::mutex> lock(m_callbackMutex);
             m_imageCallback = nullptr;
+            m_frameCallback = nullptr;
             m_errorCallback = nullptr;
             m_statusCallback = nullptr;
+            m_burstCallback = nullptr;
+            m_lookbackCallback = nullptr;
         }
 
-        // 6. Clean up buffers
+        // 6. Clean up buffers (the recording is flushed and closed)
+        StopPipeline();
+        m_frameRecorder.Stop();
+
         if (m_bufferPool)
         {
             m_bufferPool.reset();
         }
 
-        if (m_rgbBuffer.image.pImage)
-        {
-            ST_FreeBuffer(&m_rgbBuffer);
-        }
+        ReleaseReaderFrame();
+        m_frameRing.reset();
 
         // 7. Disconnect camera
         if (m_bConnected)
         {
-            ST_CloseDevice(m_hDevice);
+            m_pBackend->CloseDevice(m_hDevice);
             m_bConnected = false;
         }
 
         // 8. Free system
         if (m_bSystemInitialized)
         {
-            ST_FreeSystem();
+            m_pBackend->FreeSystem();
             m_bSystemInitialized = false;
         }
     }
 
     void CameraController::Impl::UpdateGammaLUT(double gamma)
     {
-        std::lock_guard<std::mutex> lock(m_gammaLUTMutex);
-
-        m_gammaLUT.resize(256);
-
-        if (std::abs(gamma - 1.0) < 0.001)  // Gamma is close to 1.0
-        {
-            for (int i = 0; i < 256; i++)
-            {
-                m_gammaLUT[i] = static_cast<uint8_t>(i);
-            }
-        }
-        else
-        {
-            double invGamma = 1.0 / gamma;
-            for (int i = 0; i < 256; i++)
-            {
-                double normalized = i / 255.0;
-                double corrected = std::pow(normalized, invGamma);
-                m_gammaLUT[i] = static_cast<uint8_t>(std::min(255.0, corrected * 255.0 + 0.5));
-            }
-        }
-
+        std::lock_guard<std::mutex> lock(m_toneMutex);
         m_currentGamma = gamma;
+        UpdateToneTables();
     }
 
-    void CameraController::Impl::ApplyGammaToImage(uint8_t* pData, int width, int height, int channels)
+    // Caller holds m_toneMutex
+    void CameraController::Impl::UpdateToneTables()
     {
-        if (!pData || std::abs(m_currentGamma - 1.0) < 0.001)
-            return;
+        // Software gamma only stands in for a camera without one; the curve runs on the host
+        // unless it was written to the camera's LUT
+        const bool bSoftwareGamma = m_bSoftwareGammaEnabled && !m_deviceState.HasFeature(DEVICE_FEATURE_GAMMA);
+        const double gamma = bSoftwareGamma ? m_currentGamma : 1.0;
+        const ToneCurveConfig* pCurve = m_toneCurve.enabled && !m_bHardwareLutActive ? &m_toneCurve : nullptr;
+
+        std::unique_ptr<ToneTables> pTables(new ToneTables());
+        ImageProcessing::BuildToneLut8(pCurve, gamma, pTables->lut8);
+        ImageProcessing::BuildToneLut12To8(pCurve, gamma, pTables->lut12To8);
+        ImageProcessing::BuildToneLut12(pCurve, gamma, pTables->lut12);
+
+        // Frames already being converted finish with the previous tables
+        m_toneTables.Update(std::move(pTables));
+    }
+
+    // Caller holds m_toneMutex
+    bool CameraController::Impl::WriteHardwareLut(const ToneCurveConfig& config)
+    {
+        std::unique_ptr<ImageProcessing::Lut12> pLut(new ImageProcessing::Lut12());
+        ImageProcessing::BuildToneLut12(&config, 1.0, *pLut);
+
+        // LUTIndex / LUTValue ranges give the table size and output scale (4096 x 12 bits on this camera)
+        int64_t minIndex = 0, maxIndex = TONE_CURVE_MAX_VALUE, inc = 1;
+        int64_t minValue = 0, maxValue = TONE_CURVE_MAX_VALUE;
+        m_pBackend->GetIntRegRange(m_hDevice, "LUTIndex", &minIndex, &maxIndex, &inc);
+        m_pBackend->GetIntRegRange(m_hDevice, "LUTValue", &minValue, &maxValue, &inc);
+        if (maxIndex <= minIndex || maxValue <= 0)
+        {
+            ReportError(-1, "Hardware LUT has an unexpected range");
+            return false;
+        }
 
-        std::lock_guard<std::mutex> lock(m_gammaLUTMutex);
+        // Not every camera has a selector
+        m_pBackend->SetEnumReg(m_hDevice, "LUTSelector", "Luminance");
 
-        int pixelCount = width * height * channels;
+        // Each entry is two register writes, so only the ones that changed are sent
+        const size_t entries = static_cast<size_t>(maxIndex - minIndex + 1);
+        if (m_hardwareLut.size() != entries)
+            m_hardwareLut.assign(entries, -1);
 
-        // SSE2 optimization for better performance
-#ifdef _MSC_VER
-        if (pixelCount >= 16)
+        for (size_t i = 0; i < entries; ++i)
         {
-            // Process 16 bytes at a time
-            int simdCount = pixelCount & ~15;
-            for (int i = 0; i < simdCount; i++)
-            {
-                pData[i] = m_gammaLUT[pData[i]];
-            }
+            const size_t input = (i * TONE_CURVE_MAX_VALUE + (entries - 1) / 2) / (entries - 1);
+            const int64_t value = (pLut->table[input] * maxValue + TONE_CURVE_MAX_VALUE / 2) / TONE_CURVE_MAX_VALUE;
+            if (m_hardwareLut[i] == value)
+                continue;
 
-            // Process remaining bytes
-            for (int i = simdCount; i < pixelCount; i++)
+            CVS_ERROR status = m_pBackend->SetIntReg(m_hDevice, "LUTIndex", minIndex + static_cast<int64_t>(i));
+            if (status == MCAM_ERR_OK)
+                status = m_pBackend->SetIntReg(m_hDevice, "LUTValue", value);
+            if (status != MCAM_ERR_OK)
             {
-                pData[i] = m_gammaLUT[pData[i]];
+                m_hardwareLut.clear();
+                ReportError(status, "Failed to write hardware LUT");
+                return false;
             }
+            m_hardwareLut[i] = value;
         }
-        else
-#endif
+
+        CVS_ERROR status = m_pBackend->SetBoolReg(m_hDevice, "LUTEnable", true);
+        if (status != MCAM_ERR_OK)
         {
-            // Standard processing
-            for (int i = 0; i < pixelCount; i++)
-            {
-                pData[i] = m_gammaLUT[pData[i]];
-            }
+            ReportError(status, "Failed to enable hardware LUT");
+            return false;
         }
+
+        m_bHardwareLutActive = true;
+        return true;
     }
 
-    bool CameraController::Impl::CheckGammaSupport()
+    // Caller holds m_toneMutex
+    void CameraController::Impl::DisableHardwareLut()
     {
-        if (!m_bConnected)
-            return false;
+        if (m_bConnected)
+            m_pBackend->SetBoolReg(m_hDevice, "LUTEnable", false);
+        m_bHardwareLutActive = false;
+    }
 
-        // Check for hardware gamma support
-        const char* gammaNodes[] = {
-            "Gamma",
-            "GammaCorrection",
-            "GammaValue",
-            "GammaY"
-        };
+    void CameraController::Impl::ApplyToneToImage(ImageData& imageData)
+    {
+        if (!imageData.pData)
+            return;
+
+        RcuPointer<ToneTables>::ReadGuard tables(m_toneTables);
+        if (imageData.layout == PixelLayout::Mono16)
+        {
+            ImageProcessing::ApplyLut12(reinterpret_cast<uint16_t*>(imageData.pData), imageData.width, imageData.height,
+                imageData.step, imageData.bitDepth, tables->lut12, ImageProcessing::GetSimdLevel());
+            return;
+        }
+
+        const ImageProcessing::Lut8& lut = tables->lut8;
+        if (lut.bIdentity)
+            return;
+
+        const int rowBytes = imageData.width * imageData.channels;
+        ImageProcessing::ApplyLut(imageData.pData, rowBytes, imageData.height, imageData.step, lut);
 
-        for (const char* nodeName : gammaNodes)
+        // Gamma keeps 255 at 255, but a curve that lowers white (contrast < 1) must not touch alpha
+        if (imageData.layout == PixelLayout::BGRA32 && lut.table[255] != 255)
         {
-            if (CheckFeatureAvailable(nodeName))
+            for (int y = 0; y < imageData.height; ++y)
             {
-                m_gammaNodeName = nodeName;
-                ReportStatus(std::string("Hardware gamma found: ") + nodeName);
-                return true;
+                uint8_t* pRow = imageData.pData + static_cast<size_t>(y) * imageData.step;
+                for (int x = 0; x < imageData.width; ++x)
+                    pRow[x * 4 + 3] = 255;
             }
         }
-
-        return false;
     }
 
     std::string CameraController::Impl::FindGammaNodeName()
     {
+        // Check for hardware gamma support
         const char* gammaNames[] = {
             "Gamma",
             "GammaCorrection",
@@ -606,33 +1025,38 @@ namespace CvsBallVision
             "GammaY"
         };
 
-        for (const char* name : gammaNames)
+        std::string nodeName = FindFeatureNodeName(gammaNames, sizeof(gammaNames) / sizeof(gammaNames[0]));
+        if (!nodeName.empty())
         {
-            if (CheckFeatureAvailable(name))
-            {
-                ReportStatus(std::string("Found gamma control: ") + name);
-                return name;
-            }
+            ReportStatus("Hardware gamma found: " + nodeName);
         }
 
-        return "";
+        return nodeName;
     }
 
-    bool CameraController::Impl::ValidateBufferSize(const CVS_BUFFER* pSrc, const CVS_BUFFER* pDst)
+    bool CameraController::Impl::PrepareFrameRing()
     {
-        if (!pSrc || !pDst || !pSrc->image.pImage || !pDst->image.pImage)
-            return false;
+        // Consumer slots plus whatever the pipeline keeps in flight
+        size_t slotCount = std::min(m_frameRingSize + GetPipelineSlotCount(), FRAME_RING_MAX_SIZE);
 
-        size_t srcSize = pSrc->image.width * pSrc->image.height * pSrc->image.channels;
-        size_t dstSize = pDst->image.width * pDst->image.height * pDst->image.channels;
-
-        // For Bayer to RGB conversion, destination needs 3x the source size
-        if (pSrc->image.channels == 1 && pDst->image.channels == 3)
+        // Recreate the ring only when the slot count or memory locking changed
+        if (!m_frameRing || m_frameRing->GetSlotCount() != slotCount ||
+            m_frameRing->GetLockMemory() != m_bufferPoolConfig.lockMemory)
         {
-            return (dstSize >= srcSize * 3);
+            ReleaseReaderFrame();
+            m_frameRing.reset(FrameRing::Create(slotCount, m_bufferPoolConfig.lockMemory));
         }
 
-        return (dstSize >= srcSize);
+        // Size slots for the worst case (debayered output) up front
+        m_frameRing->Reserve(static_cast<size_t>(GetOutputStep(m_deviceState.GetWidth(), m_outputFormat)) * m_deviceState.GetHeight());
+        m_frameRing->Reset();
+        return true;
+    }
+
+    void CameraController::Impl::ReleaseReaderFrame()
+    {
+        std::lock_guard<std::mutex> lock(m_readerMutex);
+        m_readerFrame.Reset();
     }
 
     bool CameraController::Impl::ReinitializeBuffers()
@@ -647,46 +1071,15 @@ namespace CvsBallVision
         }
         else
         {
-            m_bufferPool = std::make_unique<ImageBufferPool>(m_hDevice, BUFFER_POOL_SIZE);
-        }
-
-        // Free and reinitialize RGB buffer if needed
-        if (m_rgbBuffer.image.pImage)
-        {
-            ST_FreeBuffer(&m_rgbBuffer);
-            memset(&m_rgbBuffer, 0, sizeof(m_rgbBuffer));
+            m_bufferPool = std::make_unique<ImageBufferPool>(m_pBackend.get(), m_hDevice,
+                m_bufferPoolDepth, m_bufferPoolConfig.maxBuffers);
         }
 
-        if (IsColorCamera())
+        // Resize frame ring slots for the new resolution. Pipeline workers may still be
+        // writing slots; they grow them on demand in BeginWrite instead.
+        if (m_frameRing && !m_bPipelineRunning)
         {
-            // RGB buffer initialization with size validation
-            CVS_ERROR status = ST_InitBuffer(m_hDevice, &m_rgbBuffer, 3);
-            if (status != MCAM_ERR_OK)
-            {
-                ReportError(status, "Failed to reinitialize RGB buffer");
-                return false;
-            }
-
-            // Verify buffer size matches current resolution
-            if (m_rgbBuffer.image.width != m_currentWidth ||
-                m_rgbBuffer.image.height != m_currentHeight)
-            {
-                // Resize buffer to match current resolution
-                ST_FreeBuffer(&m_rgbBuffer);
-                memset(&m_rgbBuffer, 0, sizeof(m_rgbBuffer));
-
-                // Try to initialize with specific size
-                m_rgbBuffer.image.width = m_currentWidth;
-                m_rgbBuffer.image.height = m_currentHeight;
-                m_rgbBuffer.image.channels = 3;
-                status = ST_InitBuffer(m_hDevice, &m_rgbBuffer, 3);
-
-                if (status != MCAM_ERR_OK)
-                {
-                    ReportError(status, "Failed to initialize RGB buffer with specific size");
-                    return false;
-                }
-            }
+            m_frameRing->Reserve(static_cast<size_t>(GetOutputStep(m_deviceState.GetWidth(), m_outputFormat)) * m_deviceState.GetHeight());
         }
 
         return true;
@@ -698,31 +1091,40 @@ namespace CvsBallVision
             return false;
 
         // Check if resolution actually changed
-        if (m_currentWidth == width && m_currentHeight == height)
+        if (m_deviceState.GetWidth() == width && m_deviceState.GetHeight() == height)
         {
             ReportStatus("Resolution unchanged");
             return true;
         }
 
-        // Create transaction for safe rollback
-        ResolutionTransaction transaction(m_hDevice, m_currentWidth, m_currentHeight);
+        // Tracking moves wait until the new size is in place
+        std::lock_guard<std::mutex> sizeLock(m_roiSizeMutex);
+
+        // Create transaction for safe rollback (re-reads the window the camera ends up with)
+        int oldOffsetX, oldOffsetY;
+        m_deviceState.GetOffset(oldOffsetX, oldOffsetY);
+        ResolutionTransaction transaction(m_pBackend.get(), m_hDevice, m_deviceState.GetWidth(), m_deviceState.GetHeight(),
+            oldOffsetX, oldOffsetY, [this] { LoadHardwareROI(); });
 
         // Use RAII guards for safe state management
-        AcquisitionGuard acqGuard(m_hDevice, &m_bAcquiring);
-        CallbackGuard callbackGuard(m_hDevice, &m_bCallbackRegistered,
+        AcquisitionGuard acqGuard(m_pBackend.get(), m_hDevice, &m_bAcquiring, [this] { WakeGrabThread(); });
+        CallbackGuard callbackGuard(m_pBackend.get(), m_hDevice, &m_bCallbackRegistered,
             StaticGrabCallback, this);
+        WaitForCallbacksIdle();
+
+        // From here the window may move, so every failure rolls back
+        transaction.EnableRollback();
+        FitHardwareROI(width, height);
 
         // Set new resolution
-        CVS_ERROR status = ST_SetIntReg(m_hDevice, "Width", width);
+        CVS_ERROR status = m_pBackend->SetIntReg(m_hDevice, "Width", width);
         if (status != MCAM_ERR_OK)
         {
             ReportError(status, "Failed to set width");
             return false;
         }
 
-        transaction.EnableRollback();
-
-        status = ST_SetIntReg(m_hDevice, "Height", height);
+        status = m_pBackend->SetIntReg(m_hDevice, "Height", height);
         if (status != MCAM_ERR_OK)
         {
             ReportError(status, "Failed to set height");
@@ -730,16 +1132,16 @@ namespace CvsBallVision
             return false;
         }
 
-        // Update cached resolution
-        m_currentWidth = width;
-        m_currentHeight = height;
+        // Update cached resolution (limits such as the frame rate and the offsets depend on it)
+        m_deviceState.SetResolution(width, height);
+        m_deviceState.InvalidateFeatures();
+        LoadHardwareROI();
 
         // Reinitialize buffers
         if (!ReinitializeBuffers())
         {
             // Restore original resolution
-            m_currentWidth = transaction.GetOldWidth();
-            m_currentHeight = transaction.GetOldHeight();
+            m_deviceState.SetResolution(transaction.GetOldWidth(), transaction.GetOldHeight());
 
             ReportError(-1, "Failed to reinitialize buffers after resolution change");
             // Transaction destructor will handle rollback
@@ -753,32 +1155,373 @@ namespace CvsBallVision
         return true;
     }
 
-    bool CameraController::Impl::CheckFeatureAvailable(const char* nodeName)
+    void CameraController::Impl::LoadHardwareROI()
     {
-        if (!m_bConnected)
-            return false;
+        // Cameras without offset nodes have their window at the origin
+        int64_t offsetX = 0, offsetY = 0;
+        if (m_pBackend->GetIntReg(m_hDevice, "OffsetX", &offsetX) != MCAM_ERR_OK)
+            offsetX = 0;
+        if (m_pBackend->GetIntReg(m_hDevice, "OffsetY", &offsetY) != MCAM_ERR_OK)
+            offsetY = 0;
+
+        std::lock_guard<std::mutex> lock(m_roiMutex);
+        m_deviceState.SetOffset(static_cast<int>(offsetX), static_cast<int>(offsetY));
+        m_roiLimits.bValid = false;
+        ResetRoiHistory(static_cast<int>(offsetX), static_cast<int>(offsetY));
+    }
 
-        // Try to read the feature to check if it exists
-        int64_t intVal;
-        double floatVal;
-        char strVal[256];
-        uint32_t size = 256;
+    void CameraController::Impl::FitHardwareROI(int width, int height)
+    {
+        // A window moved away from the origin may leave no room for a larger size; slide it back first
+        int offsetX, offsetY;
+        m_deviceState.GetOffset(offsetX, offsetY);
+        if (offsetX == 0 && offsetY == 0)
+            return;
 
-        // Try as integer
-        if (ST_GetIntReg(m_hDevice, nodeName, &intVal) == MCAM_ERR_OK)
-            return true;
+        int64_t widthMax = 0, heightMax = 0;
+        if (m_pBackend->GetIntReg(m_hDevice, "WidthMax", &widthMax) != MCAM_ERR_OK ||
+            m_pBackend->GetIntReg(m_hDevice, "HeightMax", &heightMax) != MCAM_ERR_OK)
+        {
+            return;
+        }
 
-        // Try as float
-        if (ST_GetFloatReg(m_hDevice, nodeName, &floatVal) == MCAM_ERR_OK)
-            return true;
+        if (offsetX + width > widthMax || offsetY + height > heightMax)
+        {
+            MoveHardwareROI(std::min(offsetX, static_cast<int>(widthMax) - width),
+                std::min(offsetY, static_cast<int>(heightMax) - height));
+        }
+    }
 
-        // Try as enumeration
-        if (ST_GetEnumReg(m_hDevice, nodeName, strVal, &size) == MCAM_ERR_OK)
+    bool CameraController::Impl::MoveHardwareROI(int offsetX, int offsetY)
+    {
+        if (!m_bConnected)
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_roiMutex);
+
+        // Offset ranges only change with the window size: read once, then moves are register writes only
+        HardwareRoiLimits& limits = m_roiLimits;
+        if (!limits.bValid)
+        {
+            if (m_pBackend->GetIntRegRange(m_hDevice, "OffsetX", &limits.minX, &limits.maxX, &limits.incX) != MCAM_ERR_OK ||
+                m_pBackend->GetIntRegRange(m_hDevice, "OffsetY", &limits.minY, &limits.maxY, &limits.incY) != MCAM_ERR_OK)
+            {
+                ReportError(-1, "Hardware ROI offsets not available on this camera");
+                return false;
+            }
+
+            limits.incX = std::max<int64_t>(limits.incX, 1);
+            limits.incY = std::max<int64_t>(limits.incY, 1);
+            limits.bValid = true;
+        }
+
+        auto snap = [](int64_t value, int64_t min, int64_t max, int64_t inc)
+        {
+            value = std::max(min, std::min(value, max));
+            return min + (value - min) / inc * inc;
+        };
+        const int64_t x = snap(offsetX, limits.minX, limits.maxX, limits.incX);
+        const int64_t y = snap(offsetY, limits.minY, limits.maxY, limits.incY);
+
+        int currentX, currentY;
+        m_deviceState.GetOffset(currentX, currentY);
+
+        // Only the axes that move are written
+        if (x != currentX)
+        {
+            CVS_ERROR status = m_pBackend->SetIntReg(m_hDevice, "OffsetX", x);
+            if (status != MCAM_ERR_OK)
+            {
+                ReportError(status, "Failed to set OffsetX");
+                return false;
+            }
+            m_deviceState.SetOffset(static_cast<int>(x), currentY);
+        }
+
+        if (y != currentY)
+        {
+            CVS_ERROR status = m_pBackend->SetIntReg(m_hDevice, "OffsetY", y);
+            if (status != MCAM_ERR_OK)
+            {
+                if (x != currentX)
+                    RecordRoiMove(static_cast<int>(x), currentY);
+                ReportError(status, "Failed to set OffsetY");
+                return false;
+            }
+            m_deviceState.SetOffset(static_cast<int>(x), static_cast<int>(y));
+        }
+
+        if (x != currentX || y != currentY)
+            RecordRoiMove(static_cast<int>(x), static_cast<int>(y));
+
+        return true;
+    }
+
+    void CameraController::Impl::ResetRoiHistory(int offsetX, int offsetY)
+    {
+        std::lock_guard<std::mutex> lock(m_roiHistoryMutex);
+        m_roiHistory[0] = { 0, offsetX, offsetY };
+        m_roiHistoryCount = 1;
+    }
+
+    void CameraController::Impl::RecordRoiMove(int offsetX, int offsetY)
+    {
+        // Taken once the write is done: frames up to the last one received, plus those
+        // already exposing, keep the old origin
+        const uint64_t lastBlockID = m_lastBlockID.load(std::memory_order_relaxed);
+
+        // Not streaming, or no frame since the stream (re)started: every frame to come has the new origin
+        if (!m_bAcquiring || lastBlockID == 0)
+        {
+            ResetRoiHistory(offsetX, offsetY);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_roiHistoryMutex);
+        RoiOrigin& newest = m_roiHistory[m_roiHistoryCount - 1];
+        const uint64_t firstBlockID = std::max(newest.firstBlockID,
+            lastBlockID + 1 + static_cast<uint64_t>(m_roiMoveLatency.load(std::memory_order_relaxed)));
+
+        // Superseded before any frame was exposed with it
+        if (firstBlockID == newest.firstBlockID)
+        {
+            newest.x = offsetX;
+            newest.y = offsetY;
+            return;
+        }
+
+        if (m_roiHistoryCount == TRACKING_ROI_HISTORY)
+        {
+            memmove(m_roiHistory, m_roiHistory + 1, (TRACKING_ROI_HISTORY - 1) * sizeof(RoiOrigin));
+            m_roiHistoryCount--;
+        }
+        m_roiHistory[m_roiHistoryCount++] = { firstBlockID, offsetX, offsetY };
+    }
+
+    void CameraController::Impl::GetRoiOrigin(uint64_t blockID, int& offsetX, int& offsetY)
+    {
+        std::lock_guard<std::mutex> lock(m_roiHistoryMutex);
+        size_t index = m_roiHistoryCount - 1;
+        while (index > 0 && m_roiHistory[index].firstBlockID > blockID)
+            index--;
+
+        offsetX = m_roiHistory[index].x;
+        offsetY = m_roiHistory[index].y;
+    }
+
+    bool CameraController::Impl::SetTrackingROI(const TrackingRoiConfig& config)
+    {
+        if (!m_bConnected)
+            return false;
+
+        if (config.width < 0 || config.height < 0 ||
+            config.moveLatencyFrames < 0 || config.moveLatencyFrames > TRACKING_ROI_MAX_LATENCY_FRAMES)
+        {
+            ReportError(-1, "Invalid tracking ROI configuration");
+            return false;
+        }
+
+        // Targets stop while the window is set up
+        StopTracking();
+        m_roiMoveLatency.store(config.moveLatencyFrames, std::memory_order_relaxed);
+
+        const bool bWasEnabled = m_trackingConfig.enabled;
+        if (!config.enabled)
+        {
+            m_trackingConfig = config;
+            if (!bWasEnabled)
+                return true;
+
+            bool bOk = RestoreTrackingWindow();
+            ReportStatus("Tracking ROI disabled");
+            return bOk;
+        }
+
+        if (!bWasEnabled)
+        {
+            TrackingRestore& restore = m_trackingRestore;
+            restore.width = m_deviceState.GetWidth();
+            restore.height = m_deviceState.GetHeight();
+            m_deviceState.GetOffset(restore.offsetX, restore.offsetY);
+            restore.bFrameRate = GetFeatureValue(DEVICE_FEATURE_FRAME_RATE, restore.frameRate);
+        }
+
+        // One resize up front; from here on only the offsets move
+        const int width = config.width > 0 ? config.width : m_deviceState.GetWidth();
+        const int height = config.height > 0 ? config.height : m_deviceState.GetHeight();
+        bool bOk = SetResolutionOptimized(width, height);
+
+        // Reads the offset ranges, and fails on cameras whose window cannot move
+        if (bOk)
+        {
+            int offsetX, offsetY;
+            m_deviceState.GetOffset(offsetX, offsetY);
+            bOk = MoveHardwareROI(offsetX, offsetY);
+        }
+
+        // The frame rate range follows the window height
+        double minFps, maxFps;
+        if (bOk && config.maximizeFrameRate && GetFeatureRange(DEVICE_FEATURE_FRAME_RATE, minFps, maxFps))
+        {
+            CVS_ERROR status = SetFeatureValue(DEVICE_FEATURE_FRAME_RATE, maxFps);
+            if (status != MCAM_ERR_OK)
+            {
+                ReportError(status, "Failed to raise frame rate for tracking ROI");
+                bOk = false;
+            }
+        }
+
+        if (!bOk)
+        {
+            RestoreTrackingWindow();
+            m_trackingConfig.enabled = false;
+            return false;
+        }
+
+        m_trackingConfig = config;
+        m_trackingTargets = 0;
+        m_trackingCoalesced = 0;
+        m_trackingMoves = 0;
+        m_trackingUnchanged = 0;
+        m_trackingFailures = 0;
+        m_trackingHistogram.Reset();
+        StartTracking();
+
+        std::stringstream ss;
+        ss << "Tracking ROI enabled: " << width << "x" << height;
+        if (GetFeatureValue(DEVICE_FEATURE_FRAME_RATE, maxFps))
+            ss << " @ " << maxFps << " fps";
+        ReportStatus(ss.str());
+        return true;
+    }
+
+    bool CameraController::Impl::RestoreTrackingWindow()
+    {
+        const TrackingRestore& restore = m_trackingRestore;
+        bool bOk = SetResolutionOptimized(restore.width, restore.height);
+        bOk = MoveHardwareROI(restore.offsetX, restore.offsetY) && bOk;
+
+        // After the size: a taller window may have lowered the frame rate limit
+        if (restore.bFrameRate)
+        {
+            CVS_ERROR status = SetFeatureValue(DEVICE_FEATURE_FRAME_RATE, restore.frameRate);
+            if (status != MCAM_ERR_OK)
+            {
+                ReportError(status, "Failed to restore frame rate after tracking ROI");
+                bOk = false;
+            }
+        }
+
+        return bOk;
+    }
+
+    void CameraController::Impl::StartTracking()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_trackingMutex);
+            m_bTrackingActive = true;
+            m_bTrackingTarget = false;
+        }
+        m_trackingThread = std::thread(&Impl::TrackingThreadFunc, this);
+    }
+
+    void CameraController::Impl::StopTracking()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_trackingMutex);
+            m_bTrackingActive = false;
+            m_bTrackingTarget = false;
+        }
+        m_cvTracking.notify_all();
+
+        if (m_trackingThread.joinable())
+            m_trackingThread.join();
+    }
+
+    void CameraController::Impl::TrackingThreadFunc()
+    {
+        std::unique_lock<std::mutex> lock(m_trackingMutex);
+        while (true)
+        {
+            m_cvTracking.wait(lock, [this] { return !m_bTrackingActive || m_bTrackingTarget; });
+            if (!m_bTrackingActive)
+                break;
+
+            // Only the newest target matters; the ones it replaced were counted as coalesced
+            const double targetX = m_trackingX;
+            const double targetY = m_trackingY;
+            const int64_t targetNs = m_trackingTargetNs;
+            m_bTrackingTarget = false;
+            lock.unlock();
+
+            {
+                std::lock_guard<std::mutex> sizeLock(m_roiSizeMutex);
+                int beforeX, beforeY;
+                m_deviceState.GetOffset(beforeX, beforeY);
+
+                const int offsetX = static_cast<int>(std::lround(targetX - m_deviceState.GetWidth() / 2.0));
+                const int offsetY = static_cast<int>(std::lround(targetY - m_deviceState.GetHeight() / 2.0));
+                if (!MoveHardwareROI(offsetX, offsetY))
+                {
+                    m_trackingFailures++;
+                }
+                else
+                {
+                    int afterX, afterY;
+                    m_deviceState.GetOffset(afterX, afterY);
+                    if (afterX == beforeX && afterY == beforeY)
+                    {
+                        m_trackingUnchanged++;
+                    }
+                    else
+                    {
+                        m_trackingMoves++;
+                        m_trackingHistogram.RecordNs(ToSteadyNs(std::chrono::steady_clock::now()) - targetNs);
+                    }
+                }
+            }
+
+            lock.lock();
+        }
+    }
+
+    bool CameraController::Impl::CheckFeatureAvailable(const char* nodeName)
+    {
+        if (!m_bConnected)
+            return false;
+
+        // Try to read the feature to check if it exists
+        int64_t intVal;
+        double floatVal;
+        char strVal[256];
+        uint32_t size = 256;
+
+        // Try as integer
+        if (m_pBackend->GetIntReg(m_hDevice, nodeName, &intVal) == MCAM_ERR_OK)
+            return true;
+
+        // Try as float
+        if (m_pBackend->GetFloatReg(m_hDevice, nodeName, &floatVal) == MCAM_ERR_OK)
+            return true;
+
+        // Try as enumeration
+        if (m_pBackend->GetEnumReg(m_hDevice, nodeName, strVal, &size) == MCAM_ERR_OK)
             return true;
 
         return false;
     }
 
+    std::string CameraController::Impl::FindFeatureNodeName(const char* const* nodeNames, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (CheckFeatureAvailable(nodeNames[i]))
+                return nodeNames[i];
+        }
+
+        return "";
+    }
+
     std::string CameraController::Impl::FindGainNodeName()
     {
         // Common gain node names used by different camera manufacturers
@@ -792,311 +1535,1785 @@ namespace CvsBallVision
             "MasterGain"
         };
 
-        for (const char* name : gainNames)
+        std::string nodeName = FindFeatureNodeName(gainNames, sizeof(gainNames) / sizeof(gainNames[0]));
+        if (!nodeName.empty())
+        {
+            ReportStatus("Found gain control: " + nodeName);
+        }
+
+        return nodeName;
+    }
+
+    void CameraController::Impl::DetectAvailableFeatures()
+    {
+        if (!m_bConnected)
+            return;
+
+        ReportStatus("Detecting available camera features...");
+
+        // Resolve each feature to the node this camera uses, once
+        const char* exposureNames[] = { "ExposureTime", "ExposureTimeAbs" };
+        const char* frameRateNames[] = { "AcquisitionFrameRate", "FrameRate" };
+
+        m_deviceState.SetFeatureNode(DEVICE_FEATURE_EXPOSURE,
+            FindFeatureNodeName(exposureNames, sizeof(exposureNames) / sizeof(exposureNames[0])));
+        m_deviceState.SetFeatureNode(DEVICE_FEATURE_GAIN, FindGainNodeName());
+        m_deviceState.SetFeatureNode(DEVICE_FEATURE_FRAME_RATE,
+            FindFeatureNodeName(frameRateNames, sizeof(frameRateNames) / sizeof(frameRateNames[0])));
+        m_deviceState.SetFeatureNode(DEVICE_FEATURE_GAMMA, FindGammaNodeName());
+
+        const bool bHasGain = m_deviceState.HasFeature(DEVICE_FEATURE_GAIN);
+        const bool bHasGamma = m_deviceState.HasFeature(DEVICE_FEATURE_GAMMA);
+
+        if (!bHasGamma)
+        {
+            ReportStatus("Hardware gamma not supported - using software gamma correction");
+            m_bSoftwareGammaEnabled = true;
+        }
+
+        // Hardware LUT: contents are unknown after connecting, so a hardware curve is rewritten in full
+        bool bHardwareLutFailed = false;
+        {
+            std::lock_guard<std::mutex> lock(m_toneMutex);
+            m_bHardwareLut = CheckFeatureAvailable("LUTIndex") && CheckFeatureAvailable("LUTValue");
+            m_bHardwareLutActive = false;
+            m_hardwareLut.clear();
+            if (m_toneCurve.enabled && m_toneCurve.useHardwareLut)
+                bHardwareLutFailed = !m_bHardwareLut || !WriteHardwareLut(m_toneCurve);
+            UpdateToneTables();
+        }
+        if (bHardwareLutFailed)
+            ReportStatus("Hardware LUT not available - applying the tone curve in software");
+
+        // Report detected features
+        std::stringstream ss;
+        ss << "Features detected - ";
+        ss << "Exposure: " << (m_deviceState.HasFeature(DEVICE_FEATURE_EXPOSURE) ? "Yes" : "No") << ", ";
+        ss << "Gain: " << (bHasGain ? "Yes" : "No");
+        if (bHasGain)
+        {
+            ss << " (" << m_deviceState.GetFeatureNode(DEVICE_FEATURE_GAIN) << ")";
+        }
+        ss << ", Frame Rate: " << (m_deviceState.HasFeature(DEVICE_FEATURE_FRAME_RATE) ? "Yes" : "No");
+        ss << ", Gamma: " << (bHasGamma ? "Hardware" : "Software");
+        ss << ", LUT: " << (m_bHardwareLut ? "Hardware" : "Software");
+
+        ReportStatus(ss.str());
+    }
+
+    bool CameraController::Impl::LoadDeviceState()
+    {
+        if (!m_bConnected)
+            return false;
+
+        char pixelFormat[256] = { 0 };
+        uint32_t size = 256;
+        int64_t width = 0, height = 0;
+
+        CVS_ERROR status = m_pBackend->GetEnumReg(m_hDevice, "PixelFormat", pixelFormat, &size);
+        if (status == MCAM_ERR_OK)
+            status = m_pBackend->GetIntReg(m_hDevice, "Width", &width);
+        if (status == MCAM_ERR_OK)
+            status = m_pBackend->GetIntReg(m_hDevice, "Height", &height);
+
+        if (status != MCAM_ERR_OK)
+        {
+            ReportError(status, "Failed to read device state");
+            return false;
+        }
+
+        m_deviceState.SetPixelFormat(pixelFormat);
+        m_deviceState.SetResolution(static_cast<int>(width), static_cast<int>(height));
+        m_deviceState.InvalidateFeatures();
+        LoadHardwareROI();
+        return true;
+    }
+
+    bool CameraController::Impl::GetFeatureRange(DeviceFeature feature, double& min, double& max)
+    {
+        if (!m_bConnected || !m_deviceState.HasFeature(feature))
+            return false;
+
+        if (m_deviceState.GetRange(feature, min, max))
+            return true;
+
+        const char* nodeName = m_deviceState.GetFeatureNode(feature).c_str();
+        CVS_ERROR status = m_pBackend->GetFloatRegRange(m_hDevice, nodeName, &min, &max);
+
+        if (status != MCAM_ERR_OK)
+        {
+            // Integer nodes (e.g. GainRaw)
+            int64_t intMin, intMax, intInc;
+            status = m_pBackend->GetIntRegRange(m_hDevice, nodeName, &intMin, &intMax, &intInc);
+            if (status == MCAM_ERR_OK)
+            {
+                min = static_cast<double>(intMin);
+                max = static_cast<double>(intMax);
+            }
+        }
+
+        if (status != MCAM_ERR_OK)
+            return false;
+
+        m_deviceState.SetRange(feature, min, max);
+        return true;
+    }
+
+    bool CameraController::Impl::GetFeatureValue(DeviceFeature feature, double& value)
+    {
+        if (!m_bConnected || !m_deviceState.HasFeature(feature))
+            return false;
+
+        if (m_deviceState.GetValue(feature, value))
+            return true;
+
+        const char* nodeName = m_deviceState.GetFeatureNode(feature).c_str();
+        CVS_ERROR status = m_pBackend->GetFloatReg(m_hDevice, nodeName, &value);
+
+        if (status != MCAM_ERR_OK)
+        {
+            int64_t intValue;
+            status = m_pBackend->GetIntReg(m_hDevice, nodeName, &intValue);
+            if (status == MCAM_ERR_OK)
+            {
+                value = static_cast<double>(intValue);
+            }
+        }
+
+        if (status != MCAM_ERR_OK)
+            return false;
+
+        m_deviceState.SetValue(feature, value);
+        return true;
+    }
+
+    CVS_ERROR CameraController::Impl::SetFeatureValue(DeviceFeature feature, double value)
+    {
+        const char* nodeName = m_deviceState.GetFeatureNode(feature).c_str();
+        CVS_ERROR status = m_pBackend->SetFloatReg(m_hDevice, nodeName, value);
+
+        if (status != MCAM_ERR_OK && feature == DEVICE_FEATURE_GAIN)
+        {
+            status = m_pBackend->SetIntReg(m_hDevice, nodeName, static_cast<int64_t>(value));
+        }
+
+        if (status != MCAM_ERR_OK)
+            return status;
+
+        m_deviceState.SetValue(feature, value);
+
+        // Exposure and frame rate limit each other; the camera may have clamped the other one
+        if (feature == DEVICE_FEATURE_EXPOSURE)
+            m_deviceState.InvalidateFeature(DEVICE_FEATURE_FRAME_RATE);
+        else if (feature == DEVICE_FEATURE_FRAME_RATE)
+            m_deviceState.InvalidateFeature(DEVICE_FEATURE_EXPOSURE);
+
+        return MCAM_ERR_OK;
+    }
+
+    bool CameraController::Impl::GetParameters(CameraParameters& params)
+    {
+        if (!m_bConnected)
+            return false;
+
+        params.width = m_deviceState.GetWidth();
+        params.height = m_deviceState.GetHeight();
+        params.pixelFormat = m_deviceState.GetPixelFormat();
+
+        // Features the camera lacks read as 0
+        params.exposureTime = 0.0;
+        params.gain = 0.0;
+        params.fps = 0.0;
+        GetFeatureValue(DEVICE_FEATURE_EXPOSURE, params.exposureTime);
+        GetFeatureValue(DEVICE_FEATURE_GAIN, params.gain);
+        GetFeatureValue(DEVICE_FEATURE_FRAME_RATE, params.fps);
+
+        if (!GetFeatureValue(DEVICE_FEATURE_GAMMA, params.gamma))
+        {
+            params.gamma = m_currentGamma;
+        }
+
+        return true;
+    }
+
+    bool CameraController::Impl::ApplyParameters(const CameraParameters& params)
+    {
+        if (!m_bConnected)
+            return false;
+
+        CameraParameters current;
+        if (!GetParameters(current))
+            return false;
+
+        // Validate everything before the first write
+        if (params.width <= 0 || params.height <= 0)
+        {
+            ReportError(-1, "Invalid resolution");
+            return false;
+        }
+
+        double min, max;
+        if (params.gamma < GAMMA_MIN || params.gamma > GAMMA_MAX ||
+            (GetFeatureRange(DEVICE_FEATURE_GAMMA, min, max) && (params.gamma < min || params.gamma > max)))
+        {
+            ReportError(-1, "Gamma value out of range");
+            return false;
+        }
+
+        if (GetFeatureRange(DEVICE_FEATURE_GAIN, min, max) && (params.gain < min || params.gain > max))
+        {
+            ReportError(-1, "Gain value out of range");
+            return false;
+        }
+
+        if (GetFeatureRange(DEVICE_FEATURE_EXPOSURE, min, max) &&
+            (params.exposureTime < min || params.exposureTime > max))
+        {
+            ReportError(-1, "Exposure time out of range");
+            return false;
+        }
+
+        const bool bFormatChange = !params.pixelFormat.empty() && params.pixelFormat != current.pixelFormat;
+        const bool bResolutionChange = params.width != current.width || params.height != current.height;
+        const bool bReallocate = bFormatChange || bResolutionChange;
+
+        // The frame rate maximum follows the window size, so a new size only checks the minimum here
+        if (GetFeatureRange(DEVICE_FEATURE_FRAME_RATE, min, max) &&
+            (params.fps < min || (!bResolutionChange && params.fps > max)))
+        {
+            ReportError(-1, "Frame rate out of range");
+            return false;
+        }
+
+        int previousOffsetX, previousOffsetY;
+        m_deviceState.GetOffset(previousOffsetX, previousOffsetY);
+
+        // Stop, reallocate and restart once for everything that changes the frame size
+        std::unique_lock<std::mutex> sizeLock(m_roiSizeMutex, std::defer_lock);
+        if (bResolutionChange)
+            sizeLock.lock();
+
+        std::unique_ptr<AcquisitionGuard> acqGuard;
+        std::unique_ptr<CallbackGuard> callbackGuard;
+        if (bReallocate)
+        {
+            acqGuard = std::make_unique<AcquisitionGuard>(m_pBackend.get(), m_hDevice, &m_bAcquiring,
+                [this] { WakeGrabThread(); });
+            callbackGuard = std::make_unique<CallbackGuard>(m_pBackend.get(), m_hDevice, &m_bCallbackRegistered,
+                StaticGrabCallback, this);
+            WaitForCallbacksIdle();
+        }
+
+        CVS_ERROR status = MCAM_ERR_OK;
+        std::string failure;
+
+        if (bFormatChange)
+        {
+            status = m_pBackend->SetEnumReg(m_hDevice, "PixelFormat", params.pixelFormat.c_str());
+            failure = "Failed to set pixel format";
+        }
+
+        if (status == MCAM_ERR_OK && bResolutionChange)
+        {
+            FitHardwareROI(params.width, params.height);
+            status = m_pBackend->SetIntReg(m_hDevice, "Width", params.width);
+            if (status == MCAM_ERR_OK)
+                status = m_pBackend->SetIntReg(m_hDevice, "Height", params.height);
+            failure = "Failed to set resolution";
+        }
+
+        if (status == MCAM_ERR_OK && bReallocate)
+        {
+            if (bFormatChange)
+                m_deviceState.SetPixelFormat(params.pixelFormat);
+            m_deviceState.SetResolution(params.width, params.height);
+            m_deviceState.InvalidateFeatures();
+            if (bResolutionChange)
+                LoadHardwareROI();
+
+            if (!ReinitializeBuffers())
+            {
+                status = -1;
+                failure = "Failed to reinitialize buffers";
+            }
+        }
+
+        // Skip values the camera already has; restore written ones in reverse if a later write fails
+        std::vector<DeviceFeature> written;
+        auto writeFeature = [&](DeviceFeature feature, double value)
+        {
+            double cached;
+            if (status != MCAM_ERR_OK || !m_deviceState.HasFeature(feature) ||
+                (m_deviceState.GetValue(feature, cached) && cached == value))
+                return;
+
+            status = SetFeatureValue(feature, value);
+            if (status == MCAM_ERR_OK)
+                written.push_back(feature);
+            else
+                failure = "Failed to set " + m_deviceState.GetFeatureNode(feature);
+        };
+
+        // Lengthen the frame period before raising the exposure, shorten it after lowering it
+        const bool bFrameRateFirst = params.fps < current.fps;
+        if (bFrameRateFirst)
+            writeFeature(DEVICE_FEATURE_FRAME_RATE, params.fps);
+        writeFeature(DEVICE_FEATURE_EXPOSURE, params.exposureTime);
+        if (!bFrameRateFirst)
+            writeFeature(DEVICE_FEATURE_FRAME_RATE, params.fps);
+        writeFeature(DEVICE_FEATURE_GAIN, params.gain);
+        writeFeature(DEVICE_FEATURE_GAMMA, params.gamma);
+
+        if (status != MCAM_ERR_OK)
+        {
+            ReportError(status, failure);
+
+            bool bRestored = true;
+            for (auto it = written.rbegin(); it != written.rend(); ++it)
+            {
+                const double previous =
+                    *it == DEVICE_FEATURE_EXPOSURE ? current.exposureTime :
+                    *it == DEVICE_FEATURE_GAIN ? current.gain :
+                    *it == DEVICE_FEATURE_FRAME_RATE ? current.fps : current.gamma;
+                bRestored &= SetFeatureValue(*it, previous) == MCAM_ERR_OK;
+            }
+
+            if (bReallocate)
+            {
+                if (bResolutionChange)
+                {
+                    bRestored &= m_pBackend->SetIntReg(m_hDevice, "Width", current.width) == MCAM_ERR_OK;
+                    bRestored &= m_pBackend->SetIntReg(m_hDevice, "Height", current.height) == MCAM_ERR_OK;
+
+                    // Put back the window FitHardwareROI slid towards the origin (the old size fits it again)
+                    int offsetX, offsetY;
+                    m_deviceState.GetOffset(offsetX, offsetY);
+                    if (offsetX != previousOffsetX)
+                        bRestored &= m_pBackend->SetIntReg(m_hDevice, "OffsetX", previousOffsetX) == MCAM_ERR_OK;
+                    if (offsetY != previousOffsetY)
+                        bRestored &= m_pBackend->SetIntReg(m_hDevice, "OffsetY", previousOffsetY) == MCAM_ERR_OK;
+                }
+                if (bFormatChange)
+                    bRestored &= m_pBackend->SetEnumReg(m_hDevice, "PixelFormat", current.pixelFormat.c_str()) == MCAM_ERR_OK;
+
+                m_deviceState.SetPixelFormat(current.pixelFormat);
+                m_deviceState.SetResolution(current.width, current.height);
+                m_deviceState.InvalidateFeatures();
+                if (bResolutionChange)
+                    LoadHardwareROI();
+                bRestored &= ReinitializeBuffers();
+            }
+
+            if (!bRestored)
+                ReportError(-1, "Failed to restore previous parameters after: " + failure);
+
+            return false;
+        }
+
+        if (m_deviceState.HasFeature(DEVICE_FEATURE_GAMMA))
+            m_currentGamma = params.gamma;
+        else if (params.gamma != m_currentGamma)
+            UpdateGammaLUT(params.gamma);
+
+        ReportStatus("Parameters applied");
+        return true;
+    }
+
+    bool CameraController::Impl::StartAcquisition()
+    {
+        if (!m_bConnected)
+        {
+            ReportError(-1, "Camera not connected");
+            return false;
+        }
+
+        if (m_acquisitionState == AcquisitionState::Paused)
+            return ResumeAcquisition();
+
+        if (m_acquisitionState != AcquisitionState::Idle)
+            return m_acquisitionState == AcquisitionState::Running;
+
+        auto startTime = std::chrono::steady_clock::now();
+        m_acquisitionState = AcquisitionState::Starting;
+
+        // Reset buffer pool state and size it for this run
+        if (m_bufferPool)
+        {
+            m_bufferPool->ResetBuffers();
+        }
+        UpdateBufferPoolDepth();
+        PrepareLookback();
+
+        // Prepare frame ring and processing stages
+        PrepareFrameRing();
+        StartPipeline();
+
+        // Pull mode: the grab thread is the only consumer of frames
+        if (m_grabConfig.mode == GrabMode::Pull && m_bCallbackRegistered)
+        {
+            m_pBackend->UnregisterGrabCallback(m_hDevice);
+            m_bCallbackRegistered = false;
+        }
+
+        // The callback stays registered across stop/start; only the first start (or a
+        // start after a resolution change that failed to re-register) pays for it
+        if (m_grabConfig.mode == GrabMode::Callback && !m_bCallbackRegistered)
+        {
+            CVS_ERROR status = m_pBackend->RegisterGrabCallback(m_hDevice, StaticGrabCallback, this);
+            if (status != MCAM_ERR_OK)
+            {
+                StopPipeline();
+                m_acquisitionState = AcquisitionState::Idle;
+                ReportError(status, "Failed to register callback");
+                return false;
+            }
+            m_bCallbackRegistered = true;
+        }
+
+        // Reset counters and accept frames before the first one can arrive
+        m_frameCount = 0;
+        m_errorCount = 0;
+        m_lastBlockID = 0;
+        {
+            int offsetX, offsetY;
+            m_deviceState.GetOffset(offsetX, offsetY);
+            ResetRoiHistory(offsetX, offsetY);
+        }
+        m_framesDroppedDevice = 0;
+        m_framesDroppedInvalid = 0;
+        m_frameRing->ResetStatistics();
+        {
+            std::lock_guard<std::mutex> lock(m_statisticsMutex);
+            m_lastFrameCount = 0;
+            m_currentFps = 0.0;
+            m_lastFpsTime = startTime;
+        }
+        ResetInstrumentation();
+
+        m_startRequestNs.store(ToSteadyNs(startTime), std::memory_order_relaxed);
+        m_bPaused.store(false);
+        m_bStreamStopped.store(false);
+        m_bAcquiring.store(true);
+
+        CVS_ERROR status = m_pBackend->AcqStart(m_hDevice);
+        if (status != MCAM_ERR_OK)
+        {
+            m_bAcquiring.store(false);
+            m_startRequestNs.store(0, std::memory_order_relaxed);
+            WaitForCallbacksIdle();
+            StopPipeline();
+            m_acquisitionState = AcquisitionState::Idle;
+            ReportError(status, "Failed to start acquisition");
+            return false;
+        }
+
+        if (m_grabConfig.mode == GrabMode::Pull)
+        {
+            m_grabThread = std::thread(&Impl::GrabThreadFunc, this);
+        }
+
+        m_acquisitionState = AcquisitionState::Running;
+        m_startHistogram.Record(std::chrono::steady_clock::now() - startTime);
+
+        ReportStatus("Acquisition started");
+        return true;
+    }
+
+    bool CameraController::Impl::StopAcquisition()
+    {
+        if (m_acquisitionState != AcquisitionState::Running && m_acquisitionState != AcquisitionState::Paused)
+            return true;
+
+        auto stopTime = std::chrono::steady_clock::now();
+        m_acquisitionState = AcquisitionState::Stopping;
+
+        // Refuse new frames, then wait for the SDK to acknowledge the stop
+        m_bAcquiring.store(false);
+        m_bPaused.store(false);
+        m_startRequestNs.store(0, std::memory_order_relaxed);
+        m_resumeRequestNs.store(0, std::memory_order_relaxed);
+
+        CVS_ERROR status = m_pBackend->AcqStop(m_hDevice);
+        if (status != MCAM_ERR_OK)
+        {
+            ReportError(status, "Failed to stop acquisition");
+        }
+
+        // The pull thread leaves GrabImage once the stream has stopped
+        StopGrabThread();
+        m_bStreamStopped.store(false);
+
+        // Callbacks already inside the driver finish before the buffers are reused
+        if (!WaitForCallbacksIdle())
+        {
+            m_drainTimeouts.fetch_add(1, std::memory_order_relaxed);
+            ReportError(-1, "Timed out waiting for frame callbacks to finish");
+        }
+
+        // Stop processing stages (frames still queued are discarded)
+        StopPipeline();
+
+        // Every buffer is back once the grab thread, callbacks and stages are done
+        if (m_bufferPool)
+        {
+            m_bufferPool->ResetBuffers();
+        }
+
+        m_acquisitionState = AcquisitionState::Idle;
+        m_stopHistogram.Record(std::chrono::steady_clock::now() - stopTime);
+
+        ReportStatus("Acquisition stopped");
+        return status == MCAM_ERR_OK;
+    }
+
+    bool CameraController::Impl::PauseAcquisition(PauseMode mode)
+    {
+        if (m_acquisitionState == AcquisitionState::Paused)
+            return true;
+
+        if (m_acquisitionState != AcquisitionState::Running)
+        {
+            ReportError(-1, "Acquisition not running");
+            return false;
+        }
+
+        // Close the gate first; frames already past it finish normally
+        m_bPaused.store(true);
+        m_resumeRequestNs.store(0, std::memory_order_relaxed);
+        m_pauseMode = mode;
+
+        if (mode == PauseMode::StopStream)
+        {
+            // The pull thread parks instead of treating the stopped stream as grab errors
+            m_bStreamStopped.store(true);
+
+            CVS_ERROR status = m_pBackend->AcqStop(m_hDevice);
+            if (status != MCAM_ERR_OK)
+            {
+                m_bStreamStopped.store(false);
+                m_bPaused.store(false);
+                ReportError(status, "Failed to pause acquisition");
+                return false;
+            }
+        }
+
+        // No callback is inside the frame path once this returns
+        WaitForCallbacksIdle();
+
+        m_acquisitionState = AcquisitionState::Paused;
+        ReportStatus("Acquisition paused");
+        return true;
+    }
+
+    bool CameraController::Impl::ResumeAcquisition()
+    {
+        if (m_acquisitionState == AcquisitionState::Running)
+            return true;
+
+        if (m_acquisitionState != AcquisitionState::Paused)
+        {
+            ReportError(-1, "Acquisition not paused");
+            return false;
+        }
+
+        auto resumeTime = std::chrono::steady_clock::now();
+
+        // Gaps in blockID and the idle time while paused are not drops or grab waits
+        m_lastBlockID = 0;
+        m_lastGrabReturnNs.store(0, std::memory_order_relaxed);
+        m_resumeRequestNs.store(ToSteadyNs(resumeTime), std::memory_order_relaxed);
+        m_acquisitionState = AcquisitionState::Running;
+        m_bPaused.store(false);
+
+        if (m_pauseMode == PauseMode::StopStream)
+        {
+            CVS_ERROR status = m_pBackend->AcqStart(m_hDevice);
+            if (status != MCAM_ERR_OK)
+            {
+                m_bPaused.store(true);
+                m_resumeRequestNs.store(0, std::memory_order_relaxed);
+                m_acquisitionState = AcquisitionState::Paused;
+                ReportError(status, "Failed to resume acquisition");
+                return false;
+            }
+
+            m_bStreamStopped.store(false);
+            WakeGrabThread();
+        }
+
+        ReportStatus("Acquisition resumed");
+        return true;
+    }
+
+    bool CameraController::Impl::WaitForCallbacksIdle()
+    {
+        // Idle once the count is 0, or was 0 at any point since the gate closed: the pull
+        // thread re-enters for its next grab immediately, but no longer reaches the frame path
+        std::unique_lock<std::mutex> lock(m_shutdownMutex);
+        const uint64_t epoch = m_callbacksIdleEpoch;
+        return m_cvCallbackComplete.wait_for(lock,
+            std::chrono::seconds(CALLBACK_COMPLETE_TIMEOUT_SEC),
+            [this, epoch] { return m_activeCallbacks == 0 || m_callbacksIdleEpoch != epoch; });
+    }
+
+    // Affinity and priority for the calling thread; best effort
+    static bool ApplyThreadScheduling(int cpuCore, bool bHighPriority)
+    {
+        bool bApplied = true;
+
+#if defined(_WIN32)
+        if (cpuCore >= 0)
+        {
+            bApplied = SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpuCore) != 0 && bApplied;
+        }
+        if (bHighPriority)
+        {
+            bApplied = SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != FALSE && bApplied;
+        }
+#else
+#if defined(__linux__)
+        if (cpuCore >= 0)
+        {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(cpuCore, &cpus);
+            bApplied = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0 && bApplied;
+        }
+#endif
+        if (bHighPriority)
+        {
+            sched_param param;
+            memset(&param, 0, sizeof(param));
+            param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+            bApplied = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0 && bApplied;
+        }
+#endif
+
+        return bApplied;
+    }
+
+    bool CameraController::Impl::ShouldGrab() const
+    {
+        return m_bAcquiring.load() && !m_bStreamStopped.load();
+    }
+
+    void CameraController::Impl::WakeGrabThread()
+    {
+        std::lock_guard<std::mutex> lock(m_grabMutex);
+        m_cvGrab.notify_all();
+    }
+
+    void CameraController::Impl::StopGrabThread()
+    {
+        if (!m_grabThread.joinable())
+            return;
+
+        m_bStopGrabThread = true;
+        WakeGrabThread();
+        m_grabThread.join();
+        m_bStopGrabThread = false;
+    }
+
+    void CameraController::Impl::GrabThreadFunc()
+    {
+        if ((m_grabConfig.cpuCore >= 0 || m_grabConfig.highPriority) &&
+            !ApplyThreadScheduling(m_grabConfig.cpuCore, m_grabConfig.highPriority))
+        {
+            ReportStatus("Grab thread affinity/priority not applied");
+        }
+
+        while (!m_bStopGrabThread)
+        {
+            // Counted like a callback from here on, so stop/pause/reconfiguration (which clear
+            // m_bAcquiring, then WaitForCallbacksIdle) know when the driver buffers are free
+            m_activeCallbacks++;
+
+            if (!ShouldGrab())
+            {
+                // Stream stopped (reconfiguration or StopStream pause): park until it restarts
+                LeaveFrameCallback();
+
+                std::unique_lock<std::mutex> lock(m_grabMutex);
+                m_cvGrab.wait(lock, [this] { return m_bStopGrabThread || ShouldGrab(); });
+                continue;
+            }
+
+            CVS_BUFFER* pBuffer = m_bufferPool ?
+                m_bufferPool->WaitForBuffer(std::chrono::milliseconds(GRAB_ERROR_SLEEP_MS)) : nullptr;
+            if (!pBuffer)
+            {
+                LeaveFrameCallback();
+                continue;
+            }
+
+            // Blocks until the next frame or the SDK grab timeout
+            auto grabStart = std::chrono::steady_clock::now();
+            CVS_ERROR status = m_pBackend->GrabImage(m_hDevice, pBuffer);
+
+            if (status == MCAM_ERR_OK)
+            {
+                m_grabWaitHistogram.Record(std::chrono::steady_clock::now() - grabStart);
+                OnImageReceived(pBuffer);
+            }
+            else if (status != MCAM_ERR_TIMEOUT && ShouldGrab())
+            {
+                // Timeouts are normal in trigger mode; anything else backs off, waking early on stop
+                m_errorCount++;
+                ReportError(status, "Image grab failed");
+
+                std::unique_lock<std::mutex> lock(m_grabMutex);
+                m_cvGrab.wait_for(lock, std::chrono::milliseconds(GRAB_ERROR_SLEEP_MS),
+                    [this] { return m_bStopGrabThread.load(); });
+            }
+
+            m_bufferPool->ReleaseBuffer(pBuffer);
+            LeaveFrameCallback();
+        }
+    }
+
+    void CameraController::Impl::DeliverBurst(const std::shared_ptr<BurstCapture>& burst, bool bLookback)
+    {
+        BurstCallback callback;
+        {
+            std::lock_guard<std::mutex> cbLock(m_callbackMutex);
+            callback = bLookback ? m_lookbackCallback : m_burstCallback;
+        }
+
+        if (callback && !m_bShuttingDown)
+        {
+            try
+            {
+                callback(burst);
+            }
+            catch (...)
+            {
+                ReportError(-1, bLookback ? "Exception in look-back callback" : "Exception in burst callback");
+            }
+
+            // The frozen ring refills once the callback's copy is gone
+            if (bLookback)
+                m_lookbackRecorder.Handed(burst);
+        }
+
+        std::stringstream ss;
+        ss << (bLookback ? "Look-back captured: " : "Burst complete: ") << burst->GetFrameCount() << " frames, "
+            << burst->GetFramesMissed() << " missed";
+        ReportStatus(ss.str());
+    }
+
+    void CameraController::Impl::LeaveFrameCallback()
+    {
+        // Last one out signals a stop / shutdown waiting in WaitForCallbacksIdle
+        if (--m_activeCallbacks == 0 && (!m_bAcquiring || m_bPaused))
+        {
+            std::lock_guard<std::mutex> lock(m_shutdownMutex);
+            m_callbacksIdleEpoch++;
+            m_cvCallbackComplete.notify_all();
+        }
+    }
+
+    void CameraController::Impl::StaticGrabCallback(int32_t eventID, const CVS_BUFFER* pBuffer, void* pUserDefine)
+    {
+        if (eventID == EVENT_NEW_IMAGE && pUserDefine)
+        {
+            Impl* pImpl = static_cast<Impl*>(pUserDefine);
+
+            // Increment active callback count
+            pImpl->m_activeCallbacks++;
+
+            pImpl->RecordGrabWait(ToSteadyNs(std::chrono::steady_clock::now()));
+            pImpl->OnImageReceived(pBuffer);
+            pImpl->m_lastGrabReturnNs.store(ToSteadyNs(std::chrono::steady_clock::now()), std::memory_order_relaxed);
+
+            pImpl->LeaveFrameCallback();
+        }
+    }
+
+    void CameraController::Impl::OnImageReceived(const CVS_BUFFER* pBuffer)
+    {
+        // Early validation for real-time performance
+        if (!pBuffer || !pBuffer->image.pImage || m_bShuttingDown)
+            return;
+
+        // Check acquisition state with memory ordering
+        if (!m_bAcquiring.load(std::memory_order_acquire) || m_bPaused.load(std::memory_order_acquire))
+            return;
+
+        if (!m_frameRing)
+            return;
+
+        m_framesReceived.fetch_add(1, std::memory_order_relaxed);
+
+        // Buffer validation
+        if (pBuffer->image.width == 0 || pBuffer->image.height == 0)
+        {
+            m_framesDroppedInvalid++;
+            ReportError(-1, "Invalid image buffer dimensions");
+            return;
+        }
+
+        // Frames lost by the camera or transport show up as gaps in blockID
+        uint64_t lastBlockID = m_lastBlockID.exchange(pBuffer->blockID, std::memory_order_relaxed);
+        if (lastBlockID != 0 && pBuffer->blockID > lastBlockID + 1)
+        {
+            m_framesDroppedDevice += pBuffer->blockID - lastBlockID - 1;
+        }
+
+        PipelineFrame frame;
+        frame.captureTime = std::chrono::steady_clock::now();
+        frame.timings.receivedNs = ToSteadyNs(frame.captureTime);
+
+        // Start/resume-to-first-frame latency (one exchange per transition, relaxed loads per frame)
+        if (m_startRequestNs.load(std::memory_order_relaxed) != 0)
+        {
+            int64_t startNs = m_startRequestNs.exchange(0, std::memory_order_relaxed);
+            if (startNs != 0)
+                m_firstFrameHistogram.RecordNs(frame.timings.receivedNs - startNs);
+        }
+        if (m_resumeRequestNs.load(std::memory_order_relaxed) != 0)
+        {
+            int64_t resumeNs = m_resumeRequestNs.exchange(0, std::memory_order_relaxed);
+            if (resumeNs != 0)
+                m_resumeHistogram.RecordNs(frame.timings.receivedNs - resumeNs);
+        }
+
+        // Window the frame was exposed with (the tracking ROI may have moved it since)
+        GetRoiOrigin(pBuffer->blockID, frame.offsetX, frame.offsetY);
+
+        if (m_frameRecorder.IsRecording())
+        {
+            m_frameRecorder.Record(*pBuffer, frame.timings.receivedNs);
+        }
+
+        // Look-back ring sees every frame, burst or not
+        if (m_lookbackRecorder.IsEnabled())
+        {
+            std::shared_ptr<BurstCapture> completed;
+            m_lookbackRecorder.Record(*pBuffer, frame.timings.receivedNs, frame.offsetX, frame.offsetY, completed);
+            if (completed)
+            {
+                DeliverBurst(completed, true);
+            }
+        }
+
+        // Armed burst: the raw copy happens first, so the burst keeps up at sensor rate
+        if (m_burstRecorder.IsArmed())
+        {
+            std::shared_ptr<BurstCapture> completed;
+            bool bAborted = false;
+            if (m_burstRecorder.Record(*pBuffer, frame.timings.receivedNs, frame.offsetX, frame.offsetY,
+                completed, bAborted))
+            {
+                if (completed)
+                {
+                    DeliverBurst(completed, false);
+                }
+
+                if (!m_bBurstDeliverFrames.load(std::memory_order_relaxed))
+                    return;
+            }
+            else if (bAborted)
+            {
+                ReportError(-1, "Burst cancelled: frame size changed since it was armed");
+            }
+        }
+
+        // Software ROI: the driver frame is narrowed to the window (pointer and size only, nothing copied)
+        CVS_BUFFER received = *pBuffer;
+        {
+            RcuPointer<RoiRect>::ReadGuard roi(m_softwareRoi);
+            if (roi->width > 0 && roi->height > 0)
+            {
+                ImageProcessing::BayerPattern pattern;
+                const bool bBayer = GetBayerPattern(pattern) && received.image.channels <= 1;
+                int cropX, cropY;
+                CropBuffer(received, m_deviceState.GetRawFormat(), bBayer, *roi, cropX, cropY);
+                frame.offsetX += cropX;
+                frame.offsetY += cropY;
+            }
+        }
+
+        if (!m_bPipelineRunning)
+        {
+            // Inline: every stage on the grab thread, straight from the driver buffer
+            frame.raw = received;
+
+            auto stageStart = frame.captureTime;
+            bool bOk = ConvertFrame(frame);
+            auto stageEnd = std::chrono::steady_clock::now();
+            RecordStageTime(PIPELINE_STAGE_DEBAYER, stageEnd - stageStart);
+            frame.timings.debayerUs = ToMicroseconds(stageEnd - stageStart);
+            if (!bOk)
+            {
+                DiscardFrame(frame);
+                return;
+            }
+            m_stageCounters[PIPELINE_STAGE_DEBAYER].framesProcessed++;
+
+            stageStart = stageEnd;
+            PostProcessFrame(frame);
+            stageEnd = std::chrono::steady_clock::now();
+            RecordStageTime(PIPELINE_STAGE_POST_PROCESS, stageEnd - stageStart);
+            m_stageCounters[PIPELINE_STAGE_POST_PROCESS].framesProcessed++;
+
+            stageStart = stageEnd;
+            DeliverFrame(frame);
+            RecordStageTime(PIPELINE_STAGE_FAN_OUT, std::chrono::steady_clock::now() - stageStart);
+            m_stageCounters[PIPELINE_STAGE_FAN_OUT].framesProcessed++;
+            return;
+        }
+
+        // Pipelined: copy out of the driver buffer and hand off to the debayer worker
+        bool bCaptured = CaptureFrame(&received, frame);
+        auto captureElapsed = std::chrono::steady_clock::now() - frame.captureTime;
+        RecordStageTime(PIPELINE_STAGE_CAPTURE, captureElapsed);
+        frame.timings.captureUs = ToMicroseconds(captureElapsed);
+        if (!bCaptured)
+        {
+            m_stageCounters[PIPELINE_STAGE_CAPTURE].framesDropped++;
+            return;
+        }
+        m_stageCounters[PIPELINE_STAGE_CAPTURE].framesProcessed++;
+
+        EnqueueFrame(PIPELINE_STAGE_DEBAYER, frame);
+    }
+
+    bool CameraController::Impl::CaptureFrame(const CVS_BUFFER* pBuffer, PipelineFrame& frame)
+    {
+        const int channels = pBuffer->image.channels > 0 ? pBuffer->image.channels : 1;
+        const int rowBytes = GetBufferRowBytes(*pBuffer, m_deviceState.GetRawFormat());
+        const int srcStep = pBuffer->image.step >= rowBytes ? pBuffer->image.step : rowBytes;
+        const int height = pBuffer->image.height;
+
+        uint8_t* pData = nullptr;
+        frame.rawIndex = m_rawFramePool->Acquire(static_cast<size_t>(rowBytes) * height, pData);
+        if (frame.rawIndex == RawFramePool::INVALID_INDEX)
+            return false;
+
+        const uint8_t* pSrc = static_cast<const uint8_t*>(pBuffer->image.pImage);
+        if (srcStep == rowBytes)
+        {
+            memcpy(pData, pSrc, static_cast<size_t>(rowBytes) * height);
+        }
+        else
+        {
+            for (int y = 0; y < height; ++y)
+            {
+                memcpy(pData + static_cast<size_t>(y) * rowBytes, pSrc + static_cast<size_t>(y) * srcStep, rowBytes);
+            }
+        }
+
+        frame.raw = *pBuffer;
+        frame.raw.image.pImage = pData;
+        frame.raw.image.channels = channels;
+        frame.raw.image.step = rowBytes;
+        return true;
+    }
+
+    bool CameraController::Impl::ConvertFrame(PipelineFrame& frame)
+    {
+        FrameRing* pRing = m_frameRing.get();
+        CVS_BUFFER raw = frame.raw;
+        const int width = raw.image.width;
+        const int height = raw.image.height;
+        ImageProcessing::BayerPattern pattern = ImageProcessing::BayerPattern::RG;
+        const bool bBayer = GetBayerPattern(pattern) && raw.image.channels <= 1;
+        const int rawChannels = raw.image.channels > 0 ? raw.image.channels : 1;
+
+        // 10/12-bit samples are either kept (Mono16, no debayer) or reduced to 8 bits up front
+        ImageProcessing::RawFormat rawFormat = m_deviceState.GetRawFormat();
+        const bool bHighBitDepth = rawFormat.bitDepth > 8 && raw.image.channels <= 1;
+        RcuPointer<HighBitDepthState>::ReadGuard highBitDepth(m_highBitDepth);
+        const bool bKeep16 = bHighBitDepth && highBitDepth->config.mode == HighBitDepthMode::Keep16;
+        const bool bColor = bBayer && !bKeep16;
+        RcuPointer<ToneTables>::ReadGuard toneTables(m_toneTables);
+        bool bToneApplied = false;
+
+        // Colour frames use the configured layout, anything else is stored as delivered
+        const OutputFormat& output = m_outputFormat;
+        const int channels = bColor ? GetLayoutBytesPerPixel(output.layout) : rawChannels;
+        const int step = AlignRowBytes(width * (bKeep16 ? 2 : channels), output.rowAlignment);
+
+        // Claim an owned slot; the frame is dropped (and counted) if consumers pin every slot
+        uint8_t* pSlotData = nullptr;
+        frame.ringSlot = pRing->BeginWrite(static_cast<size_t>(step) * height, pSlotData);
+        if (frame.ringSlot == FrameRing::INVALID_SLOT)
+            return false;
+
+        // Bottom-up colour frames are written through a negative step starting at the last row
+        uint8_t* pFirstRow = output.bottomUp ? pSlotData + static_cast<size_t>(height - 1) * step : pSlotData;
+        const int rowStep = output.bottomUp ? -step : step;
+
+        ImageData& imageData = frame.imageData;
+        memset(&imageData, 0, sizeof(imageData));
+        imageData.pData = pSlotData;
+        imageData.width = width;
+        imageData.height = height;
+        imageData.step = step;
+        imageData.blockID = raw.blockID;
+        imageData.timestamp = raw.timestamp;
+        imageData.bottomUp = output.bottomUp;
+        imageData.bitDepth = 8;
+        imageData.offsetX = frame.offsetX;
+        imageData.offsetY = frame.offsetY;
+
+        bool bConverted = false;
+        if (bHighBitDepth)
+        {
+            const int rawRowBytes = GetBufferRowBytes(raw, rawFormat);
+            const int srcStep = raw.image.step >= rawRowBytes ? raw.image.step : rawRowBytes;
+            const uint8_t* pSrc = static_cast<const uint8_t*>(raw.image.pImage);
+            const int shift = highBitDepth->config.shift >= 0 ? highBitDepth->config.shift : rawFormat.bitDepth - 8;
+            const ImageProcessing::Lut12To8* pLut = highBitDepth->bLut ? &highBitDepth->lut : nullptr;
+
+            // With the default reduction the tone tables fold into the unpack, at full precision
+            // and on the mosaic, where the camera's own LUT would apply them
+            const bool bFoldTone = !pLut && highBitDepth->config.shift < 0 && !toneTables->lut12.bIdentity;
+            if (bFoldTone)
+                pLut = &toneTables->lut12To8;
+
+            if (bKeep16)
+            {
+                bConverted = ImageProcessing::UnpackRawToU16(pSrc, srcStep, reinterpret_cast<uint16_t*>(pFirstRow), rowStep,
+                    width, height, rawFormat, ImageProcessing::GetSimdLevel());
+                imageData.channels = 1;
+                imageData.layout = PixelLayout::Mono16;
+                imageData.bitDepth = rawFormat.bitDepth;
+            }
+            else if (!bColor)
+            {
+                // Mono: straight into the slot
+                bConverted = ImageProcessing::UnpackRawToU8(pSrc, srcStep, pFirstRow, rowStep,
+                    width, height, rawFormat, shift, pLut, ImageProcessing::GetSimdLevel());
+                bToneApplied = bConverted && bFoldTone;
+                imageData.channels = 1;
+                imageData.layout = PixelLayout::Mono8;
+            }
+            else
+            {
+                // Bayer: an 8-bit mosaic for the demosaic below
+                thread_local std::vector<uint8_t> mosaic;
+                mosaic.resize(static_cast<size_t>(width) * height);
+                if (ImageProcessing::UnpackRawToU8(pSrc, srcStep, mosaic.data(), width,
+                    width, height, rawFormat, shift, pLut, ImageProcessing::GetSimdLevel()))
+                {
+                    raw.image.pImage = mosaic.data();
+                    raw.image.step = width;
+                    rawFormat = { 8, false };
+                    bToneApplied = bFoldTone;
+                }
+            }
+        }
+
+        if (bColor && rawFormat.bitDepth == 8)
+        {
+            DemosaicMethod method = m_demosaicMethod.load(std::memory_order_relaxed);
+            const ImageProcessing::PackedFormat packedFormat = ToPackedFormat(output.layout);
+
+            if (method == DemosaicMethod::Vendor)
+            {
+                static const int32_t vendorCodes[] = {
+                    CVP_BayerRG2RGB, CVP_BayerGR2RGB, CVP_BayerGB2RGB, CVP_BayerBG2RGB };
+
+                // The SDK only writes packed top-down RGB; other layouts go through a scratch copy
+                const bool bDirect = output.layout == PixelLayout::RGB24 && step == width * 3 && !output.bottomUp;
+                thread_local std::vector<uint8_t> scratch;
+                if (!bDirect)
+                    scratch.resize(static_cast<size_t>(width) * height * 3);
+
+                // The SDK expects contiguous rows; a cropped driver frame is compacted first
+                if (raw.image.step > width)
+                {
+                    thread_local std::vector<uint8_t> compact;
+                    compact.resize(static_cast<size_t>(width) * height);
+                    for (int y = 0; y < height; ++y)
+                    {
+                        memcpy(compact.data() + static_cast<size_t>(y) * width,
+                            static_cast<const uint8_t*>(raw.image.pImage) + static_cast<size_t>(y) * raw.image.step, width);
+                    }
+                    raw.image.pImage = compact.data();
+                    raw.image.step = width;
+                }
+
+                CVS_BUFFER rgbBuffer;
+                memset(&rgbBuffer, 0, sizeof(rgbBuffer));
+                rgbBuffer.image.pImage = bDirect ? pSlotData : scratch.data();
+                rgbBuffer.image.width = width;
+                rgbBuffer.image.height = height;
+                rgbBuffer.image.channels = 3;
+                rgbBuffer.image.step = width * 3;
+
+                bConverted = (m_pBackend->CvtColor(raw, &rgbBuffer, vendorCodes[static_cast<int>(pattern)]) == MCAM_ERR_OK);
+                if (bConverted && !bDirect)
+                {
+                    bConverted = ImageProcessing::RepackRgb24(scratch.data(), width * 3,
+                        pFirstRow, rowStep, width, height, packedFormat);
+                }
+            }
+            else
+            {
+                // Single pass: demosaic, colour correction and tone tables straight into the slot
+                RcuPointer<ColorCorrectionState>::ReadGuard colorState(m_colorCorrection);
+
+                ImageProcessing::ColorPipeline color = {};
+                color.bColorMatrix = colorState->bActive;
+                memcpy(color.matrix, colorState->matrix, sizeof(color.matrix));
+                const bool bSoftwareTone = !bToneApplied && !toneTables->lut8.bIdentity;
+                color.pToneLut = bSoftwareTone ? &toneTables->lut8 : nullptr;
+
+                const int srcStep = raw.image.step > 0 ? raw.image.step : width;
+                bConverted = ImageProcessing::DemosaicFused(static_cast<const uint8_t*>(raw.image.pImage), srcStep,
+                    pFirstRow, rowStep, width, height, pattern, method,
+                    color, packedFormat, ImageProcessing::GetSimdLevel());
+                bToneApplied = bToneApplied || (bConverted && bSoftwareTone);
+            }
+
+            if (bConverted)
+            {
+                imageData.channels = channels;
+                imageData.layout = output.layout;
+            }
+        }
+
+        if (!bConverted)
+        {
+            // Raw data (mono, or fallback when conversion failed; the slot is large enough either way)
+            const int rowBytes = std::min(GetBufferRowBytes(raw, rawFormat), step);
+            const int srcStep = raw.image.step >= rowBytes ? raw.image.step : rowBytes;
+            const int dstStep = AlignRowBytes(rowBytes, output.rowAlignment);
+            const uint8_t* pSrc = static_cast<const uint8_t*>(raw.image.pImage);
+
+            if (srcStep == rowBytes && dstStep == rowBytes && !output.bottomUp)
+            {
+                memcpy(pSlotData, pSrc, static_cast<size_t>(rowBytes) * height);
+            }
+            else
+            {
+                for (int y = 0; y < height; ++y)
+                {
+                    int dstRow = output.bottomUp ? height - 1 - y : y;
+                    memcpy(pSlotData + static_cast<size_t>(dstRow) * dstStep, pSrc + static_cast<size_t>(y) * srcStep, rowBytes);
+                }
+            }
+
+            imageData.channels = rawChannels;
+            imageData.step = dstStep;
+            imageData.layout = rawChannels == 3 ? PixelLayout::RGB24 : PixelLayout::Mono8;
+            imageData.bitDepth = 8;
+        }
+        frame.bToneMapped = bToneApplied;
+
+        // Raw copy is no longer needed
+        if (frame.rawIndex != RawFramePool::INVALID_INDEX)
+        {
+            m_rawFramePool->Release(frame.rawIndex);
+            frame.rawIndex = RawFramePool::INVALID_INDEX;
+        }
+
+        return true;
+    }
+
+    bool CameraController::Impl::PostProcessFrame(PipelineFrame& frame)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ImageData& imageData = frame.imageData;
+
+        // Software gamma and tone curve (on the owned copy, never the driver buffer)
+        if (!frame.bToneMapped)
         {
-            if (CheckFeatureAvailable(name))
-            {
-                ReportStatus(std::string("Found gain control: ") + name);
-                return name;
-            }
+            ApplyToneToImage(imageData);
         }
 
-        return "";
+        frame.timings.postProcessUs = ToMicroseconds(std::chrono::steady_clock::now() - start);
+        imageData.timings = frame.timings;
+
+        // Publish; the slot stays pinned until the fan-out stage has run the callbacks
+        m_frameRing->Publish(frame.ringSlot, imageData);
+        frame.bPublished = true;
+
+        m_frameCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
     }
 
-    void CameraController::Impl::DetectAvailableFeatures()
+    void CameraController::Impl::DeliverFrame(PipelineFrame& frame)
     {
-        if (!m_bConnected)
-            return;
-
-        ReportStatus("Detecting available camera features...");
+        FrameRing* pRing = m_frameRing.get();
+        const ImageData& imageData = frame.imageData;
 
-        // Check for Exposure
-        m_bHasExposure = CheckFeatureAvailable("ExposureTime");
-        if (!m_bHasExposure)
+        // Get callbacks under lock to ensure thread safety
+        ImageCallback callback;
+        FrameCallback frameCallback;
         {
-            m_bHasExposure = CheckFeatureAvailable("ExposureTimeAbs");
+            std::lock_guard<std::mutex> cbLock(m_callbackMutex);
+            callback = m_imageCallback;
+            frameCallback = m_frameCallback;
         }
 
-        // Check for Gain (try multiple possible names)
-        m_gainNodeName = FindGainNodeName();
-        m_bHasGain = !m_gainNodeName.empty();
+        auto handoff = std::chrono::steady_clock::now();
+        m_endToEndHistogram.Record(handoff - frame.captureTime);
 
-        // Check for Frame Rate
-        m_bHasFrameRate = CheckFeatureAvailable("AcquisitionFrameRate");
-        if (!m_bHasFrameRate)
+        // Call the callbacks
+        if (callback && !m_bShuttingDown)
         {
-            m_bHasFrameRate = CheckFeatureAvailable("FrameRate");
+            try
+            {
+                callback(imageData);
+            }
+            catch (...)
+            {
+                // Prevent callback exceptions from crashing the system
+                ReportError(-1, "Exception in image callback");
+            }
         }
 
-        // Check for Gamma
-        m_bHasGamma = CheckGammaSupport();
-        if (!m_bHasGamma)
+        if (frameCallback && !m_bShuttingDown)
         {
-            ReportStatus("Hardware gamma not supported - using software gamma correction");
-            m_bSoftwareGammaEnabled = true;
+            try
+            {
+                // Consumers that copy the FrameRef keep the slot pinned past this call
+                FrameRef frameRef(pRing, frame.ringSlot, imageData);
+                frameCallback(frameRef);
+            }
+            catch (...)
+            {
+                ReportError(-1, "Exception in frame callback");
+            }
         }
 
-        // Report detected features
-        std::stringstream ss;
-        ss << "Features detected - ";
-        ss << "Exposure: " << (m_bHasExposure ? "Yes" : "No") << ", ";
-        ss << "Gain: " << (m_bHasGain ? "Yes" : "No");
-        if (m_bHasGain)
+        auto done = std::chrono::steady_clock::now();
+        if (callback || frameCallback)
+            m_callbackHistogram.Record(done - handoff);
+
+        m_endToEndLatency.Add(done - frame.captureTime);
+        DiscardFrame(frame);
+    }
+
+    void CameraController::Impl::DiscardFrame(PipelineFrame& frame)
+    {
+        if (frame.rawIndex != RawFramePool::INVALID_INDEX)
         {
-            ss << " (" << m_gainNodeName << ")";
+            m_rawFramePool->Release(frame.rawIndex);
+            frame.rawIndex = RawFramePool::INVALID_INDEX;
         }
-        ss << ", Frame Rate: " << (m_bHasFrameRate ? "Yes" : "No");
-        ss << ", Gamma: " << (m_bHasGamma ? "Hardware" : "Software");
 
-        ReportStatus(ss.str());
+        if (frame.ringSlot != FrameRing::INVALID_SLOT)
+        {
+            if (frame.bPublished)
+                m_frameRing->Release(frame.ringSlot);
+            else
+                m_frameRing->AbortWrite(frame.ringSlot);
+            frame.ringSlot = FrameRing::INVALID_SLOT;
+            frame.bPublished = false;
+        }
     }
 
-    void CameraController::Impl::GrabThreadFunc()
+    void CameraController::Impl::EnqueueFrame(size_t stage, PipelineFrame& frame)
     {
-        while (!m_bStopGrabThread)
+        frame.enqueueTime = std::chrono::steady_clock::now();
+
+        PipelineFrame dropped;
+        auto result = m_stageQueues[stage]->Push(std::move(frame), dropped);
+        if (result != BoundedQueue<PipelineFrame>::PushResult::Queued)
         {
-            CVS_BUFFER* pBuffer = m_bufferPool ? m_bufferPool->GetBuffer() : nullptr;
-            if (!pBuffer)
-            {
-                std::this_thread::sleep_for(std::chrono::milliseconds(GRAB_THREAD_SLEEP_MS));
-                continue;
-            }
+            // Evicted or rejected frame gives its buffers back
+            m_stageCounters[stage].framesDropped++;
+            DiscardFrame(dropped);
+        }
+    }
 
-            CVS_ERROR status = ST_GrabImage(m_hDevice, pBuffer);
+    void CameraController::Impl::PipelineWorker(size_t stage)
+    {
+        BoundedQueue<PipelineFrame>* pInput = m_stageQueues[stage].get();
+        PipelineStageCounters& counters = m_stageCounters[stage];
 
-            if (status == MCAM_ERR_OK)
-            {
-                OnImageReceived(pBuffer);
-            }
-            else if (status == MCAM_ERR_TIMEOUT)
+        PipelineFrame frame;
+        while (pInput->Pop(frame))
+        {
+            auto start = std::chrono::steady_clock::now();
+            counters.queueWait.Add(start - frame.enqueueTime);
+            if (stage != PIPELINE_STAGE_FAN_OUT)
+                frame.timings.queueWaitUs += ToMicroseconds(start - frame.enqueueTime);
+
+            bool bOk = true;
+            switch (stage)
             {
-                // Timeout is normal in trigger mode
-                std::this_thread::sleep_for(std::chrono::milliseconds(GRAB_THREAD_SLEEP_MS));
+            case PIPELINE_STAGE_DEBAYER:
+                bOk = ConvertFrame(frame);
+                frame.timings.debayerUs = ToMicroseconds(std::chrono::steady_clock::now() - start);
+                break;
+            case PIPELINE_STAGE_POST_PROCESS:
+                bOk = PostProcessFrame(frame);
+                break;
+            case PIPELINE_STAGE_FAN_OUT:
+                DeliverFrame(frame);
+                break;
             }
-            else
+
+            RecordStageTime(stage, std::chrono::steady_clock::now() - start);
+
+            if (!bOk)
             {
-                m_errorCount++;
-                ReportError(status, "Image grab failed");
-                std::this_thread::sleep_for(std::chrono::milliseconds(GRAB_ERROR_SLEEP_MS));
+                DiscardFrame(frame);
+                continue;
             }
+            counters.framesProcessed++;
 
-            if (m_bufferPool)
+            if (stage + 1 < PIPELINE_STAGE_COUNT)
             {
-                m_bufferPool->ReleaseBuffer(pBuffer);
+                EnqueueFrame(stage + 1, frame);
             }
         }
     }
 
-    void CameraController::Impl::StaticGrabCallback(int32_t eventID, const CVS_BUFFER* pBuffer, void* pUserDefine)
+    void CameraController::Impl::RecordStageTime(size_t stage, std::chrono::steady_clock::duration elapsed)
     {
-        if (eventID == EVENT_NEW_IMAGE && pUserDefine)
-        {
-            Impl* pImpl = static_cast<Impl*>(pUserDefine);
+        m_stageCounters[stage].process.Add(elapsed);
 
-            // Increment active callback count
-            pImpl->m_activeCallbacks++;
+        if (stage == PIPELINE_STAGE_DEBAYER)
+            m_debayerHistogram.Record(elapsed);
+        else if (stage == PIPELINE_STAGE_POST_PROCESS)
+            m_gammaHistogram.Record(elapsed);
+    }
 
-            pImpl->OnImageReceived(pBuffer);
+    void CameraController::Impl::RecordGrabWait(int64_t arrivalNs)
+    {
+        // Idle time of the driver's delivery thread since it returned from the previous frame
+        int64_t lastReturnNs = m_lastGrabReturnNs.load(std::memory_order_relaxed);
+        if (lastReturnNs != 0)
+            m_grabWaitHistogram.RecordNs(arrivalNs - lastReturnNs);
+    }
 
-            // Decrement and notify if shutting down
-            pImpl->m_activeCallbacks--;
-            if (pImpl->m_bShuttingDown && pImpl->m_activeCallbacks == 0)
-            {
-                pImpl->m_cvCallbackComplete.notify_all();
-            }
+    void CameraController::Impl::GetDropCounters(DropStatistics& drops)
+    {
+        memset(&drops, 0, sizeof(drops));
+        drops.device = m_framesDroppedDevice;
+        drops.invalidBuffer = m_framesDroppedInvalid;
+        drops.ringFull = m_frameRing ? m_frameRing->GetFramesDropped() : 0;
+        drops.rawPoolExhausted = m_stageCounters[PIPELINE_STAGE_CAPTURE].framesDropped;
+        for (size_t stage = PIPELINE_STAGE_DEBAYER; stage < PIPELINE_STAGE_COUNT; ++stage)
+        {
+            drops.queueOverflow += m_stageCounters[stage].framesDropped;
         }
+        drops.grabErrors = m_errorCount;
     }
 
-    void CameraController::Impl::OnImageReceived(const CVS_BUFFER* pBuffer)
+    void CameraController::Impl::ResetInstrumentation()
     {
-        // Early validation for real-time performance
-        if (!pBuffer || !pBuffer->image.pImage || m_bShuttingDown)
-            return;
+        std::lock_guard<std::mutex> lock(m_statisticsMutex);
+
+        m_grabWaitHistogram.Reset();
+        m_debayerHistogram.Reset();
+        m_gammaHistogram.Reset();
+        m_callbackHistogram.Reset();
+        m_endToEndHistogram.Reset();
+        m_framesReceived = 0;
+        m_lastGrabReturnNs = 0;
+
+        // Cumulative counters are shared with the other statistics, so keep a baseline instead
+        m_instrumentationFrameBase = m_frameCount;
+        GetDropCounters(m_dropBase);
+        m_instrumentationStart = std::chrono::steady_clock::now();
+    }
+
+    bool CameraController::Impl::StartPipeline()
+    {
+        for (auto& counters : m_stageCounters)
+        {
+            counters.Reset();
+        }
+        m_endToEndLatency.Reset();
 
-        // Use try_lock for real-time performance - skip frame if locked
-        std::unique_lock<std::mutex> lock(m_imageMutex, std::try_to_lock);
-        if (!lock.owns_lock())
-            return;  // Skip this frame to maintain real-time performance
+        if (!m_pipelineConfig.enabled)
+            return true;
 
-        // Check acquisition state with memory ordering
-        if (!m_bAcquiring.load(std::memory_order_acquire))
-            return;
+        size_t depth = m_pipelineConfig.queueDepth;
 
-        // Get callback under lock to ensure thread safety
-        ImageCallback callback;
+        // One raw copy per queued frame plus the ones being captured and debayered,
+        // and never fewer than the frames expected to be in flight at this frame rate
+        m_rawFramePool = std::make_unique<RawFramePool>(std::max(depth + 2, m_bufferPoolDepth),
+            m_deviceState.GetRawFrameBytes(),
+            m_bufferPoolConfig.lockMemory);
+
+        for (size_t stage = PIPELINE_STAGE_DEBAYER; stage < PIPELINE_STAGE_COUNT; ++stage)
         {
-            std::lock_guard<std::mutex> cbLock(m_callbackMutex);
-            callback = m_imageCallback;
+            m_stageQueues[stage] = std::make_unique<BoundedQueue<PipelineFrame>>(depth, m_pipelineConfig.queuePolicy);
         }
 
-        if (!callback)
+        for (size_t stage = PIPELINE_STAGE_DEBAYER; stage < PIPELINE_STAGE_COUNT; ++stage)
+        {
+            m_pipelineThreads.emplace_back(&Impl::PipelineWorker, this, stage);
+        }
+
+        m_bPipelineRunning = true;
+        return true;
+    }
+
+    void CameraController::Impl::StopPipeline()
+    {
+        if (!m_bPipelineRunning)
             return;
 
-        m_frameCount++;
+        // Close every queue so the workers exit
+        for (size_t stage = PIPELINE_STAGE_DEBAYER; stage < PIPELINE_STAGE_COUNT; ++stage)
+        {
+            m_stageQueues[stage]->Close();
+        }
 
-        // Calculate FPS
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastFpsTime).count();
-        if (elapsed >= STATISTICS_UPDATE_INTERVAL_MS)
+        for (auto& thread : m_pipelineThreads)
         {
-            m_currentFps = (m_frameCount - m_lastFrameCount) * 1000.0 / elapsed;
-            m_lastFrameCount = m_frameCount;
-            m_lastFpsTime = now;
+            if (thread.joinable())
+                thread.join();
         }
+        m_pipelineThreads.clear();
 
-        // Buffer validation
-        if (pBuffer->image.width == 0 || pBuffer->image.height == 0)
+        // Give back whatever was still queued
+        for (size_t stage = PIPELINE_STAGE_DEBAYER; stage < PIPELINE_STAGE_COUNT; ++stage)
         {
-            ReportError(-1, "Invalid image buffer dimensions");
-            return;
+            PipelineFrame frame;
+            while (m_stageQueues[stage]->TryPop(frame))
+            {
+                DiscardFrame(frame);
+            }
         }
 
-        // Zero-copy approach: directly use buffer data
-        m_lastImageData.width = pBuffer->image.width;
-        m_lastImageData.height = pBuffer->image.height;
-        m_lastImageData.step = pBuffer->image.step;
-        m_lastImageData.blockID = pBuffer->blockID;
-        m_lastImageData.timestamp = pBuffer->timestamp;
+        m_bPipelineRunning = false;
+    }
+
+    size_t CameraController::Impl::GetPipelineSlotCount() const
+    {
+        if (!m_pipelineConfig.enabled)
+            return 0;
+
+        // Queued for post-process and fan-out, plus one in each of the three workers
+        return m_pipelineConfig.queueDepth * 2 + 3;
+    }
+
+    void CameraController::Impl::UpdateBufferPoolDepth()
+    {
+        double fps = DEFAULT_FPS;
+        if (!GetFeatureValue(DEVICE_FEATURE_FRAME_RATE, fps) || fps <= 0.0)
+        {
+            fps = DEFAULT_FPS;
+        }
 
-        // Check if color conversion is needed
-        if (IsColorCamera() && m_rgbBuffer.image.pImage)
+        // Configured latency, else what the previous run measured (p99), else a default
+        double latencyMs = m_bufferPoolConfig.consumerLatencyMs;
+        if (latencyMs <= 0.0)
         {
-            // Validate buffer sizes before conversion
-            if (ValidateBufferSize(pBuffer, &m_rgbBuffer))
+            LatencyStatistics hold, endToEnd, callback;
+            if (m_bufferPool)
             {
-                // Convert Bayer to RGB
-                CVS_ERROR status = ST_CvtColor(*pBuffer, &m_rgbBuffer, CVP_BayerRG2RGB);
-                if (status == MCAM_ERR_OK)
-                {
-                    m_lastImageData.pData = (uint8_t*)m_rgbBuffer.image.pImage;
-                    m_lastImageData.channels = m_rgbBuffer.image.channels;
-                    m_lastImageData.width = m_rgbBuffer.image.width;
-                    m_lastImageData.height = m_rgbBuffer.image.height;
-                    m_lastImageData.step = m_rgbBuffer.image.step;
-
-                    // Apply software gamma correction if enabled
-                    if (m_bSoftwareGammaEnabled && !m_bHasGamma)
-                    {
-                        ApplyGammaToImage(m_lastImageData.pData,
-                            m_lastImageData.width,
-                            m_lastImageData.height,
-                            m_lastImageData.channels);
-                    }
-                }
-                else
-                {
-                    // Fall back to raw data
-                    m_lastImageData.pData = (uint8_t*)pBuffer->image.pImage;
-                    m_lastImageData.channels = pBuffer->image.channels;
-                }
+                m_bufferPool->GetHoldStatistics(hold);
             }
+            m_endToEndHistogram.GetStatistics(endToEnd);
+            m_callbackHistogram.GetStatistics(callback);
+
+            if (hold.count > 0)
+                latencyMs = hold.p99Us / 1000.0;
+            else if (endToEnd.count > 0)
+                latencyMs = (endToEnd.p99Us + callback.p99Us) / 1000.0;
             else
-            {
-                ReportError(-1, "RGB buffer size mismatch - using raw data");
-                m_lastImageData.pData = (uint8_t*)pBuffer->image.pImage;
-                m_lastImageData.channels = pBuffer->image.channels;
-            }
+                latencyMs = BUFFER_POOL_DEFAULT_LATENCY_MS;
         }
-        else
+
+        // Frames arriving while one is held, plus the one being filled
+        size_t depth = static_cast<size_t>(std::ceil(fps * latencyMs / 1000.0)) + 1;
+        m_bufferPoolDepth = std::min(std::max(depth, m_bufferPoolConfig.minBuffers), m_bufferPoolConfig.maxBuffers);
+        m_bufferPoolLatencyMs = latencyMs;
+
+        if (m_bufferPool)
+        {
+            m_bufferPool->SetTargetDepth(m_bufferPoolDepth);
+            m_bufferPool->ResetStatistics();
+        }
+    }
+
+    bool CameraController::Impl::PrepareLookback()
+    {
+        if (!m_lookbackConfig.enabled || !m_bConnected)
+        {
+            m_lookbackRecorder.Clear();
+            return true;
+        }
+
+        double fps = DEFAULT_FPS;
+        if (!GetFeatureValue(DEVICE_FEATURE_FRAME_RATE, fps) || fps <= 0.0)
+        {
+            fps = DEFAULT_FPS;
+        }
+
+        // Raw frames in the camera's pixel format
+        const size_t bytesPerFrame = m_deviceState.GetRawFrameBytes();
+        if (bytesPerFrame == 0)
+            return false;
+
+        size_t slotCount = SIZE_MAX;
+        if (m_lookbackConfig.durationSec > 0.0)
+            slotCount = static_cast<size_t>(std::ceil(m_lookbackConfig.durationSec * fps)) + m_lookbackConfig.postEventFrames;
+        if (m_lookbackConfig.maxBytes > 0)
+            slotCount = std::min(slotCount, m_lookbackConfig.maxBytes / bytesPerFrame);
+        if (m_lookbackConfig.maxFrames > 0)
+            slotCount = std::min<size_t>(slotCount, m_lookbackConfig.maxFrames);
+
+        if (slotCount <= m_lookbackConfig.postEventFrames)
+        {
+            ReportError(-1, "Look-back ring too small for the post-event frames");
+            m_lookbackRecorder.Clear();
+            return false;
+        }
+
+        const size_t previous = m_lookbackRecorder.GetCapacity();
+        if (!m_lookbackRecorder.Configure(slotCount, bytesPerFrame, m_lookbackConfig.postEventFrames,
+            m_deviceState.GetPixelFormat(), m_lookbackConfig.lockMemory))
+        {
+            ReportError(-1, "Failed to allocate look-back memory");
+            return false;
+        }
+
+        if (slotCount != previous)
         {
-            // Use raw data directly (zero-copy)
-            m_lastImageData.pData = (uint8_t*)pBuffer->image.pImage;
-            m_lastImageData.channels = pBuffer->image.channels;
+            std::stringstream ss;
+            ss << "Look-back ring: " << slotCount << " frames (" << (slotCount * bytesPerFrame >> 20) << " MB)";
+            ReportStatus(ss.str());
+        }
+        return true;
+    }
+
+    void CameraController::Impl::ReportError(int error, const std::string& context)
+    {
+        m_lastError = error;
 
-            // Apply gamma correction to grayscale images as well
-            if (m_bSoftwareGammaEnabled && !m_bHasGamma)
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        if (m_errorCallback && !m_bShuttingDown)
+        {
+            try
+            {
+                std::stringstream ss;
+                ss << context << " (Error: " << error << ")";
+                m_errorCallback(error, ss.str());
+            }
+            catch (...)
             {
-                ApplyGammaToImage(m_lastImageData.pData,
-                    m_lastImageData.width,
-                    m_lastImageData.height,
-                    m_lastImageData.channels);
+                // Ignore callback exceptions
             }
         }
+    }
 
-        // Release lock before callback for better performance
-        lock.unlock();
-
-        // Call the callback
-        if (callback && !m_bShuttingDown)
+    void CameraController::Impl::ReportStatus(const std::string& status)
+    {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        if (m_statusCallback && !m_bShuttingDown)
         {
             try
             {
-                callback(m_lastImageData);
+                m_statusCallback(status);
             }
             catch (...)
             {
-                // Prevent callback exceptions from crashing the system
-                ReportError(-1, "Exception in image callback");
+                // Ignore callback exceptions
             }
         }
     }
 
-    void CameraController::Impl::ReportError(int error, const std::string& context)
+    bool CameraController::Impl::GetBayerPattern(ImageProcessing::BayerPattern& pattern) const
     {
-        m_lastError = error;
+        // Per frame: cached at connect / SetPixelFormat, no register read
+        return m_deviceState.GetBayerPattern(pattern);
+    }
+
+    // FrameRef implementation
+    FrameRef::FrameRef()
+        : m_pRing(nullptr)
+        , m_slot(FrameRing::INVALID_SLOT)
+    {
+        memset(&m_imageData, 0, sizeof(m_imageData));
+    }
+
+    FrameRef::FrameRef(FrameRing* pRing, uint32_t slot, const ImageData& imageData)
+        : m_pRing(pRing)
+        , m_slot(slot)
+        , m_imageData(imageData)
+    {
+        if (m_pRing)
+        {
+            m_pRing->AddRef();
+            m_pRing->AddPin(m_slot);
+        }
+    }
+
+    FrameRef::FrameRef(const FrameRef& other)
+        : FrameRef(other.m_pRing, other.m_slot, other.m_imageData)
+    {
+    }
+
+    FrameRef::FrameRef(FrameRef&& other) noexcept
+        : m_pRing(other.m_pRing)
+        , m_slot(other.m_slot)
+        , m_imageData(other.m_imageData)
+    {
+        other.m_pRing = nullptr;
+        other.m_slot = FrameRing::INVALID_SLOT;
+    }
+
+    FrameRef& FrameRef::operator=(const FrameRef& other)
+    {
+        if (this != &other)
+        {
+            FrameRef copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    FrameRef& FrameRef::operator=(FrameRef&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_pRing = other.m_pRing;
+            m_slot = other.m_slot;
+            m_imageData = other.m_imageData;
+            other.m_pRing = nullptr;
+            other.m_slot = FrameRing::INVALID_SLOT;
+        }
+        return *this;
+    }
+
+    FrameRef::~FrameRef()
+    {
+        Reset();
+    }
+
+    void FrameRef::Reset()
+    {
+        if (m_pRing)
+        {
+            // Unpin before dropping the ring reference (the ring may be destroyed here)
+            FrameRing* pRing = m_pRing;
+            m_pRing = nullptr;
+            pRing->Release(m_slot);
+            pRing->ReleaseRef();
+        }
+        m_slot = FrameRing::INVALID_SLOT;
+        memset(&m_imageData, 0, sizeof(m_imageData));
+    }
+
+    // BurstCapture implementation
+    BurstCapture::BurstCapture()
+        : m_pImpl(std::make_unique<Impl>())
+    {
+    }
+
+    BurstCapture::~BurstCapture() = default;
+
+    size_t BurstCapture::GetFrameCount() const
+    {
+        return m_pImpl->frames.size();
+    }
+
+    const ImageData& BurstCapture::GetFrame(size_t index) const
+    {
+        return m_pImpl->frames[index];
+    }
+
+    const std::string& BurstCapture::GetPixelFormat() const
+    {
+        return m_pImpl->pixelFormat;
+    }
+
+    uint64_t BurstCapture::GetFramesMissed() const
+    {
+        return m_pImpl->framesMissed;
+    }
+
+    int64_t BurstCapture::GetDurationNs() const
+    {
+        if (m_pImpl->frames.empty())
+            return 0;
+
+        return m_pImpl->frames.back().timings.receivedNs - m_pImpl->frames.front().timings.receivedNs;
+    }
+
+    size_t BurstCapture::GetEventIndex() const
+    {
+        return m_pImpl->eventIndex;
+    }
+
+    // CameraController implementation
+    CameraController::CameraController()
+        : m_pImpl(std::make_unique<Impl>())
+    {
+    }
+
+    CameraController::~CameraController() = default;
 
-        std::lock_guard<std::mutex> lock(m_callbackMutex);
-        if (m_errorCallback && !m_bShuttingDown)
+    bool CameraController::SetDeviceBackend(DeviceBackendType type, const SimulatedCameraConfig& simulatedConfig)
+    {
+        if (m_pImpl->m_bSystemInitialized)
         {
-            try
-            {
-                std::stringstream ss;
-                ss << context << " (Error: " << error << ")";
-                m_errorCallback(error, ss.str());
-            }
-            catch (...)
-            {
-                // Ignore callback exceptions
-            }
+            m_pImpl->ReportError(-1, "Device backend cannot be changed while the system is initialized");
+            return false;
         }
-    }
 
-    void CameraController::Impl::ReportStatus(const std::string& status)
-    {
-        std::lock_guard<std::mutex> lock(m_callbackMutex);
-        if (m_statusCallback && !m_bShuttingDown)
+        switch (type)
         {
-            try
-            {
-                m_statusCallback(status);
-            }
-            catch (...)
-            {
-                // Ignore callback exceptions
-            }
+        case DeviceBackendType::CvsCamCtrl:
+#ifndef CVSBALLVISION_NO_CVSCAMCTRL
+            m_pImpl->m_pBackend = CreateCvsCamCtrlBackend();
+            break;
+#else
+            m_pImpl->ReportError(-1, "cvsCamCtrl backend not available in this build");
+            return false;
+#endif
+
+        case DeviceBackendType::Simulated:
+            m_pImpl->m_pBackend = CreateSimulatedBackend(simulatedConfig);
+            break;
+
+        case DeviceBackendType::Playback:
+            m_pImpl->ReportError(-1, "Playback backend needs a recording; use SetPlaybackBackend");
+            return false;
+
+        default:
+            return false;
         }
+
+        m_pImpl->m_backendType = type;
+        m_pImpl->ReportStatus(std::string("Device backend: ") + m_pImpl->m_pBackend->GetName());
+        return true;
     }
 
-    bool CameraController::Impl::IsColorCamera()
+    bool CameraController::SetPlaybackBackend(const PlaybackConfig& config)
     {
-        char pixelFormat[256] = { 0 };
-        uint32_t size = 256;
-        CVS_ERROR status = ST_GetEnumReg(m_hDevice, "PixelFormat", pixelFormat, &size);
+        if (m_pImpl->m_bSystemInitialized)
+        {
+            m_pImpl->ReportError(-1, "Device backend cannot be changed while the system is initialized");
+            return false;
+        }
 
-        if (status == MCAM_ERR_OK)
+        if (config.path.empty() || config.frameRate <= 0.0)
         {
-            std::string format(pixelFormat);
-            return (format.find("Bayer") != std::string::npos);
+            m_pImpl->ReportError(-1, "Invalid playback configuration");
+            return false;
         }
 
-        return false;
+        m_pImpl->m_pBackend = CreatePlaybackBackend(config);
+        m_pImpl->m_backendType = DeviceBackendType::Playback;
+        m_pImpl->ReportStatus("Device backend: Playback (" + config.path + ")");
+        return true;
     }
 
-    // CameraController implementation
-    CameraController::CameraController()
-        : m_pImpl(std::make_unique<Impl>())
+    DeviceBackendType CameraController::GetDeviceBackend() const
     {
+        return m_pImpl->m_backendType;
     }
 
-    CameraController::~CameraController() = default;
-
     bool CameraController::InitializeSystem()
     {
         if (m_pImpl->m_bSystemInitialized)
             return true;
 
-        CVS_ERROR status = ST_InitSystem();
+        CVS_ERROR status = m_pImpl->m_pBackend->InitSystem();
         if (status != MCAM_ERR_OK)
         {
             m_pImpl->ReportError(status, "Failed to initialize system");
@@ -1112,7 +3329,7 @@ namespace CvsBallVision
     {
         if (m_pImpl->m_bSystemInitialized)
         {
-            ST_FreeSystem();
+            m_pImpl->m_pBackend->FreeSystem();
             m_pImpl->m_bSystemInitialized = false;
             m_pImpl->ReportStatus("System freed");
         }
@@ -1131,7 +3348,7 @@ namespace CvsBallVision
             return false;
         }
 
-        CVS_ERROR status = ST_UpdateDevice(timeout);
+        CVS_ERROR status = m_pImpl->m_pBackend->UpdateDevice(timeout);
         if (status != MCAM_ERR_OK)
         {
             m_pImpl->ReportError(status, "Failed to update device list");
@@ -1150,7 +3367,7 @@ namespace CvsBallVision
             return cameras;
 
         uint32_t camNum = 0;
-        CVS_ERROR status = ST_GetAvailableCameraNum(&camNum);
+        CVS_ERROR status = m_pImpl->m_pBackend->GetAvailableCameraNum(&camNum);
 
         if (status != MCAM_ERR_OK || camNum == 0)
             return cameras;
@@ -1160,43 +3377,8 @@ namespace CvsBallVision
         for (uint32_t i = 0; i < camNum; i++)
         {
             CameraInfo info;
-            info.enumIndex = i;
-            info.isConnected = false;
-
-            char buffer[256];
-            uint32_t size;
-
-            // Get User ID
-            size = 256;
-            if (ST_GetEnumDeviceInfo(i, MCAM_DEVICEINFO_USER_ID, buffer, &size) == MCAM_ERR_OK)
-                info.userID = buffer;
-
-            // Get Model Name
-            size = 256;
-            if (ST_GetEnumDeviceInfo(i, MCAM_DEVICEINFO_MODEL_NAME, buffer, &size) == MCAM_ERR_OK)
-                info.modelName = buffer;
-
-            // Get Serial Number
-            size = 256;
-            if (ST_GetEnumDeviceInfo(i, MCAM_DEVICEINFO_SERIAL_NUMBER, buffer, &size) == MCAM_ERR_OK)
-                info.serialNumber = buffer;
-
-            // Get Device Version
-            size = 256;
-            if (ST_GetEnumDeviceInfo(i, MCAM_DEVICEINFO_DEVICE_VERSION, buffer, &size) == MCAM_ERR_OK)
-                info.deviceVersion = buffer;
-
-            // Get IP Address (GigE only)
-            size = 256;
-            if (ST_GetEnumDeviceInfo(i, MCAM_DEVICEINFO_IP_ADDRESS, buffer, &size) == MCAM_ERR_OK)
-                info.ipAddress = buffer;
-
-            // Get MAC Address (GigE only)
-            size = 256;
-            if (ST_GetEnumDeviceInfo(i, MCAM_DEVICEINFO_MAC_ADDRESS, buffer, &size) == MCAM_ERR_OK)
-                info.macAddress = buffer;
-
-            cameras.push_back(info);
+            if (m_pImpl->m_pBackend->GetDeviceInfo(i, info) == MCAM_ERR_OK)
+                cameras.push_back(info);
         }
 
         return cameras;
@@ -1215,7 +3397,7 @@ namespace CvsBallVision
             DisconnectCamera();
         }
 
-        CVS_ERROR status = ST_OpenDevice(enumIndex, &m_pImpl->m_hDevice);
+        CVS_ERROR status = m_pImpl->m_pBackend->OpenDevice(enumIndex, &m_pImpl->m_hDevice);
         if (status != MCAM_ERR_OK)
         {
             m_pImpl->ReportError(status, "Failed to open device");
@@ -1225,47 +3407,35 @@ namespace CvsBallVision
         m_pImpl->m_bConnected = true;
 
         // Initialize buffer pool
-        m_pImpl->m_bufferPool = std::make_unique<ImageBufferPool>(m_pImpl->m_hDevice, BUFFER_POOL_SIZE);
+        m_pImpl->m_bufferPool = std::make_unique<ImageBufferPool>(m_pImpl->m_pBackend.get(),
+            m_pImpl->m_hDevice, m_pImpl->m_bufferPoolDepth, m_pImpl->m_bufferPoolConfig.maxBuffers);
 
-        // Detect available features
+        // Detect available features and cache the current configuration
         m_pImpl->DetectAvailableFeatures();
+        m_pImpl->LoadDeviceState();
 
-        // Get current resolution
-        int64_t width, height;
-        ST_GetIntReg(m_pImpl->m_hDevice, "Width", &width);
-        ST_GetIntReg(m_pImpl->m_hDevice, "Height", &height);
-        m_pImpl->m_currentWidth = static_cast<int>(width);
-        m_pImpl->m_currentHeight = static_cast<int>(height);
-
-        // Initialize RGB buffer if color camera
-        if (m_pImpl->IsColorCamera())
+        // Set default parameters (recordings keep their own geometry and pacing)
+        if (m_pImpl->m_backendType != DeviceBackendType::Playback)
         {
-            // RGB buffer initialization
-            status = ST_InitBuffer(m_pImpl->m_hDevice, &m_pImpl->m_rgbBuffer, 3);
-            if (status != MCAM_ERR_OK)
+            SetResolution(DEFAULT_WIDTH, DEFAULT_HEIGHT);
+
+            // Only set frame rate if supported
+            if (m_pImpl->m_deviceState.HasFeature(DEVICE_FEATURE_FRAME_RATE))
             {
-                m_pImpl->ReportError(status, "Failed to initialize RGB buffer");
-                // Not critical, continue
+                SetFrameRate(DEFAULT_FPS);
             }
         }
 
-        // Set default parameters
-        SetResolution(DEFAULT_WIDTH, DEFAULT_HEIGHT);
-
-        // Only set frame rate if supported
-        if (m_pImpl->m_bHasFrameRate)
-        {
-            SetFrameRate(DEFAULT_FPS);
-        }
-
         // Register callback
-        status = ST_RegisterGrabCallback(m_pImpl->m_hDevice, EVENT_NEW_IMAGE,
+        status = m_pImpl->m_pBackend->RegisterGrabCallback(m_pImpl->m_hDevice,
             Impl::StaticGrabCallback, m_pImpl.get());
         if (status == MCAM_ERR_OK)
         {
             m_pImpl->m_bCallbackRegistered = true;
         }
 
+        m_pImpl->PrepareLookback();
+
         m_pImpl->ReportStatus("Camera connected successfully");
         return true;
     }
@@ -1275,30 +3445,36 @@ namespace CvsBallVision
         if (!m_pImpl->m_bConnected)
             return true;
 
-        if (m_pImpl->m_bAcquiring)
+        // The window goes with the camera; nothing to restore
+        m_pImpl->StopTracking();
+        m_pImpl->m_trackingConfig.enabled = false;
+
+        if (m_pImpl->m_acquisitionState != AcquisitionState::Idle)
         {
             StopAcquisition();
         }
 
         if (m_pImpl->m_bCallbackRegistered)
         {
-            ST_UnregisterGrabCallback(m_pImpl->m_hDevice, EVENT_NEW_IMAGE);
+            m_pImpl->m_pBackend->UnregisterGrabCallback(m_pImpl->m_hDevice);
             m_pImpl->m_bCallbackRegistered = false;
         }
 
+        m_pImpl->m_burstRecorder.Cancel();
+        m_pImpl->m_lookbackRecorder.Clear();
+        StopRecording();
+
         // Clear buffer pool
         if (m_pImpl->m_bufferPool)
         {
             m_pImpl->m_bufferPool.reset();
         }
 
-        if (m_pImpl->m_rgbBuffer.image.pImage)
-        {
-            ST_FreeBuffer(&m_pImpl->m_rgbBuffer);
-            memset(&m_pImpl->m_rgbBuffer, 0, sizeof(m_pImpl->m_rgbBuffer));
-        }
+        // Release frame ring (outstanding FrameRefs keep their slots alive)
+        m_pImpl->ReleaseReaderFrame();
+        m_pImpl->m_frameRing.reset();
 
-        CVS_ERROR status = ST_CloseDevice(m_pImpl->m_hDevice);
+        CVS_ERROR status = m_pImpl->m_pBackend->CloseDevice(m_pImpl->m_hDevice);
         if (status != MCAM_ERR_OK)
         {
             m_pImpl->ReportError(status, "Failed to close device");
@@ -1307,577 +3483,1038 @@ namespace CvsBallVision
 
         m_pImpl->m_hDevice = -1;
         m_pImpl->m_bConnected = false;
-        m_pImpl->m_bHasGain = false;
-        m_pImpl->m_bHasExposure = false;
-        m_pImpl->m_bHasFrameRate = false;
-        m_pImpl->m_bHasGamma = false;
-        m_pImpl->m_gainNodeName.clear();
-        m_pImpl->m_gammaNodeName.clear();
+        m_pImpl->m_deviceState.Clear();
+
+        // A hardware tone curve falls back to the host until the next camera takes it
+        {
+            std::lock_guard<std::mutex> lock(m_pImpl->m_toneMutex);
+            m_pImpl->m_bHardwareLut = false;
+            m_pImpl->m_bHardwareLutActive = false;
+            m_pImpl->m_hardwareLut.clear();
+            m_pImpl->UpdateToneTables();
+        }
 
         m_pImpl->ReportStatus("Camera disconnected");
         return true;
     }
 
-    bool CameraController::IsConnected() const
+    bool CameraController::IsConnected() const
+    {
+        return m_pImpl->m_bConnected;
+    }
+
+    bool CameraController::StartAcquisition()
+    {
+        return m_pImpl->StartAcquisition();
+    }
+
+    bool CameraController::StopAcquisition()
+    {
+        return m_pImpl->StopAcquisition();
+    }
+
+    bool CameraController::IsAcquiring() const
+    {
+        return m_pImpl->m_bAcquiring.load(std::memory_order_acquire);
+    }
+
+    bool CameraController::PauseAcquisition(PauseMode mode)
+    {
+        return m_pImpl->PauseAcquisition(mode);
+    }
+
+    bool CameraController::ResumeAcquisition()
+    {
+        return m_pImpl->ResumeAcquisition();
+    }
+
+    bool CameraController::IsPaused() const
+    {
+        return m_pImpl->m_acquisitionState.load(std::memory_order_acquire) == AcquisitionState::Paused;
+    }
+
+    AcquisitionState CameraController::GetAcquisitionState() const
+    {
+        return m_pImpl->m_acquisitionState.load(std::memory_order_acquire);
+    }
+
+    void CameraController::GetAcquisitionTransitions(AcquisitionTransitionStatistics& stats)
+    {
+        m_pImpl->m_startHistogram.GetStatistics(stats.start);
+        m_pImpl->m_firstFrameHistogram.GetStatistics(stats.firstFrame);
+        m_pImpl->m_stopHistogram.GetStatistics(stats.stop);
+        m_pImpl->m_resumeHistogram.GetStatistics(stats.resume);
+        stats.drainTimeouts = m_pImpl->m_drainTimeouts.load(std::memory_order_relaxed);
+    }
+
+    bool CameraController::ArmBurst(const BurstConfig& config)
+    {
+        if (!m_pImpl->m_bConnected)
+        {
+            m_pImpl->ReportError(-1, "Camera not connected");
+            return false;
+        }
+
+        if (config.frameCount < 1 || config.frameCount > BURST_MAX_FRAMES)
+        {
+            m_pImpl->ReportError(-1, "Burst frame count out of range");
+            return false;
+        }
+
+        // Raw frames at the current resolution and pixel format
+        const size_t bytesPerFrame = m_pImpl->m_deviceState.GetRawFrameBytes();
+        m_pImpl->m_bBurstDeliverFrames.store(config.deliverFrames, std::memory_order_relaxed);
+        if (!m_pImpl->m_burstRecorder.Arm(config.frameCount, bytesPerFrame,
+            m_pImpl->m_deviceState.GetPixelFormat(), config.lockMemory))
+        {
+            m_pImpl->ReportError(-1, "Failed to allocate burst memory");
+            return false;
+        }
+
+        std::stringstream ss;
+        ss << "Burst armed: " << config.frameCount << " frames";
+        m_pImpl->ReportStatus(ss.str());
+        return true;
+    }
+
+    void CameraController::CancelBurst()
+    {
+        m_pImpl->m_burstRecorder.Cancel();
+    }
+
+    bool CameraController::IsBurstArmed() const
+    {
+        return m_pImpl->m_burstRecorder.IsArmed();
+    }
+
+    std::shared_ptr<BurstCapture> CameraController::WaitForBurst(uint32_t timeoutMs)
+    {
+        return m_pImpl->m_burstRecorder.Wait(timeoutMs);
+    }
+
+    bool CameraController::SetLookbackConfig(const LookbackConfig& config)
+    {
+        if (config.durationSec < 0.0)
+        {
+            m_pImpl->ReportError(-1, "Invalid look-back duration");
+            return false;
+        }
+
+        if (config.enabled && config.durationSec <= 0.0 && config.maxBytes == 0 && config.maxFrames == 0)
+        {
+            m_pImpl->ReportError(-1, "Look-back ring needs a duration, byte or frame limit");
+            return false;
+        }
+
+        m_pImpl->m_lookbackConfig = config;
+        return m_pImpl->PrepareLookback();
+    }
+
+    LookbackConfig CameraController::GetLookbackConfig() const
+    {
+        return m_pImpl->m_lookbackConfig;
+    }
+
+    size_t CameraController::GetLookbackCapacity() const
+    {
+        return m_pImpl->m_lookbackRecorder.GetCapacity();
+    }
+
+    bool CameraController::TriggerLookbackEvent()
+    {
+        if (!m_pImpl->m_lookbackRecorder.IsEnabled())
+        {
+            m_pImpl->ReportError(-1, "Look-back recording not enabled");
+            return false;
+        }
+
+        std::shared_ptr<BurstCapture> completed;
+        if (!m_pImpl->m_lookbackRecorder.TriggerEvent(completed))
+        {
+            m_pImpl->ReportError(-1, "Look-back event already pending or previous capture still held");
+            return false;
+        }
+
+        if (completed)
+        {
+            m_pImpl->DeliverBurst(completed, true);
+        }
+        return true;
+    }
+
+    std::shared_ptr<BurstCapture> CameraController::WaitForLookback(uint32_t timeoutMs)
+    {
+        return m_pImpl->m_lookbackRecorder.Wait(timeoutMs);
+    }
+
+    bool CameraController::StartRecording(const RecordingConfig& config)
+    {
+        if (!m_pImpl->m_bConnected)
+        {
+            m_pImpl->ReportError(-1, "Camera not connected");
+            return false;
+        }
+
+        // Raw frames at the current resolution and pixel format
+        const size_t maxFrameBytes = m_pImpl->m_deviceState.GetRawFrameBytes();
+        Impl* pImpl = m_pImpl.get();
+
+        std::string error;
+        if (!m_pImpl->m_frameRecorder.Start(config, maxFrameBytes, m_pImpl->m_deviceState.GetPixelFormat(),
+            [pImpl](const std::string& message) { pImpl->ReportError(-1, message); }, error))
+        {
+            m_pImpl->ReportError(-1, error);
+            return false;
+        }
+
+        m_pImpl->ReportStatus("Recording started: " + config.path);
+        return true;
+    }
+
+    bool CameraController::StopRecording()
+    {
+        if (!m_pImpl->m_frameRecorder.IsRecording())
+            return true;
+
+        if (!m_pImpl->m_frameRecorder.Stop())
+        {
+            m_pImpl->ReportError(-1, "Recording finished with write errors");
+            return false;
+        }
+
+        RecordingStatistics stats;
+        m_pImpl->m_frameRecorder.GetStatistics(stats);
+
+        std::stringstream ss;
+        ss << "Recording stopped: " << stats.framesRecorded << " frames, " << stats.framesDropped << " dropped";
+        m_pImpl->ReportStatus(ss.str());
+        return true;
+    }
+
+    bool CameraController::IsRecording() const
+    {
+        return m_pImpl->m_frameRecorder.IsRecording();
+    }
+
+    void CameraController::GetRecordingStatistics(RecordingStatistics& stats)
+    {
+        m_pImpl->m_frameRecorder.GetStatistics(stats);
+    }
+
+    bool CameraController::SetResolution(int width, int height)
+    {
+        return m_pImpl->SetResolutionOptimized(width, height);
+    }
+
+    bool CameraController::GetResolution(int& width, int& height)
+    {
+        if (!m_pImpl->m_bConnected)
+            return false;
+
+        width = m_pImpl->m_deviceState.GetWidth();
+        height = m_pImpl->m_deviceState.GetHeight();
+        return true;
+    }
+
+    bool CameraController::SetSoftwareROI(const RoiRect& roi)
+    {
+        if (roi.x < 0 || roi.y < 0 || roi.width < 0 || roi.height < 0)
+        {
+            m_pImpl->ReportError(-1, "Invalid software ROI");
+            return false;
+        }
+
+        // Takes effect from the next frame
+        m_pImpl->m_softwareRoi.Update(std::unique_ptr<RoiRect>(new RoiRect(roi)));
+        return true;
+    }
+
+    RoiRect CameraController::GetSoftwareROI() const
+    {
+        RcuPointer<RoiRect>::ReadGuard roi(m_pImpl->m_softwareRoi);
+        return *roi;
+    }
+
+    bool CameraController::MoveHardwareROI(int offsetX, int offsetY)
+    {
+        return m_pImpl->MoveHardwareROI(offsetX, offsetY);
+    }
+
+    bool CameraController::GetHardwareROI(RoiRect& roi)
+    {
+        if (!m_pImpl->m_bConnected)
+            return false;
+
+        m_pImpl->m_deviceState.GetOffset(roi.x, roi.y);
+        roi.width = m_pImpl->m_deviceState.GetWidth();
+        roi.height = m_pImpl->m_deviceState.GetHeight();
+        return true;
+    }
+
+    bool CameraController::SetTrackingROI(const TrackingRoiConfig& config)
+    {
+        return m_pImpl->SetTrackingROI(config);
+    }
+
+    TrackingRoiConfig CameraController::GetTrackingROI() const
+    {
+        return m_pImpl->m_trackingConfig;
+    }
+
+    bool CameraController::SetTrackingTarget(double x, double y)
+    {
+        if (!std::isfinite(x) || !std::isfinite(y))
+            return false;
+
+        {
+            std::lock_guard<std::mutex> lock(m_pImpl->m_trackingMutex);
+            if (!m_pImpl->m_bTrackingActive)
+                return false;
+
+            if (m_pImpl->m_bTrackingTarget)
+                m_pImpl->m_trackingCoalesced++;
+
+            m_pImpl->m_trackingX = x;
+            m_pImpl->m_trackingY = y;
+            m_pImpl->m_trackingTargetNs = ToSteadyNs(std::chrono::steady_clock::now());
+            m_pImpl->m_bTrackingTarget = true;
+        }
+        m_pImpl->m_trackingTargets++;
+        m_pImpl->m_cvTracking.notify_one();
+        return true;
+    }
+
+    void CameraController::GetTrackingStatistics(TrackingRoiStatistics& stats)
     {
-        return m_pImpl->m_bConnected;
+        memset(&stats, 0, sizeof(stats));
+        stats.targets = m_pImpl->m_trackingTargets.load(std::memory_order_relaxed);
+        stats.coalesced = m_pImpl->m_trackingCoalesced.load(std::memory_order_relaxed);
+        stats.moves = m_pImpl->m_trackingMoves.load(std::memory_order_relaxed);
+        stats.unchanged = m_pImpl->m_trackingUnchanged.load(std::memory_order_relaxed);
+        stats.failures = m_pImpl->m_trackingFailures.load(std::memory_order_relaxed);
+        m_pImpl->m_trackingHistogram.GetStatistics(stats.moveLatency);
     }
 
-    bool CameraController::StartAcquisition()
+    bool CameraController::SetExposureTime(double exposureTimeUs)
     {
         if (!m_pImpl->m_bConnected)
-        {
-            m_pImpl->ReportError(-1, "Camera not connected");
             return false;
-        }
-
-        if (m_pImpl->m_bAcquiring)
-            return true;
-
-        // Reset buffer pool state
-        if (m_pImpl->m_bufferPool)
-        {
-            m_pImpl->m_bufferPool->ResetBuffers();
-        }
-
-        // Initialize image data
-        {
-            std::lock_guard<std::mutex> lock(m_pImpl->m_imageMutex);
-            memset(&m_pImpl->m_lastImageData, 0, sizeof(m_pImpl->m_lastImageData));
-            m_pImpl->m_pCurrentBuffer = nullptr;
-        }
 
-        // Register callback if not already registered
-        if (!m_pImpl->m_bCallbackRegistered)
+        if (!m_pImpl->m_deviceState.HasFeature(DEVICE_FEATURE_EXPOSURE))
         {
-            CVS_ERROR status = ST_RegisterGrabCallback(m_pImpl->m_hDevice, EVENT_NEW_IMAGE,
-                Impl::StaticGrabCallback, m_pImpl.get());
-            if (status == MCAM_ERR_OK)
-            {
-                m_pImpl->m_bCallbackRegistered = true;
-            }
-            else
-            {
-                m_pImpl->ReportError(status, "Failed to register callback");
-                return false;
-            }
+            m_pImpl->ReportStatus("Exposure control not available on this camera");
+            return false;
         }
 
-        // Hardware preparation time
-        std::this_thread::sleep_for(std::chrono::milliseconds(HARDWARE_PREP_TIME_MS));
-
-        CVS_ERROR status = ST_AcqStart(m_pImpl->m_hDevice);
+        CVS_ERROR status = m_pImpl->SetFeatureValue(DEVICE_FEATURE_EXPOSURE, exposureTimeUs);
         if (status != MCAM_ERR_OK)
         {
-            m_pImpl->ReportError(status, "Failed to start acquisition");
+            m_pImpl->ReportError(status, "Failed to set exposure time");
             return false;
         }
 
-        m_pImpl->m_bAcquiring.store(true, std::memory_order_release);
-        m_pImpl->m_frameCount = 0;
-        m_pImpl->m_errorCount = 0;
-        m_pImpl->m_lastFrameCount = 0;
-        m_pImpl->m_lastFpsTime = std::chrono::steady_clock::now();
-
-        m_pImpl->ReportStatus("Acquisition started");
         return true;
     }
 
-    bool CameraController::StopAcquisition()
+    bool CameraController::GetExposureTime(double& exposureTimeUs)
     {
-        if (!m_pImpl->m_bAcquiring)
-            return true;
-
-        // Stop grab thread if running
-        if (m_pImpl->m_grabThread.joinable())
-        {
-            m_pImpl->m_bStopGrabThread = true;
-            m_pImpl->m_grabThread.join();
-            m_pImpl->m_bStopGrabThread = false;
-        }
+        return m_pImpl->GetFeatureValue(DEVICE_FEATURE_EXPOSURE, exposureTimeUs);
+    }
 
-        // Set flag first
-        m_pImpl->m_bAcquiring.store(false, std::memory_order_release);
+    bool CameraController::GetExposureTimeRange(double& min, double& max)
+    {
+        return m_pImpl->GetFeatureRange(DEVICE_FEATURE_EXPOSURE, min, max);
+    }
 
-        CVS_ERROR status = ST_AcqStop(m_pImpl->m_hDevice);
-        if (status != MCAM_ERR_OK)
-        {
-            m_pImpl->ReportError(status, "Failed to stop acquisition");
+    bool CameraController::SetGain(double gain)
+    {
+        if (!m_pImpl->m_bConnected)
             return false;
-        }
-
-        // Wait for camera to fully stop
-        std::this_thread::sleep_for(std::chrono::milliseconds(CAMERA_STOP_WAIT_MS));
-
-        // Reset buffer pool
-        if (m_pImpl->m_bufferPool)
-        {
-            m_pImpl->m_bufferPool->ResetBuffers();
-        }
 
-        // Clear image data
+        if (!m_pImpl->m_deviceState.HasFeature(DEVICE_FEATURE_GAIN))
         {
-            std::lock_guard<std::mutex> lock(m_pImpl->m_imageMutex);
-            memset(&m_pImpl->m_lastImageData, 0, sizeof(m_pImpl->m_lastImageData));
-            m_pImpl->m_pCurrentBuffer = nullptr;
+            m_pImpl->ReportStatus("Gain control not available on this camera");
+            return false;
         }
 
-        // Unregister callback for next start
-        if (m_pImpl->m_bCallbackRegistered)
+        CVS_ERROR status = m_pImpl->SetFeatureValue(DEVICE_FEATURE_GAIN, gain);
+        if (status != MCAM_ERR_OK)
         {
-            ST_UnregisterGrabCallback(m_pImpl->m_hDevice, EVENT_NEW_IMAGE);
-            m_pImpl->m_bCallbackRegistered = false;
-            std::this_thread::sleep_for(std::chrono::milliseconds(CALLBACK_UNREGISTER_DELAY_MS));
+            m_pImpl->ReportError(status, "Failed to set gain");
+            return false;
         }
 
-        m_pImpl->ReportStatus("Acquisition stopped");
         return true;
     }
 
-    bool CameraController::IsAcquiring() const
+    bool CameraController::GetGain(double& gain)
     {
-        return m_pImpl->m_bAcquiring.load(std::memory_order_acquire);
+        return m_pImpl->GetFeatureValue(DEVICE_FEATURE_GAIN, gain);
     }
 
-    bool CameraController::SetResolution(int width, int height)
+    bool CameraController::GetGainRange(double& min, double& max)
     {
-        return m_pImpl->SetResolutionOptimized(width, height);
+        return m_pImpl->GetFeatureRange(DEVICE_FEATURE_GAIN, min, max);
     }
 
-    bool CameraController::GetResolution(int& width, int& height)
+    bool CameraController::SetFrameRate(double fps)
     {
         if (!m_pImpl->m_bConnected)
             return false;
 
-        int64_t w, h;
-        CVS_ERROR status = ST_GetIntReg(m_pImpl->m_hDevice, "Width", &w);
-        if (status != MCAM_ERR_OK)
+        if (!m_pImpl->m_deviceState.HasFeature(DEVICE_FEATURE_FRAME_RATE))
+        {
+            m_pImpl->ReportStatus("Frame rate control not available on this camera");
             return false;
+        }
 
-        status = ST_GetIntReg(m_pImpl->m_hDevice, "Height", &h);
+        CVS_ERROR status = m_pImpl->SetFeatureValue(DEVICE_FEATURE_FRAME_RATE, fps);
         if (status != MCAM_ERR_OK)
+        {
+            m_pImpl->ReportError(status, "Failed to set frame rate");
             return false;
+        }
 
-        width = static_cast<int>(w);
-        height = static_cast<int>(h);
         return true;
     }
 
-    bool CameraController::SetExposureTime(double exposureTimeUs)
+    bool CameraController::GetFrameRate(double& fps)
+    {
+        return m_pImpl->GetFeatureValue(DEVICE_FEATURE_FRAME_RATE, fps);
+    }
+
+    bool CameraController::GetFrameRateRange(double& min, double& max)
+    {
+        return m_pImpl->GetFeatureRange(DEVICE_FEATURE_FRAME_RATE, min, max);
+    }
+
+    // Gamma control functions
+    bool CameraController::SetGamma(double gamma)
     {
         if (!m_pImpl->m_bConnected)
             return false;
 
-        if (!m_pImpl->m_bHasExposure)
+        // Range check
+        if (gamma < GAMMA_MIN || gamma > GAMMA_MAX)
         {
-            m_pImpl->ReportStatus("Exposure control not available on this camera");
+            m_pImpl->ReportError(-1, "Gamma value out of range");
             return false;
         }
 
-        CVS_ERROR status = ST_SetFloatReg(m_pImpl->m_hDevice, "ExposureTime", exposureTimeUs);
-        if (status != MCAM_ERR_OK)
+        // Try hardware gamma first
+        if (m_pImpl->m_deviceState.HasFeature(DEVICE_FEATURE_GAMMA))
         {
-            status = ST_SetFloatReg(m_pImpl->m_hDevice, "ExposureTimeAbs", exposureTimeUs);
-        }
+            CVS_ERROR status = m_pImpl->SetFeatureValue(DEVICE_FEATURE_GAMMA, gamma);
 
-        if (status != MCAM_ERR_OK)
-        {
-            m_pImpl->ReportError(status, "Failed to set exposure time");
+            if (status == MCAM_ERR_OK)
+            {
+                m_pImpl->m_currentGamma = gamma;
+                return true;
+            }
+
+            m_pImpl->ReportError(status, "Failed to set hardware gamma");
             return false;
         }
 
+        // Use software gamma
+        m_pImpl->UpdateGammaLUT(gamma);
+        m_pImpl->ReportStatus("Software gamma updated");
         return true;
     }
 
-    bool CameraController::GetExposureTime(double& exposureTimeUs)
+    bool CameraController::GetGamma(double& gamma)
     {
-        if (!m_pImpl->m_bConnected || !m_pImpl->m_bHasExposure)
+        if (!m_pImpl->m_bConnected)
             return false;
 
-        CVS_ERROR status = ST_GetFloatReg(m_pImpl->m_hDevice, "ExposureTime", &exposureTimeUs);
-        if (status != MCAM_ERR_OK)
+        if (m_pImpl->GetFeatureValue(DEVICE_FEATURE_GAMMA, gamma))
         {
-            status = ST_GetFloatReg(m_pImpl->m_hDevice, "ExposureTimeAbs", &exposureTimeUs);
+            m_pImpl->m_currentGamma = gamma;
+            return true;
         }
 
-        return (status == MCAM_ERR_OK);
+        gamma = m_pImpl->m_currentGamma;
+        return true;
     }
 
-    bool CameraController::GetExposureTimeRange(double& min, double& max)
+    bool CameraController::GetGammaRange(double& min, double& max)
     {
-        if (!m_pImpl->m_bConnected || !m_pImpl->m_bHasExposure)
-            return false;
+        if (m_pImpl->GetFeatureRange(DEVICE_FEATURE_GAMMA, min, max))
+            return true;
 
-        CVS_ERROR status = ST_GetFloatRegRange(m_pImpl->m_hDevice, "ExposureTime", &min, &max);
-        if (status != MCAM_ERR_OK)
-        {
-            status = ST_GetFloatRegRange(m_pImpl->m_hDevice, "ExposureTimeAbs", &min, &max);
-        }
+        // Software gamma (or no camera)
+        min = GAMMA_MIN;
+        max = GAMMA_MAX;
+        return true;
+    }
 
-        return (status == MCAM_ERR_OK);
+    bool CameraController::IsGammaSupported()
+    {
+        return m_pImpl->m_deviceState.HasFeature(DEVICE_FEATURE_GAMMA) || m_pImpl->m_bSoftwareGammaEnabled;
     }
 
-    bool CameraController::SetGain(double gain)
+    void CameraController::SetSoftwareGammaEnabled(bool enable)
     {
-        if (!m_pImpl->m_bConnected)
-            return false;
+        std::lock_guard<std::mutex> lock(m_pImpl->m_toneMutex);
+        m_pImpl->m_bSoftwareGammaEnabled = enable;
+        m_pImpl->UpdateToneTables();
+    }
 
-        if (!m_pImpl->m_bHasGain)
-        {
-            m_pImpl->ReportStatus("Gain control not available on this camera");
-            return false;
-        }
+    bool CameraController::IsSoftwareGammaEnabled()
+    {
+        return m_pImpl->m_bSoftwareGammaEnabled;
+    }
 
-        CVS_ERROR status = ST_SetFloatReg(m_pImpl->m_hDevice,
-            m_pImpl->m_gainNodeName.c_str(), gain);
+    bool CameraController::ApplyParameters(const CameraParameters& params)
+    {
+        return m_pImpl->ApplyParameters(params);
+    }
 
-        if (status != MCAM_ERR_OK)
-        {
-            status = ST_SetIntReg(m_pImpl->m_hDevice,
-                m_pImpl->m_gainNodeName.c_str(),
-                static_cast<int64_t>(gain));
-        }
+    bool CameraController::GetParameters(CameraParameters& params)
+    {
+        return m_pImpl->GetParameters(params);
+    }
 
+    bool CameraController::SetPixelFormat(const std::string& format)
+    {
+        if (!m_pImpl->m_bConnected)
+            return false;
+
+        CVS_ERROR status = m_pImpl->m_pBackend->SetEnumReg(m_pImpl->m_hDevice, "PixelFormat", format.c_str());
         if (status != MCAM_ERR_OK)
         {
-            m_pImpl->ReportError(status, "Failed to set gain");
+            m_pImpl->ReportError(status, "Failed to set pixel format");
             return false;
         }
 
+        // Bit depth changes the limits of the other features
+        m_pImpl->m_deviceState.SetPixelFormat(format);
+        m_pImpl->m_deviceState.InvalidateFeatures();
         return true;
     }
 
-    bool CameraController::GetGain(double& gain)
+    std::string CameraController::GetPixelFormat()
     {
-        if (!m_pImpl->m_bConnected || !m_pImpl->m_bHasGain)
-            return false;
+        if (!m_pImpl->m_bConnected)
+            return "";
+
+        return m_pImpl->m_deviceState.GetPixelFormat();
+    }
+
+    std::vector<std::string> CameraController::GetAvailablePixelFormats()
+    {
+        std::vector<std::string> formats;
+
+        if (!m_pImpl->m_bConnected)
+            return formats;
 
-        CVS_ERROR status = ST_GetFloatReg(m_pImpl->m_hDevice,
-            m_pImpl->m_gainNodeName.c_str(), &gain);
+        int32_t entrySize = 0;
+        CVS_ERROR status = m_pImpl->m_pBackend->GetEnumEntrySize(m_pImpl->m_hDevice, "PixelFormat", &entrySize);
 
         if (status != MCAM_ERR_OK)
+            return formats;
+
+        formats.reserve(entrySize);
+
+        for (int32_t i = 0; i < entrySize; i++)
         {
-            int64_t intGain;
-            status = ST_GetIntReg(m_pImpl->m_hDevice,
-                m_pImpl->m_gainNodeName.c_str(), &intGain);
+            char buffer[256];
+            uint32_t size = 256;
+            status = m_pImpl->m_pBackend->GetEnumEntryValue(m_pImpl->m_hDevice, "PixelFormat", i, buffer, &size);
+
             if (status == MCAM_ERR_OK)
-            {
-                gain = static_cast<double>(intGain);
-            }
+                formats.push_back(std::string(buffer));
         }
 
-        return (status == MCAM_ERR_OK);
+        return formats;
     }
 
-    bool CameraController::GetGainRange(double& min, double& max)
+    bool CameraController::SetTriggerMode(bool enable)
     {
-        if (!m_pImpl->m_bConnected || !m_pImpl->m_bHasGain)
+        if (!m_pImpl->m_bConnected)
             return false;
 
-        CVS_ERROR status = ST_GetFloatRegRange(m_pImpl->m_hDevice,
-            m_pImpl->m_gainNodeName.c_str(), &min, &max);
-
+        CVS_ERROR status = m_pImpl->m_pBackend->SetEnumReg(m_pImpl->m_hDevice, "TriggerMode",
+            enable ? "On" : "Off");
         if (status != MCAM_ERR_OK)
         {
-            int64_t intMin, intMax, intInc;
-            status = ST_GetIntRegRange(m_pImpl->m_hDevice,
-                m_pImpl->m_gainNodeName.c_str(),
-                &intMin, &intMax, &intInc);
-            if (status == MCAM_ERR_OK)
-            {
-                min = static_cast<double>(intMin);
-                max = static_cast<double>(intMax);
-            }
+            m_pImpl->ReportError(status, "Failed to set trigger mode");
+            return false;
         }
 
-        return (status == MCAM_ERR_OK);
+        return true;
     }
 
-    bool CameraController::SetFrameRate(double fps)
+    bool CameraController::SetTriggerSource(const std::string& source)
     {
         if (!m_pImpl->m_bConnected)
             return false;
 
-        if (!m_pImpl->m_bHasFrameRate)
+        CVS_ERROR status = m_pImpl->m_pBackend->SetEnumReg(m_pImpl->m_hDevice, "TriggerSource",
+            source.c_str());
+        if (status != MCAM_ERR_OK)
         {
-            m_pImpl->ReportStatus("Frame rate control not available on this camera");
+            m_pImpl->ReportError(status, "Failed to set trigger source");
             return false;
         }
 
-        CVS_ERROR status = ST_SetFloatReg(m_pImpl->m_hDevice, "AcquisitionFrameRate", fps);
-        if (status != MCAM_ERR_OK)
-        {
-            status = ST_SetFloatReg(m_pImpl->m_hDevice, "FrameRate", fps);
-        }
+        return true;
+    }
+
+    bool CameraController::ExecuteSoftwareTrigger()
+    {
+        if (!m_pImpl->m_bConnected)
+            return false;
 
+        CVS_ERROR status = m_pImpl->m_pBackend->SetCmdReg(m_pImpl->m_hDevice, "TriggerSoftware");
         if (status != MCAM_ERR_OK)
         {
-            m_pImpl->ReportError(status, "Failed to set frame rate");
+            m_pImpl->ReportError(status, "Failed to execute software trigger");
             return false;
         }
 
         return true;
     }
 
-    bool CameraController::GetFrameRate(double& fps)
+    bool CameraController::GetLatestImage(ImageData& imageData)
     {
-        if (!m_pImpl->m_bConnected || !m_pImpl->m_bHasFrameRate)
+        std::lock_guard<std::mutex> lock(m_pImpl->m_readerMutex);
+
+        // Keep the returned frame pinned until the next call (zero-copy)
+        FrameRef frame;
+        if (!GetLatestFrame(frame))
             return false;
 
-        CVS_ERROR status = ST_GetFloatReg(m_pImpl->m_hDevice, "AcquisitionFrameRate", &fps);
-        if (status != MCAM_ERR_OK)
-        {
-            status = ST_GetFloatReg(m_pImpl->m_hDevice, "FrameRate", &fps);
-        }
+        m_pImpl->m_readerFrame = std::move(frame);
+        imageData = m_pImpl->m_readerFrame.GetImageData();
+        return true;
+    }
+
+    bool CameraController::GetLatestFrame(FrameRef& frame)
+    {
+        if (!m_pImpl->m_bConnected || !m_pImpl->m_bAcquiring)
+            return false;
+
+        FrameRing* pRing = m_pImpl->m_frameRing.get();
+        if (!pRing)
+            return false;
+
+        // Pin the newest frame so the producer cannot overwrite it
+        ImageData latest;
+        uint32_t slot = pRing->PinLatest(latest);
+        if (slot == FrameRing::INVALID_SLOT)
+            return false;
 
-        return (status == MCAM_ERR_OK);
+        frame = FrameRef(pRing, slot, latest);
+        pRing->Release(slot);
+        return true;
     }
 
-    bool CameraController::GetFrameRateRange(double& min, double& max)
+    bool CameraController::SetFrameRingSize(size_t slotCount)
     {
-        if (!m_pImpl->m_bConnected || !m_pImpl->m_bHasFrameRate)
+        if (slotCount < FRAME_RING_MIN_SIZE || slotCount > FRAME_RING_MAX_SIZE)
+        {
+            m_pImpl->ReportError(-1, "Frame ring size out of range");
             return false;
+        }
 
-        CVS_ERROR status = ST_GetFloatRegRange(m_pImpl->m_hDevice, "AcquisitionFrameRate", &min, &max);
-        if (status != MCAM_ERR_OK)
+        if (m_pImpl->m_bAcquiring)
         {
-            status = ST_GetFloatRegRange(m_pImpl->m_hDevice, "FrameRate", &min, &max);
+            m_pImpl->ReportError(-1, "Cannot change frame ring size during acquisition");
+            return false;
         }
 
-        return (status == MCAM_ERR_OK);
+        m_pImpl->m_frameRingSize = slotCount;
+        return true;
     }
 
-    // Gamma control functions
-    bool CameraController::SetGamma(double gamma)
+    size_t CameraController::GetFrameRingSize() const
     {
-        if (!m_pImpl->m_bConnected)
-            return false;
+        return m_pImpl->m_frameRingSize;
+    }
 
-        // Range check
-        if (gamma < GAMMA_MIN || gamma > GAMMA_MAX)
+    bool CameraController::SetGrabConfig(const GrabConfig& config)
+    {
+        if (config.cpuCore >= static_cast<int>(std::thread::hardware_concurrency()) ||
+            config.cpuCore >= static_cast<int>(sizeof(void*) * 8))
         {
-            m_pImpl->ReportError(-1, "Gamma value out of range");
+            m_pImpl->ReportError(-1, "Grab thread CPU core out of range");
             return false;
         }
 
-        // Try hardware gamma first
-        if (m_pImpl->m_bHasGamma)
+        if (m_pImpl->m_bAcquiring)
         {
-            CVS_ERROR status = ST_SetFloatReg(m_pImpl->m_hDevice, m_pImpl->m_gammaNodeName.c_str(), gamma);
-
-            if (status == MCAM_ERR_OK)
-            {
-                m_pImpl->m_currentGamma = gamma;
-                return true;
-            }
-
-            m_pImpl->ReportError(status, "Failed to set hardware gamma");
+            m_pImpl->ReportError(-1, "Cannot change grab mode during acquisition");
             return false;
         }
 
-        // Use software gamma
-        m_pImpl->UpdateGammaLUT(gamma);
-        m_pImpl->ReportStatus("Software gamma updated");
+        m_pImpl->m_grabConfig = config;
         return true;
     }
 
-    bool CameraController::GetGamma(double& gamma)
+    GrabConfig CameraController::GetGrabConfig() const
+    {
+        return m_pImpl->m_grabConfig;
+    }
+
+    bool CameraController::SetBufferPoolConfig(const BufferPoolConfig& config)
     {
-        if (!m_pImpl->m_bConnected)
+        if (config.minBuffers < 1 || config.maxBuffers < config.minBuffers || config.maxBuffers > BUFFER_POOL_LIMIT)
+        {
+            m_pImpl->ReportError(-1, "Buffer pool size out of range");
             return false;
+        }
 
-        if (m_pImpl->m_bHasGamma)
+        if (config.consumerLatencyMs < 0.0)
         {
-            CVS_ERROR status = ST_GetFloatReg(m_pImpl->m_hDevice, m_pImpl->m_gammaNodeName.c_str(), &gamma);
+            m_pImpl->ReportError(-1, "Invalid consumer latency");
+            return false;
+        }
 
-            if (status == MCAM_ERR_OK)
-            {
-                m_pImpl->m_currentGamma = gamma;
-                return true;
-            }
+        if (m_pImpl->m_bAcquiring)
+        {
+            m_pImpl->ReportError(-1, "Cannot change buffer pool during acquisition");
+            return false;
+        }
+
+        m_pImpl->m_bufferPoolConfig = config;
+        m_pImpl->m_bufferPoolDepth = std::min(std::max(m_pImpl->m_bufferPoolDepth, config.minBuffers), config.maxBuffers);
+
+        // The driver pool limit is fixed at construction
+        if (m_pImpl->m_bConnected)
+        {
+            m_pImpl->m_bufferPool.reset();
+            m_pImpl->m_bufferPool = std::make_unique<ImageBufferPool>(m_pImpl->m_pBackend.get(),
+                m_pImpl->m_hDevice, m_pImpl->m_bufferPoolDepth, config.maxBuffers);
         }
 
-        gamma = m_pImpl->m_currentGamma;
         return true;
     }
 
-    bool CameraController::GetGammaRange(double& min, double& max)
+    BufferPoolConfig CameraController::GetBufferPoolConfig() const
     {
-        min = GAMMA_MIN;
-        max = GAMMA_MAX;
+        return m_pImpl->m_bufferPoolConfig;
+    }
 
-        if (!m_pImpl->m_bConnected)
-            return true;
+    void CameraController::GetBufferPoolStatistics(BufferPoolStatistics& stats)
+    {
+        memset(&stats, 0, sizeof(stats));
+        stats.targetDepth = static_cast<uint32_t>(m_pImpl->m_bufferPoolDepth);
+        stats.consumerLatencyMs = m_pImpl->m_bufferPoolLatencyMs;
 
-        if (m_pImpl->m_bHasGamma)
+        if (m_pImpl->m_bufferPool)
         {
-            CVS_ERROR status = ST_GetFloatRegRange(m_pImpl->m_hDevice, m_pImpl->m_gammaNodeName.c_str(), &min, &max);
-
-            if (status == MCAM_ERR_OK)
-                return true;
+            m_pImpl->m_bufferPool->GetStatistics(stats);
         }
 
-        return true;
+        // Host memory: the frame ring always, the capture copies when the pipeline runs
+        bool bLocked = m_pImpl->m_frameRing && m_pImpl->m_frameRing->IsMemoryLocked();
+        RawFramePool* pRawPool = m_pImpl->m_rawFramePool.get();
+        if (pRawPool)
+        {
+            stats.rawFrames = static_cast<uint32_t>(pRawPool->GetCount());
+            stats.rawHighWaterMark = static_cast<uint32_t>(pRawPool->GetHighWater());
+            bLocked = bLocked && pRawPool->IsMemoryLocked();
+        }
+        stats.memoryLocked = bLocked;
     }
 
-    bool CameraController::IsGammaSupported()
+    void CameraController::RegisterImageCallback(ImageCallback callback)
     {
-        return m_pImpl->m_bHasGamma || m_pImpl->m_bSoftwareGammaEnabled;
+        std::lock_guard<std::mutex> lock(m_pImpl->m_callbackMutex);
+        m_pImpl->m_imageCallback = callback;
     }
 
-    void CameraController::SetSoftwareGammaEnabled(bool enable)
+    void CameraController::RegisterFrameCallback(FrameCallback callback)
     {
-        m_pImpl->m_bSoftwareGammaEnabled = enable;
+        std::lock_guard<std::mutex> lock(m_pImpl->m_callbackMutex);
+        m_pImpl->m_frameCallback = callback;
     }
 
-    bool CameraController::IsSoftwareGammaEnabled()
+    void CameraController::RegisterErrorCallback(ErrorCallback callback)
     {
-        return m_pImpl->m_bSoftwareGammaEnabled;
+        std::lock_guard<std::mutex> lock(m_pImpl->m_callbackMutex);
+        m_pImpl->m_errorCallback = callback;
     }
 
-    bool CameraController::SetPixelFormat(const std::string& format)
+    void CameraController::RegisterStatusCallback(StatusCallback callback)
     {
-        if (!m_pImpl->m_bConnected)
-            return false;
+        std::lock_guard<std::mutex> lock(m_pImpl->m_callbackMutex);
+        m_pImpl->m_statusCallback = callback;
+    }
 
-        CVS_ERROR status = ST_SetEnumReg(m_pImpl->m_hDevice, "PixelFormat", const_cast<char*>(format.c_str()));
-        if (status != MCAM_ERR_OK)
-        {
-            m_pImpl->ReportError(status, "Failed to set pixel format");
-            return false;
-        }
+    void CameraController::RegisterBurstCallback(BurstCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(m_pImpl->m_callbackMutex);
+        m_pImpl->m_burstCallback = callback;
+    }
 
-        return true;
+    void CameraController::RegisterLookbackCallback(BurstCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(m_pImpl->m_callbackMutex);
+        m_pImpl->m_lookbackCallback = callback;
     }
 
-    std::string CameraController::GetPixelFormat()
+    void CameraController::GetStatistics(uint64_t& frameCount, uint64_t& errorCount, double& currentFps)
     {
-        if (!m_pImpl->m_bConnected)
-            return "";
+        frameCount = m_pImpl->m_frameCount;
+        errorCount = m_pImpl->m_errorCount;
 
-        char buffer[256];
-        uint32_t size = 256;
-        CVS_ERROR status = ST_GetEnumReg(m_pImpl->m_hDevice, "PixelFormat", buffer, &size);
+        // Rate over the last STATISTICS_UPDATE_INTERVAL_MS, refreshed by whoever polls
+        std::lock_guard<std::mutex> lock(m_pImpl->m_statisticsMutex);
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_pImpl->m_lastFpsTime).count();
+        if (elapsed >= STATISTICS_UPDATE_INTERVAL_MS)
+        {
+            m_pImpl->m_currentFps = (frameCount - m_pImpl->m_lastFrameCount) * 1000.0 / elapsed;
+            m_pImpl->m_lastFrameCount = frameCount;
+            m_pImpl->m_lastFpsTime = now;
+        }
+        currentFps = m_pImpl->m_currentFps;
+    }
 
-        if (status == MCAM_ERR_OK)
-            return std::string(buffer);
+    void CameraController::GetFrameRingStatistics(FrameRingStatistics& stats)
+    {
+        memset(&stats, 0, sizeof(stats));
+        stats.framesDroppedDevice = m_pImpl->m_framesDroppedDevice;
+        stats.framesDroppedInvalid = m_pImpl->m_framesDroppedInvalid;
+        stats.slotCount = static_cast<uint32_t>(m_pImpl->m_frameRingSize);
 
-        return "";
+        FrameRing* pRing = m_pImpl->m_frameRing.get();
+        if (pRing)
+        {
+            stats.framesDelivered = pRing->GetFramesPublished();
+            stats.framesDroppedRingFull = pRing->GetFramesDropped();
+            stats.latestSequence = pRing->GetLatestSequence();
+            stats.slotCount = static_cast<uint32_t>(pRing->GetSlotCount());
+            stats.pinnedSlots = pRing->GetPinnedSlotCount();
+        }
     }
 
-    std::vector<std::string> CameraController::GetAvailablePixelFormats()
+    void CameraController::GetInstrumentation(InstrumentationSnapshot& snapshot)
     {
-        std::vector<std::string> formats;
+        memset(&snapshot, 0, sizeof(snapshot));
+
+        // A counter below its baseline was restarted (e.g. frame ring recreated)
+        auto since = [](uint64_t value, uint64_t baseline) { return value >= baseline ? value - baseline : value; };
+
+        std::lock_guard<std::mutex> lock(m_pImpl->m_statisticsMutex);
+        snapshot.elapsedSec = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - m_pImpl->m_instrumentationStart).count();
+        snapshot.framesReceived = m_pImpl->m_framesReceived;
+        snapshot.framesDelivered = since(m_pImpl->m_frameCount, m_pImpl->m_instrumentationFrameBase);
+        snapshot.averageFps = snapshot.elapsedSec > 0.0 ? snapshot.framesDelivered / snapshot.elapsedSec : 0.0;
+
+        m_pImpl->m_grabWaitHistogram.GetStatistics(snapshot.grabWait);
+        m_pImpl->m_debayerHistogram.GetStatistics(snapshot.debayer);
+        m_pImpl->m_gammaHistogram.GetStatistics(snapshot.gamma);
+        m_pImpl->m_callbackHistogram.GetStatistics(snapshot.callback);
+        m_pImpl->m_endToEndHistogram.GetStatistics(snapshot.endToEnd);
+
+        DropStatistics drops;
+        m_pImpl->GetDropCounters(drops);
+        const DropStatistics& base = m_pImpl->m_dropBase;
+        snapshot.drops.device = since(drops.device, base.device);
+        snapshot.drops.invalidBuffer = since(drops.invalidBuffer, base.invalidBuffer);
+        snapshot.drops.ringFull = since(drops.ringFull, base.ringFull);
+        snapshot.drops.rawPoolExhausted = since(drops.rawPoolExhausted, base.rawPoolExhausted);
+        snapshot.drops.queueOverflow = since(drops.queueOverflow, base.queueOverflow);
+        snapshot.drops.grabErrors = since(drops.grabErrors, base.grabErrors);
+    }
 
-        if (!m_pImpl->m_bConnected)
-            return formats;
+    void CameraController::ResetInstrumentation()
+    {
+        m_pImpl->ResetInstrumentation();
+    }
 
-        int32_t entrySize = 0;
-        CVS_ERROR status = ST_GetEnumEntrySize(m_pImpl->m_hDevice, "PixelFormat", &entrySize);
+    bool CameraController::SetPipelineConfig(const PipelineConfig& config)
+    {
+        if (config.queueDepth < 1 || config.queueDepth > PIPELINE_QUEUE_MAX_DEPTH)
+        {
+            m_pImpl->ReportError(-1, "Pipeline queue depth out of range");
+            return false;
+        }
 
-        if (status != MCAM_ERR_OK)
-            return formats;
+        if (m_pImpl->m_bAcquiring)
+        {
+            m_pImpl->ReportError(-1, "Cannot change pipeline configuration during acquisition");
+            return false;
+        }
 
-        formats.reserve(entrySize);
+        m_pImpl->m_pipelineConfig = config;
+        return true;
+    }
 
-        for (int32_t i = 0; i < entrySize; i++)
-        {
-            char buffer[256];
-            uint32_t size = 256;
-            status = ST_GetEnumEntryValue(m_pImpl->m_hDevice, "PixelFormat", i, buffer, &size);
+    PipelineConfig CameraController::GetPipelineConfig() const
+    {
+        return m_pImpl->m_pipelineConfig;
+    }
 
-            if (status == MCAM_ERR_OK)
-                formats.push_back(std::string(buffer));
-        }
+    bool CameraController::SetDemosaicMethod(DemosaicMethod method)
+    {
+        // Takes effect from the next frame, no restart needed
+        m_pImpl->m_demosaicMethod = method;
+        return true;
+    }
 
-        return formats;
+    DemosaicMethod CameraController::GetDemosaicMethod() const
+    {
+        return m_pImpl->m_demosaicMethod;
     }
 
-    bool CameraController::SetTriggerMode(bool enable)
+    bool CameraController::SetColorCorrection(const ColorCorrection& correction)
     {
-        if (!m_pImpl->m_bConnected)
-            return false;
+        std::unique_ptr<Impl::ColorCorrectionState> pState(new Impl::ColorCorrectionState());
+        pState->config = correction;
 
-        CVS_ERROR status = ST_SetEnumReg(m_pImpl->m_hDevice, "TriggerMode",
-            const_cast<char*>(enable ? "On" : "Off"));
-        if (status != MCAM_ERR_OK)
+        if (!ImageProcessing::BuildColorMatrix(correction.whiteBalance, correction.colorMatrix, pState->matrix))
         {
-            m_pImpl->ReportError(status, "Failed to set trigger mode");
+            m_pImpl->ReportError(-1, "Color correction coefficient out of range");
             return false;
         }
 
+        // Skip the matrix stage entirely when it would not change anything
+        static const int16_t identity[9] = {
+            1 << ImageProcessing::COLOR_MATRIX_FRACTION_BITS, 0, 0,
+            0, 1 << ImageProcessing::COLOR_MATRIX_FRACTION_BITS, 0,
+            0, 0, 1 << ImageProcessing::COLOR_MATRIX_FRACTION_BITS };
+        pState->bActive = correction.enabled && memcmp(pState->matrix, identity, sizeof(identity)) != 0;
+
+        // Takes effect from the next frame
+        m_pImpl->m_colorCorrection.Update(std::move(pState));
         return true;
     }
 
-    bool CameraController::SetTriggerSource(const std::string& source)
+    ColorCorrection CameraController::GetColorCorrection() const
     {
-        if (!m_pImpl->m_bConnected)
+        RcuPointer<Impl::ColorCorrectionState>::ReadGuard state(m_pImpl->m_colorCorrection);
+        return state->config;
+    }
+
+    bool CameraController::SetOutputFormat(const OutputFormat& format)
+    {
+        if (!IsValidOutputFormat(format))
+        {
+            m_pImpl->ReportError(-1, "Invalid output format");
             return false;
+        }
 
-        CVS_ERROR status = ST_SetEnumReg(m_pImpl->m_hDevice, "TriggerSource",
-            const_cast<char*>(source.c_str()));
-        if (status != MCAM_ERR_OK)
+        if (m_pImpl->m_bAcquiring)
         {
-            m_pImpl->ReportError(status, "Failed to set trigger source");
+            m_pImpl->ReportError(-1, "Cannot change output format during acquisition");
             return false;
         }
 
+        m_pImpl->m_outputFormat = format;
         return true;
     }
 
-    bool CameraController::ExecuteSoftwareTrigger()
+    OutputFormat CameraController::GetOutputFormat() const
     {
-        if (!m_pImpl->m_bConnected)
-            return false;
+        return m_pImpl->m_outputFormat;
+    }
 
-        CVS_ERROR status = ST_SetCmdReg(m_pImpl->m_hDevice, "TriggerSoftware");
-        if (status != MCAM_ERR_OK)
+    bool CameraController::SetHighBitDepthConfig(const HighBitDepthConfig& config)
+    {
+        std::unique_ptr<Impl::HighBitDepthState> pState(new Impl::HighBitDepthState());
+        pState->config = config;
+
+        if (config.shift > 15 || (!config.toneCurve.empty() && config.toneCurve.size() != static_cast<size_t>(TONE_CURVE_ENTRIES)))
         {
-            m_pImpl->ReportError(status, "Failed to execute software trigger");
+            m_pImpl->ReportError(-1, "Invalid high bit depth configuration");
             return false;
         }
 
+        pState->bLut = !config.toneCurve.empty();
+        if (pState->bLut)
+        {
+            memcpy(pState->lut.table, config.toneCurve.data(), TONE_CURVE_ENTRIES);
+        }
+
+        // Takes effect from the next frame
+        m_pImpl->m_highBitDepth.Update(std::move(pState));
         return true;
     }
 
-    bool CameraController::GetLatestImage(ImageData& imageData)
+    HighBitDepthConfig CameraController::GetHighBitDepthConfig() const
     {
-        if (!m_pImpl->m_bConnected || !m_pImpl->m_bAcquiring)
+        RcuPointer<Impl::HighBitDepthState>::ReadGuard state(m_pImpl->m_highBitDepth);
+        return state->config;
+    }
+
+    bool CameraController::SetToneCurve(const ToneCurveConfig& config)
+    {
+        if (!IsValidToneCurve(config))
+        {
+            m_pImpl->ReportError(-1, "Invalid tone curve");
             return false;
+        }
 
-        std::lock_guard<std::mutex> lock(m_pImpl->m_imageMutex);
+        std::lock_guard<std::mutex> lock(m_pImpl->m_toneMutex);
+        if (config.enabled && config.useHardwareLut)
+        {
+            if (!m_pImpl->m_bConnected || !m_pImpl->m_bHardwareLut)
+            {
+                m_pImpl->ReportError(-1, "Camera has no hardware LUT");
+                return false;
+            }
 
-        if (!m_pImpl->m_lastImageData.pData)
-            return false;
+            if (!m_pImpl->WriteHardwareLut(config))
+                return false;
+        }
+        else if (m_pImpl->m_bHardwareLutActive)
+        {
+            m_pImpl->DisableHardwareLut();
+        }
 
-        // Return reference to last image (zero-copy)
-        imageData = m_pImpl->m_lastImageData;
+        // Takes effect from the next frame
+        m_pImpl->m_toneCurve = config;
+        m_pImpl->UpdateToneTables();
         return true;
     }
 
-    void CameraController::RegisterImageCallback(ImageCallback callback)
+    ToneCurveConfig CameraController::GetToneCurve() const
     {
-        std::lock_guard<std::mutex> lock(m_pImpl->m_callbackMutex);
-        m_pImpl->m_imageCallback = callback;
+        std::lock_guard<std::mutex> lock(m_pImpl->m_toneMutex);
+        return m_pImpl->m_toneCurve;
     }
 
-    void CameraController::RegisterErrorCallback(ErrorCallback callback)
+    bool CameraController::IsHardwareLutSupported() const
     {
-        std::lock_guard<std::mutex> lock(m_pImpl->m_callbackMutex);
-        m_pImpl->m_errorCallback = callback;
+        std::lock_guard<std::mutex> lock(m_pImpl->m_toneMutex);
+        return m_pImpl->m_bHardwareLut;
     }
 
-    void CameraController::RegisterStatusCallback(StatusCallback callback)
+    void CameraController::GetPipelineStatistics(PipelineStatistics& stats)
     {
-        std::lock_guard<std::mutex> lock(m_pImpl->m_callbackMutex);
-        m_pImpl->m_statusCallback = callback;
-    }
+        memset(&stats, 0, sizeof(stats));
+        stats.enabled = m_pImpl->m_bPipelineRunning;
 
-    void CameraController::GetStatistics(uint64_t& frameCount, uint64_t& errorCount, double& currentFps)
-    {
-        frameCount = m_pImpl->m_frameCount;
-        errorCount = m_pImpl->m_errorCount;
-        currentFps = m_pImpl->m_currentFps;
+        PipelineStageStatistics* pStages[PIPELINE_STAGE_COUNT] = {
+            &stats.capture, &stats.debayer, &stats.postProcess, &stats.fanOut };
+
+        for (size_t stage = 0; stage < PIPELINE_STAGE_COUNT; ++stage)
+        {
+            const PipelineStageCounters& counters = m_pImpl->m_stageCounters[stage];
+            PipelineStageStatistics& out = *pStages[stage];
+
+            out.framesProcessed = counters.framesProcessed;
+            out.framesDropped = counters.framesDropped;
+            out.avgQueueWaitUs = counters.queueWait.GetAverageUs();
+            out.maxQueueWaitUs = counters.queueWait.GetMaxUs();
+            out.avgProcessUs = counters.process.GetAverageUs();
+            out.maxProcessUs = counters.process.GetMaxUs();
+            out.lastProcessUs = counters.process.GetLastUs();
+
+            if (stats.enabled && m_pImpl->m_stageQueues[stage])
+            {
+                out.queueSize = static_cast<uint32_t>(m_pImpl->m_stageQueues[stage]->Size());
+                out.queueHighWater = static_cast<uint32_t>(m_pImpl->m_stageQueues[stage]->GetHighWater());
+            }
+        }
+
+        stats.avgEndToEndUs = m_pImpl->m_endToEndLatency.GetAverageUs();
+        stats.maxEndToEndUs = m_pImpl->m_endToEndLatency.GetMaxUs();
     }
 
     int CameraController::GetLastError() const
@@ -1890,7 +4527,7 @@ namespace CvsBallVision
         if (!m_pImpl->m_bConnected)
             return "Not connected";
 
-        const char* desc = ST_GetLastErrorDescription(m_pImpl->m_hDevice);
+        const char* desc = m_pImpl->m_pBackend->GetLastErrorDescription(m_pImpl->m_hDevice);
         if (desc)
             return std::string(desc);
 
@@ -1902,7 +4539,7 @@ namespace CvsBallVision
         if (!m_pImpl->m_bConnected)
             return false;
 
-        CVS_ERROR status = ST_ExportJson(m_pImpl->m_hDevice, filePath.c_str());
+        CVS_ERROR status = m_pImpl->m_pBackend->ExportJson(m_pImpl->m_hDevice, filePath.c_str());
         if (status != MCAM_ERR_OK)
         {
             m_pImpl->ReportError(status, "Failed to save parameters");
@@ -1917,13 +4554,36 @@ namespace CvsBallVision
         if (!m_pImpl->m_bConnected)
             return false;
 
-        CVS_ERROR status = ST_ImportJson(m_pImpl->m_hDevice, filePath.c_str());
+        CVS_ERROR status = m_pImpl->m_pBackend->ImportJson(m_pImpl->m_hDevice, filePath.c_str());
         if (status != MCAM_ERR_OK)
         {
             m_pImpl->ReportError(status, "Failed to load parameters");
             return false;
         }
 
+        // Anything may have changed
+        return RefreshDeviceState();
+    }
+
+    bool CameraController::RefreshDeviceState()
+    {
+        if (!m_pImpl->m_bConnected)
+            return false;
+
+        const int oldWidth = m_pImpl->m_deviceState.GetWidth();
+        const int oldHeight = m_pImpl->m_deviceState.GetHeight();
+
+        m_pImpl->DetectAvailableFeatures();
+        if (!m_pImpl->LoadDeviceState())
+            return false;
+
+        // Buffers follow the resolution the device now reports
+        if ((m_pImpl->m_deviceState.GetWidth() != oldWidth || m_pImpl->m_deviceState.GetHeight() != oldHeight) &&
+            !m_pImpl->m_bAcquiring)
+        {
+            return m_pImpl->ReinitializeBuffers();
+        }
+
         return true;
     }
 
@@ -1933,6 +4593,11 @@ namespace CvsBallVision
         return "1.0.8";
     }
 
+    std::string GetProcessingInstructionSet()
+    {
+        return ImageProcessing::GetSimdLevelName(ImageProcessing::GetSimdLevel());
+    }
+
     bool ConvertBayerToRGB(const uint8_t* pSrc, uint8_t* pDst,
         int width, int height,
         const std::string& bayerPattern)
@@ -1940,30 +4605,87 @@ namespace CvsBallVision
         if (!pSrc || !pDst)
             return false;
 
-        CVS_BUFFER srcBuffer = { 0 };
-        srcBuffer.image.pImage = const_cast<uint8_t*>(pSrc);
-        srcBuffer.image.width = width;
-        srcBuffer.image.height = height;
-        srcBuffer.image.channels = 1;
-        srcBuffer.image.step = width;
+        // Unknown strings keep the historical RG default
+        ImageProcessing::BayerPattern pattern = ImageProcessing::BayerPattern::RG;
+        ImageProcessing::ParseBayerPattern(bayerPattern, pattern);
+
+        return ImageProcessing::Demosaic(pSrc, width, pDst, width * 3, width, height,
+            pattern, DemosaicMethod::Bilinear);
+    }
+
+    int GetOutputStep(int width, const OutputFormat& format)
+    {
+        if (width <= 0 || !IsValidOutputFormat(format))
+            return 0;
+
+        return AlignRowBytes(width * GetLayoutBytesPerPixel(format.layout), format.rowAlignment);
+    }
+
+    bool ConvertBayerToDisplay(const uint8_t* pSrc, uint8_t* pDst,
+        int width, int height,
+        const std::string& bayerPattern, const OutputFormat& format)
+    {
+        const int step = GetOutputStep(width, format);
+        if (!pSrc || !pDst || step == 0 || height <= 0)
+            return false;
+
+        ImageProcessing::BayerPattern pattern = ImageProcessing::BayerPattern::RG;
+        ImageProcessing::ParseBayerPattern(bayerPattern, pattern);
+
+        uint8_t* pFirstRow = format.bottomUp ? pDst + static_cast<size_t>(height - 1) * step : pDst;
+        ImageProcessing::ColorPipeline none = {};
+        return ImageProcessing::DemosaicFused(pSrc, width, pFirstRow, format.bottomUp ? -step : step,
+            width, height, pattern, DemosaicMethod::Bilinear,
+            none, ToPackedFormat(format.layout), ImageProcessing::GetSimdLevel());
+    }
+
+    ImageView MakeImageView(const ImageData& image)
+    {
+        ImageView view;
+        view.pData = image.pData;
+        view.width = image.width;
+        view.height = image.height;
+        view.channels = image.channels;
+        view.step = image.step;
+        view.offsetX = image.offsetX;
+        view.offsetY = image.offsetY;
+        view.layout = image.layout;
+        view.bottomUp = image.bottomUp;
+        view.bitDepth = image.bitDepth;
+        return view;
+    }
+
+    bool CropImageView(const ImageView& view, const RoiRect& rect, ImageView& cropped)
+    {
+        if (!view.pData || rect.x < 0 || rect.y < 0 || rect.width <= 0 || rect.height <= 0 ||
+            rect.x > view.width - rect.width || rect.y > view.height - rect.height)
+        {
+            return false;
+        }
 
-        CVS_BUFFER dstBuffer = { 0 };
-        dstBuffer.image.pImage = pDst;
-        dstBuffer.image.width = width;
-        dstBuffer.image.height = height;
-        dstBuffer.image.channels = 3;
-        dstBuffer.image.step = width * 3;
+        // Packed samples come in byte triples of two
+        size_t skipBytes;
+        if (view.layout == PixelLayout::RawPacked)
+        {
+            if (rect.x & 1)
+                return false;
+            skipBytes = static_cast<size_t>(rect.x / 2) * 3;
+        }
+        else
+        {
+            skipBytes = static_cast<size_t>(rect.x) * GetLayoutBytesPerPixel(view.layout);
+        }
 
-        int convCode = CVP_BayerRG2RGB;
-        if (bayerPattern == "BayerBG")
-            convCode = CVP_BayerBG2RGB;
-        else if (bayerPattern == "BayerGB")
-            convCode = CVP_BayerGB2RGB;
-        else if (bayerPattern == "BayerGR")
-            convCode = CVP_BayerGR2RGB;
+        // Bottom-up views start at their last image row
+        const int firstRow = view.bottomUp ? view.height - rect.y - rect.height : rect.y;
 
-        CVS_ERROR status = ST_CvtColor(srcBuffer, &dstBuffer, convCode);
-        return (status == MCAM_ERR_OK);
+        cropped = view;
+        cropped.pData = view.pData + static_cast<size_t>(firstRow) * view.step + skipBytes;
+        cropped.width = rect.width;
+        cropped.height = rect.height;
+        cropped.offsetX = view.offsetX + rect.x;
+        cropped.offsetY = view.offsetY + rect.y;
+        return true;
     }
 
     bool ApplyGammaCorrection(uint8_t* pData, int width, int height, int channels, double gamma)
@@ -1978,24 +4700,69 @@ namespace CvsBallVision
         if (std::abs(gamma - 1.0) < 0.001)
             return true;
 
-        // Create LUT
-        std::vector<uint8_t> lut(256);
-        double invGamma = 1.0 / gamma;
-
-        for (int i = 0; i < 256; i++)
+        // Reuse the table while the gamma stays the same (per thread, no locking)
+        thread_local ImageProcessing::Lut8 lut = { { 0 }, true };
+        thread_local double lutGamma = 0.0;
+        if (lutGamma != gamma)
         {
-            double normalized = i / 255.0;
-            double corrected = std::pow(normalized, invGamma);
-            lut[i] = static_cast<uint8_t>(std::min(255.0, corrected * 255.0 + 0.5));
+            ImageProcessing::BuildGammaLut(gamma, lut);
+            lutGamma = gamma;
         }
 
-        // Apply to image
-        int totalPixels = width * height * channels;
-        for (int i = 0; i < totalPixels; i++)
-        {
-            pData[i] = lut[pData[i]];
-        }
+        const int rowBytes = width * channels;
+        ImageProcessing::ApplyLut(pData, rowBytes, height, rowBytes, lut);
+
+        return true;
+    }
+
+    int GetRawRowBytes(int width, const std::string& pixelFormat)
+    {
+        ImageProcessing::RawFormat format;
+        if (width <= 0 || !ImageProcessing::ParseRawFormat(pixelFormat, format))
+            return 0;
+
+        return ImageProcessing::GetRawRowBytes(width, format);
+    }
+
+    bool UnpackRawToU16(const uint8_t* pSrc, uint16_t* pDst, int width, int height, const std::string& pixelFormat)
+    {
+        ImageProcessing::RawFormat format;
+        if (!ImageProcessing::ParseRawFormat(pixelFormat, format))
+            return false;
+
+        return ImageProcessing::UnpackRawToU16(pSrc, ImageProcessing::GetRawRowBytes(width, format), pDst, width * 2,
+            width, height, format, ImageProcessing::GetSimdLevel());
+    }
+
+    bool UnpackRawToU8(const uint8_t* pSrc, uint8_t* pDst, int width, int height, const std::string& pixelFormat, int shift)
+    {
+        ImageProcessing::RawFormat format;
+        if (!ImageProcessing::ParseRawFormat(pixelFormat, format))
+            return false;
+
+        return ImageProcessing::UnpackRawToU8(pSrc, ImageProcessing::GetRawRowBytes(width, format), pDst, width,
+            width, height, format, shift >= 0 ? shift : format.bitDepth - 8, nullptr, ImageProcessing::GetSimdLevel());
+    }
+
+    bool BuildToneCurve(const ToneCurveConfig& config, std::vector<uint16_t>& table)
+    {
+        if (!IsValidToneCurve(config))
+            return false;
+
+        std::unique_ptr<ImageProcessing::Lut12> pLut(new ImageProcessing::Lut12());
+        ImageProcessing::BuildToneLut12(&config, 1.0, *pLut);
+        table.assign(pLut->table, pLut->table + TONE_CURVE_ENTRIES);
+        return true;
+    }
+
+    bool BuildToneCurve8(const ToneCurveConfig& config, std::vector<uint8_t>& table)
+    {
+        if (!IsValidToneCurve(config))
+            return false;
 
+        std::unique_ptr<ImageProcessing::Lut12To8> pLut(new ImageProcessing::Lut12To8());
+        ImageProcessing::BuildToneLut12To8(&config, 1.0, *pLut);
+        table.assign(pLut->table, pLut->table + TONE_CURVE_ENTRIES);
         return true;
     }
 }
\ No newline at end of file
@@ -1,12 +1,19 @@
 #pragma once
 
+#if defined(_WIN32)
 #ifdef CVSBALLVISIONCORE_EXPORTS
 #define CVSBALLVISION_API __declspec(dllexport)
 #else
 #define CVSBALLVISION_API __declspec(dllimport)
 #endif
+#else
+#define CVSBALLVISION_API __attribute__((visibility("default")))
+#endif
 
+#if defined(_WIN32)
 #include <Windows.h>
+#endif
+#include <cstdint>
 #include <memory>
 #include <functional>
 #include <atomic>
@@ -33,23 +40,77 @@ namespace CvsBallVision
 
         // Gamma correction parameters
         constexpr double GAMMA_MIN = 0.1;
-        constexpr double GAMMA_MAX = 3.0;
+        constexpr double GAMMA_MAX = 3.999;         // Camera gamma / LUT range
         constexpr double GAMMA_DEFAULT = 1.0;
 
+        // Tone curves (12-bit in, 12-bit out like the camera's adjustable LUT)
+        constexpr int TONE_CURVE_ENTRIES = 4096;
+        constexpr int TONE_CURVE_MAX_VALUE = 4095;
+        constexpr double TONE_CONTRAST_MIN = 0.1;
+        constexpr double TONE_CONTRAST_MAX = 4.0;
+
         // Buffer management
-        constexpr size_t BUFFER_POOL_SIZE = 3;
+        constexpr size_t BUFFER_POOL_SIZE = 3;              // Default minimum depth
         constexpr size_t BUFFER_POOL_MAX_SIZE = 5;
+        constexpr size_t BUFFER_POOL_GROWTH_MAX = 16;       // Default maximum depth (on-demand growth)
+        constexpr size_t BUFFER_POOL_LIMIT = 64;
+        constexpr double BUFFER_POOL_DEFAULT_LATENCY_MS = 20.0;    // Until a consumer latency is measured
         constexpr double BUFFER_RESERVE_FACTOR = 1.5;
+        constexpr size_t MEMORY_PAGE_SIZE = 4096;
+
+        // Frame ring (owned slots handed to consumers)
+        constexpr size_t FRAME_RING_SIZE = 4;
+        constexpr size_t FRAME_RING_MIN_SIZE = 3;
+        constexpr size_t FRAME_RING_MAX_SIZE = 32;
+
+        // Burst capture
+        constexpr uint32_t BURST_MAX_FRAMES = 4096;
+        constexpr double LOOKBACK_DEFAULT_SECONDS = 2.0;
+
+        // Tracking ROI (hardware window following a target)
+        constexpr size_t TRACKING_ROI_HISTORY = 16;             // Window moves remembered to label frames in flight
+        constexpr int TRACKING_ROI_MAX_LATENCY_FRAMES = 8;
+
+        // Raw recording (chunked container written by a dedicated thread)
+        constexpr size_t RECORDING_ALIGNMENT = 4096;                // Sector / page multiple for direct I/O
+        constexpr size_t RECORDING_CHUNK_BYTES = 16 * 1024 * 1024;
+        constexpr uint32_t RECORDING_CHUNK_COUNT = 8;               // ~1 s of 1456x1088 @ 72 fps in flight
+
+        // Multi-camera groups
+        constexpr size_t CAMERA_GROUP_MAX_CAMERAS = 8;
+        constexpr size_t CAMERA_GROUP_PENDING_FRAMES = 4;       // Per camera, waiting for partners
+        constexpr double CAMERA_GROUP_MATCH_TOLERANCE_US = 1000.0;
+
+        // Processing pipeline
+        constexpr size_t PIPELINE_QUEUE_DEPTH = 3;
+        constexpr size_t PIPELINE_QUEUE_MAX_DEPTH = 8;
+
+        // Output frame layout
+        constexpr int OUTPUT_ROW_ALIGNMENT_MAX = 4096;
 
         // Timing constants (milliseconds)
+        constexpr int GRAB_ERROR_SLEEP_MS = 10;     // Pull thread back-off after a grab error
+
+        // Retired fixed delays and retry counts, kept so client code still compiles.
+        // Acquisition and the buffer pool wait on completion signals and no longer read them.
+        [[deprecated("unused: StopAcquisition waits for the SDK and in-flight callbacks")]]
         constexpr int ACQUISITION_STOP_TIMEOUT_MS = 200;
+        [[deprecated("unused: the grab callback stays registered across stop/start")]]
         constexpr int CALLBACK_UNREGISTER_DELAY_MS = 50;
+        [[deprecated("unused: StartAcquisition waits for the SDK acknowledgement")]]
         constexpr int HARDWARE_PREP_TIME_MS = 50;
+        [[deprecated("unused: StopAcquisition waits for the SDK acknowledgement")]]
         constexpr int CAMERA_STOP_WAIT_MS = 100;
+        [[deprecated("unused: resolution changes wait for acquisition to stop")]]
+        constexpr int RESOLUTION_CHANGE_DELAY_MS = 30;
+        [[deprecated("unused: the pool blocks on a condition variable until a buffer returns")]]
         constexpr int BUFFER_WAIT_RETRY_MS = 10;
+        [[deprecated("unused: the grab thread blocks in GrabImage instead of polling")]]
         constexpr int GRAB_THREAD_SLEEP_MS = 1;
-        constexpr int GRAB_ERROR_SLEEP_MS = 10;
-        constexpr int RESOLUTION_CHANGE_DELAY_MS = 30;
+        [[deprecated("unused: buffers are released without retries")]]
+        constexpr int BUFFER_RELEASE_MAX_RETRIES = 10;
+        [[deprecated("unused: the pool blocks on a condition variable until a buffer returns")]]
+        constexpr int BUFFER_WAIT_TIMEOUT_MS = 5;
 
         // Timeout constants (seconds)
         constexpr int SHUTDOWN_TIMEOUT_SEC = 2;
@@ -60,14 +121,63 @@ namespace CvsBallVision
         constexpr int UI_UPDATE_INTERVAL_MS = 33;  // ~30 FPS
         constexpr int STATISTICS_UPDATE_INTERVAL_MS = 1000;
 
-        // Buffer retry counts
-        constexpr int BUFFER_RELEASE_MAX_RETRIES = 10;
-        constexpr int BUFFER_WAIT_TIMEOUT_MS = 5;
-
         // Error tracking
         constexpr size_t MAX_ERROR_HISTORY = 100;
+
+        // Simulated camera defaults (MG-A160K-72 sensor geometry)
+        constexpr int SIMULATED_SENSOR_WIDTH = 1456;
+        constexpr int SIMULATED_SENSOR_HEIGHT = 1088;
+        constexpr double SIMULATED_MAX_FPS = 1000.0;
+        constexpr uint32_t SIMULATED_GRAB_TIMEOUT_MS = 1000;
+
+        // Recording playback
+        constexpr double PLAYBACK_MAX_FPS = 100000.0;
     }
 
+    // Device backend selection
+    enum class DeviceBackendType
+    {
+        CvsCamCtrl,     // CREVIS cvsCamCtrl SDK (real GigE cameras)
+        Simulated,      // Synthetic frame source for headless testing/benchmarking
+        Playback        // Recorded session (see StartRecording), replayed from a memory-mapped file
+    };
+
+    // Simulated camera configuration
+    struct SimulatedCameraConfig
+    {
+        uint32_t deviceCount = 1;
+        int sensorWidth = Constants::SIMULATED_SENSOR_WIDTH;
+        int sensorHeight = Constants::SIMULATED_SENSOR_HEIGHT;
+        std::string pixelFormat = "BayerRG8";   // BayerRG8/BG8/GB8/GR8, Mono8 or a 10/12-bit Mono/BayerRG (packed) format
+        double frameRate = Constants::DEFAULT_FPS;
+        double frameJitterUs = 0.0;             // Uniform +/- jitter on each frame interval
+        uint32_t grabTimeoutMs = Constants::SIMULATED_GRAB_TIMEOUT_MS;
+        double timeoutProbability = 0.0;        // Per-frame chance the frame never arrives
+        double errorProbability = 0.0;          // Per-frame chance of a grab/transfer error
+        bool hasHardwareGamma = false;
+        bool hasHardwareLut = false;            // LUTSelector / LUTEnable / LUTIndex / LUTValue, applied to rendered frames
+        double lineTimeUs = 0.0;                // Readout per row: caps AcquisitionFrameRate at 1e6 / (lineTimeUs * Height) (0 = no cap)
+        uint32_t randomSeed = 0;                // 0 = non-deterministic
+    };
+
+    // How the playback backend schedules frames
+    enum class PlaybackPacing
+    {
+        Original,       // Recorded arrival times
+        FixedRate,      // AcquisitionFrameRate (starts at PlaybackConfig::frameRate)
+        Maximum         // As fast as the consumer takes them
+    };
+
+    // Playback backend configuration
+    struct PlaybackConfig
+    {
+        std::string path;                       // Container written by StartRecording
+        PlaybackPacing pacing = PlaybackPacing::Original;
+        double frameRate = Constants::DEFAULT_FPS;
+        bool loop = false;                      // Restart at the end; blockIDs and timestamps keep increasing
+        uint32_t grabTimeoutMs = Constants::SIMULATED_GRAB_TIMEOUT_MS;
+    };
+
     // Camera information structure
     struct CameraInfo
     {
@@ -81,16 +191,80 @@ namespace CvsBallVision
         bool isConnected;
     };
 
-    // Camera parameters structure
+    // Camera parameters structure (a complete profile; see ApplyParameters)
     struct CameraParameters
     {
         int width;
         int height;
-        double exposureTime;
+        double exposureTime;    // Microseconds
         double gain;
         double fps;
         double gamma;
-        std::string pixelFormat;
+        std::string pixelFormat;    // Empty = keep the current format
+    };
+
+    // Host-side processing times of one frame, filled in before it is published
+    struct FrameTimings
+    {
+        int64_t receivedNs;     // std::chrono::steady_clock time the driver handed the frame over
+        float captureUs;        // Copy out of the driver buffer (0 when processed inline)
+        float debayerUs;
+        float postProcessUs;    // Software gamma (when not fused into debayer)
+        float queueWaitUs;      // Time spent in stage queues before publishing
+    };
+
+    // Pixel layout of a delivered frame
+    enum class PixelLayout
+    {
+        Mono8,
+        RGB24,
+        BGR24,      // GDI DIB / OpenCV byte order
+        BGRA32,     // Alpha = 255
+        Mono16,     // Little-endian uint16 samples, bitDepth significant bits (mono or an undebayered mosaic)
+        RawPacked   // 10/12-bit samples as the camera packs them (burst and look-back captures only)
+    };
+
+    // Layout the debayer stage writes colour frames in, so they can be displayed as-is
+    struct OutputFormat
+    {
+        PixelLayout layout = PixelLayout::RGB24;    // RGB24, BGR24 or BGRA32 (mono frames stay Mono8)
+        int rowAlignment = 1;                       // Row stride rounded up to this (power of two; 4 for DIBs)
+        bool bottomUp = false;                      // Last image row first in memory (DIB with positive biHeight)
+    };
+
+    // How 10/12-bit pixel formats (Mono10/12, Bayer..10/12, packed or not) are delivered
+    enum class HighBitDepthMode
+    {
+        Convert8,       // Reduced to 8 bits on receive; debayer, gamma and the rest are unchanged
+        Keep16          // Mono16 frames with every sensor bit (Bayer stays a mosaic; tone curves apply at 12 bits)
+    };
+
+    struct HighBitDepthConfig
+    {
+        HighBitDepthMode mode = HighBitDepthMode::Convert8;
+        int shift = -1;                     // Convert8: min(255, sample >> shift); -1 = bitDepth - 8 (top 8 bits)
+        std::vector<uint8_t> toneCurve;     // Convert8: TONE_CURVE_ENTRIES indexed by the sample scaled to 12 bits; replaces shift
+    };
+
+    // Tone curve on the 12-bit sensor scale; the stages compose in this order:
+    // black level -> contrast -> gamma -> custom curve
+    struct ToneCurveConfig
+    {
+        bool enabled = false;
+        double blackLevel = 0.0;            // Inputs up to this (0 .. 4095) map to 0, the rest is stretched
+        double contrast = 1.0;              // Slope around mid grey, TONE_CONTRAST_MIN .. TONE_CONTRAST_MAX
+        double gamma = 1.0;                 // out = in ^ (1 / gamma), GAMMA_MIN .. GAMMA_MAX
+        std::vector<uint16_t> customCurve;  // Empty, or TONE_CURVE_ENTRIES values 0 .. 4095 applied last
+        bool useHardwareLut = false;        // Write the table into the camera's LUT instead of applying it on the host
+    };
+
+    // Rectangle in pixels
+    struct RoiRect
+    {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
     };
 
     // Image data structure
@@ -103,12 +277,348 @@ namespace CvsBallVision
         int step;
         uint64_t blockID;
         uint64_t timestamp;
+        uint64_t sequence;      // Frame ring sequence number (increments per delivered frame)
+        FrameTimings timings;
+        PixelLayout layout;
+        bool bottomUp;          // pData is the bottom image row; step still advances through memory
+        int bitDepth;           // Significant bits per sample (8 except Mono16 / RawPacked)
+        int offsetX;            // Sensor position of the top-left pixel (hardware ROI offset plus software ROI)
+        int offsetY;
+    };
+
+    // Window into frame pixels without a copy: rows stay `step` bytes apart in the frame's memory.
+    // Valid for as long as the frame it was made from (e.g. while its FrameRef is held).
+    struct ImageView
+    {
+        const uint8_t* pData;   // First row in memory, like ImageData::pData
+        int width;
+        int height;
+        int channels;
+        int step;
+        int offsetX;            // Sensor position of the top-left pixel
+        int offsetY;
+        PixelLayout layout;
+        bool bottomUp;
+        int bitDepth;
+
+        // Image row y, counted from the top
+        const uint8_t* GetRow(int y) const
+        {
+            return pData + static_cast<ptrdiff_t>(bottomUp ? height - 1 - y : y) * step;
+        }
+    };
+
+    // Frame delivery statistics
+    struct FrameRingStatistics
+    {
+        uint64_t framesDelivered;       // Frames published to the ring
+        uint64_t framesDroppedRingFull; // Frames dropped because every slot was pinned by consumers
+        uint64_t framesDroppedDevice;   // Frames missing from the blockID sequence (camera/transport)
+        uint64_t framesDroppedInvalid;  // Frames rejected (bad dimensions, conversion failure)
+        uint64_t latestSequence;
+        uint32_t slotCount;
+        uint32_t pinnedSlots;
+    };
+
+    // Processing pipeline configuration
+    enum class QueuePolicy
+    {
+        DropOldest,     // Evict the oldest queued frame (lowest latency)
+        DropNewest,     // Reject the incoming frame
+        Block           // Wait for space (back-pressure reaches the grab thread)
+    };
+
+    struct PipelineConfig
+    {
+        bool enabled = true;    // false = process every frame inline on the grab thread
+        size_t queueDepth = Constants::PIPELINE_QUEUE_DEPTH;
+        QueuePolicy queuePolicy = QueuePolicy::DropOldest;
+    };
+
+    // Acquisition buffer pool sizing (applied on the next StartAcquisition).
+    // Depth follows frame rate x consumer latency + 1, clamped to [minBuffers, maxBuffers].
+    struct BufferPoolConfig
+    {
+        size_t minBuffers = Constants::BUFFER_POOL_SIZE;
+        size_t maxBuffers = Constants::BUFFER_POOL_GROWTH_MAX;
+        double consumerLatencyMs = 0.0;     // How long a frame stays in use; 0 = measured (p99 of the last run)
+        bool lockMemory = false;            // Lock host frame memory (capture copies, frame ring) into RAM
+    };
+
+    struct BufferPoolStatistics
+    {
+        uint32_t targetDepth;       // Depth chosen at the last StartAcquisition
+        uint32_t buffers;           // Driver buffers allocated (pull mode)
+        uint32_t inUse;
+        uint32_t highWaterMark;     // Most driver buffers in use at once since StartAcquisition
+        uint64_t exhausted;         // Requests that found every driver buffer in use
+        uint32_t rawFrames;         // Pipeline capture copies
+        uint32_t rawHighWaterMark;
+        double consumerLatencyMs;   // Latency the target depth was computed from
+        bool memoryLocked;          // All host frame memory is locked into RAM
+    };
+
+    // Bayer to RGB conversion used by the debayer stage
+    enum class DemosaicMethod
+    {
+        Bilinear,       // In-library bilinear (SIMD)
+        EdgeAware,      // In-library, green interpolated along the weaker gradient
+        Vendor          // Camera SDK ST_CvtColor
+    };
+
+    // Software white balance and colour correction, fused into the debayer pass
+    // (in-library demosaic methods only)
+    struct ColorCorrection
+    {
+        bool enabled = false;
+        double whiteBalance[3] = { 1.0, 1.0, 1.0 };     // R, G, B gains
+        double colorMatrix[9] = {                       // Row-major RGB, applied after white balance
+            1.0, 0.0, 0.0,
+            0.0, 1.0, 0.0,
+            0.0, 0.0, 1.0 };
+    };
+
+    // Per-stage pipeline statistics (latencies in microseconds)
+    struct PipelineStageStatistics
+    {
+        uint64_t framesProcessed;
+        uint64_t framesDropped;         // Dropped on entry to this stage
+        double avgQueueWaitUs;
+        double maxQueueWaitUs;
+        double avgProcessUs;
+        double maxProcessUs;
+        double lastProcessUs;
+        uint32_t queueSize;
+        uint32_t queueHighWater;
+    };
+
+    struct PipelineStatistics
+    {
+        bool enabled;
+        PipelineStageStatistics capture;        // Copy out of the driver buffer (grab thread)
+        PipelineStageStatistics debayer;
+        PipelineStageStatistics postProcess;    // Software gamma and publish to the frame ring
+        PipelineStageStatistics fanOut;         // User callbacks
+        double avgEndToEndUs;
+        double maxEndToEndUs;
+    };
+
+    // Latency distribution from a histogram (microseconds, within ~1.6%)
+    struct LatencyStatistics
+    {
+        uint64_t count;
+        double meanUs;
+        double minUs;
+        double maxUs;
+        double p50Us;
+        double p90Us;
+        double p99Us;
+        double p999Us;
+        double p9999Us;
+    };
+
+    // Frames lost, by reason
+    struct DropStatistics
+    {
+        uint64_t device;            // Gaps in the blockID sequence (camera/transport)
+        uint64_t invalidBuffer;     // Bad dimensions or missing image data
+        uint64_t ringFull;          // Every frame ring slot pinned by consumers
+        uint64_t rawPoolExhausted;  // No free raw copy buffer in the capture stage
+        uint64_t queueOverflow;     // Evicted or rejected by a pipeline stage queue
+        uint64_t grabErrors;        // Failed grabs (no frame produced)
+    };
+
+    // Hot-path instrumentation, collected lock-free since the last StartAcquisition
+    // or ResetInstrumentation
+    struct InstrumentationSnapshot
+    {
+        double elapsedSec;              // Collection window
+        uint64_t framesReceived;        // Frames handed over by the driver
+        uint64_t framesDelivered;       // Frames published to consumers
+        double averageFps;              // framesDelivered / elapsedSec
+        LatencyStatistics grabWait;     // Acquisition thread idle until the next frame arrived
+        LatencyStatistics debayer;
+        LatencyStatistics gamma;        // Post-process stage (software gamma when not fused)
+        LatencyStatistics callback;     // User image and frame callbacks
+        LatencyStatistics endToEnd;     // Frame arrival on the host to hand-off to the callbacks
+        DropStatistics drops;
+    };
+
+    // Acquisition state machine
+    enum class AcquisitionState
+    {
+        Idle,
+        Starting,       // Buffers and pipeline prepared, waiting for the SDK to start streaming
+        Running,
+        Paused,         // Everything stays armed; frames are not accepted
+        Stopping        // Waiting for the SDK stop, in-flight callbacks and pipeline stages to finish
+    };
+
+    // How PauseAcquisition idles between shots
+    enum class PauseMode
+    {
+        GateFrames,     // Camera keeps streaming, frames are dropped on arrival (resume on the next frame)
+        StopStream      // Camera stops streaming (no bus traffic; resume costs an AcqStart)
+    };
+
+    // How frames are taken from the SDK
+    enum class GrabMode
+    {
+        Callback,       // SDK grab callback thread (ST_RegisterGrabCallback)
+        Pull            // Own thread blocking in ST_GrabImage on the SDK grab timeout
+    };
+
+    // Frame delivery thread (applied on the next StartAcquisition)
+    struct GrabConfig
+    {
+        GrabMode mode = GrabMode::Callback;
+        int cpuCore = -1;               // Pin the pull thread to this core; -1 = no affinity
+        bool highPriority = false;      // Time-critical priority for the pull thread (best effort)
+    };
+
+    // Measured StartAcquisition / StopAcquisition latencies since connect
+    struct AcquisitionTransitionStatistics
+    {
+        LatencyStatistics start;        // StartAcquisition until the SDK acknowledged AcqStart
+        LatencyStatistics firstFrame;   // StartAcquisition until the first frame arrived
+        LatencyStatistics stop;         // StopAcquisition until callbacks drained and buffers returned
+        LatencyStatistics resume;       // ResumeAcquisition until the first frame was accepted
+        uint64_t drainTimeouts;         // Stops that gave up waiting for in-flight callbacks
+    };
+
+    class FrameRing;
+
+    // Reference-counted handle to a frame owned by the controller's frame ring.
+    // While any FrameRef to a frame exists its slot is pinned: the pixels stay valid
+    // and are never overwritten, so consumers can share one buffer without copying.
+    // Holding too many frames makes the producer drop new ones (see FrameRingStatistics).
+    class CVSBALLVISION_API FrameRef
+    {
+    public:
+        FrameRef();
+        FrameRef(const FrameRef& other);
+        FrameRef(FrameRef&& other) noexcept;
+        FrameRef& operator=(const FrameRef& other);
+        FrameRef& operator=(FrameRef&& other) noexcept;
+        ~FrameRef();
+
+        // Internal: pins the slot (used by the core when handing out frames)
+        FrameRef(FrameRing* pRing, uint32_t slot, const ImageData& imageData);
+
+        bool IsValid() const { return m_pRing != nullptr; }
+        explicit operator bool() const { return IsValid(); }
+
+        const ImageData& GetImageData() const { return m_imageData; }
+        const uint8_t* GetData() const { return m_imageData.pData; }
+        uint64_t GetSequence() const { return m_imageData.sequence; }
+
+        // Release the frame back to the ring
+        void Reset();
+
+    private:
+        FrameRing* m_pRing;
+        uint32_t m_slot;
+        ImageData m_imageData;
+    };
+
+    // Burst capture (see CameraController::ArmBurst)
+    struct BurstConfig
+    {
+        uint32_t frameCount = 0;        // Frames to record, 1 .. BURST_MAX_FRAMES
+        bool deliverFrames = false;     // Also pass burst frames through the pipeline and callbacks
+        bool lockMemory = false;        // Lock the burst memory into RAM (best effort)
+    };
+
+    // Look-back ring (see CameraController::SetLookbackConfig). The ring holds the pre-event
+    // window plus postEventFrames; its capacity is the smallest of the limits that are set.
+    struct LookbackConfig
+    {
+        bool enabled = false;
+        double durationSec = Constants::LOOKBACK_DEFAULT_SECONDS;// Pre-event window at the camera frame rate (0 = no limit)
+        size_t maxBytes = 0;                // Ring memory limit (0 = no limit)
+        uint32_t maxFrames = 0;             // Ring frame limit (0 = no limit)
+        uint32_t postEventFrames = 0;       // Frames still recorded after the event
+        bool lockMemory = false;            // Lock the ring into RAM (best effort)
+    };
+
+    // Raw recording to disk (see CameraController::StartRecording)
+    struct RecordingConfig
+    {
+        std::string path;
+        size_t chunkBytes = Constants::RECORDING_CHUNK_BYTES;     // Write size; grown to fit at least one frame
+        uint32_t chunkCount = Constants::RECORDING_CHUNK_COUNT;    // Chunks buffered between capture and disk
+        bool directIo = true;           // Bypass the OS file cache (falls back when the volume refuses)
+        bool lockMemory = false;        // Lock the chunk buffers into RAM (best effort)
+    };
+
+    struct RecordingStatistics
+    {
+        uint64_t framesRecorded;
+        uint64_t framesDropped;         // No free chunk (disk slower than the camera), or frame too large
+        uint64_t bytesWritten;
+        uint64_t chunksWritten;
+        uint32_t chunksQueued;          // Full chunks waiting for the writer
+        uint32_t queueHighWaterMark;
+        uint64_t writeErrors;
+        LatencyStatistics frameCopy;    // Time the capture path spent per frame
+        LatencyStatistics chunkWrite;   // Time per chunk write
+        double throughputMBps;          // Since StartRecording
+        bool directIo;                  // Direct I/O actually in use
+    };
+
+    // Tracking ROI (see CameraController::SetTrackingROI)
+    struct TrackingRoiConfig
+    {
+        bool enabled = false;
+        int width = 0;                  // Window size while tracking (0 = keep the current size)
+        int height = 0;
+        bool maximizeFrameRate = true;  // Raise AcquisitionFrameRate to what the smaller window allows
+        int moveLatencyFrames = 1;      // Frames already exposing when a move is written (1 free run, 0 triggered)
+    };
+
+    struct TrackingRoiStatistics
+    {
+        uint64_t targets;               // SetTrackingTarget calls
+        uint64_t coalesced;             // Targets replaced by a newer one before they were written
+        uint64_t moves;                 // Targets that moved the window
+        uint64_t unchanged;             // Targets that left the window where it was
+        uint64_t failures;              // Offset writes the camera rejected
+        LatencyStatistics moveLatency;  // SetTrackingTarget to offsets written
+    };
+
+    // A completed burst or look-back window: the raw frames exactly as the camera sent them
+    // (Mono or Bayer in GetPixelFormat, packed formats still packed), held in memory preallocated for the recording
+    class CVSBALLVISION_API BurstCapture
+    {
+    public:
+        ~BurstCapture();
+
+        size_t GetFrameCount() const;
+        const ImageData& GetFrame(size_t index) const;     // blockID, timestamp, timings.receivedNs and offsets per frame
+        const std::string& GetPixelFormat() const;
+        uint64_t GetFramesMissed() const;                   // blockID gaps (or unexpected frame sizes) while recording
+        int64_t GetDurationNs() const;                      // First to last frame arrival
+        size_t GetEventIndex() const;                       // Look-back: first frame at or after the event (0 for bursts)
+
+    private:
+        friend class BurstRecorder;
+        friend class LookbackRecorder;
+        BurstCapture();
+
+        class Impl;
+        std::unique_ptr<Impl> m_pImpl;
+
+        // Disable copy
+        BurstCapture(const BurstCapture&) = delete;
+        BurstCapture& operator=(const BurstCapture&) = delete;
     };
 
     // Callback types
     using ImageCallback = std::function<void(const ImageData&)>;
+    using FrameCallback = std::function<void(const FrameRef& frame)>;
     using ErrorCallback = std::function<void(int errorCode, const std::string& errorMsg)>;
     using StatusCallback = std::function<void(const std::string& status)>;
+    using BurstCallback = std::function<void(const std::shared_ptr<BurstCapture>& burst)>;
 
     class CVSBALLVISION_API CameraController
     {
@@ -116,6 +626,12 @@ namespace CvsBallVision
         CameraController();
         ~CameraController();
 
+        // Device backend (must be selected before InitializeSystem)
+        bool SetDeviceBackend(DeviceBackendType type,
+            const SimulatedCameraConfig& simulatedConfig = SimulatedCameraConfig());
+        bool SetPlaybackBackend(const PlaybackConfig& config);     // One camera replaying the recording
+        DeviceBackendType GetDeviceBackend() const;
+
         // System initialization
         bool InitializeSystem();
         void FreeSystem();
@@ -133,10 +649,74 @@ namespace CvsBallVision
         bool StopAcquisition();
         bool IsAcquiring() const;
 
+        // Idle between shots without tearing down: stream setup, buffer pool, frame ring,
+        // pipeline threads and callback registration are kept. IsAcquiring stays true.
+        bool PauseAcquisition(PauseMode mode = PauseMode::GateFrames);
+        bool ResumeAcquisition();
+        bool IsPaused() const;
+
+        AcquisitionState GetAcquisitionState() const;
+        void GetAcquisitionTransitions(AcquisitionTransitionStatistics& stats);
+
+        // Burst capture: the next frameCount frames to arrive (e.g. the ones following a hardware
+        // trigger) are copied raw, before any processing, into memory allocated here.
+        // Arming may happen before or during acquisition; the burst stays armed across stop/start.
+        bool ArmBurst(const BurstConfig& config);
+        void CancelBurst();
+        bool IsBurstArmed() const;
+        std::shared_ptr<BurstCapture> WaitForBurst(uint32_t timeoutMs);    // nullptr on timeout, cancel or frame size change
+
+        // Look-back recording: every raw frame goes into a preallocated ring (camera pixel format).
+        // TriggerLookbackEvent freezes the window around the event without stopping acquisition;
+        // the ring refills once the returned capture is released. Sized on connect and on each start.
+        // With a look-back callback registered the capture is handed to the callback, and
+        // WaitForLookback only receives it if it was already waiting.
+        bool SetLookbackConfig(const LookbackConfig& config);
+        LookbackConfig GetLookbackConfig() const;
+        size_t GetLookbackCapacity() const;                 // Frames the ring holds (0 when disabled)
+        bool TriggerLookbackEvent();
+        std::shared_ptr<BurstCapture> WaitForLookback(uint32_t timeoutMs);    // nullptr on timeout or when disabled
+
+        // Raw recording: every frame, as received, is appended to a chunked container file
+        // (see FrameRecorder.h for the layout). The capture path only copies into a chunk buffer;
+        // a dedicated thread does the (large, aligned) writes. Runs independently of acquisition.
+        bool StartRecording(const RecordingConfig& config);
+        bool StopRecording();               // Flushes, finalises the header and closes the file
+        bool IsRecording() const;
+        void GetRecordingStatistics(RecordingStatistics& stats);
+
         // Parameter control
         bool SetResolution(int width, int height);
         bool GetResolution(int& width, int& height);
 
+        // Software ROI: delivered frames are cropped on receive, before any processing, by pointing into
+        // the driver buffer (no copy, no reallocation), so only the window is converted and delivered.
+        // In pixels of the camera's window; kept inside each frame, with even offsets for Bayer and packed
+        // formats. Takes effect from the next frame; width or height 0 = whole frame.
+        // Burst, look-back and recording still get whole frames.
+        bool SetSoftwareROI(const RoiRect& roi);
+        RoiRect GetSoftwareROI() const;
+
+        // Hardware ROI: moves the camera's OffsetX / OffsetY window, also during acquisition; the size and
+        // so every buffer stays the same. Offsets are rounded down to the camera's increment and clamped
+        // to the sensor; the camera applies them from its next frame.
+        bool MoveHardwareROI(int offsetX, int offsetY);
+        bool GetHardwareROI(RoiRect& roi);
+
+        // Tracking ROI: a small hardware window recentred on a target every frame, so the camera runs at the
+        // frame rate of the window instead of the whole sensor. Enabling resizes once (and raises the frame
+        // rate); from then on targets only move the offsets on a dedicated thread, so buffers keep their size.
+        // Each frame's ImageData offsetX / offsetY is the window it was exposed with (moves are attributed
+        // by blockID, moveLatencyFrames after the last frame received). Disabling restores the size,
+        // offsets and frame rate it started from.
+        bool SetTrackingROI(const TrackingRoiConfig& config);
+        TrackingRoiConfig GetTrackingROI() const;
+
+        // Centre of the window in sensor pixels, e.g. the ball position predicted for the next frame.
+        // Never blocks on the camera: only the newest target is written when moves queue up.
+        bool SetTrackingTarget(double x, double y);
+        void GetTrackingStatistics(TrackingRoiStatistics& stats);
+
         bool SetExposureTime(double exposureTimeUs);
         bool GetExposureTime(double& exposureTimeUs);
         bool GetExposureTimeRange(double& min, double& max);
@@ -157,6 +737,14 @@ namespace CvsBallVision
         void SetSoftwareGammaEnabled(bool enable);
         bool IsSoftwareGammaEnabled();
 
+        // Apply a whole profile in one transaction: values are validated first, unchanged ones
+        // are skipped, frame rate and exposure are written in an order the camera accepts, and
+        // acquisition is stopped and buffers reallocated at most once (only if the frame size
+        // changes). If a write fails, the ones already made are undone.
+        // Features the camera lacks are ignored; start from GetParameters to change a subset.
+        bool ApplyParameters(const CameraParameters& params);
+        bool GetParameters(CameraParameters& params);
+
         bool SetPixelFormat(const std::string& format);
         std::string GetPixelFormat();
         std::vector<std::string> GetAvailablePixelFormats();
@@ -167,15 +755,67 @@ namespace CvsBallVision
         bool ExecuteSoftwareTrigger();
 
         // Image retrieval
+        // The returned frame stays pinned (never overwritten) until the next
+        // GetLatestImage call, a frame ring resize or DisconnectCamera.
         bool GetLatestImage(ImageData& imageData);
 
+        // Zero-copy access to the newest frame; valid for as long as the FrameRef is held
+        bool GetLatestFrame(FrameRef& frame);
+
+        // Frame ring configuration (applied on the next StartAcquisition)
+        bool SetFrameRingSize(size_t slotCount);
+        size_t GetFrameRingSize() const;
+
+        // Callback or pull delivery, pull thread affinity and priority (applied on the next StartAcquisition)
+        bool SetGrabConfig(const GrabConfig& config);
+        GrabConfig GetGrabConfig() const;
+
+        // Buffer pool sizing and memory (applied on the next StartAcquisition)
+        bool SetBufferPoolConfig(const BufferPoolConfig& config);
+        BufferPoolConfig GetBufferPoolConfig() const;
+        void GetBufferPoolStatistics(BufferPoolStatistics& stats);
+
+        // Processing pipeline (capture -> debayer -> post-process -> fan-out)
+        bool SetPipelineConfig(const PipelineConfig& config);
+        PipelineConfig GetPipelineConfig() const;
+        void GetPipelineStatistics(PipelineStatistics& stats);
+
+        // Bayer conversion (pattern follows the camera's PixelFormat)
+        bool SetDemosaicMethod(DemosaicMethod method);
+        DemosaicMethod GetDemosaicMethod() const;
+        bool SetColorCorrection(const ColorCorrection& correction);
+        ColorCorrection GetColorCorrection() const;
+
+        // Layout of delivered colour frames (cannot change during acquisition)
+        bool SetOutputFormat(const OutputFormat& format);
+        OutputFormat GetOutputFormat() const;
+
+        // 10/12-bit pixel formats (takes effect from the next frame)
+        bool SetHighBitDepthConfig(const HighBitDepthConfig& config);
+        HighBitDepthConfig GetHighBitDepthConfig() const;
+
+        // Tone curve, composed with software gamma into one table per frame depth and applied in the
+        // existing LUT passes (fused into the demosaic, or while unpacking 10/12-bit samples).
+        // Tables are swapped whole and take effect from the next frame. With useHardwareLut the
+        // table is written to the camera's LUT (LUTIndex / LUTValue, unchanged entries skipped) and
+        // costs the host nothing; that needs a connected camera with a LUT.
+        bool SetToneCurve(const ToneCurveConfig& config);
+        ToneCurveConfig GetToneCurve() const;
+        bool IsHardwareLutSupported() const;
+
         // Callbacks
         void RegisterImageCallback(ImageCallback callback);
+        void RegisterFrameCallback(FrameCallback callback);     // Copy the FrameRef to keep the frame
         void RegisterErrorCallback(ErrorCallback callback);
         void RegisterStatusCallback(StatusCallback callback);
+        void RegisterBurstCallback(BurstCallback callback);     // Called on the acquisition thread
+        void RegisterLookbackCallback(BurstCallback callback);  // Acquisition thread, or TriggerLookbackEvent's caller
 
         // Statistics
         void GetStatistics(uint64_t& frameCount, uint64_t& errorCount, double& currentFps);
+        void GetFrameRingStatistics(FrameRingStatistics& stats);
+        void GetInstrumentation(InstrumentationSnapshot& snapshot);
+        void ResetInstrumentation();
 
         // Error handling
         int GetLastError() const;
@@ -185,6 +825,10 @@ namespace CvsBallVision
         bool SaveParameters(const std::string& filePath);
         bool LoadParameters(const std::string& filePath);
 
+        // Pixel format, resolution, feature nodes and ranges are cached on connect and kept
+        // current by the setters above; call this after changing the device by other means
+        bool RefreshDeviceState();
+
     private:
         class Impl;
         std::unique_ptr<Impl> m_pImpl;
@@ -194,11 +838,118 @@ namespace CvsBallVision
         CameraController& operator=(const CameraController&) = delete;
     };
 
+    // How CameraGroup decides that frames from different cameras belong together
+    enum class FrameMatchMode
+    {
+        Timestamp,      // Device timestamps within the tolerance (nanosecond / PTP-synchronised clocks)
+        ArrivalTime,    // Host arrival times within the tolerance (cameras without a common clock)
+        BlockID         // Same frame count since StartAcquisition (hardware-triggered cameras)
+    };
+
+    struct CameraGroupConfig
+    {
+        FrameMatchMode matchMode = FrameMatchMode::Timestamp;
+        double matchToleranceUs = Constants::CAMERA_GROUP_MATCH_TOLERANCE_US;   // Timestamp / ArrivalTime
+        size_t maxPendingFrames = Constants::CAMERA_GROUP_PENDING_FRAMES;      // Per camera, oldest dropped first
+    };
+
+    // One frame per camera of the group, captured for the same exposure / trigger
+    struct FrameSet
+    {
+        uint64_t sequence;              // Increments per delivered set
+        std::vector<FrameRef> frames;   // Indexed like the group's cameras; each keeps its frame pinned
+        int64_t spreadNs;               // Latest minus earliest match key (0 for BlockID)
+        int64_t completedNs;            // steady_clock time the last frame of the set arrived
+    };
+
+    using FrameSetCallback = std::function<void(const FrameSet& frameSet)>;
+
+    struct CameraGroupStatistics
+    {
+        uint64_t setsDelivered;
+        uint64_t framesUnmatched;           // Dropped without partners (tolerance or pending limit)
+        LatencyStatistics setSpread;        // Match-key spread within a set
+        LatencyStatistics setAssembly;      // First frame of a set arrived -> last frame arrived
+        LatencyStatistics setLatency;       // First frame of a set arrived -> set handed to the callback
+        std::vector<InstrumentationSnapshot> cameras;   // Per camera, indexed like the group
+    };
+
+    // Several cameras acquired together: one CameraController (own device handle, buffer
+    // pools, grab and pipeline threads) per camera, with frames matched into FrameSets.
+    // Configure individual cameras through GetCamera; acquisition is controlled by the group.
+    class CVSBALLVISION_API CameraGroup
+    {
+    public:
+        CameraGroup();
+        ~CameraGroup();
+
+        // Device backend for every camera (before Initialize)
+        bool SetDeviceBackend(DeviceBackendType type,
+            const SimulatedCameraConfig& simulatedConfig = SimulatedCameraConfig());
+
+        // System initialization and enumeration
+        bool Initialize(uint32_t timeout = 500);
+        std::vector<CameraInfo> GetAvailableCameras();
+
+        // Connect the given enumerated devices (group index = position in the list)
+        bool Connect(const std::vector<uint32_t>& enumIndices);
+        void Disconnect();
+        bool IsConnected() const;
+
+        size_t GetCameraCount() const;
+        CameraController* GetCamera(size_t index);
+
+        // Matching (cannot change during acquisition)
+        bool SetConfig(const CameraGroupConfig& config);
+        CameraGroupConfig GetConfig() const;
+
+        // Starts / stops every camera; a failed start leaves none running
+        bool StartAcquisition();
+        bool StopAcquisition();
+        bool IsAcquiring() const;
+
+        // TriggerSoftware on every camera, back to back
+        bool ExecuteSoftwareTrigger();
+
+        // Called on the thread that completed the set; sets are delivered in order
+        void RegisterFrameSetCallback(FrameSetCallback callback);
+        void RegisterErrorCallback(ErrorCallback callback);     // Messages are prefixed with the camera index
+        void RegisterStatusCallback(StatusCallback callback);
+
+        void GetStatistics(CameraGroupStatistics& stats);
+        void ResetStatistics();
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> m_pImpl;
+
+        // Disable copy
+        CameraGroup(const CameraGroup&) = delete;
+        CameraGroup& operator=(const CameraGroup&) = delete;
+    };
+
     // Utility functions
     CVSBALLVISION_API std::string GetSDKVersion();
+    CVSBALLVISION_API std::string GetProcessingInstructionSet();    // "AVX2", "SSE2", "NEON" or "Scalar"
     CVSBALLVISION_API bool ConvertBayerToRGB(const uint8_t* pSrc, uint8_t* pDst,
         int width, int height,
         const std::string& bayerPattern);
+    CVSBALLVISION_API int GetOutputStep(int width, const OutputFormat& format);    // Row stride of a colour frame
+    CVSBALLVISION_API bool ConvertBayerToDisplay(const uint8_t* pSrc, uint8_t* pDst,   // pDst: GetOutputStep * height bytes
+        int width, int height,
+        const std::string& bayerPattern, const OutputFormat& format);
+    CVSBALLVISION_API ImageView MakeImageView(const ImageData& image);
+    CVSBALLVISION_API bool CropImageView(const ImageView& view, const RoiRect& rect,     // rect in view pixels; false unless
+        ImageView& cropped);                                                            // it lies inside (even x for RawPacked)
     CVSBALLVISION_API bool ApplyGammaCorrection(uint8_t* pData, int width, int height,
         int channels, double gamma);
+    CVSBALLVISION_API int GetRawRowBytes(int width, const std::string& pixelFormat);     // 0 for formats that are not Mono/Bayer
+    CVSBALLVISION_API bool UnpackRawToU16(const uint8_t* pSrc, uint16_t* pDst,            // pSrc: rows of GetRawRowBytes
+        int width, int height, const std::string& pixelFormat);
+    CVSBALLVISION_API bool UnpackRawToU8(const uint8_t* pSrc, uint8_t* pDst,
+        int width, int height, const std::string& pixelFormat, int shift = -1);         // -1 = keep the top 8 bits
+    CVSBALLVISION_API bool BuildToneCurve(const ToneCurveConfig& config,               // TONE_CURVE_ENTRIES 12-bit values
+        std::vector<uint16_t>& table);                                                  // (enabled is ignored)
+    CVSBALLVISION_API bool BuildToneCurve8(const ToneCurveConfig& config,              // 12-bit in, 8-bit out, e.g. for
+        std::vector<uint8_t>& table);                                                   // HighBitDepthConfig::toneCurve
 }
\ No newline at end of file
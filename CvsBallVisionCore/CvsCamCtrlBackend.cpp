@@ -0,0 +1,188 @@
+#include "CameraBackend.h"
+
+#ifndef CVSBALLVISION_NO_CVSCAMCTRL
+
+#pragma comment(lib, "cvsCamCtrl.lib")
+
+namespace CvsBallVision
+{
+    // Thin pass-through to the CREVIS cvsCamCtrl SDK
+    class CvsCamCtrlBackend : public ICameraBackend
+    {
+    private:
+        static std::mutex s_systemMutex;
+        static int s_systemRefs;
+
+    public:
+        const char* GetName() const override { return "cvsCamCtrl"; }
+
+        // The SDK system is process-wide; it is shared by every controller (CameraGroup members,
+        // the group's enumerator) and freed with the last one
+        CVS_ERROR InitSystem() override
+        {
+            std::lock_guard<std::mutex> lock(s_systemMutex);
+            if (s_systemRefs == 0)
+            {
+                CVS_ERROR status = ST_InitSystem();
+                if (status != MCAM_ERR_OK)
+                    return status;
+            }
+            s_systemRefs++;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR FreeSystem() override
+        {
+            std::lock_guard<std::mutex> lock(s_systemMutex);
+            if (s_systemRefs == 0 || --s_systemRefs > 0)
+                return MCAM_ERR_OK;
+
+            return ST_FreeSystem();
+        }
+        CVS_ERROR UpdateDevice(uint32_t timeout) override { return ST_UpdateDevice(timeout); }
+        CVS_ERROR GetAvailableCameraNum(uint32_t* pCamNum) override { return ST_GetAvailableCameraNum(pCamNum); }
+
+        CVS_ERROR GetDeviceInfo(uint32_t enumIndex, CameraInfo& info) override
+        {
+            char buffer[256];
+            uint32_t size;
+
+            info.enumIndex = enumIndex;
+            info.isConnected = false;
+
+            // Get User ID
+            size = 256;
+            if (ST_GetEnumDeviceInfo(enumIndex, MCAM_DEVICEINFO_USER_ID, buffer, &size) == MCAM_ERR_OK)
+                info.userID = buffer;
+
+            // Get Model Name
+            size = 256;
+            if (ST_GetEnumDeviceInfo(enumIndex, MCAM_DEVICEINFO_MODEL_NAME, buffer, &size) == MCAM_ERR_OK)
+                info.modelName = buffer;
+
+            // Get Serial Number
+            size = 256;
+            if (ST_GetEnumDeviceInfo(enumIndex, MCAM_DEVICEINFO_SERIAL_NUMBER, buffer, &size) == MCAM_ERR_OK)
+                info.serialNumber = buffer;
+
+            // Get Device Version
+            size = 256;
+            if (ST_GetEnumDeviceInfo(enumIndex, MCAM_DEVICEINFO_DEVICE_VERSION, buffer, &size) == MCAM_ERR_OK)
+                info.deviceVersion = buffer;
+
+            // Get IP Address (GigE only)
+            size = 256;
+            if (ST_GetEnumDeviceInfo(enumIndex, MCAM_DEVICEINFO_IP_ADDRESS, buffer, &size) == MCAM_ERR_OK)
+                info.ipAddress = buffer;
+
+            // Get MAC Address (GigE only)
+            size = 256;
+            if (ST_GetEnumDeviceInfo(enumIndex, MCAM_DEVICEINFO_MAC_ADDRESS, buffer, &size) == MCAM_ERR_OK)
+                info.macAddress = buffer;
+
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR OpenDevice(uint32_t enumIndex, int32_t* phDevice) override { return ST_OpenDevice(enumIndex, phDevice); }
+        CVS_ERROR CloseDevice(int32_t hDevice) override { return ST_CloseDevice(hDevice); }
+        CVS_ERROR AcqStart(int32_t hDevice) override { return ST_AcqStart(hDevice); }
+        CVS_ERROR AcqStop(int32_t hDevice) override { return ST_AcqStop(hDevice); }
+
+        CVS_ERROR RegisterGrabCallback(int32_t hDevice, GrabCallbackFunc callback, void* pUserDefine) override
+        {
+            return ST_RegisterGrabCallback(hDevice, EVENT_NEW_IMAGE, callback, pUserDefine);
+        }
+
+        CVS_ERROR UnregisterGrabCallback(int32_t hDevice) override
+        {
+            return ST_UnregisterGrabCallback(hDevice, EVENT_NEW_IMAGE);
+        }
+
+        CVS_ERROR InitBuffer(int32_t hDevice, CVS_BUFFER* pBuffer, int32_t channels) override
+        {
+            return ST_InitBuffer(hDevice, pBuffer, channels);
+        }
+
+        CVS_ERROR FreeBuffer(CVS_BUFFER* pBuffer) override { return ST_FreeBuffer(pBuffer); }
+        CVS_ERROR GrabImage(int32_t hDevice, CVS_BUFFER* pBuffer) override { return ST_GrabImage(hDevice, pBuffer); }
+
+        CVS_ERROR CvtColor(const CVS_BUFFER& src, CVS_BUFFER* pDst, int32_t code) override
+        {
+            return ST_CvtColor(src, pDst, code);
+        }
+
+        CVS_ERROR GetIntReg(int32_t hDevice, const char* nodeName, int64_t* pValue) override
+        {
+            return ST_GetIntReg(hDevice, nodeName, pValue);
+        }
+
+        CVS_ERROR SetIntReg(int32_t hDevice, const char* nodeName, int64_t value) override
+        {
+            return ST_SetIntReg(hDevice, nodeName, value);
+        }
+
+        CVS_ERROR GetIntRegRange(int32_t hDevice, const char* nodeName, int64_t* pMin, int64_t* pMax, int64_t* pInc) override
+        {
+            return ST_GetIntRegRange(hDevice, nodeName, pMin, pMax, pInc);
+        }
+
+        CVS_ERROR GetFloatReg(int32_t hDevice, const char* nodeName, double* pValue) override
+        {
+            return ST_GetFloatReg(hDevice, nodeName, pValue);
+        }
+
+        CVS_ERROR SetFloatReg(int32_t hDevice, const char* nodeName, double value) override
+        {
+            return ST_SetFloatReg(hDevice, nodeName, value);
+        }
+
+        CVS_ERROR GetFloatRegRange(int32_t hDevice, const char* nodeName, double* pMin, double* pMax) override
+        {
+            return ST_GetFloatRegRange(hDevice, nodeName, pMin, pMax);
+        }
+
+        CVS_ERROR GetEnumReg(int32_t hDevice, const char* nodeName, char* pValue, uint32_t* pSize) override
+        {
+            return ST_GetEnumReg(hDevice, nodeName, pValue, pSize);
+        }
+
+        CVS_ERROR SetEnumReg(int32_t hDevice, const char* nodeName, const char* value) override
+        {
+            return ST_SetEnumReg(hDevice, nodeName, const_cast<char*>(value));
+        }
+
+        CVS_ERROR GetEnumEntrySize(int32_t hDevice, const char* nodeName, int32_t* pSize) override
+        {
+            return ST_GetEnumEntrySize(hDevice, nodeName, pSize);
+        }
+
+        CVS_ERROR GetEnumEntryValue(int32_t hDevice, const char* nodeName, int32_t index, char* pValue, uint32_t* pSize) override
+        {
+            return ST_GetEnumEntryValue(hDevice, nodeName, index, pValue, pSize);
+        }
+
+        CVS_ERROR SetBoolReg(int32_t hDevice, const char* nodeName, bool value) override
+        {
+            return ST_SetBoolReg(hDevice, nodeName, value);
+        }
+
+        CVS_ERROR SetCmdReg(int32_t hDevice, const char* nodeName) override
+        {
+            return ST_SetCmdReg(hDevice, nodeName);
+        }
+
+        CVS_ERROR ExportJson(int32_t hDevice, const char* filePath) override { return ST_ExportJson(hDevice, filePath); }
+        CVS_ERROR ImportJson(int32_t hDevice, const char* filePath) override { return ST_ImportJson(hDevice, filePath); }
+        const char* GetLastErrorDescription(int32_t hDevice) override { return ST_GetLastErrorDescription(hDevice); }
+    };
+
+    std::mutex CvsCamCtrlBackend::s_systemMutex;
+    int CvsCamCtrlBackend::s_systemRefs = 0;
+
+    std::unique_ptr<ICameraBackend> CreateCvsCamCtrlBackend()
+    {
+        return std::make_unique<CvsCamCtrlBackend>();
+    }
+}
+
+#endif
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "ImageProcessing.h"
+#include <atomic>
+#include <string>
+
+namespace CvsBallVision
+{
+    // Camera features the controller exposes
+    enum DeviceFeature
+    {
+        DEVICE_FEATURE_EXPOSURE = 0,
+        DEVICE_FEATURE_GAIN,
+        DEVICE_FEATURE_FRAME_RATE,
+        DEVICE_FEATURE_GAMMA,
+        DEVICE_FEATURE_COUNT
+    };
+
+    // Device configuration cached by the controller.
+    //
+    // Filled from the camera on connect, then kept in step by the controller's own setters
+    // (which know what they wrote), so getters and the frame path never go to the device.
+    // Feature values and ranges are read lazily and dropped when a write may have moved them.
+    // Node names, values and ranges are control-path state. The frame format and feature availability
+    // are atomics so the processing stages can read them without locking, register I/O or allocation.
+    class DeviceStateCache
+    {
+    public:
+        DeviceStateCache()
+            : m_frameFormat(FRAME_FORMAT_RAW)
+            , m_rawFormat(RAW_FORMAT_8BIT)
+            , m_offset(0)
+            , m_featureMask(0)
+        {
+            Clear();
+        }
+
+        void Clear()
+        {
+            m_pixelFormat.clear();
+            m_frameFormat.store(FRAME_FORMAT_RAW, std::memory_order_relaxed);
+            m_rawFormat.store(RAW_FORMAT_8BIT, std::memory_order_relaxed);
+            m_width = 0;
+            m_height = 0;
+            m_offset.store(0, std::memory_order_relaxed);
+
+            for (int i = 0; i < DEVICE_FEATURE_COUNT; ++i)
+            {
+                m_featureNodes[i].clear();
+            }
+            m_featureMask.store(0, std::memory_order_relaxed);
+            InvalidateFeatures();
+        }
+
+        // Pixel format as reported by the camera (also decides the frame format)
+        void SetPixelFormat(const std::string& format)
+        {
+            m_pixelFormat = format;
+
+            ImageProcessing::BayerPattern pattern;
+            int frameFormat = ImageProcessing::ParseBayerPattern(format, pattern) ?
+                static_cast<int>(pattern) : FRAME_FORMAT_RAW;
+            m_frameFormat.store(frameFormat, std::memory_order_release);
+
+            ImageProcessing::RawFormat raw;
+            int rawFormat = ImageProcessing::ParseRawFormat(format, raw) ?
+                raw.bitDepth | (raw.bPacked ? RAW_FORMAT_PACKED : 0) : RAW_FORMAT_8BIT;
+            m_rawFormat.store(rawFormat, std::memory_order_release);
+        }
+
+        const std::string& GetPixelFormat() const { return m_pixelFormat; }
+
+        // Frame path: false for non-Bayer formats
+        bool GetBayerPattern(ImageProcessing::BayerPattern& pattern) const
+        {
+            int frameFormat = m_frameFormat.load(std::memory_order_acquire);
+            if (frameFormat == FRAME_FORMAT_RAW)
+                return false;
+
+            pattern = static_cast<ImageProcessing::BayerPattern>(frameFormat);
+            return true;
+        }
+
+        // Frame path: sample layout (8-bit for anything that is not Mono/Bayer 10/12)
+        ImageProcessing::RawFormat GetRawFormat() const
+        {
+            int rawFormat = m_rawFormat.load(std::memory_order_acquire);
+            ImageProcessing::RawFormat format;
+            format.bitDepth = rawFormat & ~RAW_FORMAT_PACKED;
+            format.bPacked = (rawFormat & RAW_FORMAT_PACKED) != 0;
+            return format;
+        }
+
+        // One raw frame at the cached resolution
+        size_t GetRawFrameBytes() const
+        {
+            return static_cast<size_t>(ImageProcessing::GetRawRowBytes(m_width, GetRawFormat())) * m_height;
+        }
+
+        void SetResolution(int width, int height)
+        {
+            m_width = width;
+            m_height = height;
+        }
+
+        int GetWidth() const { return m_width; }
+        int GetHeight() const { return m_height; }
+
+        // Hardware ROI origin as last written; x and y are stored together so readers never see half a move
+        void SetOffset(int x, int y)
+        {
+            m_offset.store((static_cast<uint64_t>(static_cast<uint32_t>(y)) << 32) | static_cast<uint32_t>(x),
+                std::memory_order_release);
+        }
+
+        void GetOffset(int& x, int& y) const
+        {
+            uint64_t offset = m_offset.load(std::memory_order_acquire);
+            x = static_cast<int>(static_cast<uint32_t>(offset));
+            y = static_cast<int>(static_cast<uint32_t>(offset >> 32));
+        }
+
+        // Node that controls a feature on this camera; empty when it is not available
+        void SetFeatureNode(DeviceFeature feature, const std::string& nodeName)
+        {
+            m_featureNodes[feature] = nodeName;
+            InvalidateFeature(feature);
+
+            const uint32_t bit = 1u << feature;
+            if (nodeName.empty())
+                m_featureMask.fetch_and(~bit, std::memory_order_relaxed);
+            else
+                m_featureMask.fetch_or(bit, std::memory_order_relaxed);
+        }
+
+        const std::string& GetFeatureNode(DeviceFeature feature) const { return m_featureNodes[feature]; }
+
+        bool HasFeature(DeviceFeature feature) const
+        {
+            return (m_featureMask.load(std::memory_order_relaxed) & (1u << feature)) != 0;
+        }
+
+        // Last value written to / read from the feature
+        bool GetValue(DeviceFeature feature, double& value) const
+        {
+            if (!m_features[feature].bValueValid)
+                return false;
+
+            value = m_features[feature].value;
+            return true;
+        }
+
+        void SetValue(DeviceFeature feature, double value)
+        {
+            m_features[feature].bValueValid = true;
+            m_features[feature].value = value;
+        }
+
+        // Ranges are read from the device once and kept until a write invalidates them
+        bool GetRange(DeviceFeature feature, double& min, double& max) const
+        {
+            if (!m_features[feature].bRangeValid)
+                return false;
+
+            min = m_features[feature].min;
+            max = m_features[feature].max;
+            return true;
+        }
+
+        void SetRange(DeviceFeature feature, double min, double max)
+        {
+            m_features[feature].bRangeValid = true;
+            m_features[feature].min = min;
+            m_features[feature].max = max;
+        }
+
+        // Drop the cached value and range (re-read on next use)
+        void InvalidateFeature(DeviceFeature feature)
+        {
+            m_features[feature].bValueValid = false;
+            m_features[feature].bRangeValid = false;
+        }
+
+        void InvalidateFeatures()
+        {
+            for (int i = 0; i < DEVICE_FEATURE_COUNT; ++i)
+            {
+                InvalidateFeature(static_cast<DeviceFeature>(i));
+            }
+        }
+
+    private:
+        static constexpr int FRAME_FORMAT_RAW = -1;     // Anything that is not Bayer
+        static constexpr int RAW_FORMAT_8BIT = 8;
+        static constexpr int RAW_FORMAT_PACKED = 0x100;
+
+        struct FeatureState
+        {
+            bool bValueValid;
+            bool bRangeValid;
+            double value;
+            double min;
+            double max;
+        };
+
+        std::string m_pixelFormat;
+        std::atomic<int> m_frameFormat;     // BayerPattern, or FRAME_FORMAT_RAW
+        std::atomic<int> m_rawFormat;       // Bit depth | RAW_FORMAT_PACKED
+        int m_width;
+        int m_height;
+        std::atomic<uint64_t> m_offset;     // OffsetY << 32 | OffsetX
+        std::string m_featureNodes[DEVICE_FEATURE_COUNT];
+        std::atomic<uint32_t> m_featureMask;    // Bit per DeviceFeature with a node
+        FeatureState m_features[DEVICE_FEATURE_COUNT];
+    };
+}
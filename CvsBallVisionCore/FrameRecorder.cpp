@@ -0,0 +1,445 @@
+#include "FrameRecorder.h"
+#include "ProcessingPipeline.h"
+#include <algorithm>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace CvsBallVision
+{
+    using namespace Constants;
+
+    namespace
+    {
+        size_t AlignUp(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        size_t RecordBytes(size_t dataBytes)
+        {
+            return sizeof(RecordingFrameHeader) + AlignUp(dataBytes, RECORDING_RECORD_ALIGNMENT);
+        }
+    }
+
+    FrameRecorder::FrameRecorder()
+#if defined(_WIN32)
+        : m_hFile(INVALID_HANDLE_VALUE)
+#else
+        : m_fd(-1)
+#endif
+        , m_bDirectIo(false)
+        , m_rawFormat({ 8, false })
+        , m_pCurrent(nullptr)
+        , m_chunkBytes(0)
+        , m_nextChunk(0)
+        , m_bRecording(false)
+        , m_bStopWriter(false)
+        , m_framesRecorded(0)
+        , m_framesDropped(0)
+        , m_bytesWritten(0)
+        , m_chunksWritten(0)
+        , m_writeErrors(0)
+        , m_queueHighWaterMark(0)
+        , m_startNs(0)
+        , m_stopNs(0)
+    {
+    }
+
+    FrameRecorder::~FrameRecorder()
+    {
+        Stop();
+    }
+
+    bool FrameRecorder::Start(const RecordingConfig& config, size_t maxFrameBytes, const std::string& pixelFormat,
+        ErrorHandler onError, std::string& error)
+    {
+        std::lock_guard<std::mutex> control(m_controlMutex);
+        if (m_bRecording)
+        {
+            error = "Recording already in progress";
+            return false;
+        }
+
+        if (config.path.empty() || config.chunkCount < 2)
+        {
+            error = "Invalid recording configuration";
+            return false;
+        }
+
+        // Every chunk holds at least one full frame
+        const size_t chunkBytes = AlignUp(std::max(config.chunkBytes, sizeof(RecordingChunkHeader) + RecordBytes(maxFrameBytes)),
+            RECORDING_ALIGNMENT);
+
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        for (uint32_t i = 0; i < config.chunkCount; ++i)
+        {
+            std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>();
+            if (!chunk->data.Reserve(chunkBytes, config.lockMemory))
+            {
+                error = "Failed to allocate recording buffers";
+                return false;
+            }
+            chunk->used = 0;
+            chunk->frameCount = 0;
+            chunks.push_back(std::move(chunk));
+        }
+
+        bool bDirectIo = false;
+        if (!m_header.Reserve(RECORDING_ALIGNMENT, false) || !OpenFile(config.path, config.directIo, bDirectIo))
+        {
+            error = "Failed to create recording file";
+            return false;
+        }
+
+        const int64_t startNs = ToSteadyNs(std::chrono::steady_clock::now());
+
+        ImageProcessing::RawFormat rawFormat = { 8, false };
+        ImageProcessing::ParseRawFormat(pixelFormat, rawFormat);
+
+        RecordingFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "CVSRAW1", 8);
+        header.version = RECORDING_VERSION;
+        header.headerBytes = static_cast<uint32_t>(RECORDING_ALIGNMENT);
+        header.chunkBytes = chunkBytes;
+        header.startNs = startNs;
+        strncpy(header.pixelFormat, pixelFormat.c_str(), RECORDING_PIXEL_FORMAT_SIZE - 1);
+
+        memset(m_header.Data(), 0, RECORDING_ALIGNMENT);
+        memcpy(m_header.Data(), &header, sizeof(header));
+        if (!WriteAt(m_header.Data(), RECORDING_ALIGNMENT, 0))
+        {
+            CloseFile();
+            error = "Failed to write recording header";
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_chunks = std::move(chunks);
+            m_free.clear();
+            m_queued.clear();
+            for (auto& chunk : m_chunks)
+            {
+                m_free.push_back(chunk.get());
+            }
+            m_chunkBytes = chunkBytes;
+            m_bDirectIo = bDirectIo;
+            m_rawFormat = rawFormat;
+            m_startNs = startNs;
+            m_stopNs = 0;
+            m_onError = onError;
+            m_pCurrent = nullptr;
+            m_nextChunk = 0;
+            m_bStopWriter = false;
+            m_queueHighWaterMark = 0;
+        }
+        m_framesRecorded = 0;
+        m_framesDropped = 0;
+        m_bytesWritten = 0;
+        m_chunksWritten = 0;
+        m_writeErrors = 0;
+        m_copyHistogram.Reset();
+        m_writeHistogram.Reset();
+
+        m_writer = std::thread(&FrameRecorder::WriterThread, this);
+        m_bRecording.store(true, std::memory_order_release);
+        return true;
+    }
+
+    bool FrameRecorder::Stop()
+    {
+        std::lock_guard<std::mutex> control(m_controlMutex);
+        if (!m_bRecording)
+            return true;
+
+        // Flush the partial chunk and let the writer drain the queue
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bRecording.store(false, std::memory_order_release);
+            QueueCurrent();
+            m_bStopWriter = true;
+        }
+        m_cvQueued.notify_all();
+
+        if (m_writer.joinable())
+        {
+            m_writer.join();
+        }
+
+        // Final counts go into the header block written at start
+        RecordingFileHeader* pHeader = reinterpret_cast<RecordingFileHeader*>(m_header.Data());
+        pHeader->chunkCount = m_nextChunk;
+        pHeader->frameCount = m_framesRecorded.load(std::memory_order_relaxed);
+        const bool bOk = WriteAt(m_header.Data(), RECORDING_ALIGNMENT, 0) &&
+            m_writeErrors.load(std::memory_order_relaxed) == 0;
+
+        CloseFile();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopNs = ToSteadyNs(std::chrono::steady_clock::now());
+        m_free.clear();
+        m_queued.clear();
+        m_chunks.clear();
+        return bOk;
+    }
+
+    void FrameRecorder::Record(const CVS_BUFFER& buffer, int64_t receivedNs)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_bRecording.load(std::memory_order_relaxed))
+            return;
+
+        const int channels = buffer.image.channels > 0 ? buffer.image.channels : 1;
+        const int rowBytes = GetBufferRowBytes(buffer, m_rawFormat);
+        const int srcStep = buffer.image.step >= rowBytes ? buffer.image.step : rowBytes;
+        const int height = buffer.image.height;
+        const size_t dataBytes = static_cast<size_t>(rowBytes) * height;
+        const size_t recordBytes = RecordBytes(dataBytes);
+
+        if (sizeof(RecordingChunkHeader) + recordBytes > m_chunkBytes)
+        {
+            // Resolution grew since StartRecording
+            m_framesDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if (m_pCurrent && m_pCurrent->used + recordBytes > m_chunkBytes)
+        {
+            QueueCurrent();
+        }
+
+        if (!m_pCurrent)
+        {
+            if (m_free.empty())
+            {
+                // Back-pressure: the disk is behind, never wait for it here
+                m_framesDropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            m_pCurrent = m_free.back();
+            m_free.pop_back();
+            m_pCurrent->used = sizeof(RecordingChunkHeader);
+            m_pCurrent->frameCount = 0;
+        }
+
+        uint8_t* pRecord = m_pCurrent->data.Data() + m_pCurrent->used;
+
+        RecordingFrameHeader header;
+        memset(&header, 0, sizeof(header));
+        header.blockID = buffer.blockID;
+        header.timestamp = buffer.timestamp;
+        header.receivedNs = receivedNs;
+        header.width = buffer.image.width;
+        header.height = height;
+        header.channels = channels;
+        header.step = rowBytes;
+        header.dataBytes = static_cast<uint32_t>(dataBytes);
+        header.recordBytes = static_cast<uint32_t>(recordBytes);
+        memcpy(pRecord, &header, sizeof(header));
+
+        uint8_t* pDst = pRecord + sizeof(header);
+        const uint8_t* pSrc = static_cast<const uint8_t*>(buffer.image.pImage);
+        if (srcStep == rowBytes)
+        {
+            memcpy(pDst, pSrc, dataBytes);
+        }
+        else
+        {
+            for (int y = 0; y < height; ++y)
+            {
+                memcpy(pDst + static_cast<size_t>(y) * rowBytes, pSrc + static_cast<size_t>(y) * srcStep, rowBytes);
+            }
+        }
+        memset(pDst + dataBytes, 0, recordBytes - sizeof(header) - dataBytes);
+
+        m_pCurrent->used += recordBytes;
+        m_pCurrent->frameCount++;
+        lock.unlock();
+
+        m_framesRecorded.fetch_add(1, std::memory_order_relaxed);
+        m_copyHistogram.Record(std::chrono::steady_clock::now() - startTime);
+    }
+
+    void FrameRecorder::QueueCurrent()
+    {
+        // Caller holds m_mutex
+        if (!m_pCurrent)
+            return;
+
+        RecordingChunkHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = RECORDING_CHUNK_MAGIC;
+        header.frameCount = m_pCurrent->frameCount;
+        header.sequence = m_nextChunk++;
+        header.payloadBytes = m_pCurrent->used;
+        memcpy(m_pCurrent->data.Data(), &header, sizeof(header));
+
+        m_queued.push_back(m_pCurrent);
+        m_pCurrent = nullptr;
+        m_queueHighWaterMark = std::max(m_queueHighWaterMark, static_cast<uint32_t>(m_queued.size()));
+        m_cvQueued.notify_one();
+    }
+
+    void FrameRecorder::WriterThread()
+    {
+        bool bFailed = false;
+
+        while (true)
+        {
+            Chunk* pChunk = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cvQueued.wait(lock, [this] { return !m_queued.empty() || m_bStopWriter; });
+                if (m_queued.empty())
+                    break;
+
+                pChunk = m_queued.front();
+                m_queued.pop_front();
+            }
+
+            const RecordingChunkHeader* pHeader = reinterpret_cast<const RecordingChunkHeader*>(pChunk->data.Data());
+            const uint64_t offset = RECORDING_ALIGNMENT + pHeader->sequence * m_chunkBytes;
+
+            // Unused tail is zeroed here, off the capture path, so stale records never reach the file
+            memset(pChunk->data.Data() + pHeader->payloadBytes, 0, m_chunkBytes - static_cast<size_t>(pHeader->payloadBytes));
+
+            // After a failed write the remaining chunks are only counted
+            if (!bFailed)
+            {
+                auto startTime = std::chrono::steady_clock::now();
+                if (WriteAt(pChunk->data.Data(), m_chunkBytes, offset))
+                {
+                    m_writeHistogram.Record(std::chrono::steady_clock::now() - startTime);
+                    m_bytesWritten.fetch_add(m_chunkBytes, std::memory_order_relaxed);
+                    m_chunksWritten.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    bFailed = true;
+                    if (m_onError)
+                    {
+                        m_onError("Recording write failed; further frames are discarded");
+                    }
+                }
+            }
+
+            if (bFailed)
+            {
+                m_writeErrors.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.push_back(pChunk);
+        }
+    }
+
+    void FrameRecorder::GetStatistics(RecordingStatistics& stats) const
+    {
+        memset(&stats, 0, sizeof(stats));
+        stats.framesRecorded = m_framesRecorded.load(std::memory_order_relaxed);
+        stats.framesDropped = m_framesDropped.load(std::memory_order_relaxed);
+        stats.bytesWritten = m_bytesWritten.load(std::memory_order_relaxed);
+        stats.chunksWritten = m_chunksWritten.load(std::memory_order_relaxed);
+        stats.writeErrors = m_writeErrors.load(std::memory_order_relaxed);
+        m_copyHistogram.GetStatistics(stats.frameCopy);
+        m_writeHistogram.GetStatistics(stats.chunkWrite);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stats.chunksQueued = static_cast<uint32_t>(m_queued.size());
+        stats.queueHighWaterMark = m_queueHighWaterMark;
+        stats.directIo = m_bDirectIo;
+
+        if (m_startNs != 0)
+        {
+            const int64_t endNs = m_bRecording ? ToSteadyNs(std::chrono::steady_clock::now()) : m_stopNs;
+            if (endNs > m_startNs)
+                stats.throughputMBps = stats.bytesWritten / 1048576.0 / ((endNs - m_startNs) / 1e9);
+        }
+    }
+
+    bool FrameRecorder::OpenFile(const std::string& path, bool bDirectIo, bool& bDirectIoUsed)
+    {
+#if defined(_WIN32)
+        // Unbuffered: sector-aligned offsets, sizes and buffers (all multiples of RECORDING_ALIGNMENT)
+        DWORD flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+        m_hFile = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+            flags | (bDirectIo ? FILE_FLAG_NO_BUFFERING : 0), nullptr);
+        bDirectIoUsed = bDirectIo && m_hFile != INVALID_HANDLE_VALUE;
+        if (m_hFile == INVALID_HANDLE_VALUE && bDirectIo)
+        {
+            m_hFile = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, flags, nullptr);
+        }
+        return m_hFile != INVALID_HANDLE_VALUE;
+#else
+        const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+        m_fd = -1;
+#if defined(O_DIRECT)
+        if (bDirectIo)
+        {
+            m_fd = open(path.c_str(), flags | O_DIRECT, 0644);
+        }
+#endif
+        bDirectIoUsed = m_fd >= 0;
+        if (m_fd < 0)
+        {
+            // Volume without direct I/O support (tmpfs, some network mounts)
+            m_fd = open(path.c_str(), flags, 0644);
+        }
+        return m_fd >= 0;
+#endif
+    }
+
+    bool FrameRecorder::WriteAt(const void* pData, size_t bytes, uint64_t offset)
+    {
+#if defined(_WIN32)
+        OVERLAPPED overlapped;
+        memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.Offset = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+        DWORD written = 0;
+        return WriteFile(m_hFile, pData, static_cast<DWORD>(bytes), &written, &overlapped) && written == bytes;
+#else
+        const uint8_t* p = static_cast<const uint8_t*>(pData);
+        while (bytes > 0)
+        {
+            ssize_t written = pwrite(m_fd, p, bytes, static_cast<off_t>(offset));
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return false;
+
+            p += written;
+            bytes -= static_cast<size_t>(written);
+            offset += static_cast<uint64_t>(written);
+        }
+        return true;
+#endif
+    }
+
+    void FrameRecorder::CloseFile()
+    {
+#if defined(_WIN32)
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_hFile);
+            m_hFile = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (m_fd >= 0)
+        {
+            close(m_fd);
+            m_fd = -1;
+        }
+#endif
+    }
+}
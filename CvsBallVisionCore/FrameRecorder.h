@@ -0,0 +1,147 @@
+#pragma once
+
+#include "CvsBallVisionCore.h"
+#include "AlignedBuffer.h"
+#include "CameraBackend.h"
+#include "LatencyHistogram.h"
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace CvsBallVision
+{
+    // Raw recording container. Little-endian; every block is a multiple of RECORDING_ALIGNMENT.
+    //
+    //   [file header, one alignment block]
+    //   [chunk 0][chunk 1] ...              each exactly chunkBytes long
+    //
+    // A chunk is a RecordingChunkHeader followed by frameCount records, each a RecordingFrameHeader
+    // and its pixels (rows back to back in the camera's pixel format) padded to RECORDING_RECORD_ALIGNMENT.
+    // The rest of the chunk is zero. frameCount in the file header is written when recording stops.
+    constexpr uint32_t RECORDING_VERSION = 1;
+    constexpr uint32_t RECORDING_CHUNK_MAGIC = 0x4B4E4843;     // "CHNK"
+    constexpr size_t RECORDING_RECORD_ALIGNMENT = 64;
+    constexpr size_t RECORDING_PIXEL_FORMAT_SIZE = 32;
+
+    struct RecordingFileHeader
+    {
+        char magic[8];                  // "CVSRAW1"
+        uint32_t version;
+        uint32_t headerBytes;           // Offset of the first chunk
+        uint64_t chunkBytes;
+        uint64_t chunkCount;
+        uint64_t frameCount;
+        int64_t startNs;                // Steady clock at StartRecording
+        char pixelFormat[RECORDING_PIXEL_FORMAT_SIZE];
+    };
+
+    struct RecordingChunkHeader
+    {
+        uint32_t magic;
+        uint32_t frameCount;
+        uint64_t sequence;              // Chunk index in the file
+        uint64_t payloadBytes;          // Header plus records actually used
+        uint64_t reserved[5];
+    };
+
+    struct RecordingFrameHeader
+    {
+        uint64_t blockID;
+        uint64_t timestamp;             // Camera timestamp
+        int64_t receivedNs;             // Host steady clock
+        int32_t width;
+        int32_t height;
+        int32_t channels;
+        int32_t step;
+        uint32_t dataBytes;
+        uint32_t recordBytes;           // Header + padded pixels: offset of the next record
+        uint32_t reserved[4];
+    };
+
+    static_assert(sizeof(RecordingFileHeader) <= Constants::RECORDING_ALIGNMENT, "File header must fit one block");
+    static_assert(sizeof(RecordingChunkHeader) == RECORDING_RECORD_ALIGNMENT, "Records must stay aligned");
+    static_assert(sizeof(RecordingFrameHeader) == RECORDING_RECORD_ALIGNMENT, "Pixels must stay aligned");
+
+    // Streams raw frames into chunk buffers on the capture path and writes full chunks to disk
+    // from its own thread.
+    //
+    // The capture path copies the frame into the current chunk under an uncontended mutex and
+    // never waits on the disk: when every chunk is queued or being written the frame is dropped
+    // and counted. The writer issues one chunk-sized, aligned write at a time, unbuffered when
+    // the volume allows it, so throughput is bounded by the disk rather than the page cache.
+    class FrameRecorder
+    {
+    public:
+        using ErrorHandler = std::function<void(const std::string& message)>;
+
+        FrameRecorder();
+        ~FrameRecorder();
+
+        // Control path: opens the file and allocates every chunk up front
+        bool Start(const RecordingConfig& config, size_t maxFrameBytes, const std::string& pixelFormat,
+            ErrorHandler onError, std::string& error);
+        bool Stop();
+
+        bool IsRecording() const
+        {
+            return m_bRecording.load(std::memory_order_acquire);
+        }
+
+        // Frame path
+        void Record(const CVS_BUFFER& buffer, int64_t receivedNs);
+
+        void GetStatistics(RecordingStatistics& stats) const;
+
+    private:
+        struct Chunk
+        {
+            AlignedBuffer data;
+            size_t used;
+            uint32_t frameCount;
+        };
+
+        void WriterThread();
+        bool OpenFile(const std::string& path, bool bDirectIo, bool& bDirectIoUsed);
+        bool WriteAt(const void* pData, size_t bytes, uint64_t offset);
+        void CloseFile();
+        void QueueCurrent();
+
+        // File
+#if defined(_WIN32)
+        HANDLE m_hFile;
+#else
+        int m_fd;
+#endif
+        bool m_bDirectIo;
+        ImageProcessing::RawFormat m_rawFormat;     // Row size of Mono/Bayer frames
+        AlignedBuffer m_header;             // One block, rewritten on Stop
+        ErrorHandler m_onError;
+
+        // Chunks: free -> current (capture path) -> queued -> writer -> free
+        std::vector<std::unique_ptr<Chunk>> m_chunks;
+        std::vector<Chunk*> m_free;
+        std::deque<Chunk*> m_queued;
+        Chunk* m_pCurrent;
+        size_t m_chunkBytes;
+        uint64_t m_nextChunk;               // Sequence of the next chunk handed to the writer
+
+        std::atomic<bool> m_bRecording;
+        bool m_bStopWriter;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_cvQueued;
+        std::thread m_writer;
+        std::mutex m_controlMutex;          // Serialises Start / Stop
+
+        // Statistics
+        std::atomic<uint64_t> m_framesRecorded;
+        std::atomic<uint64_t> m_framesDropped;
+        std::atomic<uint64_t> m_bytesWritten;
+        std::atomic<uint64_t> m_chunksWritten;
+        std::atomic<uint64_t> m_writeErrors;
+        uint32_t m_queueHighWaterMark;
+        int64_t m_startNs;
+        int64_t m_stopNs;
+        LatencyHistogram m_copyHistogram;
+        LatencyHistogram m_writeHistogram;
+    };
+}
@@ -0,0 +1,273 @@
+#pragma once
+
+#include "CvsBallVisionCore.h"
+#include "AlignedBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace CvsBallVision
+{
+    // Fixed set of owned frame slots shared between the acquisition thread and consumers.
+    //
+    // Producers claim a free slot, fill it and publish it with a new sequence number.
+    // Consumers pin the latest published slot; a pinned slot is never overwritten, so the
+    // pixels stay stable for as long as the pin is held. When every slot other than the
+    // latest is pinned the incoming frame is dropped and counted instead of blocking.
+    //
+    // Slot state lives in a single atomic word per slot:
+    //   bit 31     - a producer is writing the slot
+    //   bits 0..30 - number of pins held (consumers plus the publishing producer)
+    //
+    // The ring itself is intrusively reference counted so FrameRefs handed to consumers
+    // keep their slot memory alive even after the controller drops or resizes the ring.
+    class FrameRing
+    {
+    public:
+        static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+
+        // Returns a ring holding one reference (release with ReleaseRef).
+        // Slot memory is page aligned; bLockMemory also locks it into RAM (best effort).
+        static FrameRing* Create(size_t slotCount = FRAME_RING_DEFAULT_SLOTS, bool bLockMemory = false)
+        {
+            return new FrameRing(slotCount, bLockMemory);
+        }
+
+        void AddRef()
+        {
+            m_refCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void ReleaseRef()
+        {
+            if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete this;
+        }
+
+        size_t GetSlotCount() const { return m_slots.size(); }
+        bool GetLockMemory() const { return m_bLockMemory; }
+
+        // Every allocated slot is locked into RAM
+        bool IsMemoryLocked() const
+        {
+            for (const auto& slot : m_slots)
+            {
+                if (slot.data.Data() && !slot.data.IsLocked())
+                    return false;
+            }
+            return true;
+        }
+
+        // Pre-size every slot so the acquisition path does not allocate
+        void Reserve(size_t bytesPerSlot)
+        {
+            for (auto& slot : m_slots)
+            {
+                if (slot.state.load(std::memory_order_acquire) == 0)
+                    slot.data.Reserve(bytesPerSlot, m_bLockMemory);
+            }
+        }
+
+        // Forget the latest frame (e.g. on acquisition restart); pinned slots stay valid
+        void Reset()
+        {
+            m_latest.store(0, std::memory_order_release);
+        }
+
+        // Claim a slot for writing. Returns INVALID_SLOT (and counts a drop) if all are pinned.
+        uint32_t BeginWrite(size_t requiredBytes, uint8_t*& pData)
+        {
+            const uint32_t count = static_cast<uint32_t>(m_slots.size());
+            const uint32_t latestSlot = SlotOf(m_latest.load(std::memory_order_acquire));
+            uint32_t start = m_writeCursor.fetch_add(1, std::memory_order_relaxed);
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint32_t index = (start + i) % count;
+                if (index == latestSlot)
+                    continue;   // Keep the newest frame available for GetLatest
+
+                uint32_t expected = 0;
+                if (m_slots[index].state.compare_exchange_strong(expected, WRITING,
+                    std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    Slot& slot = m_slots[index];
+                    if (!slot.data.Reserve(requiredBytes, m_bLockMemory))
+                    {
+                        AbortWrite(index);
+                        break;
+                    }
+                    pData = slot.data.Data();
+                    return index;
+                }
+            }
+
+            m_framesDropped.fetch_add(1, std::memory_order_relaxed);
+            pData = nullptr;
+            return INVALID_SLOT;
+        }
+
+        // Give up a claimed slot without publishing it
+        void AbortWrite(uint32_t index)
+        {
+            m_slots[index].state.fetch_sub(WRITING, std::memory_order_release);
+        }
+
+        // Publish a written slot (fills meta.pData and meta.sequence).
+        // The producer keeps one pin and must call Release when done.
+        uint64_t Publish(uint32_t index, ImageData& meta)
+        {
+            Slot& slot = m_slots[index];
+            uint64_t sequence = m_nextSequence.fetch_add(1, std::memory_order_relaxed);
+
+            meta.pData = slot.data.Data();
+            meta.sequence = sequence;
+            slot.meta = meta;
+            slot.sequence.store(sequence, std::memory_order_relaxed);
+
+            // Writing -> pinned once by the producer
+            slot.state.fetch_add(1 - WRITING, std::memory_order_release);
+
+            // Only move the latest pointer forward (producers may publish out of order)
+            uint64_t packed = Pack(sequence, index);
+            uint64_t current = m_latest.load(std::memory_order_relaxed);
+            while ((current >> SLOT_BITS) < sequence &&
+                !m_latest.compare_exchange_weak(current, packed,
+                    std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+            }
+
+            m_framesPublished.fetch_add(1, std::memory_order_relaxed);
+            return sequence;
+        }
+
+        // Pin the latest published frame. Returns INVALID_SLOT if nothing is available.
+        uint32_t PinLatest(ImageData& imageData)
+        {
+            for (;;)
+            {
+                uint64_t latest = m_latest.load(std::memory_order_acquire);
+                if (latest == 0)
+                    return INVALID_SLOT;
+
+                uint32_t index = SlotOf(latest);
+                Slot& slot = m_slots[index];
+                uint32_t state = slot.state.fetch_add(1, std::memory_order_acquire);
+
+                // Slot was recycled between reading m_latest and pinning it
+                if ((state & WRITING) || slot.sequence.load(std::memory_order_relaxed) != (latest >> SLOT_BITS))
+                {
+                    slot.state.fetch_sub(1, std::memory_order_release);
+                    continue;
+                }
+
+                imageData = slot.meta;
+                return index;
+            }
+        }
+
+        // Add a pin to a slot the caller already holds pinned
+        void AddPin(uint32_t index)
+        {
+            m_slots[index].state.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void Release(uint32_t index)
+        {
+            if (index < m_slots.size())
+                m_slots[index].state.fetch_sub(1, std::memory_order_release);
+        }
+
+        uint64_t GetLatestSequence() const
+        {
+            return m_latest.load(std::memory_order_acquire) >> SLOT_BITS;
+        }
+
+        uint64_t GetFramesPublished() const { return m_framesPublished.load(std::memory_order_relaxed); }
+        uint64_t GetFramesDropped() const { return m_framesDropped.load(std::memory_order_relaxed); }
+
+        uint32_t GetPinnedSlotCount() const
+        {
+            uint32_t pinned = 0;
+            for (const auto& slot : m_slots)
+            {
+                if ((slot.state.load(std::memory_order_relaxed) & ~WRITING) != 0)
+                    pinned++;
+            }
+            return pinned;
+        }
+
+        void ResetStatistics()
+        {
+            m_framesPublished.store(0, std::memory_order_relaxed);
+            m_framesDropped.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        FrameRing(size_t slotCount, bool bLockMemory)
+            : m_slots(std::max<size_t>(FRAME_RING_MIN_SLOTS, std::min<size_t>(slotCount, FRAME_RING_MAX_SLOTS)))
+            , m_bLockMemory(bLockMemory)
+            , m_refCount(1)
+            , m_latest(0)
+            , m_nextSequence(1)
+            , m_writeCursor(0)
+            , m_framesPublished(0)
+            , m_framesDropped(0)
+        {
+        }
+
+        ~FrameRing() = default;
+
+        FrameRing(const FrameRing&) = delete;
+        FrameRing& operator=(const FrameRing&) = delete;
+
+        static constexpr uint32_t WRITING = 0x80000000u;
+        static constexpr uint32_t SLOT_BITS = 8;
+        static constexpr size_t FRAME_RING_DEFAULT_SLOTS = Constants::FRAME_RING_SIZE;
+        static constexpr size_t FRAME_RING_MIN_SLOTS = Constants::FRAME_RING_MIN_SIZE;
+        static constexpr size_t FRAME_RING_MAX_SLOTS = Constants::FRAME_RING_MAX_SIZE;
+
+        struct Slot
+        {
+            AlignedBuffer data;
+            ImageData meta;
+            std::atomic<uint32_t> state;
+            std::atomic<uint64_t> sequence;
+
+            Slot() : state(0), sequence(0)
+            {
+                memset(&meta, 0, sizeof(meta));
+            }
+        };
+
+        static uint64_t Pack(uint64_t sequence, uint32_t index)
+        {
+            return (sequence << SLOT_BITS) | index;
+        }
+
+        static uint32_t SlotOf(uint64_t packed)
+        {
+            return packed == 0 ? INVALID_SLOT : static_cast<uint32_t>(packed & ((1u << SLOT_BITS) - 1));
+        }
+
+        std::vector<Slot> m_slots;
+        const bool m_bLockMemory;
+        std::atomic<uint32_t> m_refCount;
+        std::atomic<uint64_t> m_latest;         // (sequence << 8) | slot, 0 = empty
+        std::atomic<uint64_t> m_nextSequence;
+        std::atomic<uint32_t> m_writeCursor;
+        std::atomic<uint64_t> m_framesPublished;
+        std::atomic<uint64_t> m_framesDropped;
+    };
+
+    // Owning pointer for the controller's reference to the ring
+    struct FrameRingReleaser
+    {
+        void operator()(FrameRing* pRing) const
+        {
+            if (pRing)
+                pRing->ReleaseRef();
+        }
+    };
+
+    using FrameRingPtr = std::unique_ptr<FrameRing, FrameRingReleaser>;
+}
@@ -0,0 +1,1750 @@
+#include "ImageProcessing.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CVSBALLVISION_X86 1
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#define CVSBALLVISION_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC/Clang need per-function target attributes to emit SSE/AVX code without global -m flags.
+// MSVC accepts the intrinsics anywhere.
+#if defined(CVSBALLVISION_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CVSBALLVISION_TARGET_SSE2 __attribute__((target("sse2")))
+#define CVSBALLVISION_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define CVSBALLVISION_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CVSBALLVISION_TARGET_SSE2
+#define CVSBALLVISION_TARGET_SSSE3
+#define CVSBALLVISION_TARGET_AVX2
+#endif
+
+namespace CvsBallVision
+{
+    namespace ImageProcessing
+    {
+        namespace
+        {
+            // Bytes reserved on each side of a padded row (only x = -1 and x = width are read)
+            constexpr int ROW_PADDING = 32;
+
+            // Three mirrored input rows and the planar output of one demosaiced row.
+            // Rows are indexed so that [0] is x = 0; [-1] and [width] hold the mirrored border.
+            struct DemosaicRow
+            {
+                const uint8_t* pUp;
+                const uint8_t* pMid;
+                const uint8_t* pDown;
+                uint8_t* pNative;       // Chroma channel sampled on this row (R on red rows, B on blue rows)
+                uint8_t* pGreen;
+                uint8_t* pOpposite;     // The other chroma channel
+                int width;
+                int chromaParity;       // x parity of the chroma samples on this row
+                bool edgeAware;
+            };
+
+            // Reference kernel; every SIMD path must match it bit for bit
+            inline void DemosaicPixelScalar(const DemosaicRow& row, int x)
+            {
+                const uint8_t* u = row.pUp;
+                const uint8_t* m = row.pMid;
+                const uint8_t* d = row.pDown;
+
+                const int c = m[x];
+                const int l = m[x - 1];
+                const int r = m[x + 1];
+                const int up = u[x];
+                const int dn = d[x];
+
+                const int horz = (l + r + 1) >> 1;
+                const int vert = (up + dn + 1) >> 1;
+
+                if ((x & 1) == row.chromaParity)
+                {
+                    int green = (l + r + up + dn + 2) >> 2;
+                    if (row.edgeAware)
+                    {
+                        // Interpolate green along the edge, not across it
+                        const int gradH = std::abs(l - r);
+                        const int gradV = std::abs(up - dn);
+                        if (gradH < gradV)
+                            green = horz;
+                        else if (gradV < gradH)
+                            green = vert;
+                    }
+
+                    row.pNative[x] = static_cast<uint8_t>(c);
+                    row.pGreen[x] = static_cast<uint8_t>(green);
+                    row.pOpposite[x] = static_cast<uint8_t>((u[x - 1] + u[x + 1] + d[x - 1] + d[x + 1] + 2) >> 2);
+                }
+                else
+                {
+                    row.pNative[x] = static_cast<uint8_t>(horz);
+                    row.pGreen[x] = static_cast<uint8_t>(c);
+                    row.pOpposite[x] = static_cast<uint8_t>(vert);
+                }
+            }
+
+            void DemosaicRowScalar(const DemosaicRow& row, int startX)
+            {
+                for (int x = startX; x < row.width; ++x)
+                {
+                    DemosaicPixelScalar(row, x);
+                }
+            }
+
+            void PackRgbScalar(const uint8_t* pR, const uint8_t* pG, const uint8_t* pB,
+                uint8_t* pDst, int startX, int width)
+            {
+                for (int x = startX; x < width; ++x)
+                {
+                    pDst[x * 3 + 0] = pR[x];
+                    pDst[x * 3 + 1] = pG[x];
+                    pDst[x * 3 + 2] = pB[x];
+                }
+            }
+
+#ifdef CVSBALLVISION_X86
+            // (a + b + c + d + 2) >> 2 per byte
+            CVSBALLVISION_TARGET_SSE2 inline __m128i Average4Sse2(__m128i a, __m128i b, __m128i c, __m128i d)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i two = _mm_set1_epi16(2);
+
+                __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)),
+                    _mm_add_epi16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(d, zero)));
+                __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)),
+                    _mm_add_epi16(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(d, zero)));
+
+                lo = _mm_srli_epi16(_mm_add_epi16(lo, two), 2);
+                hi = _mm_srli_epi16(_mm_add_epi16(hi, two), 2);
+                return _mm_packus_epi16(lo, hi);
+            }
+
+            CVSBALLVISION_TARGET_SSE2 inline __m128i SelectSse2(__m128i mask, __m128i a, __m128i b)
+            {
+                return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+            }
+
+            CVSBALLVISION_TARGET_SSE2 int DemosaicRowSse2(const DemosaicRow& row)
+            {
+                const __m128i chromaMask = (row.chromaParity == 0) ?
+                    _mm_set1_epi16(0x00FF) : _mm_set1_epi16(static_cast<short>(0xFF00));
+
+                int x = 0;
+                for (; x + 16 <= row.width; x += 16)
+                {
+                    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.pMid + x));
+                    const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.pMid + x - 1));
+                    const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.pMid + x + 1));
+                    const __m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.pUp + x));
+                    const __m128i dn = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.pDown + x));
+                    const __m128i ul = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.pUp + x - 1));
+                    const __m128i ur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.pUp + x + 1));
+                    const __m128i dl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.pDown + x - 1));
+                    const __m128i dr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.pDown + x + 1));
+
+                    const __m128i horz = _mm_avg_epu8(l, r);
+                    const __m128i vert = _mm_avg_epu8(up, dn);
+                    const __m128i diag = Average4Sse2(ul, ur, dl, dr);
+                    __m128i green = Average4Sse2(l, r, up, dn);
+
+                    if (row.edgeAware)
+                    {
+                        const __m128i gradH = _mm_or_si128(_mm_subs_epu8(l, r), _mm_subs_epu8(r, l));
+                        const __m128i gradV = _mm_or_si128(_mm_subs_epu8(up, dn), _mm_subs_epu8(dn, up));
+                        const __m128i minGrad = _mm_min_epu8(gradH, gradV);
+                        const __m128i equal = _mm_cmpeq_epi8(gradH, gradV);
+                        const __m128i useH = _mm_andnot_si128(equal, _mm_cmpeq_epi8(minGrad, gradH));
+                        const __m128i useV = _mm_andnot_si128(equal, _mm_cmpeq_epi8(minGrad, gradV));
+                        green = SelectSse2(useH, horz, SelectSse2(useV, vert, green));
+                    }
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(row.pNative + x), SelectSse2(chromaMask, c, horz));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(row.pGreen + x), SelectSse2(chromaMask, green, c));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(row.pOpposite + x), SelectSse2(chromaMask, diag, vert));
+                }
+
+                return x;
+            }
+
+            // pshufb masks that interleave 16 R, G and B bytes into three 16-byte RGB24 chunks
+            struct Rgb24ShuffleTable
+            {
+                alignas(16) uint8_t masks[3][3][16];   // [output chunk][channel][byte]
+
+                Rgb24ShuffleTable()
+                {
+                    for (int chunk = 0; chunk < 3; ++chunk)
+                    {
+                        for (int channel = 0; channel < 3; ++channel)
+                        {
+                            for (int i = 0; i < 16; ++i)
+                            {
+                                int outByte = chunk * 16 + i;
+                                masks[chunk][channel][i] = (outByte % 3 == channel) ?
+                                    static_cast<uint8_t>(outByte / 3) : 0x80;
+                            }
+                        }
+                    }
+                }
+            };
+
+            const Rgb24ShuffleTable& GetRgb24ShuffleTable()
+            {
+                static const Rgb24ShuffleTable table;
+                return table;
+            }
+
+            CVSBALLVISION_TARGET_SSSE3 int PackRgbSsse3(const uint8_t* pR, const uint8_t* pG, const uint8_t* pB,
+                uint8_t* pDst, int width)
+            {
+                const Rgb24ShuffleTable& table = GetRgb24ShuffleTable();
+                __m128i masks[3][3];
+                for (int chunk = 0; chunk < 3; ++chunk)
+                {
+                    for (int channel = 0; channel < 3; ++channel)
+                    {
+                        masks[chunk][channel] = _mm_load_si128(reinterpret_cast<const __m128i*>(table.masks[chunk][channel]));
+                    }
+                }
+
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pR + x));
+                    const __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pG + x));
+                    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + x));
+
+                    for (int chunk = 0; chunk < 3; ++chunk)
+                    {
+                        __m128i out = _mm_or_si128(
+                            _mm_or_si128(_mm_shuffle_epi8(r, masks[chunk][0]), _mm_shuffle_epi8(g, masks[chunk][1])),
+                            _mm_shuffle_epi8(b, masks[chunk][2]));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + x * 3 + chunk * 16), out);
+                    }
+                }
+
+                return x;
+            }
+
+            CVSBALLVISION_TARGET_AVX2 inline __m256i Average4Avx2(__m256i a, __m256i b, __m256i c, __m256i d)
+            {
+                const __m256i zero = _mm256_setzero_si256();
+                const __m256i two = _mm256_set1_epi16(2);
+
+                // unpack/pack both work per 128-bit lane, so byte order is preserved
+                __m256i lo = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero)),
+                    _mm256_add_epi16(_mm256_unpacklo_epi8(c, zero), _mm256_unpacklo_epi8(d, zero)));
+                __m256i hi = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero)),
+                    _mm256_add_epi16(_mm256_unpackhi_epi8(c, zero), _mm256_unpackhi_epi8(d, zero)));
+
+                lo = _mm256_srli_epi16(_mm256_add_epi16(lo, two), 2);
+                hi = _mm256_srli_epi16(_mm256_add_epi16(hi, two), 2);
+                return _mm256_packus_epi16(lo, hi);
+            }
+
+            CVSBALLVISION_TARGET_AVX2 inline __m256i SelectAvx2(__m256i mask, __m256i a, __m256i b)
+            {
+                return _mm256_blendv_epi8(b, a, mask);
+            }
+
+            CVSBALLVISION_TARGET_AVX2 int DemosaicRowAvx2(const DemosaicRow& row)
+            {
+                const __m256i chromaMask = (row.chromaParity == 0) ?
+                    _mm256_set1_epi16(0x00FF) : _mm256_set1_epi16(static_cast<short>(0xFF00));
+
+                int x = 0;
+                for (; x + 32 <= row.width; x += 32)
+                {
+                    const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.pMid + x));
+                    const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.pMid + x - 1));
+                    const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.pMid + x + 1));
+                    const __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.pUp + x));
+                    const __m256i dn = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.pDown + x));
+                    const __m256i ul = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.pUp + x - 1));
+                    const __m256i ur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.pUp + x + 1));
+                    const __m256i dl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.pDown + x - 1));
+                    const __m256i dr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.pDown + x + 1));
+
+                    const __m256i horz = _mm256_avg_epu8(l, r);
+                    const __m256i vert = _mm256_avg_epu8(up, dn);
+                    const __m256i diag = Average4Avx2(ul, ur, dl, dr);
+                    __m256i green = Average4Avx2(l, r, up, dn);
+
+                    if (row.edgeAware)
+                    {
+                        const __m256i gradH = _mm256_or_si256(_mm256_subs_epu8(l, r), _mm256_subs_epu8(r, l));
+                        const __m256i gradV = _mm256_or_si256(_mm256_subs_epu8(up, dn), _mm256_subs_epu8(dn, up));
+                        const __m256i minGrad = _mm256_min_epu8(gradH, gradV);
+                        const __m256i equal = _mm256_cmpeq_epi8(gradH, gradV);
+                        const __m256i useH = _mm256_andnot_si256(equal, _mm256_cmpeq_epi8(minGrad, gradH));
+                        const __m256i useV = _mm256_andnot_si256(equal, _mm256_cmpeq_epi8(minGrad, gradV));
+                        green = SelectAvx2(useH, horz, SelectAvx2(useV, vert, green));
+                    }
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(row.pNative + x), SelectAvx2(chromaMask, c, horz));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(row.pGreen + x), SelectAvx2(chromaMask, green, c));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(row.pOpposite + x), SelectAvx2(chromaMask, diag, vert));
+                }
+
+                return x;
+            }
+
+            void Cpuid(int info[4], int leaf, int subLeaf)
+            {
+#if defined(_MSC_VER)
+                __cpuidex(info, leaf, subLeaf);
+#else
+                unsigned int a = 0, b = 0, c = 0, d = 0;
+                __cpuid_count(leaf, subLeaf, a, b, c, d);
+                info[0] = static_cast<int>(a);
+                info[1] = static_cast<int>(b);
+                info[2] = static_cast<int>(c);
+                info[3] = static_cast<int>(d);
+#endif
+            }
+
+            uint64_t ReadXcr0()
+            {
+#if defined(_MSC_VER)
+                return _xgetbv(0);
+#else
+                uint32_t lo = 0, hi = 0;
+                __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+                return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+            }
+#endif // CVSBALLVISION_X86
+
+#ifdef CVSBALLVISION_NEON
+            inline uint8x16_t Average4Neon(uint8x16_t a, uint8x16_t b, uint8x16_t c, uint8x16_t d)
+            {
+                uint16x8_t lo = vaddq_u16(vaddl_u8(vget_low_u8(a), vget_low_u8(b)), vaddl_u8(vget_low_u8(c), vget_low_u8(d)));
+                uint16x8_t hi = vaddq_u16(vaddl_u8(vget_high_u8(a), vget_high_u8(b)), vaddl_u8(vget_high_u8(c), vget_high_u8(d)));
+
+                // Rounding narrow shift: (sum + 2) >> 2
+                return vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2));
+            }
+
+            int DemosaicRowNeon(const DemosaicRow& row)
+            {
+                static const uint8_t evenMaskBytes[16] = {
+                    0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0 };
+                const uint8x16_t evenMask = vld1q_u8(evenMaskBytes);
+                const uint8x16_t chromaMask = (row.chromaParity == 0) ? evenMask : vmvnq_u8(evenMask);
+
+                int x = 0;
+                for (; x + 16 <= row.width; x += 16)
+                {
+                    const uint8x16_t c = vld1q_u8(row.pMid + x);
+                    const uint8x16_t l = vld1q_u8(row.pMid + x - 1);
+                    const uint8x16_t r = vld1q_u8(row.pMid + x + 1);
+                    const uint8x16_t up = vld1q_u8(row.pUp + x);
+                    const uint8x16_t dn = vld1q_u8(row.pDown + x);
+                    const uint8x16_t ul = vld1q_u8(row.pUp + x - 1);
+                    const uint8x16_t ur = vld1q_u8(row.pUp + x + 1);
+                    const uint8x16_t dl = vld1q_u8(row.pDown + x - 1);
+                    const uint8x16_t dr = vld1q_u8(row.pDown + x + 1);
+
+                    // vrhaddq_u8 is (a + b + 1) >> 1
+                    const uint8x16_t horz = vrhaddq_u8(l, r);
+                    const uint8x16_t vert = vrhaddq_u8(up, dn);
+                    const uint8x16_t diag = Average4Neon(ul, ur, dl, dr);
+                    uint8x16_t green = Average4Neon(l, r, up, dn);
+
+                    if (row.edgeAware)
+                    {
+                        const uint8x16_t gradH = vabdq_u8(l, r);
+                        const uint8x16_t gradV = vabdq_u8(up, dn);
+                        green = vbslq_u8(vcltq_u8(gradH, gradV), horz,
+                            vbslq_u8(vcltq_u8(gradV, gradH), vert, green));
+                    }
+
+                    vst1q_u8(row.pNative + x, vbslq_u8(chromaMask, c, horz));
+                    vst1q_u8(row.pGreen + x, vbslq_u8(chromaMask, green, c));
+                    vst1q_u8(row.pOpposite + x, vbslq_u8(chromaMask, diag, vert));
+                }
+
+                return x;
+            }
+
+            int PackRgbNeon(const uint8_t* pR, const uint8_t* pG, const uint8_t* pB, uint8_t* pDst, int width)
+            {
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    uint8x16x3_t rgb;
+                    rgb.val[0] = vld1q_u8(pR + x);
+                    rgb.val[1] = vld1q_u8(pG + x);
+                    rgb.val[2] = vld1q_u8(pB + x);
+                    vst3q_u8(pDst + x * 3, rgb);
+                }
+                return x;
+            }
+#endif // CVSBALLVISION_NEON
+
+            SimdLevel DetectSimdLevel()
+            {
+#if defined(CVSBALLVISION_NEON)
+                return SimdLevel::NEON;
+#elif defined(CVSBALLVISION_X86)
+                int info[4] = { 0 };
+                Cpuid(info, 0, 0);
+                const int maxLeaf = info[0];
+
+                Cpuid(info, 1, 0);
+                const bool hasSse2 = (info[3] & (1 << 26)) != 0;
+                const bool hasSsse3 = (info[2] & (1 << 9)) != 0;
+                const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+                const bool hasAvx = (info[2] & (1 << 28)) != 0;
+
+                bool hasAvx2 = false;
+                if (maxLeaf >= 7 && hasOsxsave && hasAvx && hasSsse3)
+                {
+                    // The OS must also save the YMM registers
+                    if ((ReadXcr0() & 0x6) == 0x6)
+                    {
+                        Cpuid(info, 7, 0);
+                        hasAvx2 = (info[1] & (1 << 5)) != 0;
+                    }
+                }
+
+                if (hasAvx2)
+                    return SimdLevel::AVX2;
+                if (hasSse2)
+                    return SimdLevel::SSE2;
+                return SimdLevel::Scalar;
+#else
+                return SimdLevel::Scalar;
+#endif
+            }
+
+            bool IsSimdLevelSupported(SimdLevel level)
+            {
+                if (level == SimdLevel::Scalar)
+                    return true;
+
+                SimdLevel best = GetSimdLevel();
+                switch (level)
+                {
+                case SimdLevel::SSE2: return best == SimdLevel::SSE2 || best == SimdLevel::AVX2;
+                case SimdLevel::AVX2: return best == SimdLevel::AVX2;
+                case SimdLevel::NEON: return best == SimdLevel::NEON;
+                default: return false;
+                }
+            }
+
+            // Copy a source row into a padded buffer with mirrored borders
+            void PadRow(uint8_t* pDst, const uint8_t* pSrc, int width)
+            {
+                memcpy(pDst, pSrc, width);
+                pDst[-1] = pSrc[1];
+                pDst[width] = pSrc[width - 2];
+            }
+
+            int MirrorRow(int y, int height)
+            {
+                if (y < 0)
+                    return 1;
+                if (y >= height)
+                    return height - 2;
+                return y;
+            }
+
+            // Images below these sizes are not worth splitting across threads
+            constexpr size_t DEMOSAIC_PARALLEL_MIN_PIXELS = 256 * 1024;
+            constexpr int DEMOSAIC_MIN_ROWS_PER_BAND = 32;
+            constexpr size_t LUT_PARALLEL_MIN_BYTES = 512 * 1024;
+            constexpr int LUT_MIN_ROWS_PER_BAND = 16;
+
+            size_t ApplyLutScalar(uint8_t* pData, size_t count, const uint8_t* pTable)
+            {
+                size_t i = 0;
+                for (; i + 4 <= count; i += 4)
+                {
+                    uint8_t a = pTable[pData[i + 0]];
+                    uint8_t b = pTable[pData[i + 1]];
+                    uint8_t c = pTable[pData[i + 2]];
+                    uint8_t d = pTable[pData[i + 3]];
+                    pData[i + 0] = a;
+                    pData[i + 1] = b;
+                    pData[i + 2] = c;
+                    pData[i + 3] = d;
+                }
+                for (; i < count; ++i)
+                {
+                    pData[i] = pTable[pData[i]];
+                }
+                return count;
+            }
+
+#ifdef CVSBALLVISION_X86
+            // 256-entry lookup: pshufb the low nibble into all 16 sub-tables, then pick the
+            // right result with a blend tree on bits 4..7 (blendv tests bit 7 of each mask byte,
+            // so the selector bits are shifted up into that position).
+            // Lookup in the 64 entries selected by bits 6..7 (sub-tables 4q .. 4q+3)
+            CVSBALLVISION_TARGET_AVX2 inline __m256i SelectLutQuarterAvx2(const uint8_t (*pTables)[32], int quarter,
+                __m256i index, __m256i bit4, __m256i bit5)
+            {
+                const uint8_t (*p)[32] = pTables + quarter * 4;
+                __m256i t0 = _mm256_shuffle_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(p[0])), index);
+                __m256i t1 = _mm256_shuffle_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(p[1])), index);
+                __m256i t2 = _mm256_shuffle_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(p[2])), index);
+                __m256i t3 = _mm256_shuffle_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(p[3])), index);
+                return _mm256_blendv_epi8(_mm256_blendv_epi8(t0, t1, bit4), _mm256_blendv_epi8(t2, t3, bit4), bit5);
+            }
+
+            CVSBALLVISION_TARGET_AVX2 size_t ApplyLutAvx2(uint8_t* pData, size_t count, const uint8_t* pTable)
+            {
+                // Sub-tables stay in memory and are reloaded per use; keeping all 16 in
+                // registers forces spills and is slower than the extra loads
+                alignas(32) uint8_t tables[16][32];
+                for (int h = 0; h < 16; ++h)
+                {
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(tables[h]), _mm256_broadcastsi128_si256(
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTable + h * 16))));
+                }
+
+                const __m256i lowMask = _mm256_set1_epi8(0x0F);
+
+                size_t i = 0;
+                for (; i + 32 <= count; i += 32)
+                {
+                    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + i));
+                    const __m256i index = _mm256_and_si256(v, lowMask);
+                    const __m256i bit4 = _mm256_slli_epi16(v, 3);
+                    const __m256i bit5 = _mm256_slli_epi16(v, 2);
+                    const __m256i bit6 = _mm256_slli_epi16(v, 1);
+
+                    const __m256i low = _mm256_blendv_epi8(
+                        SelectLutQuarterAvx2(tables, 0, index, bit4, bit5), SelectLutQuarterAvx2(tables, 1, index, bit4, bit5), bit6);
+                    const __m256i high = _mm256_blendv_epi8(
+                        SelectLutQuarterAvx2(tables, 2, index, bit4, bit5), SelectLutQuarterAvx2(tables, 3, index, bit4, bit5), bit6);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pData + i), _mm256_blendv_epi8(low, high, v));
+                }
+
+                return i;
+            }
+#endif
+
+#if defined(CVSBALLVISION_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+            // Four 64-entry table lookups; out-of-range indices return 0
+            size_t ApplyLutNeon(uint8_t* pData, size_t count, const uint8_t* pTable)
+            {
+                uint8x16x4_t tables[4];
+                for (int t = 0; t < 4; ++t)
+                {
+                    for (int j = 0; j < 4; ++j)
+                    {
+                        tables[t].val[j] = vld1q_u8(pTable + t * 64 + j * 16);
+                    }
+                }
+
+                const uint8x16_t offset = vdupq_n_u8(64);
+
+                size_t i = 0;
+                for (; i + 16 <= count; i += 16)
+                {
+                    uint8x16_t index = vld1q_u8(pData + i);
+                    uint8x16_t result = vqtbl4q_u8(tables[0], index);
+                    for (int t = 1; t < 4; ++t)
+                    {
+                        index = vsubq_u8(index, offset);
+                        result = vorrq_u8(result, vqtbl4q_u8(tables[t], index));
+                    }
+                    vst1q_u8(pData + i, result);
+                }
+
+                return i;
+            }
+#endif
+
+            void ApplyLutSpan(uint8_t* pData, size_t count, const uint8_t* pTable, SimdLevel level)
+            {
+                size_t done = 0;
+                switch (level)
+                {
+#ifdef CVSBALLVISION_X86
+                case SimdLevel::AVX2:
+                    done = ApplyLutAvx2(pData, count, pTable);
+                    break;
+#endif
+#if defined(CVSBALLVISION_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+                case SimdLevel::NEON:
+                    done = ApplyLutNeon(pData, count, pTable);
+                    break;
+#endif
+                default:
+                    break;
+                }
+
+                ApplyLutScalar(pData + done, count - done, pTable);
+            }
+
+            // Colour matrix: out = clamp((m0 * r + m1 * g + m2 * b + round) >> 10), Q10 coefficients
+            constexpr int COLOR_MATRIX_ROUND = 1 << (COLOR_MATRIX_FRACTION_BITS - 1);
+
+            void ColorMatrixRowScalar(uint8_t* pR, uint8_t* pG, uint8_t* pB, int startX, int width, const int16_t* pMatrix)
+            {
+                for (int x = startX; x < width; ++x)
+                {
+                    const int r = pR[x];
+                    const int g = pG[x];
+                    const int b = pB[x];
+
+                    uint8_t* pOut[3] = { pR + x, pG + x, pB + x };
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        int value = (pMatrix[c * 3 + 0] * r + pMatrix[c * 3 + 1] * g + pMatrix[c * 3 + 2] * b +
+                            COLOR_MATRIX_ROUND) >> COLOR_MATRIX_FRACTION_BITS;
+                        *pOut[c] = static_cast<uint8_t>(std::min(255, std::max(0, value)));
+                    }
+                }
+            }
+
+            void PackBgraScalar(const uint8_t* pR, const uint8_t* pG, const uint8_t* pB,
+                uint8_t* pDst, int startX, int width)
+            {
+                for (int x = startX; x < width; ++x)
+                {
+                    pDst[x * 4 + 0] = pB[x];
+                    pDst[x * 4 + 1] = pG[x];
+                    pDst[x * 4 + 2] = pR[x];
+                    pDst[x * 4 + 3] = 0xFF;
+                }
+            }
+
+#ifdef CVSBALLVISION_X86
+            // Two int16 coefficients in one 32-bit lane for pmaddwd
+            inline int PackCoefficientPair(int low, int high)
+            {
+                return static_cast<int>(static_cast<uint32_t>(static_cast<uint16_t>(low)) |
+                    (static_cast<uint32_t>(static_cast<uint16_t>(high)) << 16));
+            }
+
+            // 8 pixels of one output channel: (r,g) and (b,1) word pairs against (m0,m1) and (m2,round)
+            CVSBALLVISION_TARGET_SSE2 inline __m128i ColorChannelSse2(__m128i r16, __m128i g16, __m128i b16,
+                __m128i coeffRG, __m128i coeffB1)
+            {
+                const __m128i one = _mm_set1_epi16(1);
+                __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(r16, g16), coeffRG),
+                    _mm_madd_epi16(_mm_unpacklo_epi16(b16, one), coeffB1));
+                __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(r16, g16), coeffRG),
+                    _mm_madd_epi16(_mm_unpackhi_epi16(b16, one), coeffB1));
+                return _mm_packs_epi32(_mm_srai_epi32(lo, COLOR_MATRIX_FRACTION_BITS),
+                    _mm_srai_epi32(hi, COLOR_MATRIX_FRACTION_BITS));
+            }
+
+            CVSBALLVISION_TARGET_SSE2 int ColorMatrixRowSse2(uint8_t* pR, uint8_t* pG, uint8_t* pB, int width, const int16_t* pMatrix)
+            {
+                __m128i coeffRG[3];
+                __m128i coeffB1[3];
+                for (int c = 0; c < 3; ++c)
+                {
+                    coeffRG[c] = _mm_set1_epi32(PackCoefficientPair(pMatrix[c * 3 + 0], pMatrix[c * 3 + 1]));
+                    coeffB1[c] = _mm_set1_epi32(PackCoefficientPair(pMatrix[c * 3 + 2], COLOR_MATRIX_ROUND));
+                }
+
+                const __m128i zero = _mm_setzero_si128();
+                uint8_t* pPlanes[3] = { pR, pG, pB };
+
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pR + x));
+                    const __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pG + x));
+                    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + x));
+
+                    const __m128i rLo = _mm_unpacklo_epi8(r, zero), rHi = _mm_unpackhi_epi8(r, zero);
+                    const __m128i gLo = _mm_unpacklo_epi8(g, zero), gHi = _mm_unpackhi_epi8(g, zero);
+                    const __m128i bLo = _mm_unpacklo_epi8(b, zero), bHi = _mm_unpackhi_epi8(b, zero);
+
+                    // All three inputs are loaded before any plane is overwritten
+                    __m128i out[3];
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        out[c] = _mm_packus_epi16(ColorChannelSse2(rLo, gLo, bLo, coeffRG[c], coeffB1[c]),
+                            ColorChannelSse2(rHi, gHi, bHi, coeffRG[c], coeffB1[c]));
+                    }
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(pPlanes[c] + x), out[c]);
+                    }
+                }
+
+                return x;
+            }
+
+            CVSBALLVISION_TARGET_AVX2 inline __m256i ColorChannelAvx2(__m256i r16, __m256i g16, __m256i b16,
+                __m256i coeffRG, __m256i coeffB1)
+            {
+                const __m256i one = _mm256_set1_epi16(1);
+                __m256i lo = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(r16, g16), coeffRG),
+                    _mm256_madd_epi16(_mm256_unpacklo_epi16(b16, one), coeffB1));
+                __m256i hi = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(r16, g16), coeffRG),
+                    _mm256_madd_epi16(_mm256_unpackhi_epi16(b16, one), coeffB1));
+                return _mm256_packs_epi32(_mm256_srai_epi32(lo, COLOR_MATRIX_FRACTION_BITS),
+                    _mm256_srai_epi32(hi, COLOR_MATRIX_FRACTION_BITS));
+            }
+
+            CVSBALLVISION_TARGET_AVX2 int ColorMatrixRowAvx2(uint8_t* pR, uint8_t* pG, uint8_t* pB, int width, const int16_t* pMatrix)
+            {
+                __m256i coeffRG[3];
+                __m256i coeffB1[3];
+                for (int c = 0; c < 3; ++c)
+                {
+                    coeffRG[c] = _mm256_set1_epi32(PackCoefficientPair(pMatrix[c * 3 + 0], pMatrix[c * 3 + 1]));
+                    coeffB1[c] = _mm256_set1_epi32(PackCoefficientPair(pMatrix[c * 3 + 2], COLOR_MATRIX_ROUND));
+                }
+
+                const __m256i zero = _mm256_setzero_si256();
+                uint8_t* pPlanes[3] = { pR, pG, pB };
+
+                // Unpack and pack both work per 128-bit lane, so pixel order is preserved
+                int x = 0;
+                for (; x + 32 <= width; x += 32)
+                {
+                    const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pR + x));
+                    const __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pG + x));
+                    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pB + x));
+
+                    const __m256i rLo = _mm256_unpacklo_epi8(r, zero), rHi = _mm256_unpackhi_epi8(r, zero);
+                    const __m256i gLo = _mm256_unpacklo_epi8(g, zero), gHi = _mm256_unpackhi_epi8(g, zero);
+                    const __m256i bLo = _mm256_unpacklo_epi8(b, zero), bHi = _mm256_unpackhi_epi8(b, zero);
+
+                    __m256i out[3];
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        out[c] = _mm256_packus_epi16(ColorChannelAvx2(rLo, gLo, bLo, coeffRG[c], coeffB1[c]),
+                            ColorChannelAvx2(rHi, gHi, bHi, coeffRG[c], coeffB1[c]));
+                    }
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pPlanes[c] + x), out[c]);
+                    }
+                }
+
+                return x;
+            }
+
+            CVSBALLVISION_TARGET_SSE2 int PackBgraSse2(const uint8_t* pR, const uint8_t* pG, const uint8_t* pB,
+                uint8_t* pDst, int width)
+            {
+                const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pR + x));
+                    const __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pG + x));
+                    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + x));
+
+                    const __m128i bgLo = _mm_unpacklo_epi8(b, g), bgHi = _mm_unpackhi_epi8(b, g);
+                    const __m128i raLo = _mm_unpacklo_epi8(r, alpha), raHi = _mm_unpackhi_epi8(r, alpha);
+
+                    __m128i* pOut = reinterpret_cast<__m128i*>(pDst + x * 4);
+                    _mm_storeu_si128(pOut + 0, _mm_unpacklo_epi16(bgLo, raLo));
+                    _mm_storeu_si128(pOut + 1, _mm_unpackhi_epi16(bgLo, raLo));
+                    _mm_storeu_si128(pOut + 2, _mm_unpacklo_epi16(bgHi, raHi));
+                    _mm_storeu_si128(pOut + 3, _mm_unpackhi_epi16(bgHi, raHi));
+                }
+
+                return x;
+            }
+#endif // CVSBALLVISION_X86
+
+#ifdef CVSBALLVISION_NEON
+            int PackBgraNeon(const uint8_t* pR, const uint8_t* pG, const uint8_t* pB, uint8_t* pDst, int width)
+            {
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    uint8x16x4_t bgra;
+                    bgra.val[0] = vld1q_u8(pB + x);
+                    bgra.val[1] = vld1q_u8(pG + x);
+                    bgra.val[2] = vld1q_u8(pR + x);
+                    bgra.val[3] = vdupq_n_u8(0xFF);
+                    vst4q_u8(pDst + x * 4, bgra);
+                }
+                return x;
+            }
+#endif
+
+            int GetPackedBytesPerPixel(PackedFormat format)
+            {
+                return format == PackedFormat::BGRA32 ? 4 : 3;
+            }
+
+            // Parameters shared by every row band of one conversion
+            struct DemosaicJob
+            {
+                const uint8_t* pSrc;
+                int srcStep;
+                uint8_t* pDst;
+                int dstStep;
+                int width;
+                int height;
+                int redX;               // Position of the red sample inside the 2x2 tile
+                int redY;
+                bool edgeAware;
+                SimdLevel level;
+                const ColorPipeline* pColor;
+                PackedFormat format;
+            };
+
+            // Matrix then tone LUT on one row of planes (still in L1)
+            void ProcessColorRow(const DemosaicJob& job, uint8_t* pR, uint8_t* pG, uint8_t* pB)
+            {
+                const ColorPipeline& color = *job.pColor;
+                const int width = job.width;
+
+                if (color.bColorMatrix)
+                {
+                    int done = 0;
+                    switch (job.level)
+                    {
+#ifdef CVSBALLVISION_X86
+                    case SimdLevel::AVX2: done = ColorMatrixRowAvx2(pR, pG, pB, width, color.matrix); break;
+                    case SimdLevel::SSE2: done = ColorMatrixRowSse2(pR, pG, pB, width, color.matrix); break;
+#endif
+                    default: break;
+                    }
+                    ColorMatrixRowScalar(pR, pG, pB, done, width, color.matrix);
+                }
+
+                if (color.pToneLut && !color.pToneLut->bIdentity)
+                {
+                    ApplyLutSpan(pR, width, color.pToneLut->table, job.level);
+                    ApplyLutSpan(pG, width, color.pToneLut->table, job.level);
+                    ApplyLutSpan(pB, width, color.pToneLut->table, job.level);
+                }
+            }
+
+            void PackRow(const DemosaicJob& job, const uint8_t* pR, const uint8_t* pG, const uint8_t* pB, uint8_t* pOut)
+            {
+                const int width = job.width;
+                int packed = 0;
+
+                if (job.format == PackedFormat::BGRA32)
+                {
+                    switch (job.level)
+                    {
+#ifdef CVSBALLVISION_X86
+                    case SimdLevel::AVX2:
+                    case SimdLevel::SSE2:
+                        packed = PackBgraSse2(pR, pG, pB, pOut, width);
+                        break;
+#endif
+#ifdef CVSBALLVISION_NEON
+                    case SimdLevel::NEON:
+                        packed = PackBgraNeon(pR, pG, pB, pOut, width);
+                        break;
+#endif
+                    default:
+                        break;
+                    }
+                    PackBgraScalar(pR, pG, pB, pOut, packed, width);
+                    return;
+                }
+
+                // BGR24 is RGB24 with the chroma planes swapped
+                if (job.format == PackedFormat::BGR24)
+                    std::swap(pR, pB);
+
+                switch (job.level)
+                {
+#ifdef CVSBALLVISION_X86
+                case SimdLevel::AVX2:
+                    packed = PackRgbSsse3(pR, pG, pB, pOut, width);
+                    break;
+#endif
+#ifdef CVSBALLVISION_NEON
+                case SimdLevel::NEON:
+                    packed = PackRgbNeon(pR, pG, pB, pOut, width);
+                    break;
+#endif
+                default:
+                    break;
+                }
+                PackRgbScalar(pR, pG, pB, pOut, packed, width);
+            }
+
+            // Demosaic, colour-process and pack rows [yBegin, yEnd) in a single pass.
+            // Each row goes through L1-sized planes; the source is read once and the output written once.
+            void DemosaicBand(const DemosaicJob& job, int yBegin, int yEnd)
+            {
+                const int width = job.width;
+                const int height = job.height;
+
+                // Scratch: three padded input rows (rolling) + three colour planes
+                const size_t paddedStride = static_cast<size_t>(width) + 2 * ROW_PADDING;
+                const size_t planeStride = static_cast<size_t>(width) + ROW_PADDING;
+                thread_local std::vector<uint8_t> scratch;
+                if (scratch.size() < paddedStride * 3 + planeStride * 3)
+                    scratch.resize(paddedStride * 3 + planeStride * 3);
+
+                uint8_t* pRows[3];
+                int rowTags[3] = { -1, -1, -1 };
+                for (int i = 0; i < 3; ++i)
+                {
+                    pRows[i] = scratch.data() + paddedStride * i + ROW_PADDING;
+                }
+                uint8_t* pPlanes = scratch.data() + paddedStride * 3;
+                uint8_t* pPlaneR = pPlanes;
+                uint8_t* pPlaneG = pPlanes + planeStride;
+                uint8_t* pPlaneB = pPlanes + planeStride * 2;
+
+                // Consecutive rows map to distinct slots, so a rolling window of 3 suffices
+                auto getRow = [&](int y) -> const uint8_t* {
+                    int slot = y % 3;
+                    if (rowTags[slot] != y)
+                    {
+                        PadRow(pRows[slot], job.pSrc + static_cast<size_t>(y) * job.srcStep, width);
+                        rowTags[slot] = y;
+                    }
+                    return pRows[slot];
+                };
+
+                DemosaicRow row;
+                row.width = width;
+                row.edgeAware = job.edgeAware;
+                row.pGreen = pPlaneG;
+
+                const bool bColorStages = job.pColor &&
+                    (job.pColor->bColorMatrix || (job.pColor->pToneLut && !job.pColor->pToneLut->bIdentity));
+
+                for (int y = yBegin; y < yEnd; ++y)
+                {
+                    row.pUp = getRow(MirrorRow(y - 1, height));
+                    row.pMid = getRow(y);
+                    row.pDown = getRow(MirrorRow(y + 1, height));
+
+                    const bool redRow = ((y & 1) == job.redY);
+                    row.chromaParity = redRow ? job.redX : 1 - job.redX;
+                    row.pNative = redRow ? pPlaneR : pPlaneB;
+                    row.pOpposite = redRow ? pPlaneB : pPlaneR;
+
+                    int done = 0;
+                    switch (job.level)
+                    {
+#ifdef CVSBALLVISION_X86
+                    case SimdLevel::AVX2: done = DemosaicRowAvx2(row); break;
+                    case SimdLevel::SSE2: done = DemosaicRowSse2(row); break;
+#endif
+#ifdef CVSBALLVISION_NEON
+                    case SimdLevel::NEON: done = DemosaicRowNeon(row); break;
+#endif
+                    default: break;
+                    }
+                    DemosaicRowScalar(row, done);
+
+                    if (bColorStages)
+                        ProcessColorRow(job, pPlaneR, pPlaneG, pPlaneB);
+
+                    PackRow(job, pPlaneR, pPlaneG, pPlaneB, job.pDst + static_cast<ptrdiff_t>(y) * job.dstStep);
+                }
+            }
+
+            // Raw unpacking: GigE Vision packed rows hold two samples in three bytes,
+            //   12-bit: [p0 11..4] [p1 3..0 | p0 3..0] [p1 11..4]
+            //   10-bit: [p0 9..2]  [p1 1..0 at bit 4 | p0 1..0] [p1 9..2]
+            // Unpacked 10/12-bit rows are little-endian uint16 with the high bits ignored.
+            constexpr size_t UNPACK_PARALLEL_MIN_PIXELS = 256 * 1024;
+            constexpr int UNPACK_MIN_ROWS_PER_BAND = 32;
+
+            inline int GetRawSampleMask(const RawFormat& format)
+            {
+                return (1 << format.bitDepth) - 1;
+            }
+
+            void UnpackRowScalar(const uint8_t* pSrc, uint16_t* pDst, int startX, int width, const RawFormat& format)
+            {
+                const int mask = GetRawSampleMask(format);
+                if (format.bitDepth == 8)
+                {
+                    for (int x = startX; x < width; ++x)
+                    {
+                        pDst[x] = pSrc[x];
+                    }
+                }
+                else if (!format.bPacked)
+                {
+                    for (int x = startX; x < width; ++x)
+                    {
+                        pDst[x] = static_cast<uint16_t>((pSrc[x * 2] | (pSrc[x * 2 + 1] << 8)) & mask);
+                    }
+                }
+                else
+                {
+                    const int lowBits = format.bitDepth - 8;
+                    const int lowMask = (1 << lowBits) - 1;
+                    for (int x = startX; x < width; ++x)
+                    {
+                        const uint8_t* p = pSrc + (x >> 1) * 3;
+                        pDst[x] = (x & 1) ?
+                            static_cast<uint16_t>((p[2] << lowBits) | ((p[1] >> 4) & lowMask)) :
+                            static_cast<uint16_t>((p[0] << lowBits) | (p[1] & lowMask));
+                    }
+                }
+            }
+
+            void NarrowRowScalar(const uint16_t* pSrc, uint8_t* pDst, int startX, int width, int shift)
+            {
+                for (int x = startX; x < width; ++x)
+                {
+                    pDst[x] = static_cast<uint8_t>(std::min(255, pSrc[x] >> shift));
+                }
+            }
+
+#ifdef CVSBALLVISION_X86
+            // 16 packed samples per iteration: each 128-bit half takes 12 source bytes and shuffles
+            // pair k into lanes 2k = (b0 << 8 | b1) and 2k + 1 = (b2 << 8 | b1), then one shift and
+            // three masks pull out the high and low bits of both samples.
+            CVSBALLVISION_TARGET_AVX2 int UnpackPackedRowAvx2(const uint8_t* pSrc, int rowBytes, uint16_t* pDst,
+                int width, int bitDepth)
+            {
+                const __m256i shuffle = _mm256_setr_epi8(
+                    1, 0, 1, 2, 4, 3, 4, 5, 7, 6, 7, 8, 10, 9, 10, 11,
+                    1, 0, 1, 2, 4, 3, 4, 5, 7, 6, 7, 8, 10, 9, 10, 11);
+                const int lowBits = bitDepth - 8;
+                const short lowMask = static_cast<short>((1 << lowBits) - 1);
+                const __m128i highShift = _mm_cvtsi32_si128(8 - lowBits);
+                const __m256i highMask = _mm256_set1_epi16(static_cast<short>(0xFF << lowBits));
+                const __m256i evenLow = _mm256_setr_epi16(lowMask, 0, lowMask, 0, lowMask, 0, lowMask, 0,
+                    lowMask, 0, lowMask, 0, lowMask, 0, lowMask, 0);
+                const __m256i oddLow = _mm256_setr_epi16(0, lowMask, 0, lowMask, 0, lowMask, 0, lowMask,
+                    0, lowMask, 0, lowMask, 0, lowMask, 0, lowMask);
+
+                // Each iteration reads 28 bytes; stay inside the row
+                int x = 0;
+                for (; x + 16 <= width && (x / 2) * 3 + 28 <= rowBytes; x += 16)
+                {
+                    const uint8_t* p = pSrc + (x / 2) * 3;
+                    __m256i v = _mm256_inserti128_si256(
+                        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 12)), 1);
+                    v = _mm256_shuffle_epi8(v, shuffle);
+
+                    const __m256i high = _mm256_and_si256(_mm256_srl_epi16(v, highShift), highMask);
+                    const __m256i low = _mm256_or_si256(_mm256_and_si256(v, evenLow),
+                        _mm256_and_si256(_mm256_srli_epi16(v, 4), oddLow));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + x), _mm256_or_si256(high, low));
+                }
+                return x;
+            }
+
+            CVSBALLVISION_TARGET_AVX2 int MaskRowAvx2(const uint8_t* pSrc, uint16_t* pDst, int width, int mask)
+            {
+                const __m256i vMask = _mm256_set1_epi16(static_cast<short>(mask));
+
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + x * 2));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + x), _mm256_and_si256(v, vMask));
+                }
+                return x;
+            }
+
+            CVSBALLVISION_TARGET_SSE2 int MaskRowSse2(const uint8_t* pSrc, uint16_t* pDst, int width, int mask)
+            {
+                const __m128i vMask = _mm_set1_epi16(static_cast<short>(mask));
+
+                int x = 0;
+                for (; x + 8 <= width; x += 8)
+                {
+                    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x * 2));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + x), _mm_and_si128(v, vMask));
+                }
+                return x;
+            }
+
+            // Samples are at most 12 bits, so the signed saturating pack clamps to 255 correctly
+            CVSBALLVISION_TARGET_SSE2 int NarrowRowSse2(const uint16_t* pSrc, uint8_t* pDst, int width, int shift)
+            {
+                const __m128i count = _mm_cvtsi32_si128(shift);
+
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    const __m128i a = _mm_srl_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x)), count);
+                    const __m128i b = _mm_srl_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x + 8)), count);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + x), _mm_packus_epi16(a, b));
+                }
+                return x;
+            }
+#endif // CVSBALLVISION_X86
+
+#ifdef CVSBALLVISION_NEON
+            // vld3 splits the byte triples into three registers, vst2 re-interleaves even and odd samples
+            int UnpackPackedRowNeon(const uint8_t* pSrc, uint16_t* pDst, int width, int bitDepth)
+            {
+                const uint16x8_t lowMask = vdupq_n_u16(static_cast<uint16_t>((1 << (bitDepth - 8)) - 1));
+
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    const uint8x8x3_t bytes = vld3_u8(pSrc + (x / 2) * 3);
+                    const uint16x8_t mid = vmovl_u8(bytes.val[1]);
+
+                    uint16x8x2_t samples;
+                    if (bitDepth == 12)
+                    {
+                        samples.val[0] = vorrq_u16(vshll_n_u8(bytes.val[0], 4), vandq_u16(mid, lowMask));
+                        samples.val[1] = vorrq_u16(vshll_n_u8(bytes.val[2], 4), vshrq_n_u16(mid, 4));
+                    }
+                    else
+                    {
+                        samples.val[0] = vorrq_u16(vshll_n_u8(bytes.val[0], 2), vandq_u16(mid, lowMask));
+                        samples.val[1] = vorrq_u16(vshll_n_u8(bytes.val[2], 2), vandq_u16(vshrq_n_u16(mid, 4), lowMask));
+                    }
+                    vst2q_u16(pDst + x, samples);
+                }
+                return x;
+            }
+
+            int MaskRowNeon(const uint8_t* pSrc, uint16_t* pDst, int width, int mask)
+            {
+                const uint16x8_t vMask = vdupq_n_u16(static_cast<uint16_t>(mask));
+
+                int x = 0;
+                for (; x + 8 <= width; x += 8)
+                {
+                    const uint16x8_t v = vreinterpretq_u16_u8(vld1q_u8(pSrc + x * 2));
+                    vst1q_u16(pDst + x, vandq_u16(v, vMask));
+                }
+                return x;
+            }
+
+            int NarrowRowNeon(const uint16_t* pSrc, uint8_t* pDst, int width, int shift)
+            {
+                const int16x8_t count = vdupq_n_s16(static_cast<int16_t>(-shift));
+
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    const uint8x8_t a = vqmovn_u16(vshlq_u16(vld1q_u16(pSrc + x), count));
+                    const uint8x8_t b = vqmovn_u16(vshlq_u16(vld1q_u16(pSrc + x + 8), count));
+                    vst1q_u8(pDst + x, vcombine_u8(a, b));
+                }
+                return x;
+            }
+#endif // CVSBALLVISION_NEON
+
+            // One raw row -> masked uint16 samples
+            void UnpackRow(const uint8_t* pSrc, int rowBytes, uint16_t* pDst, int width,
+                const RawFormat& format, SimdLevel level)
+            {
+                int done = 0;
+                if (format.bitDepth > 8)
+                {
+                    switch (level)
+                    {
+#ifdef CVSBALLVISION_X86
+                    case SimdLevel::AVX2:
+                        done = format.bPacked ? UnpackPackedRowAvx2(pSrc, rowBytes, pDst, width, format.bitDepth) :
+                            MaskRowAvx2(pSrc, pDst, width, GetRawSampleMask(format));
+                        break;
+                    case SimdLevel::SSE2:
+                        done = format.bPacked ? 0 : MaskRowSse2(pSrc, pDst, width, GetRawSampleMask(format));
+                        break;
+#endif
+#ifdef CVSBALLVISION_NEON
+                    case SimdLevel::NEON:
+                        done = format.bPacked ? UnpackPackedRowNeon(pSrc, pDst, width, format.bitDepth) :
+                            MaskRowNeon(pSrc, pDst, width, GetRawSampleMask(format));
+                        break;
+#endif
+                    default:
+                        break;
+                    }
+                }
+
+                UnpackRowScalar(pSrc, pDst, done & ~1, width, format);
+            }
+
+            void NarrowRow(const uint16_t* pSrc, uint8_t* pDst, int width, int shift, SimdLevel level)
+            {
+                int done = 0;
+                switch (level)
+                {
+#ifdef CVSBALLVISION_X86
+                case SimdLevel::AVX2:
+                case SimdLevel::SSE2:
+                    done = NarrowRowSse2(pSrc, pDst, width, shift);
+                    break;
+#endif
+#ifdef CVSBALLVISION_NEON
+                case SimdLevel::NEON:
+                    done = NarrowRowNeon(pSrc, pDst, width, shift);
+                    break;
+#endif
+                default:
+                    break;
+                }
+
+                NarrowRowScalar(pSrc, pDst, done, width, shift);
+            }
+
+            // 12-bit table lookups. Indices are masked to 12 bits so stray high bits stay inside the table.
+            void LookupRow12To8Scalar(const uint16_t* pSrc, uint8_t* pDst, int startX, int width, int indexShift,
+                const uint8_t* pTable)
+            {
+                for (int x = startX; x < width; ++x)
+                {
+                    pDst[x] = pTable[(pSrc[x] << indexShift) & (LUT12_ENTRIES - 1)];
+                }
+            }
+
+            void LookupRow12Scalar(uint16_t* pData, int startX, int width, int shift, const uint16_t* pTable)
+            {
+                for (int x = startX; x < width; ++x)
+                {
+                    pData[x] = static_cast<uint16_t>(pTable[(pData[x] << shift) & (LUT12_ENTRIES - 1)] >> shift);
+                }
+            }
+
+#ifdef CVSBALLVISION_X86
+            // 16 samples per iteration through two 8-lane gathers. A gather fetches 32 bits at each
+            // entry (the tables' spare entries cover the last index); the low byte / word is kept.
+            // packus works per 128-bit lane, so one cross-lane permute restores the sample order.
+            CVSBALLVISION_TARGET_AVX2 int LookupRow12To8Avx2(const uint16_t* pSrc, uint8_t* pDst, int width,
+                int indexShift, const uint8_t* pTable)
+            {
+                const __m128i count = _mm_cvtsi32_si128(indexShift);
+                const __m256i indexMask = _mm256_set1_epi32(LUT12_ENTRIES - 1);
+                const __m256i valueMask = _mm256_set1_epi32(0xFF);
+                const int* pBase = reinterpret_cast<const int*>(pTable);
+
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    __m256i a = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x)));
+                    __m256i b = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x + 8)));
+                    a = _mm256_and_si256(_mm256_i32gather_epi32(pBase, _mm256_and_si256(_mm256_sll_epi32(a, count), indexMask), 1), valueMask);
+                    b = _mm256_and_si256(_mm256_i32gather_epi32(pBase, _mm256_and_si256(_mm256_sll_epi32(b, count), indexMask), 1), valueMask);
+
+                    const __m256i words = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + x),
+                        _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1)));
+                }
+                return x;
+            }
+
+            CVSBALLVISION_TARGET_AVX2 int LookupRow12Avx2(uint16_t* pData, int width, int shift, const uint16_t* pTable)
+            {
+                const __m128i count = _mm_cvtsi32_si128(shift);
+                const __m256i indexMask = _mm256_set1_epi32(LUT12_ENTRIES - 1);
+                const __m256i valueMask = _mm256_set1_epi32(0xFFFF);
+                const int* pBase = reinterpret_cast<const int*>(pTable);
+
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    __m256i a = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + x)));
+                    __m256i b = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + x + 8)));
+                    a = _mm256_and_si256(_mm256_i32gather_epi32(pBase, _mm256_and_si256(_mm256_sll_epi32(a, count), indexMask), 2), valueMask);
+                    b = _mm256_and_si256(_mm256_i32gather_epi32(pBase, _mm256_and_si256(_mm256_sll_epi32(b, count), indexMask), 2), valueMask);
+
+                    const __m256i words = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pData + x), _mm256_srl_epi16(words, count));
+                }
+                return x;
+            }
+#endif // CVSBALLVISION_X86
+
+            // SSE2 and NEON have no gather; they use the scalar loop
+            void LookupRow12To8(const uint16_t* pSrc, uint8_t* pDst, int width, int indexShift,
+                const uint8_t* pTable, SimdLevel level)
+            {
+                int done = 0;
+#ifdef CVSBALLVISION_X86
+                if (level == SimdLevel::AVX2)
+                    done = LookupRow12To8Avx2(pSrc, pDst, width, indexShift, pTable);
+#else
+                (void)level;
+#endif
+                LookupRow12To8Scalar(pSrc, pDst, done, width, indexShift, pTable);
+            }
+
+            void LookupRow12(uint16_t* pData, int width, int shift, const uint16_t* pTable, SimdLevel level)
+            {
+                int done = 0;
+#ifdef CVSBALLVISION_X86
+                if (level == SimdLevel::AVX2)
+                    done = LookupRow12Avx2(pData, width, shift, pTable);
+#else
+                (void)level;
+#endif
+                LookupRow12Scalar(pData, done, width, shift, pTable);
+            }
+
+            // Runs rowFn(begin, end) over row bands of large images
+            template <typename RowFn>
+            void ForEachRowBand(int width, int height, RowFn rowFn)
+            {
+                if (static_cast<size_t>(width) * height >= UNPACK_PARALLEL_MIN_PIXELS)
+                    GetProcessingThreadPool().ParallelFor(height, UNPACK_MIN_ROWS_PER_BAND, rowFn);
+                else
+                    rowFn(0, height);
+            }
+        }
+
+        SimdLevel GetSimdLevel()
+        {
+            static const SimdLevel level = DetectSimdLevel();
+            return level;
+        }
+
+        const char* GetSimdLevelName(SimdLevel level)
+        {
+            switch (level)
+            {
+            case SimdLevel::SSE2: return "SSE2";
+            case SimdLevel::AVX2: return "AVX2";
+            case SimdLevel::NEON: return "NEON";
+            default: return "Scalar";
+            }
+        }
+
+        bool ParseBayerPattern(const std::string& pixelFormat, BayerPattern& pattern)
+        {
+            if (pixelFormat.compare(0, 5, "Bayer") != 0 || pixelFormat.size() < 7)
+                return false;
+
+            const std::string tile = pixelFormat.substr(5, 2);
+            if (tile == "RG")
+                pattern = BayerPattern::RG;
+            else if (tile == "GR")
+                pattern = BayerPattern::GR;
+            else if (tile == "GB")
+                pattern = BayerPattern::GB;
+            else if (tile == "BG")
+                pattern = BayerPattern::BG;
+            else
+                return false;
+
+            return true;
+        }
+
+        bool Demosaic(const uint8_t* pSrc, int srcStep,
+            uint8_t* pDst, int dstStep,
+            int width, int height,
+            BayerPattern pattern, DemosaicMethod method)
+        {
+            return DemosaicWithSimdLevel(pSrc, srcStep, pDst, dstStep, width, height,
+                pattern, method, GetSimdLevel());
+        }
+
+        bool DemosaicWithSimdLevel(const uint8_t* pSrc, int srcStep,
+            uint8_t* pDst, int dstStep,
+            int width, int height,
+            BayerPattern pattern, DemosaicMethod method, SimdLevel level)
+        {
+            ColorPipeline none = {};
+            return DemosaicFused(pSrc, srcStep, pDst, dstStep, width, height,
+                pattern, method, none, PackedFormat::RGB24, level);
+        }
+
+        bool DemosaicFused(const uint8_t* pSrc, int srcStep,
+            uint8_t* pDst, int dstStep,
+            int width, int height,
+            BayerPattern pattern, DemosaicMethod method,
+            const ColorPipeline& color, PackedFormat format, SimdLevel level)
+        {
+            if (!pSrc || !pDst || width < 2 || height < 2 || srcStep < width ||
+                std::abs(dstStep) < width * GetPackedBytesPerPixel(format))
+            {
+                return false;
+            }
+
+            if (method == DemosaicMethod::Vendor)
+                return false;   // Vendor conversion is handled by the camera backend
+
+            DemosaicJob job;
+            job.pSrc = pSrc;
+            job.srcStep = srcStep;
+            job.pDst = pDst;
+            job.dstStep = dstStep;
+            job.width = width;
+            job.height = height;
+            job.edgeAware = (method == DemosaicMethod::EdgeAware);
+            job.level = IsSimdLevelSupported(level) ? level : SimdLevel::Scalar;
+            job.pColor = &color;
+            job.format = format;
+
+            switch (pattern)
+            {
+            case BayerPattern::RG: job.redX = 0; job.redY = 0; break;
+            case BayerPattern::GR: job.redX = 1; job.redY = 0; break;
+            case BayerPattern::GB: job.redX = 0; job.redY = 1; break;
+            case BayerPattern::BG: job.redX = 1; job.redY = 1; break;
+            default: return false;
+            }
+
+            // Bands are independent: borders mirror against the full image, not the band
+            if (static_cast<size_t>(width) * height >= DEMOSAIC_PARALLEL_MIN_PIXELS)
+            {
+                GetProcessingThreadPool().ParallelFor(height, DEMOSAIC_MIN_ROWS_PER_BAND,
+                    [&job](int begin, int end) { DemosaicBand(job, begin, end); });
+            }
+            else
+            {
+                DemosaicBand(job, 0, height);
+            }
+
+            return true;
+        }
+
+        bool BuildColorMatrix(const double whiteBalance[3], const double colorMatrix[9], int16_t matrix[9])
+        {
+            const double scale = static_cast<double>(1 << COLOR_MATRIX_FRACTION_BITS);
+            const double limit = 32767.0 / scale;
+
+            for (int row = 0; row < 3; ++row)
+            {
+                for (int col = 0; col < 3; ++col)
+                {
+                    // White balance scales the input channel, i.e. the matrix column
+                    double value = colorMatrix[row * 3 + col] * whiteBalance[col];
+                    if (!(std::abs(value) < limit))
+                        return false;
+
+                    matrix[row * 3 + col] = static_cast<int16_t>(std::lround(value * scale));
+                }
+            }
+
+            return true;
+        }
+
+        bool RepackRgb24(const uint8_t* pSrc, int srcStep,
+            uint8_t* pDst, int dstStep,
+            int width, int height, PackedFormat format)
+        {
+            const int bytesPerPixel = GetPackedBytesPerPixel(format);
+            if (!pSrc || !pDst || width <= 0 || height <= 0 ||
+                std::abs(srcStep) < width * 3 || std::abs(dstStep) < width * bytesPerPixel)
+            {
+                return false;
+            }
+
+            for (int y = 0; y < height; ++y)
+            {
+                const uint8_t* pIn = pSrc + static_cast<ptrdiff_t>(y) * srcStep;
+                uint8_t* pOut = pDst + static_cast<ptrdiff_t>(y) * dstStep;
+
+                switch (format)
+                {
+                case PackedFormat::RGB24:
+                    memcpy(pOut, pIn, static_cast<size_t>(width) * 3);
+                    break;
+                case PackedFormat::BGR24:
+                    for (int x = 0; x < width; ++x, pIn += 3, pOut += 3)
+                    {
+                        pOut[0] = pIn[2];
+                        pOut[1] = pIn[1];
+                        pOut[2] = pIn[0];
+                    }
+                    break;
+                case PackedFormat::BGRA32:
+                    for (int x = 0; x < width; ++x, pIn += 3, pOut += 4)
+                    {
+                        pOut[0] = pIn[2];
+                        pOut[1] = pIn[1];
+                        pOut[2] = pIn[0];
+                        pOut[3] = 0xFF;
+                    }
+                    break;
+                }
+            }
+
+            return true;
+        }
+
+        bool ParseRawFormat(const std::string& pixelFormat, RawFormat& format)
+        {
+            std::string depth;
+            BayerPattern pattern;
+            if (pixelFormat.compare(0, 4, "Mono") == 0)
+                depth = pixelFormat.substr(4);
+            else if (ParseBayerPattern(pixelFormat, pattern))
+                depth = pixelFormat.substr(7);
+            else
+                return false;
+
+            const std::string packedSuffix = "Packed";
+            bool bPacked = false;
+            if (depth.size() > packedSuffix.size() &&
+                depth.compare(depth.size() - packedSuffix.size(), packedSuffix.size(), packedSuffix) == 0)
+            {
+                bPacked = true;
+                depth.resize(depth.size() - packedSuffix.size());
+            }
+
+            if (depth == "8" && !bPacked)
+                format.bitDepth = 8;
+            else if (depth == "10")
+                format.bitDepth = 10;
+            else if (depth == "12")
+                format.bitDepth = 12;
+            else
+                return false;
+
+            format.bPacked = bPacked;
+            return true;
+        }
+
+        int GetRawRowBytes(int width, const RawFormat& format)
+        {
+            if (format.bitDepth == 8)
+                return width;
+            if (format.bPacked)
+                return (width + 1) / 2 * 3;
+            return width * 2;
+        }
+
+        bool UnpackRawToU16(const uint8_t* pSrc, int srcStep,
+            uint16_t* pDst, int dstStep,
+            int width, int height, const RawFormat& format, SimdLevel level)
+        {
+            const int rowBytes = GetRawRowBytes(width, format);
+            if (!pSrc || !pDst || width <= 0 || height <= 0 || srcStep < rowBytes ||
+                std::abs(dstStep) < width * 2 || (dstStep & 1) != 0)
+            {
+                return false;
+            }
+
+            if (!IsSimdLevelSupported(level))
+                level = SimdLevel::Scalar;
+
+            uint8_t* pDstBytes = reinterpret_cast<uint8_t*>(pDst);
+            ForEachRowBand(width, height, [&](int begin, int end) {
+                for (int y = begin; y < end; ++y)
+                {
+                    UnpackRow(pSrc + static_cast<size_t>(y) * srcStep, rowBytes,
+                        reinterpret_cast<uint16_t*>(pDstBytes + static_cast<ptrdiff_t>(y) * dstStep), width, format, level);
+                }
+            });
+
+            return true;
+        }
+
+        bool UnpackRawToU8(const uint8_t* pSrc, int srcStep,
+            uint8_t* pDst, int dstStep,
+            int width, int height, const RawFormat& format,
+            int shift, const Lut12To8* pLut, SimdLevel level)
+        {
+            const int rowBytes = GetRawRowBytes(width, format);
+            if (!pSrc || !pDst || width <= 0 || height <= 0 || srcStep < rowBytes || std::abs(dstStep) < width ||
+                shift < 0 || shift > 15)
+            {
+                return false;
+            }
+
+            if (format.bitDepth == 8)
+            {
+                for (int y = 0; y < height; ++y)
+                {
+                    memcpy(pDst + static_cast<ptrdiff_t>(y) * dstStep, pSrc + static_cast<size_t>(y) * srcStep, width);
+                }
+                return true;
+            }
+
+            if (!IsSimdLevelSupported(level))
+                level = SimdLevel::Scalar;
+
+            const int lutShift = 12 - format.bitDepth;
+            ForEachRowBand(width, height, [&](int begin, int end) {
+                // One row of samples stays in L1 between the two passes
+                thread_local std::vector<uint16_t> samples;
+                if (samples.size() < static_cast<size_t>(width))
+                    samples.resize(width);
+
+                for (int y = begin; y < end; ++y)
+                {
+                    uint8_t* pOut = pDst + static_cast<ptrdiff_t>(y) * dstStep;
+                    UnpackRow(pSrc + static_cast<size_t>(y) * srcStep, rowBytes, samples.data(), width, format, level);
+
+                    if (pLut)
+                    {
+                        LookupRow12To8(samples.data(), pOut, width, lutShift, pLut->table, level);
+                    }
+                    else
+                    {
+                        NarrowRow(samples.data(), pOut, width, shift, level);
+                    }
+                }
+            });
+
+            return true;
+        }
+
+        ThreadPool& GetProcessingThreadPool()
+        {
+            // Never destroyed: joining threads while the DLL unloads would deadlock on the loader lock
+            static ThreadPool* pPool = new ThreadPool(
+                std::max(1u, std::thread::hardware_concurrency()) - 1);
+            return *pPool;
+        }
+
+        void BuildGammaLut(double gamma, Lut8& lut)
+        {
+            lut.bIdentity = (std::abs(gamma - 1.0) < 0.001) || gamma <= 0.0;
+            if (lut.bIdentity)
+            {
+                for (int i = 0; i < 256; i++)
+                {
+                    lut.table[i] = static_cast<uint8_t>(i);
+                }
+                return;
+            }
+
+            double invGamma = 1.0 / gamma;
+            for (int i = 0; i < 256; i++)
+            {
+                double normalized = i / 255.0;
+                double corrected = std::pow(normalized, invGamma);
+                lut.table[i] = static_cast<uint8_t>(std::min(255.0, corrected * 255.0 + 0.5));
+            }
+        }
+
+        void ApplyLut(uint8_t* pData, int rowBytes, int rows, int step, const Lut8& lut)
+        {
+            ApplyLutWithSimdLevel(pData, rowBytes, rows, step, lut, GetSimdLevel(), true);
+        }
+
+        void ApplyLutWithSimdLevel(uint8_t* pData, int rowBytes, int rows, int step, const Lut8& lut,
+            SimdLevel level, bool bParallel)
+        {
+            if (!pData || rowBytes <= 0 || rows <= 0 || step < rowBytes || lut.bIdentity)
+                return;
+
+            if (!IsSimdLevelSupported(level))
+                level = SimdLevel::Scalar;
+
+            auto applyRows = [&](int begin, int end) {
+                if (step == rowBytes)
+                {
+                    // Contiguous rows: one long span
+                    ApplyLutSpan(pData + static_cast<size_t>(begin) * step,
+                        static_cast<size_t>(end - begin) * rowBytes, lut.table, level);
+                    return;
+                }
+
+                for (int y = begin; y < end; ++y)
+                {
+                    ApplyLutSpan(pData + static_cast<size_t>(y) * step, rowBytes, lut.table, level);
+                }
+            };
+
+            if (bParallel && static_cast<size_t>(rowBytes) * rows >= LUT_PARALLEL_MIN_BYTES)
+                GetProcessingThreadPool().ParallelFor(rows, LUT_MIN_ROWS_PER_BAND, applyRows);
+            else
+                applyRows(0, rows);
+        }
+
+        void ApplyLut12(uint16_t* pData, int width, int rows, int step, int bitDepth, const Lut12& lut, SimdLevel level)
+        {
+            if (!pData || width <= 0 || rows <= 0 || std::abs(step) < width * 2 ||
+                bitDepth < 8 || bitDepth > 12 || lut.bIdentity)
+            {
+                return;
+            }
+
+            if (!IsSimdLevelSupported(level))
+                level = SimdLevel::Scalar;
+
+            const int shift = 12 - bitDepth;
+            uint8_t* pBytes = reinterpret_cast<uint8_t*>(pData);
+            ForEachRowBand(width, rows, [&](int begin, int end) {
+                for (int y = begin; y < end; ++y)
+                {
+                    LookupRow12(reinterpret_cast<uint16_t*>(pBytes + static_cast<ptrdiff_t>(y) * step),
+                        width, shift, lut.table, level);
+                }
+            });
+        }
+
+        double EvaluateToneCurve(const ToneCurveConfig* pCurve, double gamma, double x)
+        {
+            x = std::min(1.0, std::max(0.0, x));
+
+            if (pCurve)
+            {
+                // Black level: everything up to it goes to 0, the rest is stretched back to full range
+                const double black = pCurve->blackLevel / Constants::TONE_CURVE_MAX_VALUE;
+                x = black < 1.0 ? std::max(0.0, (x - black) / (1.0 - black)) : 0.0;
+
+                // Contrast: slope around mid grey
+                x = std::min(1.0, std::max(0.0, 0.5 + (x - 0.5) * pCurve->contrast));
+
+                if (pCurve->gamma > 0.0 && std::abs(pCurve->gamma - 1.0) >= 0.001)
+                    x = std::pow(x, 1.0 / pCurve->gamma);
+
+                // Custom curve: exact at 12-bit inputs, linear in between
+                if (pCurve->customCurve.size() == static_cast<size_t>(LUT12_ENTRIES))
+                {
+                    const double pos = x * (LUT12_ENTRIES - 1);
+                    const int i = std::min(static_cast<int>(pos), LUT12_ENTRIES - 2);
+                    const double y0 = std::min<int>(pCurve->customCurve[i], LUT12_ENTRIES - 1);
+                    const double y1 = std::min<int>(pCurve->customCurve[i + 1], LUT12_ENTRIES - 1);
+                    x = (y0 + (y1 - y0) * (pos - i)) / (LUT12_ENTRIES - 1);
+                }
+            }
+
+            if (gamma > 0.0 && std::abs(gamma - 1.0) >= 0.001)
+                x = std::pow(x, 1.0 / gamma);
+
+            return x;
+        }
+
+        void BuildToneLut8(const ToneCurveConfig* pCurve, double gamma, Lut8& lut)
+        {
+            lut.bIdentity = true;
+            for (int i = 0; i < 256; i++)
+            {
+                lut.table[i] = static_cast<uint8_t>(std::min(255.0, EvaluateToneCurve(pCurve, gamma, i / 255.0) * 255.0 + 0.5));
+                lut.bIdentity = lut.bIdentity && lut.table[i] == i;
+            }
+        }
+
+        void BuildToneLut12(const ToneCurveConfig* pCurve, double gamma, Lut12& lut)
+        {
+            const double maxValue = LUT12_ENTRIES - 1;
+            lut.bIdentity = true;
+            for (int i = 0; i < LUT12_ENTRIES; i++)
+            {
+                lut.table[i] = static_cast<uint16_t>(std::min(maxValue, EvaluateToneCurve(pCurve, gamma, i / maxValue) * maxValue + 0.5));
+                lut.bIdentity = lut.bIdentity && lut.table[i] == i;
+            }
+            lut.table[LUT12_ENTRIES] = lut.table[LUT12_ENTRIES - 1];
+        }
+
+        void BuildToneLut12To8(const ToneCurveConfig* pCurve, double gamma, Lut12To8& lut)
+        {
+            const double maxInput = LUT12_ENTRIES - 1;
+            for (int i = 0; i < LUT12_ENTRIES; i++)
+            {
+                lut.table[i] = static_cast<uint8_t>(std::min(255.0, EvaluateToneCurve(pCurve, gamma, i / maxInput) * 255.0 + 0.5));
+            }
+            memset(lut.table + LUT12_ENTRIES, lut.table[LUT12_ENTRIES - 1], sizeof(lut.table) - LUT12_ENTRIES);
+        }
+    }
+}
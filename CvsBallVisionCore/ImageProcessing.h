@@ -0,0 +1,157 @@
+#pragma once
+
+#include "CvsBallVisionCore.h"
+
+namespace CvsBallVision
+{
+    class ThreadPool;
+
+    namespace ImageProcessing
+    {
+        // Colour filter layout, named after the top-left 2x2 tile
+        enum class BayerPattern
+        {
+            RG,
+            GR,
+            GB,
+            BG
+        };
+
+        // Instruction sets the kernels are built for (best available picked at runtime)
+        enum class SimdLevel
+        {
+            Scalar,
+            SSE2,
+            AVX2,
+            NEON
+        };
+
+        SimdLevel GetSimdLevel();
+        const char* GetSimdLevelName(SimdLevel level);
+
+        // "BayerRG8", "BayerGB12Packed", "BayerBG" ... -> pattern. Returns false for non-Bayer formats.
+        bool ParseBayerPattern(const std::string& pixelFormat, BayerPattern& pattern);
+
+        // 8-bit Bayer -> interleaved RGB24 (R, G, B byte order), mirrored borders.
+        // Output is bit-exact across SIMD levels. width and height must be >= 2.
+        bool Demosaic(const uint8_t* pSrc, int srcStep,
+            uint8_t* pDst, int dstStep,
+            int width, int height,
+            BayerPattern pattern, DemosaicMethod method);
+
+        // Same as Demosaic with an explicit instruction set (falls back to scalar if unsupported)
+        bool DemosaicWithSimdLevel(const uint8_t* pSrc, int srcStep,
+            uint8_t* pDst, int dstStep,
+            int width, int height,
+            BayerPattern pattern, DemosaicMethod method, SimdLevel level);
+
+        // 8-bit lookup table; treated as immutable once built so it can be shared lock-free
+        struct Lut8
+        {
+            uint8_t table[256];
+            bool bIdentity;
+        };
+
+        // table[i] = 255 * (i / 255) ^ (1 / gamma), rounded
+        void BuildGammaLut(double gamma, Lut8& lut);
+
+        // In-place lookup over `rows` rows of `rowBytes` bytes spaced `step` apart.
+        // Large images are split into row bands on the processing thread pool.
+        void ApplyLut(uint8_t* pData, int rowBytes, int rows, int step, const Lut8& lut);
+        void ApplyLutWithSimdLevel(uint8_t* pData, int rowBytes, int rows, int step, const Lut8& lut,
+            SimdLevel level, bool bParallel);
+
+        // Output packing of the fused demosaic pass
+        enum class PackedFormat
+        {
+            RGB24,
+            BGR24,      // GDI / OpenCV byte order
+            BGRA32      // Alpha = 255
+        };
+
+        constexpr int COLOR_MATRIX_FRACTION_BITS = 10;
+
+        // Per-pixel stages fused into the demosaic pass: colour matrix, then tone LUT
+        struct ColorPipeline
+        {
+            bool bColorMatrix;
+            int16_t matrix[9];          // Row-major RGB, Q10 fixed point, white balance folded in
+            const Lut8* pToneLut;       // nullptr = no tone mapping
+        };
+
+        // matrix = colorMatrix * diag(whiteBalance) in Q10. False if a coefficient exceeds +-32.
+        bool BuildColorMatrix(const double whiteBalance[3], const double colorMatrix[9], int16_t matrix[9]);
+
+        // Demosaic + colour matrix + tone LUT + packing in one pass over the image,
+        // processed row by row through cache-resident planes and split into row bands.
+        // A negative dstStep writes bottom-up (pDst is then the last row in memory).
+        bool DemosaicFused(const uint8_t* pSrc, int srcStep,
+            uint8_t* pDst, int dstStep,
+            int width, int height,
+            BayerPattern pattern, DemosaicMethod method,
+            const ColorPipeline& color, PackedFormat format, SimdLevel level);
+
+        // Interleaved RGB24 -> format (either step may be negative)
+        bool RepackRgb24(const uint8_t* pSrc, int srcStep,
+            uint8_t* pDst, int dstStep,
+            int width, int height, PackedFormat format);
+
+        // Sample layout of a mono or Bayer pixel format
+        struct RawFormat
+        {
+            int bitDepth;       // 8, 10 or 12 significant bits
+            bool bPacked;       // Two samples in three bytes (GigE Vision "Packed"); else one byte or a little-endian uint16
+        };
+
+        // "Mono8", "BayerRG12", "Mono10Packed", "BayerGB12Packed" ... -> layout. False for anything else.
+        bool ParseRawFormat(const std::string& pixelFormat, RawFormat& format);
+
+        // Bytes in one row of raw samples (an odd packed width still takes the whole byte triple)
+        int GetRawRowBytes(int width, const RawFormat& format);
+
+        constexpr int LUT12_ENTRIES = 4096;
+
+        // 12-bit input table; 10-bit samples index it with their value << 2.
+        // The spare entries keep 32-bit gathers at the last index inside the table.
+        struct Lut12To8
+        {
+            uint8_t table[LUT12_ENTRIES + 3];
+        };
+
+        // 12-bit in, 12-bit out, like the camera's adjustable LUT
+        struct Lut12
+        {
+            uint16_t table[LUT12_ENTRIES + 1];
+            bool bIdentity;
+        };
+
+        // Raw rows -> uint16 samples in the low bitDepth bits.
+        // dstStep is in bytes and may be negative (bottom-up). Large images are split into row bands.
+        bool UnpackRawToU16(const uint8_t* pSrc, int srcStep,
+            uint16_t* pDst, int dstStep,
+            int width, int height, const RawFormat& format, SimdLevel level);
+
+        // Raw rows -> 8 bits: pLut->table[sample << (12 - bitDepth)] when pLut is set,
+        // else min(255, sample >> shift). 8-bit formats are copied as they are.
+        bool UnpackRawToU8(const uint8_t* pSrc, int srcStep,
+            uint8_t* pDst, int dstStep,
+            int width, int height, const RawFormat& format,
+            int shift, const Lut12To8* pLut, SimdLevel level);
+
+        // In-place 12-bit lookup over uint16 samples with bitDepth (8..12) significant bits; step in bytes.
+        // Samples index the table with value << (12 - bitDepth) and keep the top bitDepth bits of the result.
+        void ApplyLut12(uint16_t* pData, int width, int rows, int step, int bitDepth, const Lut12& lut, SimdLevel level);
+
+        // Composed tone curve on 0..1: the ToneCurveConfig stages (black level, contrast, gamma,
+        // custom curve) when pCurve is set, then out ^ (1 / gamma)
+        double EvaluateToneCurve(const ToneCurveConfig* pCurve, double gamma, double x);
+
+        // The curve sampled for each table's input and output range, rounded
+        void BuildToneLut8(const ToneCurveConfig* pCurve, double gamma, Lut8& lut);
+        void BuildToneLut12(const ToneCurveConfig* pCurve, double gamma, Lut12& lut);
+        void BuildToneLut12To8(const ToneCurveConfig* pCurve, double gamma, Lut12To8& lut);
+
+        // Shared workers for row-band parallelism (hardware threads - 1)
+        ThreadPool& GetProcessingThreadPool();
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "CvsBallVisionCore.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+namespace CvsBallVision
+{
+    // Lock-free log-linear latency histogram (HdrHistogram layout, nanoseconds).
+    //
+    // Values below 2^SUB_BUCKET_BITS ns are counted exactly; above that every power of two
+    // is split into 2^(SUB_BUCKET_BITS - 1) equal buckets, so a reported percentile is within
+    // 1/64 (~1.6%) of the recorded value. Record is a handful of relaxed atomic adds and is
+    // safe from any thread; snapshots read the counters without stopping writers.
+    class LatencyHistogram
+    {
+    public:
+        static constexpr int SUB_BUCKET_BITS = 7;
+        static constexpr int MAX_VALUE_BITS = 36;      // ~68 s; larger values are clamped
+        static constexpr uint64_t SUB_BUCKET_COUNT = 1ull << SUB_BUCKET_BITS;
+        static constexpr uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+        static constexpr uint64_t MAX_VALUE_NS = (1ull << MAX_VALUE_BITS) - 1;
+        static constexpr size_t BUCKET_COUNT =
+            static_cast<size_t>((MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_HALF + SUB_BUCKET_HALF);
+
+        LatencyHistogram()
+        {
+            Reset();
+        }
+
+        void Record(std::chrono::steady_clock::duration elapsed)
+        {
+            RecordNs(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+
+        void RecordNs(int64_t valueNs)
+        {
+            uint64_t ns = static_cast<uint64_t>(std::max<int64_t>(0, valueNs));
+            ns = std::min(ns, MAX_VALUE_NS);
+
+            m_buckets[BucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+            m_count.fetch_add(1, std::memory_order_relaxed);
+            m_totalNs.fetch_add(ns, std::memory_order_relaxed);
+
+            uint64_t current = m_maxNs.load(std::memory_order_relaxed);
+            while (ns > current && !m_maxNs.compare_exchange_weak(current, ns, std::memory_order_relaxed))
+            {
+            }
+
+            current = m_minNs.load(std::memory_order_relaxed);
+            while (ns < current && !m_minNs.compare_exchange_weak(current, ns, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        // Percentiles of everything recorded since the last Reset.
+        // Writers may run concurrently; their samples land in this snapshot or the next.
+        void GetStatistics(LatencyStatistics& stats) const
+        {
+            memset(&stats, 0, sizeof(stats));
+
+            uint64_t counts[BUCKET_COUNT];
+            uint64_t total = 0;
+            for (size_t i = 0; i < BUCKET_COUNT; ++i)
+            {
+                counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+                total += counts[i];
+            }
+
+            if (total == 0)
+                return;
+
+            const uint64_t maxNs = m_maxNs.load(std::memory_order_relaxed);
+            stats.count = total;
+            stats.meanUs = m_totalNs.load(std::memory_order_relaxed) / 1000.0 / std::max<uint64_t>(1, m_count.load(std::memory_order_relaxed));
+            stats.minUs = m_minNs.load(std::memory_order_relaxed) / 1000.0;
+            stats.maxUs = maxNs / 1000.0;
+
+            const double quantiles[] = { 0.50, 0.90, 0.99, 0.999, 0.9999 };
+            double* pOut[] = { &stats.p50Us, &stats.p90Us, &stats.p99Us, &stats.p999Us, &stats.p9999Us };
+
+            size_t bucket = 0;
+            uint64_t cumulative = counts[0];
+            for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); ++q)
+            {
+                // Nearest rank, reported as the bucket's upper bound (never above the true max)
+                uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(quantiles[q] * total + 0.5));
+                while (cumulative < rank && bucket + 1 < BUCKET_COUNT)
+                {
+                    cumulative += counts[++bucket];
+                }
+                *pOut[q] = std::min(BucketUpperBound(bucket), maxNs) / 1000.0;
+            }
+        }
+
+        void Reset()
+        {
+            for (auto& bucket : m_buckets)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            m_count.store(0, std::memory_order_relaxed);
+            m_totalNs.store(0, std::memory_order_relaxed);
+            m_maxNs.store(0, std::memory_order_relaxed);
+            m_minNs.store(UINT64_MAX, std::memory_order_relaxed);
+        }
+
+    private:
+        static size_t BucketIndex(uint64_t ns)
+        {
+            if (ns < SUB_BUCKET_COUNT)
+                return static_cast<size_t>(ns);
+
+            int msb = 63;
+            while (!(ns >> msb))
+            {
+                --msb;
+            }
+
+            // Keep the top SUB_BUCKET_BITS bits: [SUB_BUCKET_HALF, SUB_BUCKET_COUNT) within the octave
+            int shift = msb - (SUB_BUCKET_BITS - 1);
+            return static_cast<size_t>(shift * SUB_BUCKET_HALF + (ns >> shift));
+        }
+
+        static uint64_t BucketUpperBound(size_t index)
+        {
+            if (index < SUB_BUCKET_COUNT)
+                return index;
+
+            uint64_t shift = (index - SUB_BUCKET_HALF) / SUB_BUCKET_HALF;
+            uint64_t subBucket = index - shift * SUB_BUCKET_HALF;
+            return ((subBucket + 1) << shift) - 1;
+        }
+
+        LatencyHistogram(const LatencyHistogram&) = delete;
+        LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+        std::atomic<uint64_t> m_buckets[BUCKET_COUNT];
+        std::atomic<uint64_t> m_count;
+        std::atomic<uint64_t> m_totalNs;
+        std::atomic<uint64_t> m_maxNs;
+        std::atomic<uint64_t> m_minNs;
+    };
+}
@@ -0,0 +1,1008 @@
+#include "CameraBackend.h"
+#include "FrameRecorder.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CvsBallVision
+{
+    using namespace Constants;
+
+    namespace
+    {
+        constexpr int32_t PLAYBACK_HANDLE = 200;
+
+        struct IntNode
+        {
+            int64_t value;
+            int64_t min;
+            int64_t max;
+        };
+
+        struct FloatNode
+        {
+            double value;
+            double min;
+            double max;
+        };
+
+        struct EnumNode
+        {
+            std::string value;
+            std::vector<std::string> entries;
+        };
+
+        CVS_ERROR CopyString(const std::string& value, char* pValue, uint32_t* pSize)
+        {
+            if (!pSize)
+                return BackendError::INVALID_PARAMETER;
+
+            const uint32_t required = static_cast<uint32_t>(value.size() + 1);
+            if (!pValue || *pSize < required)
+            {
+                *pSize = required;
+                return BackendError::BUFFER_TOO_SMALL;
+            }
+
+            memcpy(pValue, value.c_str(), required);
+            *pSize = required;
+            return MCAM_ERR_OK;
+        }
+
+        // Read-only view of a whole file
+        class MappedFile
+        {
+        public:
+            MappedFile()
+                : m_pData(nullptr)
+                , m_size(0)
+#if defined(_WIN32)
+                , m_hFile(INVALID_HANDLE_VALUE)
+                , m_hMapping(nullptr)
+#endif
+            {
+            }
+
+            ~MappedFile()
+            {
+                Close();
+            }
+
+            bool Open(const std::string& path)
+            {
+                Close();
+#if defined(_WIN32)
+                m_hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+                if (m_hFile == INVALID_HANDLE_VALUE)
+                    return false;
+
+                LARGE_INTEGER size;
+                if (!GetFileSizeEx(m_hFile, &size) || size.QuadPart == 0)
+                {
+                    Close();
+                    return false;
+                }
+
+                m_hMapping = CreateFileMappingA(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                void* p = m_hMapping ? MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+                if (!p)
+                {
+                    Close();
+                    return false;
+                }
+                m_size = static_cast<size_t>(size.QuadPart);
+#else
+                int fd = open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                    return false;
+
+                struct stat info;
+                if (fstat(fd, &info) != 0 || info.st_size == 0)
+                {
+                    close(fd);
+                    return false;
+                }
+
+                void* p = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+                close(fd);
+                if (p == MAP_FAILED)
+                    return false;
+
+                // Frames are read front to back; let the kernel read ahead
+                madvise(p, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+                m_size = static_cast<size_t>(info.st_size);
+#endif
+                m_pData = static_cast<const uint8_t*>(p);
+                return true;
+            }
+
+            void Close()
+            {
+#if defined(_WIN32)
+                if (m_pData)
+                    UnmapViewOfFile(m_pData);
+                if (m_hMapping)
+                    CloseHandle(m_hMapping);
+                if (m_hFile != INVALID_HANDLE_VALUE)
+                    CloseHandle(m_hFile);
+                m_hMapping = nullptr;
+                m_hFile = INVALID_HANDLE_VALUE;
+#else
+                if (m_pData)
+                    munmap(const_cast<uint8_t*>(m_pData), m_size);
+#endif
+                m_pData = nullptr;
+                m_size = 0;
+            }
+
+            const uint8_t* Data() const { return m_pData; }
+            size_t Size() const { return m_size; }
+
+        private:
+            const uint8_t* m_pData;
+            size_t m_size;
+#if defined(_WIN32)
+            HANDLE m_hFile;
+            HANDLE m_hMapping;
+#endif
+        };
+    }
+
+    // Replays a recording made with CameraController::StartRecording as a single camera.
+    //
+    // The file is memory-mapped and indexed once; in callback mode each frame is handed to the
+    // grab callback straight from the mapping (no copy), with its recorded blockID and timestamp.
+    // GrabImage (pull mode) copies into the caller's buffer like a real driver. Geometry and
+    // pixel format are fixed by the recording; trigger mode steps one frame per software trigger.
+    class PlaybackCameraBackend : public ICameraBackend
+    {
+    private:
+        enum class FrameEvent
+        {
+            Ready,
+            Timeout,
+            Stopped
+        };
+
+        struct Frame
+        {
+            const RecordingFrameHeader* pHeader;
+            const uint8_t* pData;
+        };
+
+        PlaybackConfig m_config;
+        MappedFile m_file;
+        std::vector<Frame> m_frames;
+        std::string m_pixelFormat;
+        int m_width;
+        int m_height;
+        int m_rowBytes;                 // Recorded row size (wider than m_width for 10/12-bit formats)
+
+        std::mutex m_mutex;
+        std::condition_variable m_cvState;
+        bool m_systemInitialized;
+        bool m_open;
+
+        std::map<std::string, IntNode> m_intNodes;
+        std::map<std::string, FloatNode> m_floatNodes;
+        std::map<std::string, EnumNode> m_enumNodes;
+        std::set<std::string> m_commandNodes;
+
+        // Streaming state (guarded by m_mutex)
+        bool m_acquiring;
+        bool m_stopStream;
+        uint32_t m_pendingTriggers;
+        size_t m_nextFrame;
+        uint64_t m_loop;
+        std::chrono::steady_clock::time_point m_streamStart;    // Original pacing: time of frame 0 in this pass
+        std::chrono::steady_clock::time_point m_nextFrameTime;  // Fixed pacing
+
+        GrabCallbackFunc m_callback;
+        void* m_pUserDefine;
+        std::thread m_streamThread;
+
+        std::string m_lastError;
+
+    public:
+        explicit PlaybackCameraBackend(const PlaybackConfig& config)
+            : m_config(config)
+            , m_width(0)
+            , m_height(0)
+            , m_rowBytes(0)
+            , m_systemInitialized(false)
+            , m_open(false)
+            , m_acquiring(false)
+            , m_stopStream(false)
+            , m_pendingTriggers(0)
+            , m_nextFrame(0)
+            , m_loop(0)
+            , m_callback(nullptr)
+            , m_pUserDefine(nullptr)
+        {
+        }
+
+        ~PlaybackCameraBackend() override
+        {
+            FreeSystem();
+        }
+
+        const char* GetName() const override { return "Playback"; }
+
+        CVS_ERROR InitSystem() override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_systemInitialized)
+                return MCAM_ERR_OK;
+
+            if (!m_file.Open(m_config.path))
+            {
+                m_lastError = "Cannot open recording: " + m_config.path;
+                return BackendError::FILE_IO;
+            }
+
+            if (!IndexRecording())
+            {
+                m_file.Close();
+                return BackendError::FILE_IO;
+            }
+
+            m_systemInitialized = true;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR FreeSystem() override
+        {
+            CloseDevice(PLAYBACK_HANDLE);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_systemInitialized = false;
+            m_frames.clear();
+            m_file.Close();
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR UpdateDevice(uint32_t /*timeout*/) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_systemInitialized ? MCAM_ERR_OK : BackendError::NOT_INITIALIZED;
+        }
+
+        CVS_ERROR GetAvailableCameraNum(uint32_t* pCamNum) override
+        {
+            if (!pCamNum)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_systemInitialized)
+                return BackendError::NOT_INITIALIZED;
+
+            *pCamNum = 1;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetDeviceInfo(uint32_t enumIndex, CameraInfo& info) override
+        {
+            if (enumIndex != 0)
+                return MCAM_ERR_NO_DEVICE;
+
+            const size_t slash = m_config.path.find_last_of("/\\");
+            info.enumIndex = enumIndex;
+            info.isConnected = false;
+            info.userID = "Playback";
+            info.modelName = "Recording";
+            info.serialNumber = slash == std::string::npos ? m_config.path : m_config.path.substr(slash + 1);
+            info.deviceVersion = "1.0.0";
+            info.ipAddress = "";
+            info.macAddress = "";
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR OpenDevice(uint32_t enumIndex, int32_t* phDevice) override
+        {
+            if (!phDevice)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_systemInitialized)
+                return BackendError::NOT_INITIALIZED;
+
+            if (enumIndex != 0)
+                return MCAM_ERR_NO_DEVICE;
+
+            if (m_open)
+                return BackendError::ACCESS_DENIED;
+
+            InitializeRegisters();
+            m_open = true;
+            m_nextFrame = 0;
+            m_loop = 0;
+            *phDevice = PLAYBACK_HANDLE;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR CloseDevice(int32_t hDevice) override
+        {
+            if (!IsOpen(hDevice))
+                return BackendError::INVALID_HANDLE;
+
+            AcqStop(hDevice);
+            UnregisterGrabCallback(hDevice);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_open = false;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR AcqStart(int32_t hDevice) override
+        {
+            if (!IsOpen(hDevice))
+                return BackendError::INVALID_HANDLE;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_acquiring)
+                    return MCAM_ERR_OK;
+
+                // Playback resumes where it stopped
+                m_acquiring = true;
+                m_stopStream = false;
+                m_pendingTriggers = 0;
+                RestartPacing();
+            }
+
+            StartStreamThread();
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR AcqStop(int32_t hDevice) override
+        {
+            if (!IsOpen(hDevice))
+                return BackendError::INVALID_HANDLE;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_acquiring = false;
+                m_stopStream = true;
+            }
+            m_cvState.notify_all();
+
+            JoinStreamThread();
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR RegisterGrabCallback(int32_t hDevice, GrabCallbackFunc callback, void* pUserDefine) override
+        {
+            if (!IsOpen(hDevice))
+                return BackendError::INVALID_HANDLE;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_callback = callback;
+                m_pUserDefine = pUserDefine;
+            }
+
+            StartStreamThread();
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR UnregisterGrabCallback(int32_t hDevice) override
+        {
+            if (!IsOpen(hDevice))
+                return BackendError::INVALID_HANDLE;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_callback = nullptr;
+                m_pUserDefine = nullptr;
+                m_stopStream = true;
+            }
+            m_cvState.notify_all();
+
+            JoinStreamThread();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopStream = false;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR InitBuffer(int32_t hDevice, CVS_BUFFER* pBuffer, int32_t channels) override
+        {
+            if (!IsOpen(hDevice) || !pBuffer || channels <= 0)
+                return BackendError::INVALID_PARAMETER;
+
+            const int step = std::max(m_width * channels, m_rowBytes);
+            size_t size = static_cast<size_t>(step) * m_height;
+            void* pImage = std::calloc(size, 1);
+            if (!pImage)
+                return BackendError::GENERIC;
+
+            memset(pBuffer, 0, sizeof(CVS_BUFFER));
+            pBuffer->image.pImage = pImage;
+            pBuffer->image.width = m_width;
+            pBuffer->image.height = m_height;
+            pBuffer->image.channels = channels;
+            pBuffer->image.step = step;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR FreeBuffer(CVS_BUFFER* pBuffer) override
+        {
+            if (!pBuffer)
+                return BackendError::INVALID_PARAMETER;
+
+            std::free(pBuffer->image.pImage);
+            pBuffer->image.pImage = nullptr;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GrabImage(int32_t hDevice, CVS_BUFFER* pBuffer) override
+        {
+            if (!IsOpen(hDevice) || !pBuffer || !pBuffer->image.pImage)
+                return BackendError::INVALID_PARAMETER;
+
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_config.grabTimeoutMs);
+
+            CVS_BUFFER frame;
+            FrameEvent event = WaitForNextFrame(deadline, frame);
+            if (event == FrameEvent::Timeout)
+                return MCAM_ERR_TIMEOUT;
+            if (event != FrameEvent::Ready)
+                return BackendError::ACCESS_DENIED;
+
+            // Recorded rows are stored back to back, so the step is the row size
+            const int rowBytes = frame.image.step;
+            if (pBuffer->image.width < frame.image.width || pBuffer->image.height < frame.image.height ||
+                pBuffer->image.step < rowBytes)
+            {
+                return BackendError::BUFFER_TOO_SMALL;
+            }
+
+            uint8_t* pDst = static_cast<uint8_t*>(pBuffer->image.pImage);
+            const uint8_t* pSrc = static_cast<const uint8_t*>(frame.image.pImage);
+            for (int y = 0; y < frame.image.height; ++y)
+            {
+                memcpy(pDst + static_cast<size_t>(y) * pBuffer->image.step, pSrc + static_cast<size_t>(y) * frame.image.step, rowBytes);
+            }
+
+            pBuffer->image.width = frame.image.width;
+            pBuffer->image.height = frame.image.height;
+            pBuffer->image.channels = frame.image.channels;
+            pBuffer->blockID = frame.blockID;
+            pBuffer->timestamp = frame.timestamp;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR CvtColor(const CVS_BUFFER& src, CVS_BUFFER* pDst, int32_t code) override
+        {
+            return SoftwareCvtColor(src, pDst, code);
+        }
+
+        CVS_ERROR GetIntReg(int32_t hDevice, const char* nodeName, int64_t* pValue) override
+        {
+            if (!IsOpen(hDevice) || !nodeName || !pValue)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_intNodes.find(nodeName);
+            if (it == m_intNodes.end())
+                return NodeNotFound(nodeName);
+
+            *pValue = it->second.value;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR SetIntReg(int32_t hDevice, const char* nodeName, int64_t value) override
+        {
+            if (!IsOpen(hDevice) || !nodeName)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_intNodes.find(nodeName);
+            if (it == m_intNodes.end())
+                return NodeNotFound(nodeName);
+
+            if (value < it->second.min || value > it->second.max)
+            {
+                m_lastError = std::string(nodeName) + " is fixed by the recording";
+                return BackendError::ACCESS_DENIED;
+            }
+
+            it->second.value = value;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetIntRegRange(int32_t hDevice, const char* nodeName, int64_t* pMin, int64_t* pMax, int64_t* pInc) override
+        {
+            if (!IsOpen(hDevice) || !nodeName || !pMin || !pMax || !pInc)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_intNodes.find(nodeName);
+            if (it == m_intNodes.end())
+                return NodeNotFound(nodeName);
+
+            *pMin = it->second.min;
+            *pMax = it->second.max;
+            *pInc = 1;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetFloatReg(int32_t hDevice, const char* nodeName, double* pValue) override
+        {
+            if (!IsOpen(hDevice) || !nodeName || !pValue)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_floatNodes.find(nodeName);
+            if (it == m_floatNodes.end())
+                return NodeNotFound(nodeName);
+
+            *pValue = it->second.value;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR SetFloatReg(int32_t hDevice, const char* nodeName, double value) override
+        {
+            if (!IsOpen(hDevice) || !nodeName)
+                return BackendError::INVALID_PARAMETER;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_floatNodes.find(nodeName);
+                if (it == m_floatNodes.end())
+                    return NodeNotFound(nodeName);
+
+                if (value < it->second.min || value > it->second.max)
+                {
+                    m_lastError = std::string(nodeName) + " value out of range";
+                    return BackendError::INVALID_PARAMETER;
+                }
+
+                it->second.value = value;
+            }
+
+            // A new fixed rate applies from the next frame
+            m_cvState.notify_all();
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetFloatRegRange(int32_t hDevice, const char* nodeName, double* pMin, double* pMax) override
+        {
+            if (!IsOpen(hDevice) || !nodeName || !pMin || !pMax)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_floatNodes.find(nodeName);
+            if (it == m_floatNodes.end())
+                return NodeNotFound(nodeName);
+
+            *pMin = it->second.min;
+            *pMax = it->second.max;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetEnumReg(int32_t hDevice, const char* nodeName, char* pValue, uint32_t* pSize) override
+        {
+            if (!IsOpen(hDevice) || !nodeName)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_enumNodes.find(nodeName);
+            if (it == m_enumNodes.end())
+                return NodeNotFound(nodeName);
+
+            return CopyString(it->second.value, pValue, pSize);
+        }
+
+        CVS_ERROR SetEnumReg(int32_t hDevice, const char* nodeName, const char* value) override
+        {
+            if (!IsOpen(hDevice) || !nodeName || !value)
+                return BackendError::INVALID_PARAMETER;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_enumNodes.find(nodeName);
+                if (it == m_enumNodes.end())
+                    return NodeNotFound(nodeName);
+
+                EnumNode& node = it->second;
+                if (std::find(node.entries.begin(), node.entries.end(), value) == node.entries.end())
+                {
+                    m_lastError = std::string(value) + " is not a valid entry of " + nodeName;
+                    return BackendError::INVALID_PARAMETER;
+                }
+
+                node.value = value;
+                RestartPacing();
+            }
+
+            // Trigger configuration changes wake any waiting grab
+            m_cvState.notify_all();
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetEnumEntrySize(int32_t hDevice, const char* nodeName, int32_t* pSize) override
+        {
+            if (!IsOpen(hDevice) || !nodeName || !pSize)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_enumNodes.find(nodeName);
+            if (it == m_enumNodes.end())
+                return NodeNotFound(nodeName);
+
+            *pSize = static_cast<int32_t>(it->second.entries.size());
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetEnumEntryValue(int32_t hDevice, const char* nodeName, int32_t index, char* pValue, uint32_t* pSize) override
+        {
+            if (!IsOpen(hDevice) || !nodeName)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_enumNodes.find(nodeName);
+            if (it == m_enumNodes.end())
+                return NodeNotFound(nodeName);
+
+            if (index < 0 || index >= static_cast<int32_t>(it->second.entries.size()))
+                return BackendError::INVALID_PARAMETER;
+
+            return CopyString(it->second.entries[index], pValue, pSize);
+        }
+
+        CVS_ERROR SetBoolReg(int32_t hDevice, const char* nodeName, bool /*value*/) override
+        {
+            if (!IsOpen(hDevice) || !nodeName)
+                return BackendError::INVALID_PARAMETER;
+
+            // The recording has no boolean features (no LUT or gamma enable to replay)
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return NodeNotFound(nodeName);
+        }
+
+        CVS_ERROR SetCmdReg(int32_t hDevice, const char* nodeName) override
+        {
+            if (!IsOpen(hDevice) || !nodeName)
+                return BackendError::INVALID_PARAMETER;
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_commandNodes.find(nodeName) == m_commandNodes.end())
+                return NodeNotFound(nodeName);
+
+            if (strcmp(nodeName, "TriggerSoftware") == 0)
+            {
+                if (!m_acquiring || !IsTriggerActive())
+                {
+                    m_lastError = "Software trigger is not armed";
+                    return BackendError::ACCESS_DENIED;
+                }
+
+                m_pendingTriggers++;
+                lock.unlock();
+                m_cvState.notify_all();
+            }
+
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR ExportJson(int32_t /*hDevice*/, const char* /*filePath*/) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lastError = "Recordings have no parameter file";
+            return BackendError::ACCESS_DENIED;
+        }
+
+        CVS_ERROR ImportJson(int32_t /*hDevice*/, const char* /*filePath*/) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lastError = "Recordings have no parameter file";
+            return BackendError::ACCESS_DENIED;
+        }
+
+        const char* GetLastErrorDescription(int32_t /*hDevice*/) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_lastError.empty() ? "No error" : m_lastError.c_str();
+        }
+
+    private:
+        bool IsOpen(int32_t hDevice)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_open && hDevice == PLAYBACK_HANDLE;
+        }
+
+        CVS_ERROR NodeNotFound(const char* nodeName)
+        {
+            m_lastError = std::string("Node not found: ") + nodeName;
+            return BackendError::NODE_NOT_FOUND;
+        }
+
+        // Pixels lie inside the record and cover step * height
+        static bool IsValidRecord(const RecordingFrameHeader& frame)
+        {
+            if (frame.width <= 0 || frame.height <= 0 || frame.step <= 0)
+                return false;
+
+            return static_cast<uint64_t>(frame.step) * frame.height <= frame.dataBytes &&
+                sizeof(RecordingFrameHeader) + static_cast<uint64_t>(frame.dataBytes) <= frame.recordBytes;
+        }
+
+        // Caller holds m_mutex. Builds the frame index from the chunk headers.
+        bool IndexRecording()
+        {
+            const uint8_t* pFile = m_file.Data();
+            const size_t fileSize = m_file.Size();
+
+            RecordingFileHeader header;
+            if (fileSize < sizeof(header))
+            {
+                m_lastError = "Recording is truncated";
+                return false;
+            }
+            memcpy(&header, pFile, sizeof(header));
+
+            if (memcmp(header.magic, "CVSRAW1", 8) != 0 || header.version != RECORDING_VERSION ||
+                header.chunkBytes < sizeof(RecordingChunkHeader) || header.headerBytes > fileSize)
+            {
+                m_lastError = "Not a CvsBallVision recording";
+                return false;
+            }
+
+            // chunkCount is 0 if the recording was never finalised; take every complete chunk
+            uint64_t chunkCount = (fileSize - header.headerBytes) / header.chunkBytes;
+            if (header.chunkCount != 0)
+                chunkCount = std::min(chunkCount, header.chunkCount);
+
+            // A corrupt or truncated record ends the index: nothing after it can be trusted
+            m_frames.clear();
+            bool bValid = true;
+            for (uint64_t i = 0; bValid && i < chunkCount; ++i)
+            {
+                const uint8_t* pChunk = pFile + header.headerBytes + i * header.chunkBytes;
+                const RecordingChunkHeader* pChunkHeader = reinterpret_cast<const RecordingChunkHeader*>(pChunk);
+                if (pChunkHeader->magic != RECORDING_CHUNK_MAGIC || pChunkHeader->payloadBytes > header.chunkBytes)
+                    break;
+
+                size_t offset = sizeof(RecordingChunkHeader);
+                for (uint32_t k = 0; k < pChunkHeader->frameCount; ++k)
+                {
+                    const RecordingFrameHeader* pFrame = reinterpret_cast<const RecordingFrameHeader*>(pChunk + offset);
+                    if (offset + sizeof(RecordingFrameHeader) > pChunkHeader->payloadBytes ||
+                        !IsValidRecord(*pFrame) ||
+                        offset + pFrame->recordBytes > pChunkHeader->payloadBytes)
+                    {
+                        bValid = false;
+                        break;
+                    }
+
+                    m_frames.push_back({ pFrame, pChunk + offset + sizeof(RecordingFrameHeader) });
+                    offset += pFrame->recordBytes;
+                }
+            }
+
+            if (m_frames.empty())
+            {
+                m_lastError = "Recording contains no frames";
+                return false;
+            }
+
+            m_pixelFormat.assign(header.pixelFormat, strnlen(header.pixelFormat, RECORDING_PIXEL_FORMAT_SIZE));
+            if (m_pixelFormat.empty())
+                m_pixelFormat = "Mono8";
+            m_width = m_frames.front().pHeader->width;
+            m_height = m_frames.front().pHeader->height;
+            m_rowBytes = m_frames.front().pHeader->step;
+            return true;
+        }
+
+        // Caller holds m_mutex
+        void InitializeRegisters()
+        {
+            m_intNodes.clear();
+            m_floatNodes.clear();
+            m_enumNodes.clear();
+
+            m_intNodes["Width"] = { m_width, m_width, m_width };
+            m_intNodes["Height"] = { m_height, m_height, m_height };
+            m_intNodes["WidthMax"] = { m_width, m_width, m_width };
+            m_intNodes["HeightMax"] = { m_height, m_height, m_height };
+            m_intNodes["OffsetX"] = { 0, 0, 0 };
+            m_intNodes["OffsetY"] = { 0, 0, 0 };
+            m_intNodes["PayloadSize"] = { static_cast<int64_t>(m_rowBytes) * m_height, 0, INT64_MAX };
+
+            // Exposure and gain are baked into the recording; accepted so settings dialogs keep working
+            m_floatNodes["AcquisitionFrameRate"] = {
+                std::min(std::max(m_config.frameRate, 0.1), PLAYBACK_MAX_FPS), 0.1, PLAYBACK_MAX_FPS };
+            m_floatNodes["ExposureTime"] = { DEFAULT_EXPOSURE_US, 1.0, 3000000.0 };
+            m_floatNodes["Gain"] = { 0.0, 0.0, 32.0 };
+
+            m_enumNodes["PixelFormat"] = { m_pixelFormat, { m_pixelFormat } };
+            m_enumNodes["TriggerMode"] = { "Off", { "Off", "On" } };
+            m_enumNodes["TriggerSource"] = { "Software", { "Software" } };
+            m_enumNodes["AcquisitionMode"] = { "Continuous", { "Continuous" } };
+
+            m_commandNodes = { "TriggerSoftware", "AcquisitionStart", "AcquisitionStop" };
+        }
+
+        bool IsTriggerActive()
+        {
+            return m_enumNodes["TriggerMode"].value == "On";
+        }
+
+        // Caller holds m_mutex. The schedule restarts from the next frame to be delivered.
+        void RestartPacing()
+        {
+            auto now = std::chrono::steady_clock::now();
+            m_nextFrameTime = now;
+            m_streamStart = now - std::chrono::nanoseconds(FrameOffsetNs(m_nextFrame));
+        }
+
+        // Recorded arrival of frame index relative to frame 0
+        int64_t FrameOffsetNs(size_t index) const
+        {
+            if (index >= m_frames.size())
+                return 0;
+
+            return m_frames[index].pHeader->receivedNs - m_frames.front().pHeader->receivedNs;
+        }
+
+        // Blocks until the next frame is due, the deadline passes or streaming stops.
+        // Each frame goes to exactly one consumer (callback thread or GrabImage).
+        FrameEvent WaitForNextFrame(std::chrono::steady_clock::time_point deadline, CVS_BUFFER& frame)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto stopped = [this] { return !m_acquiring || m_stopStream; };
+
+            while (true)
+            {
+                if (stopped())
+                    return FrameEvent::Stopped;
+
+                if (m_nextFrame >= m_frames.size())
+                {
+                    if (!m_config.loop)
+                    {
+                        // End of the recording: idle until stopped
+                        m_cvState.wait_until(lock, deadline, stopped);
+                        return stopped() ? FrameEvent::Stopped : FrameEvent::Timeout;
+                    }
+
+                    m_nextFrame = 0;
+                    m_loop++;
+                    RestartPacing();
+                }
+
+                if (IsTriggerActive())
+                {
+                    if (m_pendingTriggers == 0)
+                    {
+                        if (!m_cvState.wait_until(lock, deadline, [this] {
+                            return !m_acquiring || m_stopStream || m_pendingTriggers > 0 || !IsTriggerActive();
+                            }))
+                        {
+                            return FrameEvent::Timeout;
+                        }
+                        continue;
+                    }
+
+                    m_pendingTriggers--;
+                }
+                else if (m_config.pacing != PlaybackPacing::Maximum)
+                {
+                    auto due = m_nextFrameTime;
+                    if (m_config.pacing == PlaybackPacing::Original)
+                        due = m_streamStart + std::chrono::nanoseconds(FrameOffsetNs(m_nextFrame));
+
+                    if (due > deadline)
+                    {
+                        m_cvState.wait_until(lock, deadline, stopped);
+                        return stopped() ? FrameEvent::Stopped : FrameEvent::Timeout;
+                    }
+
+                    // Woken early by a stop or a trigger/rate change: re-evaluate
+                    if (m_cvState.wait_until(lock, due, [this] { return !m_acquiring || m_stopStream || IsTriggerActive(); }))
+                        continue;
+
+                    // Fixed schedule; resynchronise if the consumer fell more than a frame behind
+                    auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(1.0 / m_floatNodes["AcquisitionFrameRate"].value));
+                    auto now = std::chrono::steady_clock::now();
+                    m_nextFrameTime = (now - due > period) ? now + period : due + period;
+                }
+
+                const Frame& source = m_frames[m_nextFrame++];
+                const RecordingFrameHeader& header = *source.pHeader;
+
+                // Later passes continue the blockID and timestamp sequence of the first
+                const RecordingFrameHeader& first = *m_frames.front().pHeader;
+                const RecordingFrameHeader& last = *m_frames.back().pHeader;
+                const uint64_t blockSpan = last.blockID - first.blockID + 1;
+                const uint64_t timeSpan = last.timestamp - first.timestamp +
+                    (m_frames.size() > 1 ? (last.timestamp - first.timestamp) / (m_frames.size() - 1) : 0);
+
+                memset(&frame, 0, sizeof(frame));
+                frame.image.pImage = const_cast<uint8_t*>(source.pData);
+                frame.image.width = header.width;
+                frame.image.height = header.height;
+                frame.image.channels = header.channels;
+                frame.image.step = header.step;
+                frame.blockID = header.blockID + m_loop * blockSpan;
+                frame.timestamp = header.timestamp + m_loop * timeSpan;
+                return FrameEvent::Ready;
+            }
+        }
+
+        void StartStreamThread()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_acquiring || !m_callback || m_streamThread.joinable())
+                return;
+
+            m_stopStream = false;
+            m_streamThread = std::thread(&PlaybackCameraBackend::StreamThreadFunc, this);
+        }
+
+        void JoinStreamThread()
+        {
+            if (!m_streamThread.joinable())
+                return;
+
+            if (m_streamThread.get_id() == std::this_thread::get_id())
+            {
+                // Called from inside the grab callback; the thread exits on its own
+                m_streamThread.detach();
+                return;
+            }
+
+            m_streamThread.join();
+        }
+
+        // Push-mode delivery straight from the mapping
+        void StreamThreadFunc()
+        {
+            while (true)
+            {
+                CVS_BUFFER frame;
+                FrameEvent event = WaitForNextFrame(
+                    std::chrono::steady_clock::now() + std::chrono::milliseconds(m_config.grabTimeoutMs), frame);
+
+                if (event == FrameEvent::Stopped)
+                    break;
+
+                if (event != FrameEvent::Ready)
+                    continue;
+
+                GrabCallbackFunc callback;
+                void* pUserDefine;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    callback = m_callback;
+                    pUserDefine = m_pUserDefine;
+                }
+
+                if (callback)
+                    callback(EVENT_NEW_IMAGE, &frame, pUserDefine);
+            }
+        }
+    };
+
+    std::unique_ptr<ICameraBackend> CreatePlaybackBackend(const PlaybackConfig& config)
+    {
+        return std::make_unique<PlaybackCameraBackend>(config);
+    }
+}
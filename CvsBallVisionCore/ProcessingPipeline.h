@@ -0,0 +1,350 @@
+#pragma once
+
+#include "CameraBackend.h"
+#include "FrameRing.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+
+namespace CvsBallVision
+{
+    // Stage indices (capture runs on the driver's grab thread, the rest on workers)
+    enum PipelineStageIndex
+    {
+        PIPELINE_STAGE_CAPTURE = 0,
+        PIPELINE_STAGE_DEBAYER,
+        PIPELINE_STAGE_POST_PROCESS,
+        PIPELINE_STAGE_FAN_OUT,
+        PIPELINE_STAGE_COUNT
+    };
+
+    inline float ToMicroseconds(std::chrono::steady_clock::duration elapsed)
+    {
+        return std::chrono::duration<float, std::micro>(elapsed).count();
+    }
+
+    inline int64_t ToSteadyNs(std::chrono::steady_clock::time_point time)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    // Lock-free latency accumulator (nanoseconds)
+    class LatencyCounter
+    {
+    public:
+        LatencyCounter() : m_count(0), m_totalNs(0), m_maxNs(0), m_lastNs(0) {}
+
+        void Add(std::chrono::steady_clock::duration elapsed)
+        {
+            uint64_t ns = static_cast<uint64_t>(std::max<int64_t>(0,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+
+            m_count.fetch_add(1, std::memory_order_relaxed);
+            m_totalNs.fetch_add(ns, std::memory_order_relaxed);
+            m_lastNs.store(ns, std::memory_order_relaxed);
+
+            uint64_t currentMax = m_maxNs.load(std::memory_order_relaxed);
+            while (ns > currentMax &&
+                !m_maxNs.compare_exchange_weak(currentMax, ns, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        double GetAverageUs() const
+        {
+            uint64_t count = m_count.load(std::memory_order_relaxed);
+            return count ? m_totalNs.load(std::memory_order_relaxed) / 1000.0 / count : 0.0;
+        }
+
+        double GetMaxUs() const { return m_maxNs.load(std::memory_order_relaxed) / 1000.0; }
+        double GetLastUs() const { return m_lastNs.load(std::memory_order_relaxed) / 1000.0; }
+
+        void Reset()
+        {
+            m_count.store(0, std::memory_order_relaxed);
+            m_totalNs.store(0, std::memory_order_relaxed);
+            m_maxNs.store(0, std::memory_order_relaxed);
+            m_lastNs.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64_t> m_count;
+        std::atomic<uint64_t> m_totalNs;
+        std::atomic<uint64_t> m_maxNs;
+        std::atomic<uint64_t> m_lastNs;
+    };
+
+    // Per-stage counters
+    struct PipelineStageCounters
+    {
+        std::atomic<uint64_t> framesProcessed;
+        std::atomic<uint64_t> framesDropped;
+        LatencyCounter queueWait;
+        LatencyCounter process;
+
+        PipelineStageCounters() : framesProcessed(0), framesDropped(0) {}
+
+        void Reset()
+        {
+            framesProcessed.store(0, std::memory_order_relaxed);
+            framesDropped.store(0, std::memory_order_relaxed);
+            queueWait.Reset();
+            process.Reset();
+        }
+    };
+
+    // Fixed-capacity FIFO between pipeline stages.
+    // When full, the configured policy decides whether the oldest entry is evicted,
+    // the new entry is rejected, or the producer blocks until space frees up.
+    // Evicted/rejected entries are handed back so the caller can release their resources.
+    template <typename T>
+    class BoundedQueue
+    {
+    public:
+        enum class PushResult
+        {
+            Queued,
+            QueuedDroppedOldest,    // 'dropped' holds the evicted oldest entry
+            DroppedNewest,          // 'dropped' holds the rejected new entry
+            Closed                  // 'dropped' holds the rejected new entry
+        };
+
+        BoundedQueue(size_t capacity, QueuePolicy policy)
+            : m_items(std::max<size_t>(capacity, 1))
+            , m_policy(policy)
+            , m_head(0)
+            , m_size(0)
+            , m_highWater(0)
+            , m_closed(false)
+        {
+        }
+
+        PushResult Push(T&& item, T& dropped)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            PushResult result = PushResult::Queued;
+
+            if (m_closed)
+            {
+                dropped = std::move(item);
+                return PushResult::Closed;
+            }
+
+            if (m_size == m_items.size())
+            {
+                switch (m_policy)
+                {
+                case QueuePolicy::DropNewest:
+                    dropped = std::move(item);
+                    return PushResult::DroppedNewest;
+
+                case QueuePolicy::DropOldest:
+                    dropped = std::move(m_items[m_head]);
+                    m_head = (m_head + 1) % m_items.size();
+                    m_size--;
+                    result = PushResult::QueuedDroppedOldest;
+                    break;
+
+                case QueuePolicy::Block:
+                    m_cvNotFull.wait(lock, [this] { return m_closed || m_size < m_items.size(); });
+                    if (m_closed)
+                    {
+                        dropped = std::move(item);
+                        return PushResult::Closed;
+                    }
+                    break;
+                }
+            }
+
+            m_items[(m_head + m_size) % m_items.size()] = std::move(item);
+            m_size++;
+            m_highWater = std::max(m_highWater, m_size);
+
+            lock.unlock();
+            m_cvNotEmpty.notify_one();
+            return result;
+        }
+
+        // Blocks until an entry is available; returns false once closed and empty
+        bool Pop(T& item)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cvNotEmpty.wait(lock, [this] { return m_closed || m_size > 0; });
+            if (m_size == 0)
+                return false;
+
+            PopFront(item);
+            lock.unlock();
+            m_cvNotFull.notify_one();
+            return true;
+        }
+
+        bool TryPop(T& item)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_size == 0)
+                return false;
+
+            PopFront(item);
+            m_cvNotFull.notify_one();
+            return true;
+        }
+
+        // Wake all waiters; further pushes are rejected
+        void Close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_closed = true;
+            }
+            m_cvNotEmpty.notify_all();
+            m_cvNotFull.notify_all();
+        }
+
+        size_t Size()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_size;
+        }
+
+        size_t GetHighWater()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_highWater;
+        }
+
+    private:
+        void PopFront(T& item)
+        {
+            item = std::move(m_items[m_head]);
+            m_head = (m_head + 1) % m_items.size();
+            m_size--;
+        }
+
+        std::vector<T> m_items;
+        QueuePolicy m_policy;
+        size_t m_head;
+        size_t m_size;
+        size_t m_highWater;
+        bool m_closed;
+        std::mutex m_mutex;
+        std::condition_variable m_cvNotEmpty;
+        std::condition_variable m_cvNotFull;
+    };
+
+    // Owned copies of raw driver frames, so the driver buffer can be returned immediately
+    class RawFramePool
+    {
+    public:
+        static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+        // Page-aligned buffers, prefaulted and optionally locked into RAM
+        RawFramePool(size_t count, size_t bytesPerFrame, bool bLockMemory)
+            : m_frames(count)
+            , m_bLockMemory(bLockMemory)
+            , m_inUse(0)
+            , m_highWater(0)
+        {
+            for (auto& frame : m_frames)
+            {
+                frame.data.Reserve(bytesPerFrame, m_bLockMemory);
+            }
+        }
+
+        // Returns INVALID_INDEX when every buffer is in flight
+        uint32_t Acquire(size_t requiredBytes, uint8_t*& pData)
+        {
+            for (size_t i = 0; i < m_frames.size(); ++i)
+            {
+                bool expected = false;
+                if (m_frames[i].inUse.compare_exchange_strong(expected, true,
+                    std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    // Only grows after a resolution change
+                    if (!m_frames[i].data.Reserve(requiredBytes, m_bLockMemory))
+                    {
+                        m_frames[i].inUse.store(false, std::memory_order_release);
+                        break;
+                    }
+
+                    uint32_t inUse = m_inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+                    uint32_t highWater = m_highWater.load(std::memory_order_relaxed);
+                    while (inUse > highWater && !m_highWater.compare_exchange_weak(highWater, inUse, std::memory_order_relaxed))
+                    {
+                    }
+
+                    pData = m_frames[i].data.Data();
+                    return static_cast<uint32_t>(i);
+                }
+            }
+
+            pData = nullptr;
+            return INVALID_INDEX;
+        }
+
+        void Release(uint32_t index)
+        {
+            if (index < m_frames.size())
+            {
+                m_frames[index].inUse.store(false, std::memory_order_release);
+                m_inUse.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        size_t GetCount() const { return m_frames.size(); }
+        uint32_t GetHighWater() const { return m_highWater.load(std::memory_order_relaxed); }
+
+        bool IsMemoryLocked() const
+        {
+            for (const auto& frame : m_frames)
+            {
+                if (!frame.data.IsLocked())
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        struct Frame
+        {
+            AlignedBuffer data;
+            std::atomic<bool> inUse;
+
+            Frame() : inUse(false) {}
+        };
+
+        std::vector<Frame> m_frames;
+        const bool m_bLockMemory;
+        std::atomic<uint32_t> m_inUse;
+        std::atomic<uint32_t> m_highWater;
+    };
+
+    // Work item passed between pipeline stages
+    struct PipelineFrame
+    {
+        CVS_BUFFER raw;             // Raw image (owned pool copy, or the driver buffer when inline)
+        uint32_t rawIndex;          // RawFramePool index, INVALID_INDEX if not owned
+        uint32_t ringSlot;          // FrameRing slot, INVALID_SLOT until claimed
+        bool bPublished;            // Slot published (pinned) rather than being written
+        bool bToneMapped;           // Tone tables already applied (fused debayer pass or 10/12-bit unpack)
+        int offsetX;                // Sensor position of raw's top-left pixel
+        int offsetY;
+        ImageData imageData;
+        FrameTimings timings;       // Copied into imageData when the frame is published
+        std::chrono::steady_clock::time_point captureTime;
+        std::chrono::steady_clock::time_point enqueueTime;
+
+        PipelineFrame()
+            : rawIndex(RawFramePool::INVALID_INDEX)
+            , ringSlot(FrameRing::INVALID_SLOT)
+            , bPublished(false)
+            , bToneMapped(false)
+            , offsetX(0)
+            , offsetY(0)
+        {
+            memset(&raw, 0, sizeof(raw));
+            memset(&imageData, 0, sizeof(imageData));
+            memset(&timings, 0, sizeof(timings));
+        }
+    };
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace CvsBallVision
+{
+    // Immutable object published to lock-free readers (read-copy-update).
+    //
+    // Readers open a ReadGuard and use the current object without taking a lock.
+    // Writers swap in a replacement and delete the previous object only once no reader
+    // can still be using it (grace period). Readers are counted per generation: a write
+    // flips the generation, so it only waits for guards opened before the swap and
+    // never for readers that keep arriving afterwards. Writes are rare parameter
+    // changes and are serialized by a mutex; reads never block.
+    template <typename T>
+    class RcuPointer
+    {
+    public:
+        class ReadGuard
+        {
+        public:
+            explicit ReadGuard(const RcuPointer& owner)
+                : m_owner(owner)
+            {
+                // seq_cst pairs with Update: a reader registered in the generation it
+                // validated is either waited for by the writer, or sees the new object
+                for (;;)
+                {
+                    const uint32_t generation = m_owner.m_generation.load(std::memory_order_seq_cst);
+                    m_slot = generation & 1u;
+                    m_owner.m_readers[m_slot].fetch_add(1, std::memory_order_seq_cst);
+                    if (m_owner.m_generation.load(std::memory_order_seq_cst) == generation)
+                        break;
+
+                    // A writer flipped in between; register again in the new generation
+                    m_owner.m_readers[m_slot].fetch_sub(1, std::memory_order_release);
+                }
+                m_pValue = m_owner.m_pValue.load(std::memory_order_seq_cst);
+            }
+
+            ~ReadGuard()
+            {
+                m_owner.m_readers[m_slot].fetch_sub(1, std::memory_order_release);
+            }
+
+            const T* Get() const { return m_pValue; }
+            const T* operator->() const { return m_pValue; }
+            const T& operator*() const { return *m_pValue; }
+
+        private:
+            ReadGuard(const ReadGuard&) = delete;
+            ReadGuard& operator=(const ReadGuard&) = delete;
+
+            const RcuPointer& m_owner;
+            const T* m_pValue;
+            uint32_t m_slot;
+        };
+
+        explicit RcuPointer(std::unique_ptr<T> initial = nullptr)
+            : m_pValue(initial.release())
+            , m_generation(0)
+        {
+            m_readers[0].store(0, std::memory_order_relaxed);
+            m_readers[1].store(0, std::memory_order_relaxed);
+        }
+
+        ~RcuPointer()
+        {
+            delete m_pValue.load(std::memory_order_acquire);
+        }
+
+        void Update(std::unique_ptr<T> value)
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            const T* pOld = m_pValue.exchange(value.release(), std::memory_order_seq_cst);
+
+            // Start a new generation; guards opened from here on register in the other slot
+            const uint32_t generation = m_generation.fetch_add(1, std::memory_order_seq_cst);
+
+            // Grace period: wait out only the readers of the generation that may hold the old object
+            while (m_readers[generation & 1u].load(std::memory_order_seq_cst) != 0)
+            {
+                std::this_thread::yield();
+            }
+
+            delete pOld;
+        }
+
+    private:
+        RcuPointer(const RcuPointer&) = delete;
+        RcuPointer& operator=(const RcuPointer&) = delete;
+
+        std::atomic<const T*> m_pValue;
+        std::atomic<uint32_t> m_generation;
+        mutable std::atomic<int> m_readers[2];
+        std::mutex m_writeMutex;
+    };
+}
@@ -0,0 +1,1274 @@
+#include "CameraBackend.h"
+#include "ImageProcessing.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <cmath>
+#include <random>
+#include <set>
+#include <sstream>
+
+namespace CvsBallVision
+{
+    using namespace Constants;
+
+    namespace
+    {
+        constexpr int32_t SIMULATED_HANDLE_BASE = 100;
+        constexpr int SIMULATED_WIDTH_MIN = 64;
+        constexpr int SIMULATED_WIDTH_INC = 8;
+        constexpr int SIMULATED_HEIGHT_MIN = 8;
+        constexpr int SIMULATED_HEIGHT_INC = 2;
+        constexpr double SIMULATED_GAMMA_MAX = 3.999;
+        constexpr int SIMULATED_LUT_ENTRIES = 4096;            // 12 bits in, 12 bits out
+
+        struct IntNode
+        {
+            int64_t value;
+            int64_t min;
+            int64_t max;
+            int64_t inc;
+            bool lockedWhileAcquiring;
+        };
+
+        struct FloatNode
+        {
+            double value;
+            double min;
+            double max;
+        };
+
+        struct EnumNode
+        {
+            std::string value;
+            std::vector<std::string> entries;
+            bool lockedWhileAcquiring;
+        };
+
+        bool IsBayerFormat(const std::string& format)
+        {
+            return format.compare(0, 5, "Bayer") == 0;
+        }
+
+        ImageProcessing::RawFormat GetSimulatedRawFormat(const std::string& format)
+        {
+            ImageProcessing::RawFormat rawFormat = { 8, false };
+            ImageProcessing::ParseRawFormat(format, rawFormat);
+            return rawFormat;
+        }
+
+        // 8-bit scene row -> bitDepth samples in the camera's layout (v scaled to the full range,
+        // through the 12-bit hardware LUT when pLut is set)
+        void EncodeRawRow(const uint8_t* pSrc, uint8_t* pDst, int width, const ImageProcessing::RawFormat& format,
+            const uint16_t* pLut)
+        {
+            const int bits = format.bitDepth;
+            auto expand = [bits, pLut](uint8_t v) -> uint16_t
+            {
+                uint16_t sample = static_cast<uint16_t>((v << 4) | (v >> 4));
+                if (pLut)
+                    sample = pLut[sample];
+                return static_cast<uint16_t>(sample >> (12 - bits));
+            };
+
+            if (bits == 8)
+            {
+                for (int x = 0; x < width; x++)
+                    pDst[x] = static_cast<uint8_t>(expand(pSrc[x]));
+                return;
+            }
+
+            if (!format.bPacked)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    uint16_t sample = expand(pSrc[x]);
+                    pDst[2 * x] = static_cast<uint8_t>(sample);
+                    pDst[2 * x + 1] = static_cast<uint8_t>(sample >> 8);
+                }
+                return;
+            }
+
+            // GigE Vision packed: byte 0 = s0 high bits, byte 1 = low nibbles (s0 | s1 << 4), byte 2 = s1 high bits
+            const int lowBits = bits - 8;
+            for (int x = 0; x < width; x += 2)
+            {
+                uint16_t s0 = expand(pSrc[x]);
+                uint16_t s1 = (x + 1 < width) ? expand(pSrc[x + 1]) : 0;
+                uint8_t* pTriple = pDst + (x / 2) * 3;
+                pTriple[0] = static_cast<uint8_t>(s0 >> lowBits);
+                pTriple[1] = static_cast<uint8_t>((s0 & ((1 << lowBits) - 1)) | ((s1 & ((1 << lowBits) - 1)) << 4));
+                pTriple[2] = static_cast<uint8_t>(s1 >> lowBits);
+            }
+        }
+
+        CVS_ERROR CopyString(const std::string& value, char* pValue, uint32_t* pSize)
+        {
+            if (!pValue || !pSize)
+                return BackendError::INVALID_PARAMETER;
+
+            if (value.size() + 1 > *pSize)
+            {
+                *pSize = static_cast<uint32_t>(value.size() + 1);
+                return BackendError::BUFFER_TOO_SMALL;
+            }
+
+            memcpy(pValue, value.c_str(), value.size() + 1);
+            *pSize = static_cast<uint32_t>(value.size() + 1);
+            return MCAM_ERR_OK;
+        }
+
+        uint64_t SteadyClockNs()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+    }
+
+    // Synthetic camera that emulates the register map and streaming behaviour
+    // of an MG-A160K class GigE camera (Bayer/Mono 8-12 bit, free-run or trigger).
+    class SimulatedCameraBackend : public ICameraBackend
+    {
+    private:
+        enum class FrameEvent
+        {
+            Ready,
+            Timeout,
+            Error,
+            Stopped
+        };
+
+        struct Device
+        {
+            int32_t handle;
+            uint32_t enumIndex;
+
+            std::mutex mutex;
+            std::condition_variable cvState;
+
+            std::map<std::string, IntNode> intNodes;
+            std::map<std::string, FloatNode> floatNodes;
+            std::map<std::string, EnumNode> enumNodes;
+            std::map<std::string, bool> boolNodes;
+            std::set<std::string> commandNodes;
+            std::vector<uint16_t> lut;      // Hardware LUT behind LUTIndex / LUTValue
+
+            // Streaming state (guarded by mutex)
+            bool acquiring = false;
+            bool stopStream = false;
+            uint32_t pendingTriggers = 0;
+            uint64_t blockID = 0;
+            std::chrono::steady_clock::time_point nextFrameTime;
+            std::mt19937 rng;
+
+            // Free run exposes the next frame while the current one is read out, so its window
+            // is latched when the previous frame is produced; a trigger latches it on arrival
+            int exposingOffsetX = 0;
+            int exposingOffsetY = 0;
+
+            // Geometry latched at AcqStart (OffsetX / OffsetY are latched per frame)
+            int streamWidth = 0;
+            int streamHeight = 0;
+            int sensorWidth = 0;
+            int sensorHeight = 0;
+            std::string streamFormat;
+            ImageProcessing::RawFormat streamRawFormat = { 8, false };
+            std::vector<uint8_t> background;    // Whole sensor
+
+            GrabCallbackFunc callback = nullptr;
+            void* pUserDefine = nullptr;
+            std::thread streamThread;
+
+            std::string lastError;
+        };
+
+        SimulatedCameraConfig m_config;
+        std::mutex m_mutex;
+        bool m_systemInitialized;
+        std::map<int32_t, std::unique_ptr<Device>> m_devices;
+        int32_t m_nextHandle;
+
+    public:
+        explicit SimulatedCameraBackend(const SimulatedCameraConfig& config)
+            : m_config(config)
+            , m_systemInitialized(false)
+            , m_nextHandle(SIMULATED_HANDLE_BASE)
+        {
+        }
+
+        ~SimulatedCameraBackend() override
+        {
+            FreeSystem();
+        }
+
+        const char* GetName() const override { return "Simulated"; }
+
+        CVS_ERROR InitSystem() override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_systemInitialized = true;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR FreeSystem() override
+        {
+            std::vector<int32_t> handles;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (auto& entry : m_devices)
+                    handles.push_back(entry.first);
+            }
+
+            for (int32_t hDevice : handles)
+                CloseDevice(hDevice);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_systemInitialized = false;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR UpdateDevice(uint32_t /*timeout*/) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_systemInitialized ? MCAM_ERR_OK : BackendError::NOT_INITIALIZED;
+        }
+
+        CVS_ERROR GetAvailableCameraNum(uint32_t* pCamNum) override
+        {
+            if (!pCamNum)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_systemInitialized)
+                return BackendError::NOT_INITIALIZED;
+
+            *pCamNum = m_config.deviceCount;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetDeviceInfo(uint32_t enumIndex, CameraInfo& info) override
+        {
+            if (enumIndex >= m_config.deviceCount)
+                return MCAM_ERR_NO_DEVICE;
+
+            char text[64];
+            info.enumIndex = enumIndex;
+            info.isConnected = false;
+            info.userID = "Simulated";
+            info.modelName = IsBayerFormat(m_config.pixelFormat) ? "SIM-A160K-72" : "SIM-A160M-72";
+            snprintf(text, sizeof(text), "SIM%05u", enumIndex);
+            info.serialNumber = text;
+            info.deviceVersion = "1.0.0";
+            snprintf(text, sizeof(text), "127.0.0.%u", 10 + enumIndex);
+            info.ipAddress = text;
+            snprintf(text, sizeof(text), "00:00:5E:00:53:%02X", enumIndex & 0xFF);
+            info.macAddress = text;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR OpenDevice(uint32_t enumIndex, int32_t* phDevice) override
+        {
+            if (!phDevice)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_systemInitialized)
+                return BackendError::NOT_INITIALIZED;
+
+            if (enumIndex >= m_config.deviceCount)
+                return MCAM_ERR_NO_DEVICE;
+
+            for (auto& entry : m_devices)
+            {
+                if (entry.second->enumIndex == enumIndex)
+                    return BackendError::ACCESS_DENIED;
+            }
+
+            auto device = std::make_unique<Device>();
+            device->handle = m_nextHandle++;
+            device->enumIndex = enumIndex;
+            device->rng.seed(m_config.randomSeed != 0 ? m_config.randomSeed + enumIndex : std::random_device()());
+            InitializeRegisters(*device);
+
+            *phDevice = device->handle;
+            m_devices[device->handle] = std::move(device);
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR CloseDevice(int32_t hDevice) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice)
+                return BackendError::INVALID_HANDLE;
+
+            AcqStop(hDevice);
+            UnregisterGrabCallback(hDevice);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_devices.erase(hDevice);
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR AcqStart(int32_t hDevice) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice)
+                return BackendError::INVALID_HANDLE;
+
+            {
+                std::lock_guard<std::mutex> lock(pDevice->mutex);
+                if (pDevice->acquiring)
+                    return MCAM_ERR_OK;
+
+                pDevice->streamWidth = static_cast<int>(pDevice->intNodes["Width"].value);
+                pDevice->streamHeight = static_cast<int>(pDevice->intNodes["Height"].value);
+                pDevice->sensorWidth = static_cast<int>(pDevice->intNodes["WidthMax"].value);
+                pDevice->sensorHeight = static_cast<int>(pDevice->intNodes["HeightMax"].value);
+                pDevice->streamFormat = pDevice->enumNodes["PixelFormat"].value;
+                pDevice->streamRawFormat = GetSimulatedRawFormat(pDevice->streamFormat);
+                RenderBackground(*pDevice);
+
+                pDevice->acquiring = true;
+                pDevice->stopStream = false;
+                pDevice->pendingTriggers = 0;
+                pDevice->nextFrameTime = std::chrono::steady_clock::now() + FramePeriod(*pDevice);
+                LatchOffsets(*pDevice, pDevice->exposingOffsetX, pDevice->exposingOffsetY);
+            }
+
+            StartStreamThread(*pDevice);
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR AcqStop(int32_t hDevice) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice)
+                return BackendError::INVALID_HANDLE;
+
+            {
+                std::lock_guard<std::mutex> lock(pDevice->mutex);
+                pDevice->acquiring = false;
+                pDevice->stopStream = true;
+            }
+            pDevice->cvState.notify_all();
+
+            JoinStreamThread(*pDevice);
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR RegisterGrabCallback(int32_t hDevice, GrabCallbackFunc callback, void* pUserDefine) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice)
+                return BackendError::INVALID_HANDLE;
+
+            {
+                std::lock_guard<std::mutex> lock(pDevice->mutex);
+                pDevice->callback = callback;
+                pDevice->pUserDefine = pUserDefine;
+            }
+
+            StartStreamThread(*pDevice);
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR UnregisterGrabCallback(int32_t hDevice) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice)
+                return BackendError::INVALID_HANDLE;
+
+            {
+                std::lock_guard<std::mutex> lock(pDevice->mutex);
+                pDevice->callback = nullptr;
+                pDevice->pUserDefine = nullptr;
+                pDevice->stopStream = true;
+            }
+            pDevice->cvState.notify_all();
+
+            JoinStreamThread(*pDevice);
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+            pDevice->stopStream = false;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR InitBuffer(int32_t hDevice, CVS_BUFFER* pBuffer, int32_t channels) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !pBuffer || channels <= 0)
+                return BackendError::INVALID_PARAMETER;
+
+            int width, height;
+            ImageProcessing::RawFormat rawFormat;
+            {
+                std::lock_guard<std::mutex> lock(pDevice->mutex);
+                width = static_cast<int>(pDevice->intNodes["Width"].value);
+                height = static_cast<int>(pDevice->intNodes["Height"].value);
+                rawFormat = GetSimulatedRawFormat(pDevice->enumNodes["PixelFormat"].value);
+            }
+
+            // Raw buffers hold a row of camera samples, which is wider than width for 10/12-bit formats
+            const int step = std::max(width * channels, ImageProcessing::GetRawRowBytes(width, rawFormat));
+            size_t size = static_cast<size_t>(step) * height;
+            void* pImage = std::calloc(size, 1);
+            if (!pImage)
+                return BackendError::GENERIC;
+
+            memset(pBuffer, 0, sizeof(CVS_BUFFER));
+            pBuffer->image.pImage = pImage;
+            pBuffer->image.width = width;
+            pBuffer->image.height = height;
+            pBuffer->image.channels = channels;
+            pBuffer->image.step = step;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR FreeBuffer(CVS_BUFFER* pBuffer) override
+        {
+            if (!pBuffer)
+                return BackendError::INVALID_PARAMETER;
+
+            std::free(pBuffer->image.pImage);
+            pBuffer->image.pImage = nullptr;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GrabImage(int32_t hDevice, CVS_BUFFER* pBuffer) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !pBuffer || !pBuffer->image.pImage)
+                return BackendError::INVALID_PARAMETER;
+
+            auto deadline = std::chrono::steady_clock::now() +
+                std::chrono::milliseconds(m_config.grabTimeoutMs);
+
+            uint64_t blockID = 0;
+            int offsetX = 0, offsetY = 0;
+            FrameEvent event = WaitForNextFrame(*pDevice, deadline, blockID, offsetX, offsetY);
+
+            switch (event)
+            {
+            case FrameEvent::Ready:
+                return RenderFrame(*pDevice, pBuffer, blockID, offsetX, offsetY);
+            case FrameEvent::Timeout:
+                return MCAM_ERR_TIMEOUT;
+            case FrameEvent::Error:
+                return BackendError::TRANSFER_ERROR;
+            default:
+                return BackendError::ACCESS_DENIED;
+            }
+        }
+
+        CVS_ERROR CvtColor(const CVS_BUFFER& src, CVS_BUFFER* pDst, int32_t code) override
+        {
+            return SoftwareCvtColor(src, pDst, code);
+        }
+
+        CVS_ERROR GetIntReg(int32_t hDevice, const char* nodeName, int64_t* pValue) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !nodeName || !pValue)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+            auto it = pDevice->intNodes.find(nodeName);
+            if (it == pDevice->intNodes.end())
+                return NodeNotFound(*pDevice, nodeName);
+
+            *pValue = it->second.value;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR SetIntReg(int32_t hDevice, const char* nodeName, int64_t value) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !nodeName)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+            auto it = pDevice->intNodes.find(nodeName);
+            if (it == pDevice->intNodes.end())
+                return NodeNotFound(*pDevice, nodeName);
+
+            IntNode& node = it->second;
+            if (node.lockedWhileAcquiring && pDevice->acquiring)
+            {
+                pDevice->lastError = std::string(nodeName) + " is locked while acquiring";
+                return BackendError::ACCESS_DENIED;
+            }
+
+            if (value < node.min || value > node.max || (value - node.min) % node.inc != 0)
+            {
+                pDevice->lastError = std::string(nodeName) + " value out of range";
+                return BackendError::INVALID_PARAMETER;
+            }
+
+            node.value = value;
+
+            // LUTValue reads and writes the entry LUTIndex selects
+            if (strcmp(nodeName, "LUTIndex") == 0)
+                pDevice->intNodes["LUTValue"].value = pDevice->lut[static_cast<size_t>(value)];
+            else if (strcmp(nodeName, "LUTValue") == 0)
+                pDevice->lut[static_cast<size_t>(pDevice->intNodes["LUTIndex"].value)] = static_cast<uint16_t>(value);
+
+            UpdateDependentNodes(*pDevice);
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetIntRegRange(int32_t hDevice, const char* nodeName, int64_t* pMin, int64_t* pMax, int64_t* pInc) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !nodeName || !pMin || !pMax || !pInc)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+            auto it = pDevice->intNodes.find(nodeName);
+            if (it == pDevice->intNodes.end())
+                return NodeNotFound(*pDevice, nodeName);
+
+            *pMin = it->second.min;
+            *pMax = it->second.max;
+            *pInc = it->second.inc;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetFloatReg(int32_t hDevice, const char* nodeName, double* pValue) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !nodeName || !pValue)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+            auto it = pDevice->floatNodes.find(nodeName);
+            if (it == pDevice->floatNodes.end())
+                return NodeNotFound(*pDevice, nodeName);
+
+            *pValue = it->second.value;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR SetFloatReg(int32_t hDevice, const char* nodeName, double value) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !nodeName)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+            auto it = pDevice->floatNodes.find(nodeName);
+            if (it == pDevice->floatNodes.end())
+                return NodeNotFound(*pDevice, nodeName);
+
+            FloatNode& node = it->second;
+            if (value < node.min || value > node.max)
+            {
+                pDevice->lastError = std::string(nodeName) + " value out of range";
+                return BackendError::INVALID_PARAMETER;
+            }
+
+            node.value = value;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetFloatRegRange(int32_t hDevice, const char* nodeName, double* pMin, double* pMax) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !nodeName || !pMin || !pMax)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+            auto it = pDevice->floatNodes.find(nodeName);
+            if (it == pDevice->floatNodes.end())
+                return NodeNotFound(*pDevice, nodeName);
+
+            *pMin = it->second.min;
+            *pMax = it->second.max;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetEnumReg(int32_t hDevice, const char* nodeName, char* pValue, uint32_t* pSize) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !nodeName)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+            auto it = pDevice->enumNodes.find(nodeName);
+            if (it == pDevice->enumNodes.end())
+                return NodeNotFound(*pDevice, nodeName);
+
+            return CopyString(it->second.value, pValue, pSize);
+        }
+
+        CVS_ERROR SetEnumReg(int32_t hDevice, const char* nodeName, const char* value) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !nodeName || !value)
+                return BackendError::INVALID_PARAMETER;
+
+            std::unique_lock<std::mutex> lock(pDevice->mutex);
+            auto it = pDevice->enumNodes.find(nodeName);
+            if (it == pDevice->enumNodes.end())
+                return NodeNotFound(*pDevice, nodeName);
+
+            EnumNode& node = it->second;
+            if (node.lockedWhileAcquiring && pDevice->acquiring)
+            {
+                pDevice->lastError = std::string(nodeName) + " is locked while acquiring";
+                return BackendError::ACCESS_DENIED;
+            }
+
+            if (std::find(node.entries.begin(), node.entries.end(), value) == node.entries.end())
+            {
+                pDevice->lastError = std::string(value) + " is not a valid entry of " + nodeName;
+                return BackendError::INVALID_PARAMETER;
+            }
+
+            node.value = value;
+            if (strcmp(nodeName, "PixelFormat") == 0)
+                UpdateDependentNodes(*pDevice);
+            lock.unlock();
+
+            // Trigger configuration changes wake any waiting grab
+            pDevice->cvState.notify_all();
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetEnumEntrySize(int32_t hDevice, const char* nodeName, int32_t* pSize) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !nodeName || !pSize)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+            auto it = pDevice->enumNodes.find(nodeName);
+            if (it == pDevice->enumNodes.end())
+                return NodeNotFound(*pDevice, nodeName);
+
+            *pSize = static_cast<int32_t>(it->second.entries.size());
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR GetEnumEntryValue(int32_t hDevice, const char* nodeName, int32_t index, char* pValue, uint32_t* pSize) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !nodeName)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+            auto it = pDevice->enumNodes.find(nodeName);
+            if (it == pDevice->enumNodes.end())
+                return NodeNotFound(*pDevice, nodeName);
+
+            if (index < 0 || index >= static_cast<int32_t>(it->second.entries.size()))
+                return BackendError::INVALID_PARAMETER;
+
+            return CopyString(it->second.entries[index], pValue, pSize);
+        }
+
+        CVS_ERROR SetBoolReg(int32_t hDevice, const char* nodeName, bool value) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !nodeName)
+                return BackendError::INVALID_PARAMETER;
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+            auto it = pDevice->boolNodes.find(nodeName);
+            if (it == pDevice->boolNodes.end())
+                return NodeNotFound(*pDevice, nodeName);
+
+            it->second = value;
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR SetCmdReg(int32_t hDevice, const char* nodeName) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !nodeName)
+                return BackendError::INVALID_PARAMETER;
+
+            std::unique_lock<std::mutex> lock(pDevice->mutex);
+            if (pDevice->commandNodes.find(nodeName) == pDevice->commandNodes.end())
+                return NodeNotFound(*pDevice, nodeName);
+
+            if (strcmp(nodeName, "TriggerSoftware") == 0)
+            {
+                if (!pDevice->acquiring || !IsSoftwareTriggerActive(*pDevice))
+                {
+                    pDevice->lastError = "Software trigger is not armed";
+                    return BackendError::ACCESS_DENIED;
+                }
+
+                pDevice->pendingTriggers++;
+                lock.unlock();
+                pDevice->cvState.notify_all();
+            }
+
+            return MCAM_ERR_OK;
+        }
+
+        CVS_ERROR ExportJson(int32_t hDevice, const char* filePath) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !filePath)
+                return BackendError::INVALID_PARAMETER;
+
+            std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+            if (!file)
+                return BackendError::FILE_IO;
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+
+            std::vector<std::string> entries;
+            for (auto& node : pDevice->intNodes)
+            {
+                std::stringstream ss;
+                ss << "        {\n            \"Name\": \"" << node.first << "\",\n"
+                    << "            \"Type\": \"Integer\",\n            \"Value\": " << node.second.value << "\n        }";
+                entries.push_back(ss.str());
+            }
+            for (auto& node : pDevice->floatNodes)
+            {
+                std::stringstream ss;
+                ss.precision(17);
+                ss << "        {\n            \"Name\": \"" << node.first << "\",\n"
+                    << "            \"Type\": \"Float\",\n            \"Value\": " << node.second.value << "\n        }";
+                entries.push_back(ss.str());
+            }
+            for (auto& node : pDevice->enumNodes)
+            {
+                std::stringstream ss;
+                ss << "        {\n            \"Name\": \"" << node.first << "\",\n"
+                    << "            \"Type\": \"Enum\",\n            \"Value\": \"" << node.second.value << "\"\n        }";
+                entries.push_back(ss.str());
+            }
+
+            file << "{\n    \"ModelName\": \"SIM-A160-72\",\n    \"Parameters\": [\n";
+            for (size_t i = 0; i < entries.size(); i++)
+            {
+                file << entries[i] << (i + 1 < entries.size() ? ",\n" : "\n");
+            }
+            file << "    ]\n}\n";
+
+            return file.good() ? MCAM_ERR_OK : BackendError::FILE_IO;
+        }
+
+        CVS_ERROR ImportJson(int32_t hDevice, const char* filePath) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice || !filePath)
+                return BackendError::INVALID_PARAMETER;
+
+            std::ifstream file(filePath);
+            if (!file)
+                return BackendError::FILE_IO;
+
+            std::stringstream content;
+            content << file.rdbuf();
+            const std::string text = content.str();
+
+            // Minimal scanner for the {"Name": ..., "Value": ...} layout written by ExportJson
+            size_t pos = 0;
+            while ((pos = text.find("\"Name\"", pos)) != std::string::npos)
+            {
+                std::string name = ReadJsonString(text, text.find(':', pos) + 1);
+                size_t valuePos = text.find("\"Value\"", pos);
+                size_t nextEntry = text.find("\"Name\"", pos + 1);
+                pos++;
+
+                if (name.empty() || valuePos == std::string::npos ||
+                    (nextEntry != std::string::npos && valuePos > nextEntry))
+                    continue;
+
+                size_t valueStart = text.find_first_not_of(" \t\r\n", text.find(':', valuePos) + 1);
+                if (valueStart == std::string::npos)
+                    break;
+
+                // Values the device rejects (read-only, out of range) are skipped like the SDK does
+                if (text[valueStart] == '"')
+                {
+                    std::string value = ReadJsonString(text, valueStart);
+                    SetEnumReg(hDevice, name.c_str(), value.c_str());
+                }
+                else
+                {
+                    double value = std::strtod(text.c_str() + valueStart, nullptr);
+                    if (SetFloatReg(hDevice, name.c_str(), value) != MCAM_ERR_OK)
+                        SetIntReg(hDevice, name.c_str(), static_cast<int64_t>(value));
+                }
+            }
+
+            return MCAM_ERR_OK;
+        }
+
+        const char* GetLastErrorDescription(int32_t hDevice) override
+        {
+            Device* pDevice = FindDevice(hDevice);
+            if (!pDevice)
+                return "Invalid device handle";
+
+            std::lock_guard<std::mutex> lock(pDevice->mutex);
+            return pDevice->lastError.empty() ? "No error" : pDevice->lastError.c_str();
+        }
+
+    private:
+        Device* FindDevice(int32_t hDevice)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_devices.find(hDevice);
+            return (it != m_devices.end()) ? it->second.get() : nullptr;
+        }
+
+        static CVS_ERROR NodeNotFound(Device& device, const char* nodeName)
+        {
+            device.lastError = std::string("Node not found: ") + nodeName;
+            return BackendError::NODE_NOT_FOUND;
+        }
+
+        static std::string ReadJsonString(const std::string& text, size_t pos)
+        {
+            size_t begin = text.find('"', pos);
+            if (begin == std::string::npos)
+                return "";
+
+            size_t end = text.find('"', begin + 1);
+            if (end == std::string::npos)
+                return "";
+
+            return text.substr(begin + 1, end - begin - 1);
+        }
+
+        void InitializeRegisters(Device& device)
+        {
+            const int64_t sensorWidth = std::max(SIMULATED_WIDTH_MIN, m_config.sensorWidth);
+            const int64_t sensorHeight = std::max(SIMULATED_HEIGHT_MIN, m_config.sensorHeight);
+            const int64_t maxWidth = sensorWidth - (sensorWidth - SIMULATED_WIDTH_MIN) % SIMULATED_WIDTH_INC;
+            const int64_t maxHeight = sensorHeight - (sensorHeight - SIMULATED_HEIGHT_MIN) % SIMULATED_HEIGHT_INC;
+
+            device.intNodes["Width"] = { maxWidth, SIMULATED_WIDTH_MIN, maxWidth, SIMULATED_WIDTH_INC, true };
+            device.intNodes["Height"] = { maxHeight, SIMULATED_HEIGHT_MIN, maxHeight, SIMULATED_HEIGHT_INC, true };
+            device.intNodes["WidthMax"] = { maxWidth, maxWidth, maxWidth, 1, true };
+            device.intNodes["HeightMax"] = { maxHeight, maxHeight, maxHeight, 1, true };
+            device.intNodes["OffsetX"] = { 0, 0, 0, SIMULATED_WIDTH_INC, false };
+            device.intNodes["OffsetY"] = { 0, 0, 0, SIMULATED_HEIGHT_INC, false };
+            device.intNodes["PayloadSize"] = { maxWidth * maxHeight, 0, INT64_MAX, 1, true };
+            device.intNodes["GevTimestampTickFrequency"] = { 1000000000LL, 1000000000LL, 1000000000LL, 1, true };
+
+            device.floatNodes["ExposureTime"] = { DEFAULT_EXPOSURE_US, 1.0, 3000000.0 };
+            device.floatNodes["Gain"] = { 0.0, 0.0, 32.0 };
+            device.floatNodes["AcquisitionFrameRate"] = {
+                std::min(std::max(m_config.frameRate, 1.0), SIMULATED_MAX_FPS), 1.0, SIMULATED_MAX_FPS };
+            if (m_config.hasHardwareGamma)
+            {
+                device.floatNodes["Gamma"] = { DEFAULT_GAMMA, 0.0, SIMULATED_GAMMA_MAX };
+            }
+            if (m_config.hasHardwareLut)
+            {
+                device.lut.resize(SIMULATED_LUT_ENTRIES);
+                for (int i = 0; i < SIMULATED_LUT_ENTRIES; i++)
+                    device.lut[i] = static_cast<uint16_t>(i);
+
+                device.intNodes["LUTIndex"] = { 0, 0, SIMULATED_LUT_ENTRIES - 1, 1, false };
+                device.intNodes["LUTValue"] = { 0, 0, SIMULATED_LUT_ENTRIES - 1, 1, false };
+                device.enumNodes["LUTSelector"] = { "Luminance", { "Luminance" }, false };
+                device.boolNodes["LUTEnable"] = false;
+            }
+
+            EnumNode pixelFormat;
+            pixelFormat.entries = { "Mono8", "Mono10", "Mono12", "Mono10Packed", "Mono12Packed",
+                "BayerRG8", "BayerGB8", "BayerGR8", "BayerBG8",
+                "BayerRG10", "BayerRG12", "BayerRG10Packed", "BayerRG12Packed" };
+            pixelFormat.value = m_config.pixelFormat;
+            pixelFormat.lockedWhileAcquiring = true;
+            if (std::find(pixelFormat.entries.begin(), pixelFormat.entries.end(), pixelFormat.value) == pixelFormat.entries.end())
+                pixelFormat.value = "BayerRG8";
+            device.enumNodes["PixelFormat"] = pixelFormat;
+
+            device.enumNodes["TriggerMode"] = { "Off", { "Off", "On" }, false };
+            device.enumNodes["TriggerSource"] = { "Software", { "Software", "Line1" }, false };
+            device.enumNodes["AcquisitionMode"] = { "Continuous", { "Continuous", "SingleFrame", "MultiFrame" }, true };
+
+            device.commandNodes = { "TriggerSoftware", "AcquisitionStart", "AcquisitionStop" };
+
+            UpdateDependentNodes(device);
+        }
+
+        void UpdateDependentNodes(Device& device)
+        {
+            IntNode& width = device.intNodes["Width"];
+            IntNode& height = device.intNodes["Height"];
+            IntNode& offsetX = device.intNodes["OffsetX"];
+            IntNode& offsetY = device.intNodes["OffsetY"];
+            const int64_t maxWidth = device.intNodes["WidthMax"].value;
+            const int64_t maxHeight = device.intNodes["HeightMax"].value;
+
+            // ROI window must stay inside the sensor
+            offsetX.max = maxWidth - width.value;
+            offsetY.max = maxHeight - height.value;
+            offsetX.value = std::min(offsetX.value, offsetX.max);
+            offsetY.value = std::min(offsetY.value, offsetY.max);
+            width.max = maxWidth - offsetX.value;
+            height.max = maxHeight - offsetY.value;
+
+            const ImageProcessing::RawFormat rawFormat = GetSimulatedRawFormat(device.enumNodes["PixelFormat"].value);
+            device.intNodes["PayloadSize"].value =
+                static_cast<int64_t>(ImageProcessing::GetRawRowBytes(static_cast<int>(width.value), rawFormat)) * height.value;
+
+            // Readout time grows with the window height
+            if (m_config.lineTimeUs > 0.0)
+            {
+                FloatNode& frameRate = device.floatNodes["AcquisitionFrameRate"];
+                frameRate.max = std::max(frameRate.min,
+                    std::min(SIMULATED_MAX_FPS, 1000000.0 / (m_config.lineTimeUs * static_cast<double>(height.value))));
+                frameRate.value = std::min(frameRate.value, frameRate.max);
+            }
+        }
+
+        // Window for a frame whose exposure starts now
+        static void LatchOffsets(Device& device, int& offsetX, int& offsetY)
+        {
+            offsetX = static_cast<int>(device.intNodes["OffsetX"].value);
+            offsetY = static_cast<int>(device.intNodes["OffsetY"].value);
+        }
+
+        static bool IsSoftwareTriggerActive(Device& device)
+        {
+            return device.enumNodes["TriggerMode"].value == "On";
+        }
+
+        std::chrono::steady_clock::duration FramePeriod(Device& device)
+        {
+            double fps = device.floatNodes["AcquisitionFrameRate"].value;
+            double exposureUs = device.floatNodes["ExposureTime"].value;
+
+            // Frame rate cannot exceed what the exposure time allows
+            if (exposureUs > 0.0)
+                fps = std::min(fps, 1000000.0 / exposureUs);
+
+            return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / std::max(fps, 0.001)));
+        }
+
+        std::chrono::steady_clock::duration FrameJitter(Device& device)
+        {
+            if (m_config.frameJitterUs <= 0.0)
+                return std::chrono::steady_clock::duration::zero();
+
+            std::uniform_real_distribution<double> jitter(-m_config.frameJitterUs, m_config.frameJitterUs);
+            return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double, std::micro>(jitter(device.rng)));
+        }
+
+        // Blocks until the device produces its next frame, the deadline passes or streaming stops.
+        // Each produced frame is handed to exactly one consumer (callback thread or GrabImage).
+        FrameEvent WaitForNextFrame(Device& device, std::chrono::steady_clock::time_point deadline, uint64_t& blockID,
+            int& offsetX, int& offsetY)
+        {
+            std::unique_lock<std::mutex> lock(device.mutex);
+            std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+            while (true)
+            {
+                if (!device.acquiring || device.stopStream)
+                    return FrameEvent::Stopped;
+
+                if (IsSoftwareTriggerActive(device))
+                {
+                    if (device.pendingTriggers == 0)
+                    {
+                        if (!device.cvState.wait_until(lock, deadline, [&device] {
+                            return !device.acquiring || device.stopStream || device.pendingTriggers > 0;
+                            }))
+                        {
+                            return FrameEvent::Timeout;
+                        }
+                        continue;
+                    }
+
+                    device.pendingTriggers--;
+                    LatchOffsets(device, device.exposingOffsetX, device.exposingOffsetY);
+                }
+                else
+                {
+                    auto due = device.nextFrameTime;
+                    if (due > deadline)
+                    {
+                        device.cvState.wait_until(lock, deadline, [&device] {
+                            return !device.acquiring || device.stopStream;
+                            });
+                        return device.acquiring && !device.stopStream ? FrameEvent::Timeout : FrameEvent::Stopped;
+                    }
+
+                    if (device.cvState.wait_until(lock, due, [&device] {
+                        return !device.acquiring || device.stopStream || IsSoftwareTriggerActive(device);
+                        }))
+                    {
+                        continue;
+                    }
+
+                    // Free-run schedule; resynchronise if the consumer fell more than a frame behind
+                    auto period = FramePeriod(device);
+                    auto now = std::chrono::steady_clock::now();
+                    device.nextFrameTime = (now - due > period) ? now + period : due + period;
+                    device.nextFrameTime += FrameJitter(device);
+                }
+
+                blockID = ++device.blockID;
+                offsetX = device.exposingOffsetX;
+                offsetY = device.exposingOffsetY;
+                if (!IsSoftwareTriggerActive(device))
+                    LatchOffsets(device, device.exposingOffsetX, device.exposingOffsetY);
+
+                if (m_config.timeoutProbability > 0.0 && chance(device.rng) < m_config.timeoutProbability)
+                {
+                    // Frame never arrives: the sensor stalls for a full grab timeout
+                    device.nextFrameTime += std::chrono::milliseconds(m_config.grabTimeoutMs);
+                    continue;
+                }
+
+                if (m_config.errorProbability > 0.0 && chance(device.rng) < m_config.errorProbability)
+                {
+                    device.lastError = "Simulated transfer error";
+                    return FrameEvent::Error;
+                }
+
+                return FrameEvent::Ready;
+            }
+        }
+
+        void StartStreamThread(Device& device)
+        {
+            std::lock_guard<std::mutex> lock(device.mutex);
+            if (!device.acquiring || !device.callback || device.streamThread.joinable())
+                return;
+
+            device.stopStream = false;
+            device.streamThread = std::thread(&SimulatedCameraBackend::StreamThreadFunc, this, &device);
+        }
+
+        void JoinStreamThread(Device& device)
+        {
+            if (!device.streamThread.joinable())
+                return;
+
+            if (device.streamThread.get_id() == std::this_thread::get_id())
+            {
+                // Called from inside the grab callback; the thread exits on its own
+                device.streamThread.detach();
+                return;
+            }
+
+            device.streamThread.join();
+        }
+
+        // Push-mode delivery: renders each frame into a device-owned buffer and invokes the callback
+        void StreamThreadFunc(Device* pDevice)
+        {
+            CVS_BUFFER frame;
+            memset(&frame, 0, sizeof(frame));
+
+            std::vector<uint8_t> storage;
+            {
+                std::lock_guard<std::mutex> lock(pDevice->mutex);
+                frame.image.width = pDevice->streamWidth;
+                frame.image.height = pDevice->streamHeight;
+                frame.image.step = ImageProcessing::GetRawRowBytes(pDevice->streamWidth, pDevice->streamRawFormat);
+                storage.resize(static_cast<size_t>(frame.image.step) * pDevice->streamHeight);
+            }
+            frame.image.pImage = storage.data();
+            frame.image.channels = 1;
+
+            while (true)
+            {
+                uint64_t blockID = 0;
+                int offsetX = 0, offsetY = 0;
+                FrameEvent event = WaitForNextFrame(*pDevice,
+                    std::chrono::steady_clock::now() + std::chrono::milliseconds(m_config.grabTimeoutMs),
+                    blockID, offsetX, offsetY);
+
+                if (event == FrameEvent::Stopped)
+                    break;
+
+                if (event != FrameEvent::Ready)
+                    continue;
+
+                RenderFrame(*pDevice, &frame, blockID, offsetX, offsetY);
+
+                GrabCallbackFunc callback;
+                void* pUserDefine;
+                {
+                    std::lock_guard<std::mutex> lock(pDevice->mutex);
+                    callback = pDevice->callback;
+                    pUserDefine = pDevice->pUserDefine;
+                }
+
+                if (callback)
+                    callback(EVENT_NEW_IMAGE, &frame, pUserDefine);
+            }
+        }
+
+        // Static scene over the whole sensor: RGB gradients sampled through the configured colour filter array
+        static void RenderBackground(Device& device)
+        {
+            const int width = device.sensorWidth;
+            const int height = device.sensorHeight;
+            const std::string& format = device.streamFormat;
+            const bool isBayer = IsBayerFormat(format);
+
+            // Colour at (0,0),(1,0),(0,1),(1,1) of the 2x2 CFA tile: 0=R, 1=G, 2=B
+            int cfa[4] = { 0, 1, 1, 2 };
+            ImageProcessing::BayerPattern pattern = ImageProcessing::BayerPattern::RG;
+            ImageProcessing::ParseBayerPattern(format, pattern);
+            if (pattern == ImageProcessing::BayerPattern::BG) { cfa[0] = 2; cfa[1] = 1; cfa[2] = 1; cfa[3] = 0; }
+            else if (pattern == ImageProcessing::BayerPattern::GB) { cfa[0] = 1; cfa[1] = 2; cfa[2] = 0; cfa[3] = 1; }
+            else if (pattern == ImageProcessing::BayerPattern::GR) { cfa[0] = 1; cfa[1] = 0; cfa[2] = 2; cfa[3] = 1; }
+
+            device.background.resize(static_cast<size_t>(width) * height);
+            for (int y = 0; y < height; y++)
+            {
+                uint8_t* row = device.background.data() + static_cast<size_t>(y) * width;
+                for (int x = 0; x < width; x++)
+                {
+                    int r = 40 + (x * 160) / std::max(1, width - 1);
+                    int g = 40 + (y * 160) / std::max(1, height - 1);
+                    int b = (((x >> 5) ^ (y >> 5)) & 1) ? 150 : 60;
+
+                    if (isBayer)
+                    {
+                        int color = cfa[((y & 1) << 1) | (x & 1)];
+                        row[x] = static_cast<uint8_t>(color == 0 ? r : (color == 1 ? g : b));
+                    }
+                    else
+                    {
+                        row[x] = static_cast<uint8_t>((r * 77 + g * 150 + b * 29) >> 8);
+                    }
+                }
+            }
+        }
+
+        CVS_ERROR RenderFrame(Device& device, CVS_BUFFER* pBuffer, uint64_t blockID, int offsetX, int offsetY)
+        {
+            const int width = device.streamWidth;
+            const int height = device.streamHeight;
+            const ImageProcessing::RawFormat& rawFormat = device.streamRawFormat;
+
+            if (pBuffer->image.width < width || pBuffer->image.height < height ||
+                pBuffer->image.step < ImageProcessing::GetRawRowBytes(width, rawFormat))
+            {
+                return BackendError::BUFFER_TOO_SMALL;
+            }
+
+            // Offsets were latched when the frame's exposure started
+            offsetX = std::max(0, std::min(offsetX, device.sensorWidth - width));
+            offsetY = std::max(0, std::min(offsetY, device.sensorHeight - height));
+
+            // The hardware LUT applies to the sensor's 12-bit values; take a copy for this frame
+            thread_local std::vector<uint16_t> lut;
+            bool bLut;
+            {
+                std::lock_guard<std::mutex> lock(device.mutex);
+                auto it = device.boolNodes.find("LUTEnable");
+                bLut = it != device.boolNodes.end() && it->second;
+                if (bLut)
+                    lut = device.lut;
+            }
+
+            // Higher bit depths (and the LUT) render the 8-bit scene first and encode it row by row
+            const bool bEncode = rawFormat.bitDepth != 8 || bLut;
+            thread_local std::vector<uint8_t> scene;
+            if (bEncode)
+                scene.resize(static_cast<size_t>(width) * height);
+
+            uint8_t* pDst = bEncode ? scene.data() : static_cast<uint8_t*>(pBuffer->image.pImage);
+            const int step = bEncode ? width : pBuffer->image.step;
+            for (int y = 0; y < height; y++)
+            {
+                memcpy(pDst + static_cast<size_t>(y) * step,
+                    device.background.data() + static_cast<size_t>(offsetY + y) * device.sensorWidth + offsetX, width);
+            }
+
+            // Bright ball bouncing across the sensor, seen through the window
+            const int radius = std::max(4, device.sensorHeight / 24);
+            const int spanX = std::max(1, device.sensorWidth - 2 * radius);
+            const int spanY = std::max(1, device.sensorHeight - 2 * radius);
+            const int phaseX = static_cast<int>((blockID * 7) % (2 * spanX));
+            const int phaseY = static_cast<int>((blockID * 5) % (2 * spanY));
+            const int cx = radius + (phaseX < spanX ? phaseX : 2 * spanX - phaseX) - offsetX;
+            const int cy = radius + (phaseY < spanY ? phaseY : 2 * spanY - phaseY) - offsetY;
+
+            for (int y = std::max(0, cy - radius); y < std::min(height, cy + radius); y++)
+            {
+                int dy = y - cy;
+                int dx = static_cast<int>(std::sqrt(static_cast<double>(radius * radius - dy * dy)));
+                int x0 = std::max(0, cx - dx);
+                int x1 = std::min(width, cx + dx);
+                if (x1 > x0)
+                    memset(pDst + static_cast<size_t>(y) * step + x0, 235, x1 - x0);
+            }
+
+            if (bEncode)
+            {
+                uint8_t* pRaw = static_cast<uint8_t*>(pBuffer->image.pImage);
+                for (int y = 0; y < height; y++)
+                {
+                    EncodeRawRow(scene.data() + static_cast<size_t>(y) * width,
+                        pRaw + static_cast<size_t>(y) * pBuffer->image.step, width, rawFormat, bLut ? lut.data() : nullptr);
+                }
+            }
+
+            pBuffer->image.width = width;
+            pBuffer->image.height = height;
+            pBuffer->image.channels = 1;
+            pBuffer->blockID = blockID;
+            pBuffer->timestamp = SteadyClockNs();
+            return MCAM_ERR_OK;
+        }
+    };
+
+    std::unique_ptr<ICameraBackend> CreateSimulatedBackend(const SimulatedCameraConfig& config)
+    {
+        return std::make_unique<SimulatedCameraBackend>(config);
+    }
+
+    CVS_ERROR SoftwareCvtColor(const CVS_BUFFER& src, CVS_BUFFER* pDst, int32_t code)
+    {
+        if (!pDst || !src.image.pImage || !pDst->image.pImage)
+            return BackendError::INVALID_PARAMETER;
+
+        const int width = src.image.width;
+        const int height = src.image.height;
+        if (src.image.channels != 1 || pDst->image.channels != 3 ||
+            pDst->image.width < width || pDst->image.height < height)
+        {
+            return BackendError::BUFFER_TOO_SMALL;
+        }
+
+        ImageProcessing::BayerPattern pattern;
+        switch (code)
+        {
+        case CVP_BayerRG2RGB: pattern = ImageProcessing::BayerPattern::RG; break;
+        case CVP_BayerGR2RGB: pattern = ImageProcessing::BayerPattern::GR; break;
+        case CVP_BayerGB2RGB: pattern = ImageProcessing::BayerPattern::GB; break;
+        case CVP_BayerBG2RGB: pattern = ImageProcessing::BayerPattern::BG; break;
+        default:
+            return BackendError::INVALID_PARAMETER;
+        }
+
+        if (!ImageProcessing::Demosaic(static_cast<const uint8_t*>(src.image.pImage), src.image.step,
+            static_cast<uint8_t*>(pDst->image.pImage), pDst->image.step,
+            width, height, pattern, DemosaicMethod::Bilinear))
+        {
+            return BackendError::INVALID_PARAMETER;
+        }
+
+        pDst->blockID = src.blockID;
+        pDst->timestamp = src.timestamp;
+        return MCAM_ERR_OK;
+    }
+}
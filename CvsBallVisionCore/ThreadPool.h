@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CvsBallVision
+{
+    // Fixed set of worker threads for splitting image work into row bands.
+    //
+    // ParallelFor blocks until every band has run; the calling thread processes bands too,
+    // so a pool with zero workers simply runs the whole range inline.
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(size_t workerCount)
+            : m_bStop(false)
+        {
+            for (size_t i = 0; i < workerCount; ++i)
+            {
+                m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+            }
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_bStop = true;
+            }
+            m_cvWork.notify_all();
+
+            for (auto& worker : m_workers)
+            {
+                if (worker.joinable())
+                    worker.join();
+            }
+        }
+
+        size_t GetWorkerCount() const { return m_workers.size(); }
+
+        // Run fn(begin, end) over [0, count) in bands of at least minPerBand items
+        void ParallelFor(int count, int minPerBand, const std::function<void(int, int)>& fn)
+        {
+            if (count <= 0)
+                return;
+
+            const int maxBands = static_cast<int>(m_workers.size()) + 1;
+            const int bandCount = std::max(1, std::min(maxBands, count / std::max(1, minPerBand)));
+            if (bandCount == 1)
+            {
+                fn(0, count);
+                return;
+            }
+
+            // Shared with the workers; a late worker may still hold it after we return
+            auto pJob = std::make_shared<Job>(fn, count, bandCount);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (int i = 1; i < bandCount; ++i)
+                {
+                    m_tasks.push_back(pJob);
+                }
+            }
+            m_cvWork.notify_all();
+
+            RunBands(*pJob);
+
+            std::unique_lock<std::mutex> lock(pJob->doneMutex);
+            pJob->cvDone.wait(lock, [&] { return pJob->bandsDone == pJob->bandCount; });
+        }
+
+    private:
+        struct Job
+        {
+            std::function<void(int, int)> fn;
+            int count;
+            int bandCount;
+            std::atomic<int> nextBand;
+            int bandsDone;
+            std::mutex doneMutex;
+            std::condition_variable cvDone;
+
+            Job(const std::function<void(int, int)>& function, int total, int bands)
+                : fn(function), count(total), bandCount(bands), nextBand(0), bandsDone(0)
+            {
+            }
+        };
+
+        // Claim bands until none are left
+        static void RunBands(Job& job)
+        {
+            for (;;)
+            {
+                int band = job.nextBand.fetch_add(1, std::memory_order_relaxed);
+                if (band >= job.bandCount)
+                    return;
+
+                int begin = static_cast<int>(static_cast<int64_t>(job.count) * band / job.bandCount);
+                int end = static_cast<int>(static_cast<int64_t>(job.count) * (band + 1) / job.bandCount);
+                job.fn(begin, end);
+
+                bool bLast;
+                {
+                    std::lock_guard<std::mutex> lock(job.doneMutex);
+                    bLast = (++job.bandsDone == job.bandCount);
+                }
+                if (bLast)
+                    job.cvDone.notify_all();
+            }
+        }
+
+        void WorkerLoop()
+        {
+            for (;;)
+            {
+                std::shared_ptr<Job> pJob;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cvWork.wait(lock, [this] { return m_bStop || !m_tasks.empty(); });
+                    if (m_bStop && m_tasks.empty())
+                        return;
+
+                    pJob = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+
+                RunBands(*pJob);
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        std::vector<std::thread> m_workers;
+        std::deque<std::shared_ptr<Job>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_cvWork;
+        bool m_bStop;
+    };
+}
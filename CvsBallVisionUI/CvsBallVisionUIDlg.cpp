@@ -23,14 +23,10 @@ CvsBallVisionUIDlg::CvsBallVisionUIDlg(CWnd* pParent /*=nullptr*/)
     , m_imageWidth(DEFAULT_WIDTH)
     , m_imageHeight(DEFAULT_HEIGHT)
     , m_bImageUpdated(false)
-    , m_displayBufferSize(0)
     , m_bShuttingDown(false)
     , m_bAsyncOperationInProgress(false)
 {
     m_pCamera = std::make_unique<CvsBallVision::CameraController>();
-
-    // Pre-allocate display buffer for maximum expected size
-    m_displayBuffer.reserve(1920 * 1080 * 3);
 }
 
 CvsBallVisionUIDlg::~CvsBallVisionUIDlg()
@@ -53,12 +49,10 @@ void CvsBallVisionUIDlg::ShutdownCamera()
         m_asyncThread.join();
     }
 
-    // 2. Stop acquisition first (most important)
+    // 2. Stop acquisition first (most important; returns once callbacks have drained)
     if (m_pCamera && m_pCamera->IsAcquiring())
     {
         m_pCamera->StopAcquisition();
-        // Wait for acquisition to fully stop
-        std::this_thread::sleep_for(std::chrono::milliseconds(ACQUISITION_STOP_TIMEOUT_MS));
     }
 
     // 3. Set shutdown flag
@@ -72,16 +66,13 @@ void CvsBallVisionUIDlg::ShutdownCamera()
         m_pCamera->RegisterStatusCallback(nullptr);
     }
 
-    // 5. Wait for any ongoing callbacks to complete
-    std::this_thread::sleep_for(std::chrono::milliseconds(CAMERA_STOP_WAIT_MS));
-
-    // 6. Disconnect camera
+    // 5. Disconnect camera
     if (m_pCamera && m_pCamera->IsConnected())
     {
         m_pCamera->DisconnectCamera();
     }
 
-    // 7. Free system
+    // 6. Free system
     if (m_pCamera && m_pCamera->IsSystemInitialized())
     {
         m_pCamera->FreeSystem();
@@ -187,8 +178,8 @@ BOOL CvsBallVisionUIDlg::OnInitDialog()
     m_sliderFps.SetRange(1, 200);
     m_sliderFps.SetPos(static_cast<int>(DEFAULT_FPS));
 
-    // Initialize gamma slider (0.1 ~ 3.0 mapped to 10 ~ 300)
-    m_sliderGamma.SetRange(10, 300);
+    // Initialize gamma slider (GAMMA_MIN ~ GAMMA_MAX mapped to 10 ~ 399)
+    m_sliderGamma.SetRange(static_cast<int>(GAMMA_MIN * 100), static_cast<int>(GAMMA_MAX * 100));
     m_sliderGamma.SetPos(static_cast<int>(DEFAULT_GAMMA * 100));
 
     // Update slider value displays
@@ -257,10 +248,10 @@ void CvsBallVisionUIDlg::InitializeCamera()
         return;
 
     // Register callbacks with safety checks
-    m_pCamera->RegisterImageCallback(
-        [this](const CvsBallVision::ImageData& imageData) {
+    m_pCamera->RegisterFrameCallback(
+        [this](const CvsBallVision::FrameRef& frame) {
             if (!m_bShuttingDown)
-                OnImageCallback(imageData);
+                OnImageCallback(frame);
         });
 
     m_pCamera->RegisterErrorCallback(
@@ -275,6 +266,12 @@ void CvsBallVisionUIDlg::InitializeCamera()
                 OnStatusCallback(status);
         });
 
+    // Have the core write frames as DIB rows (BGR, DWORD-aligned) so DrawImage needs no conversion
+    CvsBallVision::OutputFormat outputFormat;
+    outputFormat.layout = CvsBallVision::PixelLayout::BGR24;
+    outputFormat.rowAlignment = 4;
+    m_pCamera->SetOutputFormat(outputFormat);
+
     // Initialize system
     if (!m_pCamera->InitializeSystem())
     {
@@ -365,7 +362,17 @@ void CvsBallVisionUIDlg::UpdateStatistics()
     str.Format(_T("Frames: %llu"), m_frameCount);
     m_staticFrameCount.SetWindowText(str);
 
-    str.Format(_T("Errors: %llu"), m_errorCount);
+    CvsBallVision::FrameRingStatistics ringStats;
+    m_pCamera->GetFrameRingStatistics(ringStats);
+    CvsBallVision::PipelineStatistics pipelineStats;
+    m_pCamera->GetPipelineStatistics(pipelineStats);
+
+    uint64_t droppedFrames = ringStats.framesDroppedRingFull + ringStats.framesDroppedDevice +
+        ringStats.framesDroppedInvalid + pipelineStats.capture.framesDropped +
+        pipelineStats.debayer.framesDropped + pipelineStats.postProcess.framesDropped +
+        pipelineStats.fanOut.framesDropped;
+
+    str.Format(_T("Errors: %llu  Drops: %llu"), m_errorCount, droppedFrames);
     m_staticErrorCount.SetWindowText(str);
 }
 
@@ -472,9 +479,25 @@ void CvsBallVisionUIDlg::ApplySettings()
     if (!m_pCamera || !m_pCamera->IsConnected())
         return;
 
+    // Start from the current profile so empty or invalid fields keep their value
+    CvsBallVision::CameraParameters params;
+    if (!m_pCamera->GetParameters(params))
+        return;
+
+    ReadParameterControls(params);
+    m_pCamera->ApplyParameters(params);
+
+    // Apply software gamma setting
+    bool useSoftwareGamma = (m_checkSoftwareGamma.GetCheck() == BST_CHECKED);
+    m_pCamera->SetSoftwareGammaEnabled(useSoftwareGamma);
+
+    UpdateParameterValues();
+}
+
+void CvsBallVisionUIDlg::ReadParameterControls(CvsBallVision::CameraParameters& params)
+{
     CString str;
 
-    // Apply resolution
     m_editWidth.GetWindowText(str);
     int width = _ttoi(str);
 
@@ -483,46 +506,37 @@ void CvsBallVisionUIDlg::ApplySettings()
 
     if (width > 0 && height > 0)
     {
-        m_pCamera->SetResolution(width, height);
+        params.width = width;
+        params.height = height;
     }
 
-    // Apply exposure
     m_editExposure.GetWindowText(str);
     double exposure = _ttof(str);
     if (exposure > 0)
     {
-        m_pCamera->SetExposureTime(exposure);
+        params.exposureTime = exposure;
     }
 
-    // Apply gain
     m_editGain.GetWindowText(str);
     double gain = _ttof(str);
     if (gain >= 0)
     {
-        m_pCamera->SetGain(gain);
+        params.gain = gain;
     }
 
-    // Apply FPS
     m_editFps.GetWindowText(str);
     double fps = _ttof(str);
     if (fps > 0)
     {
-        m_pCamera->SetFrameRate(fps);
+        params.fps = fps;
     }
 
-    // Apply gamma
     m_editGamma.GetWindowText(str);
     double gamma = _ttof(str);
-    if (gamma >= 0.1 && gamma <= 3.0)
+    if (gamma >= GAMMA_MIN && gamma <= GAMMA_MAX)
     {
-        m_pCamera->SetGamma(gamma);
+        params.gamma = gamma;
     }
-
-    // Apply software gamma setting
-    bool useSoftwareGamma = (m_checkSoftwareGamma.GetCheck() == BST_CHECKED);
-    m_pCamera->SetSoftwareGammaEnabled(useSoftwareGamma);
-
-    UpdateParameterValues();
 }
 
 void CvsBallVisionUIDlg::CreateMemoryDC()
@@ -559,12 +573,20 @@ void CvsBallVisionUIDlg::DrawImage()
     CRect rect;
     m_staticVideo.GetClientRect(&rect);
 
-    // Try to lock for drawing - skip if locked (real-time optimization)
-    std::unique_lock<std::mutex> lock(m_imageMutex, std::try_to_lock);
-    if (!lock.owns_lock())
-        return;
+    // Take a reference to the current frame; the camera keeps filling other slots meanwhile
+    CvsBallVision::FrameRef frame;
+    {
+        std::lock_guard<std::mutex> lock(m_imageMutex);
+        frame = m_displayFrame;
+    }
 
-    if (m_displayBuffer.empty() || m_imageWidth <= 0 || m_imageHeight <= 0)
+    // Frames arrive in DIB layout (see InitializeCamera); anything else is not drawn
+    const CvsBallVision::ImageData& imageData = frame.GetImageData();
+    const bool bDrawable = imageData.layout == CvsBallVision::PixelLayout::Mono8 ||
+        imageData.layout == CvsBallVision::PixelLayout::BGR24 ||
+        imageData.layout == CvsBallVision::PixelLayout::BGRA32;
+    if (!frame || !imageData.pData || imageData.width <= 0 || imageData.height <= 0 || !bDrawable ||
+        imageData.step != ((imageData.width * imageData.channels + 3) & ~3))
     {
         // Clear with black
         m_memDC.FillSolidRect(&rect, RGB(0, 0, 0));
@@ -572,33 +594,48 @@ void CvsBallVisionUIDlg::DrawImage()
     else
     {
         // Calculate scaling to fit
-        double scaleX = static_cast<double>(rect.Width()) / m_imageWidth;
-        double scaleY = static_cast<double>(rect.Height()) / m_imageHeight;
+        double scaleX = static_cast<double>(rect.Width()) / imageData.width;
+        double scaleY = static_cast<double>(rect.Height()) / imageData.height;
         double scale = min(scaleX, scaleY);
 
-        int destWidth = static_cast<int>(m_imageWidth * scale);
-        int destHeight = static_cast<int>(m_imageHeight * scale);
+        int destWidth = static_cast<int>(imageData.width * scale);
+        int destHeight = static_cast<int>(imageData.height * scale);
         int destX = (rect.Width() - destWidth) / 2;
         int destY = (rect.Height() - destHeight) / 2;
 
         // Clear background
         m_memDC.FillSolidRect(&rect, RGB(0, 0, 0));
 
-        // Create bitmap from image data
-        BITMAPINFO bmi = { 0 };
+        // Create bitmap header directly over the frame data (grayscale palette for mono)
+        struct
+        {
+            BITMAPINFOHEADER bmiHeader;
+            RGBQUAD bmiColors[256];
+        } bmi = { 0 };
         bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-        bmi.bmiHeader.biWidth = m_imageWidth;
-        bmi.bmiHeader.biHeight = -m_imageHeight; // Top-down
+        bmi.bmiHeader.biWidth = imageData.width;
+        bmi.bmiHeader.biHeight = imageData.bottomUp ? imageData.height : -imageData.height;
         bmi.bmiHeader.biPlanes = 1;
-        bmi.bmiHeader.biBitCount = 24;
+        bmi.bmiHeader.biBitCount = static_cast<WORD>(imageData.channels * 8);
         bmi.bmiHeader.biCompression = BI_RGB;
 
+        if (imageData.channels == 1)
+        {
+            bmi.bmiHeader.biClrUsed = 256;
+            for (int i = 0; i < 256; i++)
+            {
+                bmi.bmiColors[i].rgbRed = static_cast<BYTE>(i);
+                bmi.bmiColors[i].rgbGreen = static_cast<BYTE>(i);
+                bmi.bmiColors[i].rgbBlue = static_cast<BYTE>(i);
+            }
+        }
+
         // Draw image
         SetStretchBltMode(m_memDC.GetSafeHdc(), HALFTONE);
         StretchDIBits(m_memDC.GetSafeHdc(),
             destX, destY, destWidth, destHeight,
-            0, 0, m_imageWidth, m_imageHeight,
-            m_displayBuffer.data(), &bmi, DIB_RGB_COLORS, SRCCOPY);
+            0, 0, imageData.width, imageData.height,
+            imageData.pData, reinterpret_cast<BITMAPINFO*>(&bmi), DIB_RGB_COLORS, SRCCOPY);
     }
 
     // Copy to screen
@@ -606,56 +643,23 @@ void CvsBallVisionUIDlg::DrawImage()
     dc.BitBlt(0, 0, rect.Width(), rect.Height(), &m_memDC, 0, 0, SRCCOPY);
 }
 
-void CvsBallVisionUIDlg::OnImageCallback(const CvsBallVision::ImageData& imageData)
+void CvsBallVisionUIDlg::OnImageCallback(const CvsBallVision::FrameRef& frame)
 {
     if (m_bShuttingDown)
         return;
 
     // Data validation
+    const CvsBallVision::ImageData& imageData = frame.GetImageData();
     if (!imageData.pData || imageData.width <= 0 || imageData.height <= 0)
         return;
 
-    // Try to lock - skip frame if locked (real-time optimization)
-    std::unique_lock<std::mutex> lock(m_imageMutex, std::try_to_lock);
-    if (!lock.owns_lock())
-        return;
-
-    // Update dimensions
-    m_imageWidth = imageData.width;
-    m_imageHeight = imageData.height;
-
-    // Optimized buffer allocation
-    int dataSize = imageData.width * imageData.height * 3;
-
-    // Only reallocate if capacity is insufficient
-    if (m_displayBuffer.capacity() < dataSize)
-    {
-        // Allocate with extra space to reduce future reallocations
-        m_displayBuffer.reserve(static_cast<size_t>(dataSize * BUFFER_RESERVE_FACTOR));
-    }
-
-    // Resize to actual needed size
-    m_displayBuffer.resize(dataSize);
-    m_displayBufferSize = dataSize;
-
-    // Copy image data
-    if (imageData.channels == 3)
+    // Keep a reference to the frame instead of copying it; the previous frame
+    // is released back to the core's frame ring
     {
-        // RGB data - direct copy
-        memcpy(m_displayBuffer.data(), imageData.pData, dataSize);
-    }
-    else if (imageData.channels == 1)
-    {
-        // Grayscale - convert to RGB
-        uint8_t* dst = m_displayBuffer.data();
-        const uint8_t* src = imageData.pData;
-        for (int i = 0; i < imageData.width * imageData.height; i++)
-        {
-            uint8_t gray = src[i];
-            dst[i * 3] = gray;
-            dst[i * 3 + 1] = gray;
-            dst[i * 3 + 2] = gray;
-        }
+        std::lock_guard<std::mutex> lock(m_imageMutex);
+        m_displayFrame = frame;
+        m_imageWidth = imageData.width;
+        m_imageHeight = imageData.height;
     }
 
     m_bImageUpdated = true;
@@ -740,48 +744,23 @@ void CvsBallVisionUIDlg::ApplySettingsAsync()
     m_staticStatus.SetWindowText(_T("Applying settings..."));
     UpdateUIState();
 
-    // Get values from UI controls
-    CString str;
-    m_editWidth.GetWindowText(str);
-    int width = _ttoi(str);
-
-    m_editHeight.GetWindowText(str);
-    int height = _ttoi(str);
-
-    m_editExposure.GetWindowText(str);
-    double exposure = _ttof(str);
-
-    m_editGain.GetWindowText(str);
-    double gain = _ttof(str);
-
-    m_editFps.GetWindowText(str);
-    double fps = _ttof(str);
-
-    m_editGamma.GetWindowText(str);
-    double gamma = _ttof(str);
+    // Get values from UI controls (fields left empty or invalid keep the current value)
+    CvsBallVision::CameraParameters params;
+    bool bHaveParams = m_pCamera && m_pCamera->GetParameters(params);
+    if (bHaveParams)
+    {
+        ReadParameterControls(params);
+    }
 
     bool useSoftwareGamma = (m_checkSoftwareGamma.GetCheck() == BST_CHECKED);
 
-    m_asyncThread = std::thread([this, width, height, exposure, gain, fps, gamma, useSoftwareGamma]() {
-        bool success = true;
+    m_asyncThread = std::thread([this, params, bHaveParams, useSoftwareGamma]() {
+        bool success = bHaveParams;
 
-        if (m_pCamera && m_pCamera->IsConnected())
+        if (bHaveParams && m_pCamera->IsConnected())
         {
-            if (width > 0 && height > 0)
-                success &= m_pCamera->SetResolution(width, height);
-
-            if (exposure > 0)
-                success &= m_pCamera->SetExposureTime(exposure);
-
-            if (gain >= 0)
-                success &= m_pCamera->SetGain(gain);
-
-            if (fps > 0)
-                success &= m_pCamera->SetFrameRate(fps);
-
-            if (gamma >= 0.1 && gamma <= 3.0)
-                success &= m_pCamera->SetGamma(gamma);
-
+            // One transaction: at most one stop/restart, writes ordered by the core
+            success = m_pCamera->ApplyParameters(params);
             m_pCamera->SetSoftwareGammaEnabled(useSoftwareGamma);
         }
 
@@ -897,7 +876,7 @@ void CvsBallVisionUIDlg::OnBnClickedCheckSoftwareGamma()
         CString str;
         m_editGamma.GetWindowText(str);
         double gamma = _ttof(str);
-        if (gamma >= 0.1 && gamma <= 3.0)
+        if (gamma >= GAMMA_MIN && gamma <= GAMMA_MAX)
         {
             m_pCamera->SetGamma(gamma);
         }
@@ -1051,8 +1030,7 @@ LRESULT CvsBallVisionUIDlg::OnAsyncOperationComplete(WPARAM wParam, LPARAM lPara
             // Clear display
             {
                 std::lock_guard<std::mutex> lock(m_imageMutex);
-                m_displayBuffer.clear();
-                m_displayBufferSize = 0;
+                m_displayFrame.Reset();
             }
             DrawImage();
         }
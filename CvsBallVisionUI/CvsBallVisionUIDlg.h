@@ -69,10 +69,9 @@ private:
     CDC m_memDC;
     CBitmap m_memBitmap;
     std::mutex m_imageMutex;
-    std::vector<uint8_t> m_displayBuffer;
+    CvsBallVision::FrameRef m_displayFrame;     // Shared with the core, no copy
     int m_imageWidth;
     int m_imageHeight;
-    size_t m_displayBufferSize;
     std::atomic<bool> m_bImageUpdated;
     std::atomic<bool> m_bShuttingDown;
 
@@ -130,6 +129,7 @@ private:
     void UpdateParameterRanges();
     void UpdateParameterValues();
     void ApplySettings();
+    void ReadParameterControls(CvsBallVision::CameraParameters& params);
     void DrawImage();
     void CreateMemoryDC();
 
@@ -139,7 +139,7 @@ private:
     void ApplySettingsAsync();
 
     // Callbacks from camera
-    void OnImageCallback(const CvsBallVision::ImageData& imageData);
+    void OnImageCallback(const CvsBallVision::FrameRef& frame);
     void OnErrorCallback(int errorCode, const std::string& errorMsg);
     void OnStatusCallback(const std::string& status);
 };